@@ -1,28 +0,0 @@
-
-# Consider dependencies only in project.
-set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
-
-# The set of languages for which implicit dependencies are needed:
-set(CMAKE_DEPENDS_LANGUAGES
-  )
-
-# The set of dependency files which are needed:
-set(CMAKE_DEPENDS_DEPENDENCY_FILES
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SCS.cpp" "CMakeFiles/SCServo.dir/SCS.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SCS.cpp.o.d"
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SCSCL.cpp" "CMakeFiles/SCServo.dir/SCSCL.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SCSCL.cpp.o.d"
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SCSerial.cpp" "CMakeFiles/SCServo.dir/SCSerial.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SCSerial.cpp.o.d"
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SMSBL.cpp" "CMakeFiles/SCServo.dir/SMSBL.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SMSBL.cpp.o.d"
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SMSCL.cpp" "CMakeFiles/SCServo.dir/SMSCL.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SMSCL.cpp.o.d"
-  "/home/ubuntu/ros2_ws/src/pan_tilt_ros/include/SCServo_Linux/SMS_STS.cpp" "CMakeFiles/SCServo.dir/SMS_STS.cpp.o" "gcc" "CMakeFiles/SCServo.dir/SMS_STS.cpp.o.d"
-  )
-
-# Targets to which this target links which contain Fortran sources.
-set(CMAKE_Fortran_TARGET_LINKED_INFO_FILES
-  )
-
-# Targets to which this target links which contain Fortran sources.
-set(CMAKE_Fortran_TARGET_FORWARD_LINKED_INFO_FILES
-  )
-
-# Fortran module output directory.
-set(CMAKE_Fortran_TARGET_MODULE_DIR "")
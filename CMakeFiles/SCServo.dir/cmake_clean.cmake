@@ -1,21 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/SCServo.dir/SCS.cpp.o"
-  "CMakeFiles/SCServo.dir/SCS.cpp.o.d"
-  "CMakeFiles/SCServo.dir/SCSCL.cpp.o"
-  "CMakeFiles/SCServo.dir/SCSCL.cpp.o.d"
-  "CMakeFiles/SCServo.dir/SCSerial.cpp.o"
-  "CMakeFiles/SCServo.dir/SCSerial.cpp.o.d"
-  "CMakeFiles/SCServo.dir/SMSBL.cpp.o"
-  "CMakeFiles/SCServo.dir/SMSBL.cpp.o.d"
-  "CMakeFiles/SCServo.dir/SMSCL.cpp.o"
-  "CMakeFiles/SCServo.dir/SMSCL.cpp.o.d"
-  "CMakeFiles/SCServo.dir/SMS_STS.cpp.o"
-  "CMakeFiles/SCServo.dir/SMS_STS.cpp.o.d"
-  "libSCServo.a"
-  "libSCServo.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/SCServo.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
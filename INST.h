@@ -1,26 +1,29 @@
-/*
- * INST.h
- * 飞特串行舵机协议指令定义
- * 日期: 2021.12.8
- * 作者: 
- */
-
-#ifndef _INST_H
-#define _INST_H
-
-typedef	char s8;
-typedef	unsigned char u8;	
-typedef	unsigned short u16;	
-typedef	short s16;
-typedef	unsigned long u32;	
-typedef	long s32;
-
-#define INST_PING 0x01
-#define INST_READ 0x02
-#define INST_WRITE 0x03
-#define INST_REG_WRITE 0x04
-#define INST_REG_ACTION 0x05
-#define INST_SYNC_READ 0x82
-#define INST_SYNC_WRITE 0x83
-
+/*
+ * INST.h
+ * 飞特串行舵机协议指令定义
+ * 日期: 2021.12.8
+ * 作者: 
+ */
+
+#ifndef _INST_H
+#define _INST_H
+
+typedef	char s8;
+typedef	unsigned char u8;	
+typedef	unsigned short u16;	
+typedef	short s16;
+typedef	unsigned long u32;	
+typedef	long s32;
+typedef	unsigned long long u64;
+
+#include "SCSConfig.h"
+
+#define INST_PING 0x01
+#define INST_READ 0x02
+#define INST_WRITE 0x03
+#define INST_REG_WRITE 0x04
+#define INST_REG_ACTION 0x05
+#define INST_SYNC_READ 0x82
+#define INST_SYNC_WRITE 0x83
+
 #endif
\ No newline at end of file
@@ -1,394 +1,902 @@
-﻿/*
- * SCS.cpp
- * 飞特串行舵机通信层协议程序
- * 日期: 2022.3.29
- * 作者: 
- */
-#include <stdio.h>
-#include <string.h>
-#include <stddef.h>
-#include "SCS.h"
-
-SCS::SCS()
-{
-	Level = 1;//除广播指令所有指令返回应答
-	Error = 0;
-}
-
-SCS::SCS(u8 End)
-{
-	Level = 1;
-	this->End = End;
-	Error = 0;
-}
-
-SCS::SCS(u8 End, u8 Level)
-{
-	this->Level = Level;
-	this->End = End;
-	Error = 0;
-}
-
-//1个16位数拆分为2个8位数
-//DataL为低位，DataH为高位
-void SCS::Host2SCS(u8 *DataL, u8* DataH, u16 Data)
-{
-	if(End){
-		*DataL = (Data>>8);
-		*DataH = (Data&0xff);
-	}else{
-		*DataH = (Data>>8);
-		*DataL = (Data&0xff);
-	}
-}
-
-//2个8位数组合为1个16位数
-//DataL为低位，DataH为高位
-u16 SCS::SCS2Host(u8 DataL, u8 DataH)
-{
-	u16 Data;
-	if(End){
-		Data = DataL;
-		Data<<=8;
-		Data |= DataH;
-	}else{
-		Data = DataH;
-		Data<<=8;
-		Data |= DataL;
-	}
-	return Data;
-}
-
-void SCS::writeBuf(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen, u8 Fun)
-{
-	u8 msgLen = 2;
-	u8 bBuf[6];
-	u8 CheckSum = 0;
-	bBuf[0] = 0xff;
-	bBuf[1] = 0xff;
-	bBuf[2] = ID;
-	bBuf[4] = Fun;
-	if(nDat){
-		msgLen += nLen + 1;
-		bBuf[3] = msgLen;
-		bBuf[5] = MemAddr;
-		writeSCS(bBuf, 6);
-		
-	}else{
-		bBuf[3] = msgLen;
-		writeSCS(bBuf, 5);
-	}
-	CheckSum = ID + msgLen + Fun + MemAddr;
-	u8 i = 0;
-	if(nDat){
-		for(i=0; i<nLen; i++){
-			CheckSum += nDat[i];
-		}
-		writeSCS(nDat, nLen);
-	}
-	writeSCS(~CheckSum);
-}
-
-//普通写指令
-//舵机ID，MemAddr内存表地址，写入数据，写入长度
-int SCS::genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
-{
-	rFlushSCS();
-	writeBuf(ID, MemAddr, nDat, nLen, INST_WRITE);
-	wFlushSCS();
-	return Ack(ID);
-}
-
-//异步写指令
-//舵机ID，MemAddr内存表地址，写入数据，写入长度
-int SCS::regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
-{
-	rFlushSCS();
-	writeBuf(ID, MemAddr, nDat, nLen, INST_REG_WRITE);
-	wFlushSCS();
-	return Ack(ID);
-}
-
-//异步写执行指令
-//舵机ID
-int SCS::RegWriteAction(u8 ID)
-{
-	rFlushSCS();
-	writeBuf(ID, 0, NULL, 0, INST_REG_ACTION);
-	wFlushSCS();
-	return Ack(ID);
-}
-
-//同步写指令
-//舵机ID[]数组，IDN数组长度，MemAddr内存表地址，写入数据，写入长度
-void SCS::syncWrite(u8 ID[], u8 IDN, u8 MemAddr, u8 *nDat, u8 nLen)
-{
-	rFlushSCS();
-	u8 mesLen = ((nLen+1)*IDN+4);
-	u8 Sum = 0;
-	u8 bBuf[7];
-	bBuf[0] = 0xff;
-	bBuf[1] = 0xff;
-	bBuf[2] = 0xfe;
-	bBuf[3] = mesLen;
-	bBuf[4] = INST_SYNC_WRITE;
-	bBuf[5] = MemAddr;
-	bBuf[6] = nLen;
-	writeSCS(bBuf, 7);
-
-	Sum = 0xfe + mesLen + INST_SYNC_WRITE + MemAddr + nLen;
-	u8 i, j;
-	for(i=0; i<IDN; i++){
-		writeSCS(ID[i]);
-		writeSCS(nDat+i*nLen, nLen);
-		Sum += ID[i];
-		for(j=0; j<nLen; j++){
-			Sum += nDat[i*nLen+j];
-		}
-	}
-	writeSCS(~Sum);
-	wFlushSCS();
-}
-
-int SCS::writeByte(u8 ID, u8 MemAddr, u8 bDat)
-{
-	rFlushSCS();
-	writeBuf(ID, MemAddr, &bDat, 1, INST_WRITE);
-	wFlushSCS();
-	return Ack(ID);
-}
-
-int SCS::writeWord(u8 ID, u8 MemAddr, u16 wDat)
-{
-	u8 bBuf[2];
-	Host2SCS(bBuf+0, bBuf+1, wDat);
-	rFlushSCS();
-	writeBuf(ID, MemAddr, bBuf, 2, INST_WRITE);
-	wFlushSCS();
-	return Ack(ID);
-}
-
-//读指令
-//舵机ID，MemAddr内存表地址，返回数据nData，数据长度nLen
-int SCS::Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
-{
-	rFlushSCS();
-	writeBuf(ID, MemAddr, &nLen, 1, INST_READ);
-	wFlushSCS();
-
-	u8 bBuf[255];
-	u8 i;
-	u8 calSum = 0;
-	int Size = readSCS(bBuf, nLen+6);
-	//printf("nLen+6 = %d, Size = %d\n", nLen+6, Size);
-	if(Size!=(nLen+6)){
-		return 0;
-	}
-	//for(i=0; i<Size; i++){
-		//printf("%x\n", bBuf[i]);
-	//}
-	if(bBuf[0]!=0xff || bBuf[1]!=0xff){
-		return 0;
-	}
-	for(i=2; i<(Size-1); i++){
-		calSum += bBuf[i];
-	}
-	calSum = ~calSum;
-	if(calSum!=bBuf[Size-1]){
-		return 0;
-	}
-	memcpy(nData, bBuf+5, nLen);
-	Error = bBuf[4];
-	return nLen;
-}
-
-//读1字节，超时返回-1
-int SCS::readByte(u8 ID, u8 MemAddr)
-{
-	u8 bDat;
-	int Size = Read(ID, MemAddr, &bDat, 1);
-	if(Size!=1){
-		return -1;
-	}else{
-		return bDat;
-	}
-}
-
-//读2字节，超时返回-1
-int SCS::readWord(u8 ID, u8 MemAddr)
-{	
-	u8 nDat[2];
-	int Size;
-	u16 wDat;
-	Size = Read(ID, MemAddr, nDat, 2);
-	if(Size!=2)
-		return -1;
-	wDat = SCS2Host(nDat[0], nDat[1]);
-	return wDat;
-}
-
-//Ping指令，返回舵机ID，超时返回-1
-int	SCS::Ping(u8 ID)
-{
-	rFlushSCS();
-	writeBuf(ID, 0, NULL, 0, INST_PING);
-	wFlushSCS();
-	Error = 0;
-
-	u8 bBuf[6];
-	u8 i;
-	u8 calSum = 0;
-	int Size = readSCS(bBuf, 6);
-	if(Size!=6){
-		return -1;
-	}
-	if(bBuf[0]!=0xff || bBuf[1]!=0xff){
-		return -1;
-	}
-	if(bBuf[2]!=ID && ID!=0xfe){
-		return -1;
-	}
-	if(bBuf[3]!=2){
-		return -1;
-	}
-	for(i=2; i<(Size-1); i++){
-		calSum += bBuf[i];
-	}
-	calSum = ~calSum;
-	if(calSum!=bBuf[Size-1]){
-		return -1;
-	}
-	Error = bBuf[2];
-	return Error;
-}
-
-int	SCS::Ack(u8 ID)
-{
-	Error = 0;
-	if(ID!=0xfe && Level){
-		u8 bBuf[6];
-		u8 i;
-		u8 calSum = 0;
-		int Size = readSCS(bBuf, 6);
-		if(Size!=6){
-			return 0;
-		}
-		if(bBuf[0]!=0xff || bBuf[1]!=0xff){
-			return 0;
-		}
-		if(bBuf[2]!=ID){
-			return 0;
-		}
-		if(bBuf[3]!=2){
-			return 0;
-		}
-		for(i=2; i<(Size-1); i++){
-			calSum += bBuf[i];
-		}
-		calSum = ~calSum;
-		if(calSum!=bBuf[Size-1]){
-			return 0;
-		}
-		Error = bBuf[4];
-	}
-	return 1;
-}
-
-int	SCS::syncReadPacketTx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
-{
-	rFlushSCS();
-	syncReadRxPacketLen = nLen;
-	u8 checkSum = (4+0xfe)+IDN+MemAddr+nLen+INST_SYNC_READ;
-	u8 i;
-	writeSCS(0xff);
-	writeSCS(0xff);
-	writeSCS(0xfe);
-	writeSCS(IDN+4);
-	writeSCS(INST_SYNC_READ);
-	writeSCS(MemAddr);
-	writeSCS(nLen);
-	for(i=0; i<IDN; i++){
-		writeSCS(ID[i]);
-		checkSum += ID[i];
-	}
-	checkSum = ~checkSum;
-	writeSCS(checkSum);
-	wFlushSCS();
-	
-	syncReadRxBuffLen = readSCS(syncReadRxBuff, syncReadRxBuffMax);
-	return syncReadRxBuffLen;
-}
-
-void SCS::syncReadBegin(u8 IDN, u8 rxLen)
-{
-	syncReadRxBuffMax = IDN*(rxLen+6);
-	syncReadRxBuff = new u8[syncReadRxBuffMax];
-}
-
-void SCS::syncReadEnd()
-{
-	if(syncReadRxBuff){
-		delete syncReadRxBuff;
-		syncReadRxBuff = NULL;
-	}
-}
-
-int SCS::syncReadPacketRx(u8 ID, u8 *nDat)
-{
-	u16 syncReadRxBuffIndex = 0;
-	syncReadRxPacket = nDat;
-	syncReadRxPacketIndex = 0;
-	while((syncReadRxBuffIndex+6+syncReadRxPacketLen)<=syncReadRxBuffLen){
-		u8 bBuf[] = {0, 0, 0};
-		u8 calSum = 0;
-		while(syncReadRxBuffIndex<syncReadRxBuffLen){
-			bBuf[0] = bBuf[1];
-			bBuf[1] = bBuf[2];
-			bBuf[2] = syncReadRxBuff[syncReadRxBuffIndex++];
-			if(bBuf[0]==0xff && bBuf[1]==0xff && bBuf[2]!=0xff){
-				break;
-			}
-		}
-		if(bBuf[2]!=ID){
-			continue;
-		}
-		if(syncReadRxBuff[syncReadRxBuffIndex++]!=(syncReadRxPacketLen+2)){
-			continue;
-		}
-		Error = syncReadRxBuff[syncReadRxBuffIndex++];
-		calSum = ID+(syncReadRxPacketLen+2)+Error;
-		for(u8 i=0; i<syncReadRxPacketLen; i++){
-			syncReadRxPacket[i] = syncReadRxBuff[syncReadRxBuffIndex++];
-			calSum += syncReadRxPacket[i];
-		}
-		calSum = ~calSum;
-		if(calSum!=syncReadRxBuff[syncReadRxBuffIndex++]){
-			return 0;
-		}
-		return syncReadRxPacketLen;
-	}
-	return 0;
-}
-
-int SCS::syncReadRxPacketToByte()
-{
-	if(syncReadRxPacketIndex>=syncReadRxPacketLen){
-		return -1;
-	}
-	return syncReadRxPacket[syncReadRxPacketIndex++];
-}
-
-int SCS::syncReadRxPacketToWrod(u8 negBit)
-{
-	if((syncReadRxPacketIndex+1)>=syncReadRxPacketLen){
-		return -1;
-	}
-	int Word = SCS2Host(syncReadRxPacket[syncReadRxPacketIndex], syncReadRxPacket[syncReadRxPacketIndex+1]);
-	syncReadRxPacketIndex += 2;
-	if(negBit){
-		if(Word&(1<<negBit)){
-			Word = -(Word & ~(1<<negBit));
-		}
-	}
-	return Word;
+﻿/*
+ * SCS.cpp
+ * 飞特串行舵机通信层协议程序
+ * 日期: 2022.3.29
+ * 作者: 
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "SCS.h"
+#include "SCSBatch.h"
+#include "SCSStats.h"
+#include "SCSTrace.h"
+#include "SCSChecksum.h"
+#include "SCSStatus.h"
+#include "SCSCoalesce.h"
+
+#define SCS_TRACE_BEGIN(Inst) if(Trace) Trace->tx(TraceTag, Inst, txLen)
+#define SCS_TRACE_END(ID, Inst, Result, rxLen) if(Trace) Trace->rx(TraceTag, ID, Inst, Result, rxLen)
+#ifdef SCS_NO_STATS
+#define SCS_STAT_BEGIN(Inst) do{ SCS_TRACE_BEGIN(Inst); }while(0)
+#define SCS_STAT_END(ID, Inst, Result, rxLen) do{ SCS_TRACE_END(ID, Inst, Result, rxLen); }while(0)
+#else
+#define SCS_STAT_BEGIN(Inst) do{ SCS_TRACE_BEGIN(Inst); if(Stats) Stats->begin(Inst, txLen); }while(0)
+#define SCS_STAT_END(ID, Inst, Result, rxLen) do{ SCS_TRACE_END(ID, Inst, Result, rxLen); if(Stats) Stats->end(ID, Inst, Result, rxLen, rxFirstUs); }while(0)
+#endif
+
+SCS::SCS()
+{
+	Level = 1;//除广播指令所有指令返回应答
+	Error = 0;
+	rxPacketNum = 1;
+	syncReadRxBuff = NULL;
+	syncReadRxBuffLen = 0;
+	syncReadRxBuffMax = 0;
+	syncReadRxBuffSize = 0;
+	rxFirstUs = 0;
+	RxStamp = 0;
+	syncReadRxUs = 0;
+	txInst = 0;
+	txLen = 0;
+	rxStatusLen = 0;
+	LazyFlush = 0;
+	rxDirty = 1;
+	Stats = NULL;
+	Trace = NULL;
+	TraceTag = 0;
+	Coalesce = NULL;
+	Locking = 0;
+	MutexInit = 0;
+}
+
+SCS::SCS(u8 End)
+{
+	Level = 1;
+	this->End = End;
+	Error = 0;
+	rxPacketNum = 1;
+	syncReadRxBuff = NULL;
+	syncReadRxBuffLen = 0;
+	syncReadRxBuffMax = 0;
+	syncReadRxBuffSize = 0;
+	rxFirstUs = 0;
+	RxStamp = 0;
+	syncReadRxUs = 0;
+	txInst = 0;
+	txLen = 0;
+	rxStatusLen = 0;
+	LazyFlush = 0;
+	rxDirty = 1;
+	Stats = NULL;
+	Trace = NULL;
+	TraceTag = 0;
+	Coalesce = NULL;
+	Locking = 0;
+	MutexInit = 0;
+}
+
+SCS::SCS(u8 End, u8 Level)
+{
+	this->Level = Level;
+	this->End = End;
+	Error = 0;
+	rxPacketNum = 1;
+	syncReadRxBuff = NULL;
+	syncReadRxBuffLen = 0;
+	syncReadRxBuffMax = 0;
+	syncReadRxBuffSize = 0;
+	rxFirstUs = 0;
+	RxStamp = 0;
+	syncReadRxUs = 0;
+	txInst = 0;
+	txLen = 0;
+	rxStatusLen = 0;
+	LazyFlush = 0;
+	rxDirty = 1;
+	Stats = NULL;
+	Trace = NULL;
+	TraceTag = 0;
+	Coalesce = NULL;
+	Locking = 0;
+	MutexInit = 0;
+}
+
+SCS::~SCS()
+{
+	syncReadEnd();
+	disableStats();
+	if(MutexInit){
+		pthread_mutex_destroy(&Mutex);
+	}
+}
+
+int SCS::enableStats()
+{
+#ifdef SCS_NO_STATS
+	return 0;
+#else
+	if(!Stats){
+#ifdef SCS_STATIC_ALLOC
+		StatsPool.clear();
+		Stats = &StatsPool;
+#else
+		Stats = new SCSStats();
+#endif
+	}
+	return 1;
+#endif
+}
+
+void SCS::disableStats()
+{
+	if(Stats){
+#ifndef SCS_STATIC_ALLOC
+		delete Stats;
+#endif
+		Stats = NULL;
+	}
+}
+
+int SCS::snapshotStats(SCSStatInst Inst[])
+{
+	if(!Stats){
+		return 0;
+	}
+	memcpy(Inst, Stats->Inst, sizeof(Stats->Inst));
+	return SCS_STAT_INST;
+}
+
+int SCS::snapshotStats(u8 ID, SCSStatID *Stat)
+{
+	if(!Stats || ID>=SCS_STAT_ID){
+		return 0;
+	}
+	*Stat = Stats->ID[ID];
+	return 1;
+}
+
+//1个16位数拆分为2个8位数
+//DataL为低位，DataH为高位
+void SCS::Host2SCS(u8 *DataL, u8* DataH, u16 Data)
+{
+	if(End){
+		*DataL = (Data>>8);
+		*DataH = (Data&0xff);
+	}else{
+		*DataH = (Data>>8);
+		*DataL = (Data&0xff);
+	}
+}
+
+//2个8位数组合为1个16位数
+//DataL为低位，DataH为高位
+u16 SCS::SCS2Host(u8 DataL, u8 DataH)
+{
+	u16 Data;
+	if(End){
+		Data = DataL;
+		Data<<=8;
+		Data |= DataH;
+	}else{
+		Data = DataH;
+		Data<<=8;
+		Data |= DataL;
+	}
+	return Data;
+}
+
+void SCS::writeBuf(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen, u8 Fun)
+{
+	u8 msgLen = 2;
+	u8 bBuf[6];
+	u8 CheckSum = 0;
+	struct iovec iov[3];
+	int iovcnt = 0;
+	bBuf[0] = 0xff;
+	bBuf[1] = 0xff;
+	bBuf[2] = ID;
+	bBuf[4] = Fun;
+	txInst = Fun;
+	txLen = nDat ? nLen+7 : 6;
+	if(nDat){
+		msgLen += nLen + 1;
+		bBuf[3] = msgLen;
+		bBuf[5] = MemAddr;
+		iov[0].iov_base = bBuf;
+		iov[0].iov_len = 6;
+		iov[1].iov_base = nDat;
+		iov[1].iov_len = nLen;
+		iovcnt = 2;
+	}else{
+		bBuf[3] = msgLen;
+		iov[0].iov_base = bBuf;
+		iov[0].iov_len = 5;
+		iovcnt = 1;
+	}
+	CheckSum = ID + msgLen + Fun + MemAddr;
+	if(nDat){
+		CheckSum += SCSChecksum::sum(nDat, nLen);
+	}
+	CheckSum = ~CheckSum;
+	iov[iovcnt].iov_base = &CheckSum;
+	iov[iovcnt].iov_len = 1;
+	writeSCSv(iov, iovcnt+1);
+}
+
+void SCS::setCoalesce(SCSCoalesce *coalesce)
+{
+	if(Coalesce){
+		Coalesce->flush();
+	}
+	Coalesce = coalesce;
+}
+
+//Recursive, so the series functions built on genWrite/Read and a caller
+//holding lock() across a SyncRead session nest freely. Off by default,
+//a single-threaded program pays one branch per transaction.
+int SCS::setLocking(u8 Enable)
+{
+	if(Enable && !MutexInit){
+		pthread_mutexattr_t Attr;
+		pthread_mutexattr_init(&Attr);
+		pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
+		int rc = pthread_mutex_init(&Mutex, &Attr);
+		pthread_mutexattr_destroy(&Attr);
+		if(rc){
+			return 0;
+		}
+		MutexInit = 1;
+	}
+	Locking = Enable ? 1 : 0;
+	return 1;
+}
+
+//one tcflush per transaction, or with LazyFlush only after a transaction
+//that may have left bytes behind (timeout, skipped garbage, short SyncRead)
+void SCS::rxFlush()
+{
+	if(Coalesce){
+		Coalesce->flush();//buffered writes go out ahead of the next request
+	}
+	if(!LazyFlush || rxDirty){
+		rFlushSCS();
+		rxDirty = 0;
+	}
+}
+
+int SCS::writeSCSv(const struct iovec *iov, int iovcnt)
+{
+	int nLen = 0;
+	for(int i=0; i<iovcnt; i++){
+		writeSCS((unsigned char*)iov[i].iov_base, iov[i].iov_len);
+		nLen += iov[i].iov_len;
+	}
+	return nLen;
+}
+
+//普通写指令
+//舵机ID，MemAddr内存表地址，写入数据，写入长度
+int SCS::genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
+{
+	SCSLock Guard(this);
+	if(Coalesce && Coalesce->add(ID, MemAddr, nDat, nLen)){
+		return 1;
+	}
+	rxFlush();
+	writeBuf(ID, MemAddr, nDat, nLen, INST_WRITE);
+	wFlushSCS();
+	return Ack(ID);
+}
+
+//异步写指令
+//舵机ID，MemAddr内存表地址，写入数据，写入长度
+int SCS::regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	writeBuf(ID, MemAddr, nDat, nLen, INST_REG_WRITE);
+	wFlushSCS();
+	return Ack(ID);
+}
+
+//异步写执行指令
+//舵机ID
+int SCS::RegWriteAction(u8 ID)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	writeBuf(ID, 0, NULL, 0, INST_REG_ACTION);
+	wFlushSCS();
+	return Ack(ID);
+}
+
+//同步写指令
+//舵机ID[]数组，IDN数组长度，MemAddr内存表地址，写入数据，写入长度
+//IDs beyond the 255-byte packet limit go out in further packets.
+//Header, IDs and checksums are framed in place, the servo data is
+//handed to the transport without copying.
+void SCS::syncWrite(const u8 ID[], u8 IDN, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	u8 maxIDN = SCS_SYNC_WRITE_MAX/(nLen+1);
+	if(!maxIDN){
+		return;
+	}
+	struct iovec iov[0xfe*2+2];
+	u8 bBuf[7];
+	u16 Total = 0;
+	u8 n;
+	for(u8 k=0; k<IDN; k+=n){
+		n = IDN-k;
+		if(n>maxIDN){
+			n = maxIDN;
+		}
+		u8 mesLen = (nLen+1)*n+4;
+		bBuf[0] = 0xff;
+		bBuf[1] = 0xff;
+		bBuf[2] = 0xfe;
+		bBuf[3] = mesLen;
+		bBuf[4] = INST_SYNC_WRITE;
+		bBuf[5] = MemAddr;
+		bBuf[6] = nLen;
+		iov[0].iov_base = bBuf;
+		iov[0].iov_len = 7;
+		u8 Sum = 0xfe + mesLen + INST_SYNC_WRITE + MemAddr + nLen;
+		int iovcnt = 1;
+		for(u8 i=k; i<k+n; i++){
+			const u8 *Dat = nDat+i*nLen;
+			iov[iovcnt].iov_base = (u8*)ID+i;
+			iov[iovcnt++].iov_len = 1;
+			iov[iovcnt].iov_base = (u8*)Dat;
+			iov[iovcnt++].iov_len = nLen;
+			Sum += ID[i]+SCSChecksum::sum(Dat, nLen);
+		}
+		Sum = ~Sum;
+		iov[iovcnt].iov_base = &Sum;
+		iov[iovcnt++].iov_len = 1;
+		writeSCSv(iov, iovcnt);
+		Total += mesLen+4;
+	}
+	wFlushSCS();
+	txInst = INST_SYNC_WRITE;
+	txLen = Total;
+	SCS_STAT_BEGIN(INST_SYNC_WRITE);
+	SCS_STAT_END(0xfe, INST_SYNC_WRITE, SCS_STAT_NOREPLY, 0);
+}
+
+//Pkt is a complete request frame that gets no reply, see SCSSyncWritePacket
+void SCS::writePrepared(const u8 *Pkt, int Len)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	writeSCS((unsigned char*)Pkt, Len);
+	wFlushSCS();
+	txInst = Pkt[4];
+	txLen = Len;
+	SCS_STAT_BEGIN(txInst);
+	SCS_STAT_END(0xfe, txInst, SCS_STAT_NOREPLY, 0);
+}
+
+int SCS::writeByte(u8 ID, u8 MemAddr, u8 bDat)
+{
+	SCSLock Guard(this);
+	if(Coalesce && Coalesce->add(ID, MemAddr, &bDat, 1)){
+		return 1;
+	}
+	rxFlush();
+	writeBuf(ID, MemAddr, &bDat, 1, INST_WRITE);
+	wFlushSCS();
+	return Ack(ID);
+}
+
+int SCS::writeWord(u8 ID, u8 MemAddr, u16 wDat)
+{
+	SCSLock Guard(this);
+	u8 bBuf[2];
+	Host2SCS(bBuf+0, bBuf+1, wDat);
+	if(Coalesce && Coalesce->add(ID, MemAddr, bBuf, 2)){
+		return 1;
+	}
+	rxFlush();
+	writeBuf(ID, MemAddr, bBuf, 2, INST_WRITE);
+	wFlushSCS();
+	return Ack(ID);
+}
+
+//读指令
+//舵机ID，MemAddr内存表地址，返回数据nData，数据长度nLen
+int SCS::Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
+{
+	SCSReply Reply;
+	return Read(ID, MemAddr, nData, nLen, &Reply);
+}
+
+//Error is still updated, callers on other threads use Reply->Error
+int SCS::Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen, SCSReply *Reply)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	writeBuf(ID, MemAddr, &nLen, 1, INST_READ);
+	wFlushSCS();
+	SCS_STAT_BEGIN(INST_READ);
+
+	u8 bBuf[255+6];
+	u8 Result;
+	Reply->Error = 0;
+	Reply->Stamp = 0;
+	if(!readStatus(ID, nLen, bBuf, &Result)){
+		Reply->Result = Result;
+		SCS_STAT_END(ID, INST_READ, Result, rxStatusLen);
+		return 0;
+	}
+	memcpy(nData, bBuf+5, nLen);
+	Error = bBuf[4];
+	Reply->Result = SCS_STAT_OK;
+	Reply->Error = Error;
+	Reply->Stamp = RxStamp;
+	SCS_STAT_END(ID, INST_READ, SCS_STAT_OK, rxStatusLen);
+	return nLen;
+}
+
+//Status packets are located in the input stream instead of being
+//expected at the first byte: leading garbage (echo, noise) is skipped,
+//packets with a bad checksum, another ID (late replies to an earlier
+//request) or another length are dropped, and reading continues for at
+//most SCS_STATUS_READS reads.
+int SCS::readStatus(u8 ID, u8 nLen, u8 *Pkt, u8 *Result)
+{
+	u8 Buf[SCS_STATUS_SCAN];
+	int Len = 0;
+	int Want = nLen+6;
+	int Need = Want;
+	u64 firstUs = 0;
+	*Result = SCS_STAT_TIMEOUT;
+	rxStatusLen = 0;
+	RxStamp = 0;
+	for(int Reads=0; Reads<SCS_STATUS_READS; Reads++){
+		if(Len+Need>(int)sizeof(Buf)){
+			Len = 0;
+		}
+		int n = readSCS(Buf+Len, Need);
+		if(n>0){
+			rxStatusLen += n;
+			if(!firstUs){
+				firstUs = rxFirstUs;
+			}
+		}
+		rxFirstUs = firstUs;
+		Len += n;
+		if(n<Need){
+			rxDirty = 1;
+			return 0;
+		}
+		int Pos = 0;
+		int pktLen;
+		while((pktLen = SCSStatus::find(Buf, Len, &Pos, Result))>0){
+			const u8 *p = Buf+Pos;
+			if(SCSStatus::match(p, ID, nLen)==SCS_STAT_OK){
+				memcpy(Pkt, p, Want);
+				if(firstUs){
+					RxStamp = firstUs+wireUs(rxStatusLen-(Len-Pos));//bytes received ahead of this packet
+				}
+				if(*Result!=SCS_STAT_TIMEOUT || ID==0xfe){
+					rxDirty = 1;//more stray bytes or other broadcast replies may follow
+				}
+				*Result = SCS_STAT_OK;
+				return Want;
+			}
+			Pos += pktLen;
+			*Result = SCS_STAT_WRONGID;
+		}
+		memmove(Buf, Buf+Pos, Len-Pos);
+		Len -= Pos;
+		Need = SCSStatus::need(Buf, Len, Want);
+	}
+	rxDirty = 1;
+	return 0;
+}
+
+//读1字节，超时返回-1
+int SCS::readByte(u8 ID, u8 MemAddr)
+{
+	u8 bDat;
+	int Size = Read(ID, MemAddr, &bDat, 1);
+	if(Size!=1){
+		return -1;
+	}else{
+		return bDat;
+	}
+}
+
+//读2字节，超时返回-1
+int SCS::readWord(u8 ID, u8 MemAddr)
+{	
+	u8 nDat[2];
+	int Size;
+	u16 wDat;
+	Size = Read(ID, MemAddr, nDat, 2);
+	if(Size!=2)
+		return -1;
+	wDat = SCS2Host(nDat[0], nDat[1]);
+	return wDat;
+}
+
+//Ping指令，返回舵机ID，超时返回-1
+int	SCS::Ping(u8 ID)
+{
+	SCSReply Reply;
+	return Ping(ID, &Reply);
+}
+
+int	SCS::Ping(u8 ID, SCSReply *Reply)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	writeBuf(ID, 0, NULL, 0, INST_PING);
+	wFlushSCS();
+	Error = 0;
+	SCS_STAT_BEGIN(INST_PING);
+
+	u8 bBuf[6];
+	u8 Result;
+	Reply->Error = 0;
+	Reply->Stamp = 0;
+	if(!readStatus(ID, 0, bBuf, &Result)){
+		Reply->Result = Result;
+		SCS_STAT_END(ID, INST_PING, Result, rxStatusLen);
+		return -1;
+	}
+	Error = bBuf[4];
+	Reply->Result = SCS_STAT_OK;
+	Reply->Error = Error;
+	Reply->Stamp = RxStamp;
+	SCS_STAT_END(bBuf[2], INST_PING, SCS_STAT_OK, rxStatusLen);
+	return bBuf[2];
+}
+
+int	SCS::Ack(u8 ID)
+{
+	Error = 0;
+	SCS_STAT_BEGIN(txInst);
+	if(ID!=0xfe && Level){
+		u8 bBuf[6];
+		u8 Result;
+		if(!readStatus(ID, 0, bBuf, &Result)){
+			SCS_STAT_END(ID, txInst, Result, rxStatusLen);
+			return 0;
+		}
+		Error = bBuf[4];
+		SCS_STAT_END(ID, txInst, SCS_STAT_OK, rxStatusLen);
+	}else{
+		SCS_STAT_END(ID, txInst, SCS_STAT_NOREPLY, 0);
+	}
+	return 1;
+}
+
+int SCS::syncReadFrame(u8 *Pkt, const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	u8 checkSum = (4+0xfe)+IDN+MemAddr+nLen+INST_SYNC_READ;
+	u8 i;
+	Pkt[0] = 0xff;
+	Pkt[1] = 0xff;
+	Pkt[2] = 0xfe;
+	Pkt[3] = IDN+4;
+	Pkt[4] = INST_SYNC_READ;
+	Pkt[5] = MemAddr;
+	Pkt[6] = nLen;
+	for(i=0; i<IDN; i++){
+		Pkt[7+i] = ID[i];
+		checkSum += ID[i];
+	}
+	Pkt[7+IDN] = ~checkSum;
+	return IDN+8;
+}
+
+int	SCS::syncReadPacketTx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	u8 Pkt[254+8];
+	int Len = syncReadFrame(Pkt, ID, IDN, MemAddr, nLen);
+	return syncReadPrepared(Pkt, Len, IDN, nLen);
+}
+
+//Pkt is a complete SYNC_READ frame, see SCSSyncReadPacket
+int SCS::syncReadPrepared(const u8 *Pkt, int Len, u8 IDN, u8 nLen)
+{
+	return syncReadSend(NULL, 0, Pkt, Len, IDN, nLen);
+}
+
+int SCS::syncReadSend(const u8 *Pre, int PreLen, const u8 *Pkt, int Len, u8 IDN, u8 nLen)
+{
+	SCSLock Guard(this);
+	rxFlush();
+	syncReadRxPacketLen = nLen;
+	if(Pre && PreLen){
+		struct iovec iov[2];
+		iov[0].iov_base = (void*)Pre;
+		iov[0].iov_len = PreLen;
+		iov[1].iov_base = (void*)Pkt;
+		iov[1].iov_len = Len;
+		writeSCSv(iov, 2);
+	}else{
+		writeSCS((unsigned char*)Pkt, Len);
+	}
+	wFlushSCS();
+	txInst = INST_SYNC_READ;
+	txLen = PreLen+Len;
+	SCS_STAT_BEGIN(INST_SYNC_READ);
+#ifndef SCS_NO_STATS
+	if(Stats){
+		Stats->syncBegin(Pkt+7, IDN);
+	}
+#endif
+	
+	rxPacketNum = IDN;
+	syncReadRxBuffLen = readSCS(syncReadRxBuff, syncReadRxBuffMax);
+	syncReadRxUs = rxFirstUs;
+	if(syncReadRxBuffLen<syncReadRxBuffMax){
+		rxDirty = 1;
+	}
+	rxPacketNum = 1;
+	SCS_STAT_END(0xfe, INST_SYNC_READ, syncReadRxBuffLen<syncReadRxBuffMax ? SCS_STAT_TIMEOUT : SCS_STAT_OK, syncReadRxBuffLen);
+	return syncReadRxBuffLen;
+}
+
+//the owned buffer only grows, repeated Begin/End cycles reuse it
+void SCS::syncReadBegin(u8 IDN, u8 rxLen)
+{
+	SCSLock Guard(this);
+	syncReadRxBuffMax = IDN*(rxLen+6);
+	if(syncReadRxBuffSize>=syncReadRxBuffMax){
+		return;
+	}
+	syncReadEnd();
+#ifdef SCS_STATIC_ALLOC
+	if(syncReadRxBuffMax>SCS_SYNC_READ_POOL){
+		syncReadRxBuffMax = 0;//no buffer, every reply of this SyncRead is invalid
+		return;
+	}
+	syncReadRxBuff = syncReadPool;
+#else
+	syncReadRxBuff = new u8[syncReadRxBuffMax];
+#endif
+	syncReadRxBuffSize = syncReadRxBuffMax;
+}
+
+void SCS::syncReadBegin(u8 IDN, u8 rxLen, u8 *rxBuff)
+{
+	SCSLock Guard(this);
+	if(syncReadRxBuff!=rxBuff){
+		syncReadEnd();
+	}
+	syncReadRxBuff = rxBuff;
+	syncReadRxBuffMax = IDN*(rxLen+6);
+}
+
+//frees an owned buffer, caller storage is only released
+void SCS::syncReadEnd()
+{
+	SCSLock Guard(this);
+#ifndef SCS_STATIC_ALLOC
+	if(syncReadRxBuff && syncReadRxBuffSize){
+		delete[] syncReadRxBuff;
+	}
+#endif
+	syncReadRxBuff = NULL;
+	syncReadRxBuffSize = 0;
+	syncReadRxBuffLen = 0;
+}
+
+//Begin, send and decode under one lock hold. The session state of the
+//bus is put back afterwards, so this can run between the calls of a
+//session of another thread. rxTab[ID].Dat points into rxBuff.
+int SCS::syncRead(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, u8 *rxBuff, SyncReadRx rxTab[], u8 tabLen)
+{
+	u8 Pkt[254+8];
+	int Len = syncReadFrame(Pkt, ID, IDN, MemAddr, nLen);
+	return syncReadPrepared(Pkt, Len, IDN, nLen, rxBuff, rxTab, tabLen);
+}
+
+//the session of syncReadBegin() is left as it was
+int SCS::syncReadPrepared(const u8 *Pkt, int Len, u8 IDN, u8 nLen, u8 *rxBuff, SyncReadRx rxTab[], u8 tabLen, const u8 *Pre, int PreLen)
+{
+	SCSLock Guard(this);
+	u8 *Buff = syncReadRxBuff;
+	u16 BuffLen = syncReadRxBuffLen;
+	u16 BuffMax = syncReadRxBuffMax;
+	u16 BuffSize = syncReadRxBuffSize;
+	u8 PacketLen = syncReadRxPacketLen;
+	syncReadRxBuff = rxBuff;
+	syncReadRxBuffMax = IDN*(nLen+6);
+	syncReadRxBuffSize = 0;
+	syncReadSend(Pre, PreLen, Pkt, Len, IDN, nLen);
+	int rxNum = syncReadPacketRxAll(rxTab, tabLen);
+	syncReadRxBuff = Buff;
+	syncReadRxBuffLen = BuffLen;
+	syncReadRxBuffMax = BuffMax;
+	syncReadRxBuffSize = BuffSize;
+	syncReadRxPacketLen = PacketLen;
+	return rxNum;
+}
+
+int SCS::syncReadPacketRx(u8 ID, u8 *nDat)
+{
+	SCSLock Guard(this);
+	int Pos = 0;
+	int pktLen;
+	u8 Result;
+	syncReadRxPacket = nDat;
+	syncReadRxPacketIndex = 0;
+	while((pktLen = SCSStatus::find(syncReadRxBuff, syncReadRxBuffLen, &Pos, &Result))>0){
+		const u8 *p = syncReadRxBuff+Pos;
+		if(SCSStatus::match(p, ID, syncReadRxPacketLen)==SCS_STAT_OK){
+			Error = p[4];
+			memcpy(syncReadRxPacket, p+5, syncReadRxPacketLen);
+			return syncReadRxPacketLen;
+		}
+		Pos += pktLen;
+	}
+	return 0;
+}
+
+//Single-pass SyncRead decode
+//rxTab is indexed by ID with tabLen entries, packets from ID>=tabLen are skipped
+//A bad checksum does not abort decoding, the scan resyncs on the next byte
+int SCS::syncReadPacketRxAll(SyncReadRx rxTab[], u8 tabLen)
+{
+	SCSLock Guard(this);
+	u16 i;
+	int rxNum = 0;
+	u8 pktLen = syncReadRxPacketLen+2;
+	for(i=0; i<tabLen; i++){
+		rxTab[i].Valid = 0;
+	}
+	u16 syncReadRxBuffIndex = 0;
+	while((syncReadRxBuffIndex+6+syncReadRxPacketLen)<=syncReadRxBuffLen){
+		//replies are normally back to back: check the whole run at once
+		int Run = SCSChecksum::validate(syncReadRxBuff+syncReadRxBuffIndex, syncReadRxBuffLen-syncReadRxBuffIndex, pktLen+4);
+		if(!Run){
+			syncReadRxBuffIndex++;
+			continue;
+		}
+		for(int k=0; k<Run; k++){
+			u8 *bBuf = syncReadRxBuff+syncReadRxBuffIndex;
+			if(bBuf[2]<tabLen){
+				if(!rxTab[bBuf[2]].Valid){
+					rxNum++;
+				}
+				rxTab[bBuf[2]].Valid = 1;
+				rxTab[bBuf[2]].Error = bBuf[4];
+				rxTab[bBuf[2]].Dat = bBuf+5;
+				rxTab[bBuf[2]].Stamp = syncReadRxUs ? syncReadRxUs+wireUs(syncReadRxBuffIndex) : 0;
+			}
+			syncReadRxBuffIndex += pktLen+4;
+		}
+	}
+	if(Trace){
+		Trace->add(SCS_TRACE_SYNC, TraceTag, 0xfe, INST_SYNC_READ, 0, rxNum, syncReadRxBuffMax/(syncReadRxPacketLen+6));
+	}
+#ifndef SCS_NO_STATS
+	if(Stats){
+		for(i=0; i<Stats->SyncIDN; i++){
+			u8 ID = Stats->SyncID[i];
+			Stats->syncEnd(ID, (ID<tabLen && rxTab[ID].Valid) ? SCS_STAT_OK : SCS_STAT_TIMEOUT);
+		}
+		Stats->SyncIDN = 0;
+	}
+#endif
+	return rxNum;
+}
+
+int SCS::syncReadRxPacketSelect(SyncReadRx *rx)
+{
+	if(!rx->Valid){
+		return 0;
+	}
+	syncReadRxPacket = rx->Dat;
+	syncReadRxPacketIndex = 0;
+	Error = rx->Error;
+	return syncReadRxPacketLen;
+}
+
+//Requests are framed back-to-back and flushed once, the status packets
+//are read in one pass and matched in order to the pending request by ID
+int SCS::batchExec(SCSBatch *batch)
+{
+	SCSLock Guard(this);
+	u8 i;
+	int Done = 0;
+	u8 rxNum = 0;
+	rxFlush();
+	for(i=0; i<batch->ReqNum; i++){
+		SCSBatchReq *req = batch->Req+i;
+		req->Valid = 0;
+		req->Error = 0;
+		req->Stamp = 0;
+		if(req->Fun==INST_READ){
+			writeBuf(req->ID, req->MemAddr, &req->nLen, 1, INST_READ);
+			rxNum++;
+		}else{
+			writeBuf(req->ID, req->MemAddr, req->nDat, req->nLen, req->Fun);
+			if(req->ID!=0xfe && Level){
+				rxNum++;
+			}else{
+				req->Valid = 1;
+				Done++;
+			}
+		}
+	}
+	wFlushSCS();
+	if(!rxNum){
+		return Done;
+	}
+
+	u16 rxLen = 0;
+	for(i=0; i<batch->ReqNum; i++){
+		if(!batch->Req[i].Valid){
+			rxLen += batch->Req[i].Fun==INST_READ ? batch->Req[i].nLen+6 : 6;
+		}
+	}
+	rxPacketNum = rxNum;
+	u16 rxWant = rxLen;
+	rxLen = readSCS(batch->RxBuf, rxLen);
+	u64 rxUs = rxFirstUs;
+	rxPacketNum = 1;
+	if(rxLen<rxWant){
+		rxDirty = 1;
+	}
+
+	int Index = 0;
+	u8 Next = 0;//first request still waiting for a reply
+	int pktLen;
+	u8 Result;
+	while((pktLen = SCSStatus::find(batch->RxBuf, rxLen, &Index, &Result))>0){
+		u8 *bBuf = batch->RxBuf+Index;
+		for(i=Next; i<batch->ReqNum; i++){
+			SCSBatchReq *req = batch->Req+i;
+			if(req->Valid || req->ID!=bBuf[2]){
+				continue;
+			}
+			if(SCSStatus::match(bBuf, req->ID, req->Fun==INST_READ ? req->nLen : 0)!=SCS_STAT_OK){
+				continue;
+			}
+			if(req->Fun==INST_READ){
+				memcpy(req->nDat, bBuf+5, req->nLen);
+			}
+			req->Error = bBuf[4];
+			req->Valid = 1;
+			req->Stamp = rxUs ? rxUs+wireUs(Index) : 0;
+			Done++;
+			break;
+		}
+		while(Next<batch->ReqNum && batch->Req[Next].Valid){
+			Next++;
+		}
+		Index += pktLen;
+	}
+	return Done;
+}
+
+int SCS::syncReadRxPacketToByte()
+{
+	if(syncReadRxPacketIndex>=syncReadRxPacketLen){
+		return -1;
+	}
+	return syncReadRxPacket[syncReadRxPacketIndex++];
+}
+
+int SCS::syncReadRxPacketToWrod(u8 negBit)
+{
+	if((syncReadRxPacketIndex+1)>=syncReadRxPacketLen){
+		return -1;
+	}
+	int Word = SCS2Host(syncReadRxPacket[syncReadRxPacketIndex], syncReadRxPacket[syncReadRxPacketIndex+1]);
+	syncReadRxPacketIndex += 2;
+	if(negBit){
+		if(Word&(1<<negBit)){
+			Word = -(Word & ~(1<<negBit));
+		}
+	}
+	return Word;
 }
\ No newline at end of file
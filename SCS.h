@@ -1,56 +1,153 @@
-﻿/*
- * SCS.h
- * 飞特串行舵机通信层协议程序
- * 日期: 2022.3.29
- * 作者: 
- */
-
-#ifndef _SCS_H
-#define _SCS_H
-
-#include "INST.h"
-
-class SCS{
-public:
-	SCS();
-	SCS(u8 End);
-	SCS(u8 End, u8 Level);
-	int genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//普通写指令
-	int regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//异步写指令
-	int RegWriteAction(u8 ID = 0xfe);//异步写执行指令
-	void syncWrite(u8 ID[], u8 IDN, u8 MemAddr, u8 *nDat, u8 nLen);//同步写指令
-	int writeByte(u8 ID, u8 MemAddr, u8 bDat);//写1个字节
-	int writeWord(u8 ID, u8 MemAddr, u16 wDat);//写2个字节
-	int Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen);//读指令
-	int readByte(u8 ID, u8 MemAddr);//读1个字节
-	int readWord(u8 ID, u8 MemAddr);//读2个字节
-	int Ping(u8 ID);//Ping指令
-	int syncReadPacketTx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//同步读指令包发送
-	int syncReadPacketRx(u8 ID, u8 *nDat);//同步读返回包解码，成功返回内存字节数，失败返回0
-	int syncReadRxPacketToByte();//解码一个字节
-	int syncReadRxPacketToWrod(u8 negBit=0);//解码两个字节，negBit为方向为，negBit=0表示无方向
-	void syncReadBegin(u8 IDN, u8 rxLen);//同步读开始
-	void syncReadEnd();//同步读结束
-public:
-	u8	Level;//舵机返回等级
-	u8	End;//处理器大小端结构
-	u8	Error;//舵机状态
-	u8 syncReadRxPacketIndex;
-	u8 syncReadRxPacketLen;
-	u8 *syncReadRxPacket;
-	u8 *syncReadRxBuff;
-	u16 syncReadRxBuffLen;
-	u16 syncReadRxBuffMax;
-protected:
-	virtual int writeSCS(unsigned char *nDat, int nLen) = 0;
-	virtual int readSCS(unsigned char *nDat, int nLen) = 0;
-	virtual int writeSCS(unsigned char bDat) = 0;
-	virtual void rFlushSCS() = 0;
-	virtual void wFlushSCS() = 0;
-protected:
-	void writeBuf(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen, u8 Fun);
-	void Host2SCS(u8 *DataL, u8* DataH, u16 Data);//1个16位数拆分为2个8位数
-	u16	SCS2Host(u8 DataL, u8 DataH);//2个8位数组合为1个16位数
-	int	Ack(u8 ID);//返回应答
-};
+﻿/*
+ * SCS.h
+ * 飞特串行舵机通信层协议程序
+ * 日期: 2022.3.29
+ * 作者: 
+ */
+
+#ifndef _SCS_H
+#define _SCS_H
+
+#include <sys/uio.h>
+#include <pthread.h>
+#include "INST.h"
+#if defined(SCS_STATIC_ALLOC) && !defined(SCS_NO_STATS)
+#include "SCSStats.h"
+#endif
+
+#define SCS_STATUS_SCAN 520//status packet scan window, two maximum packets
+#define SCS_STATUS_READS 4//reads one status packet search may take
+#define SCS_SYNC_WRITE_MAX 251//servo data bytes of one sync write packet, (nLen+1)*IDN at length byte 255
+#define SCS_SYNC_WRITE_IDS (SCS_MAX_ID+1)//servos one series sync write takes, all IDs and the broadcast ID
+#define SCS_SYNC_WRITE_BUF (SCS_SYNC_WRITE_IDS*7)//series sync write payload, up to 7 bytes for each ID
+#define SCS_SYNC_READ_POOL (SCS_MAX_ID*(SCS_MAX_PAYLOAD+6))//owned SyncRead buffer of the fixed allocation build
+
+class SCSBatch;
+class SCSStats;
+class SCSTrace;
+class SCSCoalesce;
+struct SCSStatInst;
+struct SCSStatID;
+
+//Single-pass SyncRead result entry, indexed by ID
+struct SyncReadRx{
+	u8 Valid;//1: status packet received with a good checksum
+	u8 Error;//servo status byte
+	u8 *Dat;//payload, points into syncReadRxBuff until the next syncReadPacketTx
+	u64 Stamp;//estimated arrival of the first byte of the packet, monotonic us, 0 if unknown
+};
+
+//Outcome of one transaction, filled per call instead of through the members
+struct SCSReply{
+	u8 Result;//SCS_STAT_* (SCSStats.h)
+	u8 Error;//servo status byte
+	u64 Stamp;//arrival of the status packet, monotonic us, 0 if unknown
+};
+
+class SCS{
+public:
+	SCS();
+	SCS(u8 End);
+	SCS(u8 End, u8 Level);
+	virtual ~SCS();
+	int genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//普通写指令
+	int regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//异步写指令
+	int RegWriteAction(u8 ID = 0xfe);//异步写执行指令
+	void syncWrite(const u8 ID[], u8 IDN, u8 MemAddr, const u8 *nDat, u8 nLen);//同步写指令
+	int writeByte(u8 ID, u8 MemAddr, u8 bDat);//写1个字节
+	int writeWord(u8 ID, u8 MemAddr, u16 wDat);//写2个字节
+	int Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen);//读指令
+	int Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen, SCSReply *Reply);//Read reporting into Reply, reentrant
+	int readByte(u8 ID, u8 MemAddr);//读1个字节
+	int readWord(u8 ID, u8 MemAddr);//读2个字节
+	int Ping(u8 ID);//Ping指令
+	int Ping(u8 ID, SCSReply *Reply);//Ping reporting into Reply, reentrant
+	int syncReadPacketTx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//同步读指令包发送
+	int syncReadPacketRx(u8 ID, u8 *nDat);//同步读返回包解码，成功返回内存字节数，失败返回0
+	int syncReadPacketRxAll(SyncReadRx rxTab[], u8 tabLen);//single-pass decode of all return packets into rxTab[ID], returns number of valid packets
+	int syncReadRxPacketSelect(SyncReadRx *rx);//select a decoded entry for syncReadRxPacketToByte/Wrod, returns payload length or 0
+	int syncReadRxPacketToByte();//解码一个字节
+	int syncReadRxPacketToWrod(u8 negBit=0);//解码两个字节，negBit为方向为，negBit=0表示无方向
+	void syncReadBegin(u8 IDN, u8 rxLen);//同步读开始
+	void syncReadBegin(u8 IDN, u8 rxLen, u8 *rxBuff);//SyncRead into caller storage of at least IDN*(rxLen+6) bytes, no heap use
+	void syncReadEnd();//同步读结束
+	int syncRead(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, u8 *rxBuff, SyncReadRx rxTab[], u8 tabLen);//whole SyncRead into caller storage of IDN*(nLen+6) bytes, reentrant, returns valid packets
+	int enableStats();//allocate and start transaction statistics, returns 0 if compiled out (SCS_NO_STATS)
+	void disableStats();
+	const SCSStats *getStats(){  return Stats;  }//live statistics, NULL when disabled
+	int snapshotStats(SCSStatInst Inst[]);//copy the per-instruction statistics (SCS_STAT_INST entries)
+	int snapshotStats(u8 ID, SCSStatID *Stat);//copy the statistics of one servo
+	void writePrepared(const u8 *Pkt, int Len);//send a prebuilt frame that gets no reply, e.g. an SCSSyncWritePacket
+	int syncReadPrepared(const u8 *Pkt, int Len, u8 IDN, u8 nLen);//syncReadPacketTx with a prebuilt SYNC_READ frame of IDN servos
+	int syncReadPrepared(const u8 *Pkt, int Len, u8 IDN, u8 nLen, u8 *rxBuff, SyncReadRx rxTab[], u8 tabLen, const u8 *Pre = NULL, int PreLen = 0);//syncRead() with a prebuilt frame, Pre (e.g. a sync write) goes out in the same write ahead of it
+	int batchExec(SCSBatch *batch);//send all queued requests in one write and demultiplex the replies, returns completed transactions
+	void setTrace(SCSTrace *trace, u8 Tag = 0){  TraceTag = Tag;  Trace = trace;  }//record transactions into trace (SCSTrace.h), Tag tells buses apart, NULL stops
+	SCSTrace *getTrace(){  return Trace;  }
+	u8 getTraceTag(){  return TraceTag;  }
+	void setCoalesce(SCSCoalesce *coalesce);//buffer genWrite/writeByte/writeWord into sync writes, NULL sends the buffered writes and stops
+	int setLocking(u8 Enable);//per-bus recursive mutex around every transaction, set before other threads use the bus
+	void lock(){  if(Locking) pthread_mutex_lock(&Mutex);  }//hold the bus across several calls, e.g. a SyncRead session
+	void unlock(){  if(Locking) pthread_mutex_unlock(&Mutex);  }
+public:
+	u8	Level;//舵机返回等级
+	u8	End;//处理器大小端结构
+	u8	Error;//舵机状态
+	u8 syncReadRxPacketIndex;
+	u8 syncReadRxPacketLen;
+	u8 *syncReadRxPacket;
+	u8 *syncReadRxBuff;
+	u16 syncReadRxBuffLen;
+	u16 syncReadRxBuffMax;
+	u16 syncReadRxBuffSize;//allocated size of syncReadRxBuff, 0 if it is caller storage
+	u64 RxStamp;//arrival of the first byte of the last status packet decoded by Read, Ping or an ack, monotonic us, 0 if unknown
+	u8 LazyFlush;//1: flush the input only after a failed or incomplete transaction instead of before every request
+protected:
+	u8 rxPacketNum;//status packets expected by the next readSCS, used for timeout estimation
+	u64 rxFirstUs;//arrival of the first byte returned by the last readSCS, set by the transport, 0 if unknown
+	u8 txInst;//instruction of the last framed request
+	u16 txLen;//length of the last framed request
+	u16 rxStatusLen;//bytes consumed by the last readStatus
+	u8 rxDirty;//input may hold stale bytes, flush before the next request
+	u64 syncReadRxUs;//rxFirstUs of the last SyncRead reply
+	SCSStats *Stats;
+	SCSTrace *Trace;//NULL: no tracing, not owned
+	u8 TraceTag;
+	SCSCoalesce *Coalesce;//NULL: writes go out at once, not owned
+	u8 Locking;//1: lock() takes Mutex
+	u8 MutexInit;
+	pthread_mutex_t Mutex;
+	u8 syncWriteBuf[SCS_SYNC_WRITE_BUF];//payload the series sync writes encode into, reused every call
+#ifdef SCS_STATIC_ALLOC
+	u8 syncReadPool[SCS_SYNC_READ_POOL];//owned SyncRead buffer
+#ifndef SCS_NO_STATS
+	SCSStats StatsPool;
+#endif
+#endif
+	virtual int writeSCS(unsigned char *nDat, int nLen) = 0;
+	virtual int readSCS(unsigned char *nDat, int nLen) = 0;
+	virtual int writeSCS(unsigned char bDat) = 0;
+	virtual void rFlushSCS() = 0;
+	virtual void wFlushSCS() = 0;
+	virtual int writeSCSv(const struct iovec *iov, int iovcnt);//gather output, default copies through writeSCS
+	virtual u32 wireUs(int nLen){  return 0;  }//time nLen bytes take on the line, 0 if the rate is unknown
+protected:
+	void writeBuf(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen, u8 Fun);
+	void Host2SCS(u8 *DataL, u8* DataH, u16 Data);//1个16位数拆分为2个8位数
+	u16	SCS2Host(u8 DataL, u8 DataH);//2个8位数组合为1个16位数
+	int	Ack(u8 ID);//返回应答
+	int syncReadSend(const u8 *Pre, int PreLen, const u8 *Pkt, int Len, u8 IDN, u8 nLen);//send Pre and the SYNC_READ frame, read the replies into syncReadRxBuff
+	static int syncReadFrame(u8 *Pkt, const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//SYNC_READ frame of IDN+8 bytes into Pkt, returns its length
+	void rxFlush();//rFlushSCS unless LazyFlush and the input is known clean
+	int readStatus(u8 ID, u8 nLen, u8 *Pkt, u8 *Result);//find the status packet of ID with nLen payload bytes in the input, returns nLen+6 or 0, Result: SCS_STAT_*
+};
+
+//Holds the bus lock for the lifetime of the guard, free when locking is off
+class SCSLock{
+public:
+	SCSLock(SCS *bus) : bus(bus){  bus->lock();  }
+	~SCSLock(){  bus->unlock();  }
+private:
+	SCS *bus;
+};
+
 #endif
\ No newline at end of file
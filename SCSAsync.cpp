@@ -0,0 +1,268 @@
+/*
+ * SCSAsync.cpp
+ * Non-blocking transactions with futures or completion callbacks
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSAsync.h"
+#include "SCSChecksum.h"
+#include "SCSStatus.h"
+
+void SCSAsyncOp::complete()
+{
+	if(Callback){
+		Callback(Arg, this);
+	}
+	__atomic_store_n(&State, SCS_ASYNC_FREE, __ATOMIC_RELEASE);
+}
+
+SCSAsync::SCSAsync(SCSerial *bus)
+{
+	this->bus = bus;
+	memset(Ops, 0, sizeof(Ops));
+	QueueHead = 0;
+	QueueN = 0;
+	Exec = NULL;
+	ExecCtx = NULL;
+	rxLen = 0;
+	Completed = 0;
+	TimeOuts = 0;
+}
+
+void SCSAsync::setExecutor(SCSAsyncExecutor exec, void *ctx)
+{
+	Exec = exec;
+	ExecCtx = ctx;
+}
+
+SCSAsyncOp *SCSAsync::alloc(u8 Inst, u8 ID, u8 MemAddr, u8 nLen, SCSAsyncCallback cb, void *arg)
+{
+	if(QueueN==SCS_ASYNC_OPS){
+		return NULL;
+	}
+	for(int i=0; i<SCS_ASYNC_OPS; i++){
+		SCSAsyncOp *op = Ops+i;
+		if(__atomic_load_n(&op->State, __ATOMIC_ACQUIRE)!=SCS_ASYNC_FREE){
+			continue;
+		}
+		op->Inst = Inst;
+		op->ID = ID;
+		op->MemAddr = MemAddr;
+		op->nLen = nLen;
+		op->Error = 0;
+		op->IDN = 0;
+		op->ValidMask = 0;
+		op->Stamp = 0;
+		op->Callback = cb;
+		op->Arg = arg;
+		op->State = SCS_ASYNC_QUEUED;
+		Queue[(QueueHead+QueueN)%SCS_ASYNC_OPS] = i;
+		QueueN++;
+		return op;
+	}
+	return NULL;
+}
+
+SCSAsyncOp *SCSAsync::readAsync(u8 ID, u8 MemAddr, u8 nLen, SCSAsyncCallback cb, void *arg)
+{
+	if(!nLen || nLen>250 || ID>=0xfe){
+		return NULL;
+	}
+	return alloc(INST_READ, ID, MemAddr, nLen, cb, arg);
+}
+
+SCSAsyncOp *SCSAsync::writeAsync(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen, SCSAsyncCallback cb, void *arg)
+{
+	if(nLen>250){
+		return NULL;
+	}
+	SCSAsyncOp *op = alloc(INST_WRITE, ID, MemAddr, nLen, cb, arg);
+	if(op){
+		memcpy(op->Dat, nDat, nLen);
+	}
+	return op;
+}
+
+SCSAsyncOp *SCSAsync::pingAsync(u8 ID, SCSAsyncCallback cb, void *arg)
+{
+	if(ID>=0xfe){
+		return NULL;
+	}
+	return alloc(INST_PING, ID, 0, 0, cb, arg);
+}
+
+SCSAsyncOp *SCSAsync::syncReadAsync(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, SCSAsyncCallback cb, void *arg)
+{
+	if(!IDN || IDN>SCS_ASYNC_IDS || !nLen || IDN*nLen>SCS_ASYNC_DAT){
+		return NULL;
+	}
+	SCSAsyncOp *op = alloc(INST_SYNC_READ, 0xfe, MemAddr, nLen, cb, arg);
+	if(op){
+		op->IDN = IDN;
+		memcpy(op->IDs, ID, IDN);
+	}
+	return op;
+}
+
+u32 SCSAsync::timeOutUs(int txLen, int rxLen, int rxPackets)
+{
+	int Baud = bus->getBaudRate();
+	if(!bus->AdaptiveTimeOut || Baud<=0){
+		return bus->IOTimeOut*1000;
+	}
+	u32 Wire = (u32)(((u64)(txLen+rxLen)*10*1000000ULL+Baud-1)/Baud);
+	return Wire+bus->ReturnDelayUs*rxPackets+bus->TimeOutMarginUs;
+}
+
+void SCSAsync::send(SCSAsyncOp *op, u64 NowUs)
+{
+	u8 *p = txBuf;
+	*p++ = 0xff;
+	*p++ = 0xff;
+	*p++ = op->ID;
+	u8 *Len = p++;
+	*p++ = op->Inst;
+	int rxBytes = 0;
+	int rxPackets = 1;
+	if(op->Inst==INST_READ){
+		*p++ = op->MemAddr;
+		*p++ = op->nLen;
+		rxBytes = op->nLen+6;
+	}else if(op->Inst==INST_WRITE){
+		*p++ = op->MemAddr;
+		memcpy(p, op->Dat, op->nLen);
+		p += op->nLen;
+		rxBytes = 6;
+	}else if(op->Inst==INST_SYNC_READ){
+		*p++ = op->MemAddr;
+		*p++ = op->nLen;
+		memcpy(p, op->IDs, op->IDN);
+		p += op->IDN;
+		rxBytes = op->IDN*(op->nLen+6);
+		rxPackets = op->IDN;
+	}else{
+		rxBytes = 6;
+	}
+	*Len = p-Len;
+	*p = ~SCSChecksum::sum(txBuf+2, p-txBuf-2);
+	p++;
+	//replies of a timed-out op may still trickle in
+	while(bus->recvRaw(rxBuf, sizeof(rxBuf))>0);
+	rxLen = 0;
+	bus->sendRaw(txBuf, p-txBuf);
+	op->DeadlineUs = NowUs+timeOutUs(p-txBuf, rxBytes, rxPackets);
+	op->State = SCS_ASYNC_SENT;
+}
+
+//status packets in rxBuf for op, 1 once every expected packet is there
+int SCSAsync::scan(SCSAsyncOp *op)
+{
+	u8 Want = (op->Inst==INST_READ || op->Inst==INST_SYNC_READ) ? op->nLen : 0;
+	u32 All = op->IDN==32 ? 0xffffffff : (1UL<<op->IDN)-1;
+	int Done = 0;
+	int Pos = 0;
+	int pktLen;
+	u8 Result;
+	while(!Done && (pktLen = SCSStatus::find(rxBuf, rxLen, &Pos, &Result))>0){
+		u8 *p = rxBuf+Pos;
+		Pos += pktLen;
+		if(SCSStatus::match(p, 0xfe, Want)!=SCS_STAT_OK){
+			continue;
+		}
+		if(op->Inst==INST_SYNC_READ){
+			for(u8 i=0; i<op->IDN; i++){
+				if(op->IDs[i]==p[2]){
+					memcpy(op->Dat+i*op->nLen, p+5, Want);
+					op->ValidMask |= 1UL<<i;
+					op->Error = p[4];
+				}
+			}
+			Done = (op->ValidMask&All)==All;
+		}else if(p[2]==op->ID){
+			memcpy(op->Dat, p+5, Want);
+			op->Error = p[4];
+			Done = 1;
+		}
+	}
+	memmove(rxBuf, rxBuf+Pos, rxLen-Pos);
+	rxLen -= Pos;
+	return Done;
+}
+
+void SCSAsync::finish(SCSAsyncOp *op, u8 State, u64 NowUs)
+{
+	QueueHead = (QueueHead+1)%SCS_ASYNC_OPS;
+	QueueN--;
+	Completed++;
+	op->Stamp = NowUs;
+	if(!op->Callback){
+		__atomic_store_n(&op->State, State, __ATOMIC_RELEASE);
+		return;
+	}
+	op->State = State;
+	if(Exec){
+		Exec(ExecCtx, op);
+	}else{
+		op->complete();
+	}
+}
+
+int SCSAsync::poll(u64 NowUs)
+{
+	int Num = 0;
+	while(QueueN){
+		SCSAsyncOp *op = Ops+Queue[QueueHead];
+		if(op->State==SCS_ASYNC_QUEUED){
+			send(op, NowUs);
+			if(op->Inst==INST_WRITE && (op->ID==0xfe || !bus->Level)){
+				finish(op, SCS_ASYNC_DONE, NowUs);
+				Num++;
+				continue;
+			}
+		}
+		if(rxLen==(int)sizeof(rxBuf)){
+			rxLen = 0;
+		}
+		int n = bus->recvRaw(rxBuf+rxLen, sizeof(rxBuf)-rxLen);
+		if(n>0){
+			rxLen += n;
+		}
+		if(scan(op)){
+			finish(op, SCS_ASYNC_DONE, NowUs);
+			Num++;
+			continue;
+		}
+		if((long long)(NowUs-op->DeadlineUs)>=0){
+			TimeOuts++;
+			finish(op, SCS_ASYNC_FAILED, NowUs);
+			Num++;
+			continue;
+		}
+		break;
+	}
+	return Num;
+}
+
+int SCSAsync::wait(SCSAsyncOp *op)
+{
+	while(op->State==SCS_ASYNC_QUEUED || op->State==SCS_ASYNC_SENT){
+		bus->rxPoll(100);
+		poll(SCSerial::monoUs());
+	}
+	return op->State==SCS_ASYNC_DONE;
+}
+
+void SCSAsync::release(SCSAsyncOp *op)
+{
+	if(op->ready()){
+		__atomic_store_n(&op->State, SCS_ASYNC_FREE, __ATOMIC_RELEASE);
+	}
+}
+
+int SCSAsync::job(void *async)
+{
+	((SCSAsync*)async)->poll(SCSerial::monoUs());
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * SCSAsync.h
+ * Non-blocking transactions with futures or completion callbacks
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSASYNC_H
+#define _SCSASYNC_H
+
+#include "SCSerial.h"
+
+#ifndef SCS_ASYNC_OPS
+#define SCS_ASYNC_OPS 16//transactions queued or in flight per bus
+#endif
+#ifndef SCS_ASYNC_IDS
+#define SCS_ASYNC_IDS 32//servos of one async SyncRead
+#endif
+#define SCS_ASYNC_DAT 512//payload bytes of one transaction
+#define SCS_ASYNC_RX 1024//receive scan buffer
+
+#define SCS_ASYNC_FREE 0
+#define SCS_ASYNC_QUEUED 1
+#define SCS_ASYNC_SENT 2
+#define SCS_ASYNC_DONE 3//every expected status packet arrived (or none was expected)
+#define SCS_ASYNC_FAILED 4//timeout, SyncRead entries may be partly valid
+
+struct SCSAsyncOp;
+typedef void (*SCSAsyncCallback)(void *arg, SCSAsyncOp *op);
+typedef void (*SCSAsyncExecutor)(void *ctx, SCSAsyncOp *op);//run op->complete() now or later, on any thread
+
+//One transaction. Without a callback the op is a future: poll until
+//ready(), read the result, then SCSAsync::release() it. With a callback
+//the slot is released when the callback returns.
+struct SCSAsyncOp{
+	volatile u8 State;
+	u8 Inst;
+	u8 ID;
+	u8 MemAddr;
+	u8 nLen;//payload bytes per servo
+	u8 Error;//servo status byte of the (last) status packet
+	u8 IDN;//servos of a SyncRead
+	u8 IDs[SCS_ASYNC_IDS];
+	u32 ValidMask;//SyncRead: bit i set when IDs[i] answered
+	u64 DeadlineUs;
+	u64 Stamp;//completion time, monotonic us
+	SCSAsyncCallback Callback;
+	void *Arg;
+	u8 Dat[SCS_ASYNC_DAT];//read payload (SyncRead: nLen bytes per servo in IDs order), write data
+	int ready(){  return State>=SCS_ASYNC_DONE;  }
+	int ok(){  return State==SCS_ASYNC_DONE;  }
+	void complete();//run the callback and free the slot
+};
+
+//Issues transactions on bus without waiting for them. Requests are sent
+//one at a time in submission order, poll() (from the bus thread, e.g.
+//when bus->getEpollFd() is readable or as an SCSLoop job) pulls the
+//bytes that are already there, matches status packets to the op in
+//flight and sends the next request. One thread can drive several buses,
+//each with its own SCSAsync. Submissions and poll() belong to the bus
+//thread, completions run there too unless an executor is set.
+class SCSAsync{
+public:
+	SCSAsync(SCSerial *bus);
+	SCSAsyncOp *readAsync(u8 ID, u8 MemAddr, u8 nLen, SCSAsyncCallback cb = NULL, void *arg = NULL);//NULL if no slot is free
+	SCSAsyncOp *writeAsync(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen, SCSAsyncCallback cb = NULL, void *arg = NULL);
+	SCSAsyncOp *pingAsync(u8 ID, SCSAsyncCallback cb = NULL, void *arg = NULL);
+	SCSAsyncOp *syncReadAsync(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, SCSAsyncCallback cb = NULL, void *arg = NULL);
+	template<class Map> SCSAsyncOp *WritePosExAsync(u8 ID, s16 Position, u16 Speed, u8 ACC = 0, SCSAsyncCallback cb = NULL, void *arg = NULL)
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+		u8 bBuf[PosExBlock::len];
+		PosExBlock::template set<typename Map::Acc, Map::End>(bBuf, ACC);
+		PosExBlock::template set<typename Map::GoalPosition, Map::End>(bBuf, Position);
+		PosExBlock::template set<typename Map::GoalTime, Map::End>(bBuf, 0);
+		PosExBlock::template set<typename Map::GoalSpeed, Map::End>(bBuf, Speed);
+		return writeAsync(ID, PosExBlock::addr, bBuf, sizeof(bBuf), cb, arg);
+	}
+	template<class Map> SCSAsyncOp *FeedBackAsync(u8 ID, SCSAsyncCallback cb = NULL, void *arg = NULL)//decode with Map::FeedBack::get(op->Dat)
+	{
+		return readAsync(ID, Map::FeedBack::addr, Map::FeedBack::len, cb, arg);
+	}
+	int poll(u64 NowUs);//advance the transaction in flight, returns ops completed
+	int wait(SCSAsyncOp *op);//poll until op is ready, for mixing with blocking code, returns op->ok()
+	void release(SCSAsyncOp *op);//free a future
+	int pending(){  return QueueN;  }//ops queued or in flight
+	void setExecutor(SCSAsyncExecutor exec, void *ctx);//completions go to exec instead of running in poll(), NULL: bus thread
+	static int job(void *async);//SCSLoopJob running poll(SCSerial::monoUs())
+public:
+	u32 Completed;
+	u32 TimeOuts;
+private:
+	SCSAsyncOp *alloc(u8 Inst, u8 ID, u8 MemAddr, u8 nLen, SCSAsyncCallback cb, void *arg);
+	void send(SCSAsyncOp *op, u64 NowUs);
+	int scan(SCSAsyncOp *op);
+	void finish(SCSAsyncOp *op, u8 State, u64 NowUs);
+	u32 timeOutUs(int txLen, int rxLen, int rxPackets);
+private:
+	SCSerial *bus;
+	SCSAsyncOp Ops[SCS_ASYNC_OPS];
+	u8 Queue[SCS_ASYNC_OPS];//submission order, Queue[QueueHead] is in flight once sent
+	int QueueHead;
+	int QueueN;
+	SCSAsyncExecutor Exec;
+	void *ExecCtx;
+	u8 txBuf[255+6];
+	u8 rxBuf[SCS_ASYNC_RX];
+	int rxLen;
+};
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * SCSBalance.cpp
+ * Servo group to bus assignment across several ports from the predicted per-bus cycle load
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSBalance.h"
+
+SCSBalance::SCSBalance()
+{
+	BusN = 0;
+	GroupN = 0;
+	MaxLoad = 0;
+	MaxLoadNow = 0;
+	memset(B, 0, sizeof(B));
+	memset(Now, 0, sizeof(Now));
+	memset(LooseN, 0, sizeof(LooseN));
+}
+
+int SCSBalance::addBus(int BaudRate, u32 ReturnDelayUs, u32 TurnUs)
+{
+	if(BusN>=SCS_BAL_BUSES || BaudRate<=0){
+		return -1;
+	}
+	SCSBalanceBus *b = B+BusN;
+	memset(b, 0, sizeof(SCSBalanceBus));
+	b->BaudRate = BaudRate;
+	b->ReturnDelayUs = ReturnDelayUs;
+	b->TurnUs = TurnUs;
+	Now[BusN] = *b;
+	return BusN++;
+}
+
+int SCSBalance::addBus(SCSerial *bus, u32 ReturnDelayUs, u32 TurnUs)
+{
+	int i = addBus(bus ? bus->getBaudRate() : 0, ReturnDelayUs, TurnUs);
+	if(i>=0){
+		B[i].bus = Now[i].bus = bus;
+	}
+	return i;
+}
+
+int SCSBalance::addGroup(const char *Name, const u8 ID[], u8 IDN, double RateHz, u8 ReadLen, u8 WriteLen)
+{
+	if(GroupN>=SCS_BAL_GROUPS || !IDN || IDN>SCS_BAL_IDS || RateHz<=0){
+		return -1;
+	}
+	SCSBalanceGroup *g = G+GroupN;
+	memset(g, 0, sizeof(SCSBalanceGroup));
+	snprintf(g->Name, sizeof(g->Name), "%s", Name ? Name : "");
+	memcpy(g->ID, ID, IDN);
+	g->IDN = IDN;
+	g->RateHz = RateHz;
+	g->ReadLen = ReadLen;
+	g->WriteLen = WriteLen;
+	g->Bus = SCS_BAL_UNKNOWN;
+	g->Assign = 0;
+	return GroupN++;
+}
+
+int SCSBalance::locate(SCSDiscovery *disc[])
+{
+	u8 Owned[SCS_DISC_ID];
+	memset(Owned, 0, sizeof(Owned));
+	int n = 0;
+	for(u8 k=0; k<GroupN; k++){
+		SCSBalanceGroup *g = G+k;
+		g->Bus = SCS_BAL_UNKNOWN;
+		g->Found = 0;
+		for(u8 i=0; i<g->IDN; i++){
+			u8 ID = g->ID[i];
+			if(ID<SCS_DISC_ID){
+				Owned[ID] = 1;
+			}
+			for(u8 b=0; b<BusN; b++){
+				if(!disc[b] || ID>=SCS_DISC_ID || !disc[b]->Present[ID]){
+					continue;
+				}
+				g->Found++;
+				if(g->Bus==SCS_BAL_UNKNOWN){
+					g->Bus = b;
+				}else if(g->Bus!=b){
+					g->Bus = SCS_BAL_SPLIT;
+				}
+			}
+		}
+		n += g->Bus>=0;
+	}
+	for(u8 b=0; b<BusN; b++){
+		LooseN[b] = 0;
+		if(!disc[b]){
+			continue;
+		}
+		for(u8 i=0; i<disc[b]->IDN; i++){
+			if(!Owned[disc[b]->ID[i]]){
+				Loose[b][LooseN[b]++] = disc[b]->ID[i];
+			}
+		}
+	}
+	int Cur[SCS_BAL_GROUPS];
+	for(u8 k=0; k<GroupN; k++){
+		Cur[k] = G[k].Bus;
+	}
+	MaxLoadNow = evaluate(Cur, Now);
+	return n;
+}
+
+//one SyncRead per (rate, ReadLen) and one sync write per (rate, WriteLen)
+//of the groups on bus b
+double SCSBalance::busCost(int b, const int Assign[], SCSBalanceBus *Out)
+{
+	u8 Done[SCS_BAL_GROUPS];
+	double Load = 0;
+	u32 CycleUs = 0;
+	u8 GroupN = 0;
+	for(int Pass=0; Pass<2; Pass++){
+		memset(Done, 0, sizeof(Done));
+		for(u8 k=0; k<this->GroupN; k++){
+			const SCSBalanceGroup *g = G+k;
+			u8 Len = Pass ? g->WriteLen : g->ReadLen;
+			if(Assign[k]!=b || Done[k] || !Len){
+				continue;
+			}
+			int IDN = 0;
+			for(u8 j=k; j<this->GroupN; j++){
+				const SCSBalanceGroup *h = G+j;
+				if(Assign[j]==b && !Done[j] && h->RateHz==g->RateHz && (Pass ? h->WriteLen : h->ReadLen)==Len){
+					IDN += h->IDN;
+					Done[j] = 1;
+				}
+			}
+			SCSBudget Bud(B[b].BaudRate, B[b].ReturnDelayUs, B[b].TurnUs);
+			while(IDN>0){
+				u8 n = IDN>253 ? 253 : IDN;
+				if(Pass){
+					Bud.addSyncWrite(n, Len);
+				}else{
+					Bud.addSyncRead(n, Len);
+				}
+				IDN -= n;
+			}
+			u32 Us = Bud.cycleUs();
+			CycleUs += Us;
+			Load += Us*g->RateHz*1e-6;
+		}
+	}
+	for(u8 k=0; k<this->GroupN; k++){
+		GroupN += Assign[k]==b;
+	}
+	if(Out){
+		Out->CycleUs = CycleUs;
+		Out->Load = Load;
+		Out->GroupN = GroupN;
+	}
+	return Load;
+}
+
+double SCSBalance::evaluate(const int Assign[], SCSBalanceBus Out[])
+{
+	double Max = 0;
+	for(u8 b=0; b<BusN; b++){
+		double Load = busCost(b, Assign, Out ? Out+b : NULL);
+		if(Load>Max){
+			Max = Load;
+		}
+	}
+	return Max;
+}
+
+int SCSBalance::plan()
+{
+	if(!BusN || !GroupN){
+		MaxLoad = 0;
+		return 0;
+	}
+	int Assign[SCS_BAL_GROUPS];
+	double Cost[SCS_BAL_GROUPS];
+	u8 Order[SCS_BAL_GROUPS];
+	for(u8 k=0; k<GroupN; k++){
+		Assign[k] = -1;
+	}
+	//largest first, cost of the group alone on bus 0
+	for(u8 k=0; k<GroupN; k++){
+		int Alone[SCS_BAL_GROUPS];
+		for(u8 j=0; j<GroupN; j++){
+			Alone[j] = j==k ? 0 : -1;
+		}
+		Cost[k] = busCost(0, Alone, NULL);
+		Order[k] = k;
+	}
+	for(u8 i=1; i<GroupN; i++){
+		for(u8 j=i; j>0 && Cost[Order[j]]>Cost[Order[j-1]]; j--){
+			u8 t = Order[j];
+			Order[j] = Order[j-1];
+			Order[j-1] = t;
+		}
+	}
+	for(u8 i=0; i<GroupN; i++){
+		u8 k = Order[i];
+		int Best = 0;
+		double BestLoad = 0;
+		for(u8 b=0; b<BusN; b++){
+			Assign[k] = b;
+			double Load = busCost(b, Assign, NULL);
+			//prefer the bus the group is on when it costs nothing more
+			if(b==0 || Load<BestLoad || (Load==BestLoad && G[k].Bus==b)){
+				Best = b;
+				BestLoad = Load;
+			}
+		}
+		Assign[k] = Best;
+	}
+	//moves and swaps while the largest load drops
+	double Max = evaluate(Assign, NULL);
+	for(int Improved=1; Improved; ){
+		Improved = 0;
+		for(u8 k=0; k<GroupN && !Improved; k++){
+			int From = Assign[k];
+			for(u8 b=0; b<BusN && !Improved; b++){
+				if(b==From){
+					continue;
+				}
+				Assign[k] = b;
+				double m = evaluate(Assign, NULL);
+				if(m<Max-1e-9){
+					Max = m;
+					Improved = 1;
+					break;
+				}
+				for(u8 j=0; j<GroupN; j++){
+					if(Assign[j]!=b || j==k){
+						continue;
+					}
+					Assign[j] = From;
+					m = evaluate(Assign, NULL);
+					if(m<Max-1e-9){
+						Max = m;
+						Improved = 1;
+						break;
+					}
+					Assign[j] = b;
+				}
+				if(!Improved){
+					Assign[k] = From;
+				}
+			}
+		}
+	}
+	MaxLoad = evaluate(Assign, B);
+	int Moves = 0;
+	for(u8 k=0; k<GroupN; k++){
+		G[k].Assign = Assign[k];
+		Moves += G[k].Bus!=SCS_BAL_UNKNOWN && G[k].Bus!=Assign[k];
+	}
+	return Moves;
+}
+
+void SCSBalance::report(FILE *f)
+{
+	fprintf(f, "bus  baud     now: load  cycle_us   plan: load  cycle_us groups\n");
+	for(u8 b=0; b<BusN; b++){
+		fprintf(f, "%-4d %-8d %9.1f%% %9lu %10.1f%% %9lu %6d\n", b, B[b].BaudRate, Now[b].Load*100, Now[b].CycleUs, B[b].Load*100, B[b].CycleUs, B[b].GroupN);
+	}
+	fprintf(f, "largest load now %.1f%%, planned %.1f%%\n", MaxLoadNow*100, MaxLoad*100);
+	for(u8 k=0; k<GroupN; k++){
+		const SCSBalanceGroup *g = G+k;
+		if(g->Bus==SCS_BAL_UNKNOWN){
+			fprintf(f, "group %s (%d servos, %.0f Hz): not found, plan bus %d\n", g->Name, g->IDN, g->RateHz, g->Assign);
+		}else if(g->Bus==SCS_BAL_SPLIT){
+			fprintf(f, "group %s: split over several buses, plan bus %d\n", g->Name, g->Assign);
+		}else if(g->Bus!=g->Assign){
+			fprintf(f, "group %s: move bus %d -> %d\n", g->Name, g->Bus, g->Assign);
+		}
+		if(g->Bus!=SCS_BAL_UNKNOWN && g->Found<g->IDN){
+			fprintf(f, "group %s: %d of %d servos found\n", g->Name, g->Found, g->IDN);
+		}
+	}
+	for(u8 b=0; b<BusN; b++){
+		for(u8 i=0; i<LooseN[b]; i++){
+			fprintf(f, "bus %d: ID %d is in no group\n", b, Loose[b][i]);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * SCSBalance.h
+ * Servo group to bus assignment across several ports from the predicted per-bus cycle load
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBALANCE_H
+#define _SCSBALANCE_H
+
+#include <stdio.h>
+#include "SCSBudget.h"
+#include "SCSDiscovery.h"
+
+#define SCS_BAL_BUSES 8//SCS_BUS_MAX
+#define SCS_BAL_GROUPS 32
+#define SCS_BAL_IDS 32//servos of one group
+#define SCS_BAL_NAME 16
+
+#define SCS_BAL_UNKNOWN -1//no servo of the group was found
+#define SCS_BAL_SPLIT -2//servos of the group were found on several buses
+
+//A group is what moves between ports as a whole, e.g. the daisy chain of
+//one limb: read ReadLen bytes (SyncRead) and write WriteLen bytes (sync
+//write) per servo at RateHz.
+struct SCSBalanceGroup{
+	char Name[SCS_BAL_NAME];
+	u8 ID[SCS_BAL_IDS];
+	u8 IDN;
+	double RateHz;
+	u8 ReadLen;//0: not read
+	u8 WriteLen;//0: not written
+	int Bus;//where locate() found it, SCS_BAL_UNKNOWN or SCS_BAL_SPLIT
+	int Assign;//bus chosen by plan()
+	u8 Found;//servos of the group found by locate()
+};
+
+struct SCSBalanceBus{
+	SCSerial *bus;//may be NULL for planning only
+	int BaudRate;
+	u32 ReturnDelayUs;
+	u32 TurnUs;//host latency per reply, see SCSBudget
+	u32 CycleUs;//predicted cycle when every group of the bus is due
+	double Load;//predicted share of the line time in use
+	u8 GroupN;
+};
+
+//The cost of a bus is predicted with SCSBudget: groups of the same rate
+//and frame size share one SyncRead and one sync write, so merging groups
+//is cheaper than their sum. plan() puts the groups on the buses largest
+//first, each on the bus whose load grows the least (in real time, so a
+//faster port takes more), then moves or swaps groups while that lowers
+//the largest load. Equal loads let the parallel cycles of SCSBusGroup
+//end together instead of waiting for the slowest bus. locate() tells
+//where the servos are wired now, report() prints both and the moves.
+class SCSBalance{
+public:
+	SCSBalance();
+	int addBus(SCSerial *bus, u32 ReturnDelayUs = 0, u32 TurnUs = 0);//rate taken from the port, returns the bus index, -1 if full
+	int addBus(int BaudRate, u32 ReturnDelayUs = 0, u32 TurnUs = 0);
+	int addGroup(const char *Name, const u8 ID[], u8 IDN, double RateHz, u8 ReadLen, u8 WriteLen);//returns the group index, -1 if full
+	int locate(SCSDiscovery *disc[]);//disc[i]: scan result of bus i, e.g. SCSDiscovery::scanGroup(), returns groups found on one bus
+	int plan();//fill Assign, returns groups to move (found on a bus other than their Assign)
+	double evaluate(const int Assign[], SCSBalanceBus Out[]);//bus loads for a group to bus map, returns the largest load
+	void report(FILE *f);
+public:
+	u8 BusN;
+	SCSBalanceBus B[SCS_BAL_BUSES];//loads of the plan
+	SCSBalanceBus Now[SCS_BAL_BUSES];//loads as located, groups not on one bus left out
+	u8 GroupN;
+	SCSBalanceGroup G[SCS_BAL_GROUPS];
+	u8 Loose[SCS_BAL_BUSES][SCS_DISC_ID];//found servos of no group per bus
+	u8 LooseN[SCS_BAL_BUSES];
+	double MaxLoad;//largest load of the plan
+	double MaxLoadNow;
+private:
+	double busCost(int b, const int Assign[], SCSBalanceBus *Out);
+};
+
+#endif
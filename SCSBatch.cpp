@@ -0,0 +1,55 @@
+/*
+ * SCSBatch.cpp
+ * Pipelined multi-transaction batch for the SCS communication layer
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#include <stddef.h>
+#include "SCSBatch.h"
+
+SCSBatch::SCSBatch()
+{
+	clear();
+}
+
+void SCSBatch::clear()
+{
+	ReqNum = 0;
+	RxLen = 0;
+}
+
+int SCSBatch::add(u8 ID, u8 Fun, u8 MemAddr, u8 *nDat, u8 nLen, u16 rxLen)
+{
+	if(ReqNum>=SCS_BATCH_MAX || (RxLen+rxLen)>SCS_BATCH_RX_MAX){
+		return -1;
+	}
+	SCSBatchReq *req = Req+ReqNum;
+	req->ID = ID;
+	req->Fun = Fun;
+	req->MemAddr = MemAddr;
+	req->nLen = nLen;
+	req->nDat = nDat;
+	req->Error = 0;
+	req->Valid = 0;
+	RxLen += rxLen;
+	return ReqNum++;
+}
+
+int SCSBatch::read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
+{
+	if(ID==0xfe){
+		return -1;
+	}
+	return add(ID, INST_READ, MemAddr, nData, nLen, nLen+6);
+}
+
+int SCSBatch::write(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
+{
+	return add(ID, INST_WRITE, MemAddr, nDat, nLen, ID==0xfe ? 0 : 6);
+}
+
+int SCSBatch::regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
+{
+	return add(ID, INST_REG_WRITE, MemAddr, nDat, nLen, ID==0xfe ? 0 : 6);
+}
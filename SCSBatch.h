@@ -0,0 +1,49 @@
+/*
+ * SCSBatch.h
+ * Pipelined multi-transaction batch for the SCS communication layer
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _SCSBATCH_H
+#define _SCSBATCH_H
+
+#include "INST.h"
+
+#ifndef SCS_BATCH_MAX
+#define SCS_BATCH_MAX 32//max queued transactions
+#endif
+#define SCS_BATCH_RX_MAX 1024//max expected status bytes per batch
+
+struct SCSBatchReq{
+	u8 ID;
+	u8 Fun;//INST_READ, INST_WRITE or INST_REG_WRITE
+	u8 MemAddr;
+	u8 nLen;
+	u8 *nDat;//read: result buffer, write: data to send
+	u8 Error;//servo status byte
+	u8 Valid;//1: transaction completed (status packet received, or no reply expected)
+	u64 Stamp;//estimated arrival of the first byte of its status packet, monotonic us, 0 if none
+};
+
+//Requests are sent back-to-back in one write and status packets are
+//matched to requests by ID as they stream in. On a half-duplex bus the
+//servo return delay must cover the request frames that are still being
+//sent, otherwise replies collide with the tail of the batch.
+class SCSBatch{
+public:
+	SCSBatch();
+	void clear();
+	int read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen);//queue a read, returns request index or -1 when full
+	int write(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//queue a write, nDat must stay valid until SCS::batchExec
+	int regWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//queue an async write
+public:
+	SCSBatchReq Req[SCS_BATCH_MAX];
+	u8 ReqNum;
+	u16 RxLen;//status bytes expected
+	u8 RxBuf[SCS_BATCH_RX_MAX];
+private:
+	int add(u8 ID, u8 Fun, u8 MemAddr, u8 *nDat, u8 nLen, u16 rxLen);
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * SCSBudget.cpp
+ * Bus bandwidth budget: predicted wire and cycle time of a planned bus cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include "SCSBudget.h"
+
+SCSBudget::SCSBudget(int baudRate, u32 returnDelayUs, u32 turnUs)
+{
+	BaudRate = baudRate>0 ? baudRate : 1000000;
+	ReturnDelayUs = returnDelayUs;
+	TurnUs = turnUs;
+	clear();
+}
+
+void SCSBudget::clear()
+{
+	EntryN = 0;
+}
+
+int SCSBudget::add(u8 Inst, u8 IDN, u8 nLen, u8 Packets, u16 TxBytes, u16 RxBytes, u8 Replies)
+{
+	if(EntryN>=SCS_BUDGET_ENTRIES){
+		return -1;
+	}
+	SCSBudgetEntry *e = Entry+EntryN;
+	e->Inst = Inst;
+	e->IDN = IDN;
+	e->nLen = nLen;
+	e->Packets = Packets;
+	e->TxBytes = TxBytes;
+	e->RxBytes = RxBytes;
+	e->Replies = Replies;
+	e->PredUs = byteUs(TxBytes+RxBytes)+Replies*ReturnDelayUs+(Replies ? TurnUs : 0);
+	e->MeasUs = 0;
+	e->MeasP99Us = 0;
+	return EntryN++;
+}
+
+//frames as SCS::syncWrite builds them: ff ff fe len inst addr nLen {ID data}... sum
+int SCSBudget::addSyncWrite(u8 IDN, u8 nLen)
+{
+	u8 maxIDN = SCS_SYNC_WRITE_MAX/(nLen+1);
+	if(!maxIDN){
+		return -1;
+	}
+	u8 Packets = (IDN+maxIDN-1)/maxIDN;
+	return add(INST_SYNC_WRITE, IDN, nLen, Packets, Packets*8+IDN*(nLen+1), 0, 0);
+}
+
+//SCS::syncReadPacketTx: ff ff fe len inst addr nLen IDs... sum, one status packet per servo
+int SCSBudget::addSyncRead(u8 IDN, u8 nLen)
+{
+	return add(INST_SYNC_READ, IDN, nLen, 1, IDN+8, IDN*(nLen+6), IDN);
+}
+
+int SCSBudget::addWrite(u8 nLen, u8 Ack)
+{
+	return add(INST_WRITE, 1, nLen, 1, nLen+7, Ack ? 6 : 0, Ack ? 1 : 0);
+}
+
+int SCSBudget::addRead(u8 nLen)
+{
+	return add(INST_READ, 1, nLen, 1, 8, nLen+6, 1);
+}
+
+int SCSBudget::addPing()
+{
+	return add(INST_PING, 1, 0, 1, 6, 6, 1);
+}
+
+u32 SCSBudget::wireUs()
+{
+	u32 Bytes = 0;
+	for(u8 i=0; i<EntryN; i++){
+		Bytes += Entry[i].TxBytes+Entry[i].RxBytes;
+	}
+	return byteUs(Bytes);
+}
+
+u32 SCSBudget::cycleUs()
+{
+	u32 Us = 0;
+	for(u8 i=0; i<EntryN; i++){
+		Us += Entry[i].PredUs;
+	}
+	return Us;
+}
+
+int SCSBudget::compare(const SCSStats *stats)
+{
+	int Over = 0;
+	for(u8 i=0; i<EntryN; i++){
+		SCSBudgetEntry *e = Entry+i;
+		int k = SCSStats::instIndex(e->Inst);
+		if(k<0 || !stats->Inst[k].Reply.Count){
+			e->MeasUs = e->MeasP99Us = 0;
+			continue;
+		}
+		e->MeasUs = stats->Inst[k].Reply.mean();
+		e->MeasP99Us = stats->Inst[k].Reply.percentile(99);
+		if(e->MeasP99Us>e->PredUs){
+			Over++;
+		}
+	}
+	return Over;
+}
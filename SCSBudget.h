@@ -0,0 +1,60 @@
+/*
+ * SCSBudget.h
+ * Bus bandwidth budget: predicted wire and cycle time of a planned bus cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBUDGET_H
+#define _SCSBUDGET_H
+
+#include "SCS.h"
+#include "SCSStats.h"
+
+#define SCS_BUDGET_ENTRIES 32//transactions of one planned cycle
+
+//one planned transaction, byte counts as SCS frames them
+struct SCSBudgetEntry{
+	u8 Inst;
+	u8 IDN;//servos addressed
+	u8 nLen;//payload bytes per servo
+	u8 Packets;//request packets (a sync write splits at SCS_SYNC_WRITE_MAX)
+	u16 TxBytes;
+	u16 RxBytes;
+	u8 Replies;//status packets expected
+	u32 PredUs;//request and reply wire time, return delays and turnarounds
+	u32 MeasUs;//mean reply time of the instruction from SCSStats, 0 if none (compare())
+	u32 MeasP99Us;
+};
+
+//Describe one bus cycle with add*(), then read wireUs()/cycleUs()/
+//maxRateHz() before building it, or check a period with load(). At run
+//time compare() puts the SCSStats reply times next to each prediction;
+//SCSStats keeps one histogram per instruction, so entries of the same
+//instruction share the measured value.
+class SCSBudget{
+public:
+	SCSBudget(int baudRate = 1000000, u32 returnDelayUs = 0, u32 turnUs = 0);//turnUs: host latency per reply (USB frames, scheduling)
+	void clear();
+	int addSyncWrite(u8 IDN, u8 nLen);//returns the entry index, -1 if full
+	int addSyncRead(u8 IDN, u8 nLen);
+	int addWrite(u8 nLen, u8 Ack = 1);//genWrite/regWrite, Ack 0 for broadcast or Level 0
+	int addRead(u8 nLen);
+	int addPing();
+	u32 wireUs();//bytes on the wire per cycle
+	u32 cycleUs();//wire time plus return delays and turnarounds
+	double maxRateHz(){  u32 Us = cycleUs();  return Us ? 1000000.0/Us : 0;  }
+	double load(u32 periodUs){  return periodUs ? (double)cycleUs()/periodUs : 0;  }//>1: the cycle does not fit the period
+	int compare(const SCSStats *stats);//fill MeasUs/MeasP99Us, returns entries whose p99 exceeds the prediction
+	u32 byteUs(u32 nBytes){  return (u32)(((u64)nBytes*10*1000000ULL+BaudRate-1)/BaudRate);  }//8N1
+public:
+	int BaudRate;
+	u32 ReturnDelayUs;
+	u32 TurnUs;
+	SCSBudgetEntry Entry[SCS_BUDGET_ENTRIES];
+	u8 EntryN;
+private:
+	int add(u8 Inst, u8 IDN, u8 nLen, u8 Packets, u16 TxBytes, u16 RxBytes, u8 Replies);
+};
+
+#endif
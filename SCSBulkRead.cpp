@@ -0,0 +1,219 @@
+/*
+ * SCSBulkRead.cpp
+ * Bulk read of different register ranges per servo, planned into few SyncReads
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSBulkRead.h"
+
+SCSBulkRead::SCSBulkRead()
+{
+	clear();
+}
+
+void SCSBulkRead::clear()
+{
+	ItemN = 0;
+	GroupN = 0;
+	WireBytes = 0;
+	Planned = 0;
+}
+
+int SCSBulkRead::add(u8 ID, u8 MemAddr, u8 nLen)
+{
+	if(ItemN>=SCS_BULK_ITEMS || !nLen || ID>=0xfe){
+		return -1;
+	}
+	SCSBulkItem *t = Item+ItemN;
+	t->ID = ID;
+	t->MemAddr = MemAddr;
+	t->nLen = nLen;
+	t->Valid = 0;
+	t->Error = 0;
+	t->Group = 0;
+	t->Stamp = 0;
+	t->Dat = NULL;
+	Planned = 0;
+	return ItemN++;
+}
+
+int SCSBulkRead::has(const Group *g, u8 ID)
+{
+	for(u8 i=0; i<g->IDN; i++){
+		if(g->ID[i]==ID){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int SCSBulkRead::merge(const Group *a, const Group *b, Group *u)
+{
+	int First = a->MemAddr<b->MemAddr ? a->MemAddr : b->MemAddr;
+	int End = a->MemAddr+a->nLen;
+	if(b->MemAddr+b->nLen>End){
+		End = b->MemAddr+b->nLen;
+	}
+	if(End-First>0xff){
+		return 0;
+	}
+	*u = *a;
+	u->MemAddr = First;
+	u->nLen = End-First;
+	for(u8 i=0; i<b->IDN; i++){
+		if(has(u, b->ID[i])){
+			continue;
+		}
+		if(u->IDN>=SCS_BULK_IDS){
+			return 0;
+		}
+		u->ID[u->IDN++] = b->ID[i];
+	}
+	return 1;
+}
+
+int SCSBulkRead::plan()
+{
+	Planned = 0;
+	GroupN = 0;
+	WireBytes = 0;
+	//ranges of one servo first: one span per servo where the gaps are short
+	u8 Done[SCS_BULK_ITEMS];
+	memset(Done, 0, sizeof(Done));
+	for(u8 i=0; i<ItemN; i++){
+		if(Done[i]){
+			continue;
+		}
+		int First = Item[i].MemAddr;
+		int End = First+Item[i].nLen;
+		Done[i] = 1;
+		for(int Grew=1; Grew; ){
+			Grew = 0;
+			for(u8 k=0; k<ItemN; k++){
+				const SCSBulkItem *t = Item+k;
+				if(Done[k] || t->ID!=Item[i].ID){
+					continue;
+				}
+				if(t->MemAddr>End+SCS_BULK_GAP || t->MemAddr+t->nLen+SCS_BULK_GAP<First){
+					continue;
+				}
+				if(t->MemAddr<First){
+					First = t->MemAddr;
+				}
+				if(t->MemAddr+t->nLen>End){
+					End = t->MemAddr+t->nLen;
+				}
+				Done[k] = 1;
+				Grew = 1;
+			}
+		}
+		if(End-First>0xff){
+			return 0;
+		}
+		//spans with the same range share a group
+		u8 g;
+		for(g=0; g<GroupN; g++){
+			if(G[g].MemAddr==First && G[g].nLen==End-First && !has(G+g, Item[i].ID) && G[g].IDN<SCS_BULK_IDS){
+				break;
+			}
+		}
+		if(g==GroupN){
+			if(GroupN>=SCS_BULK_GROUPS){
+				return 0;
+			}
+			G[g].MemAddr = First;
+			G[g].nLen = End-First;
+			G[g].IDN = 0;
+			GroupN++;
+		}
+		G[g].ID[G[g].IDN++] = Item[i].ID;
+	}
+	//merge the pair of groups that saves most while anything saves
+	while(GroupN>1){
+		int Best = 0;
+		u8 ba = 0, bb = 0;
+		Group u;
+		for(u8 a=0; a<GroupN; a++){
+			for(u8 b=a+1; b<GroupN; b++){
+				if(!merge(G+a, G+b, &u)){
+					continue;
+				}
+				int Save = (int)(cost(G[a].IDN, G[a].nLen)+cost(G[b].IDN, G[b].nLen))-(int)cost(u.IDN, u.nLen);
+				if(Save>Best){
+					Best = Save;
+					ba = a;
+					bb = b;
+				}
+			}
+		}
+		if(!Best){
+			break;
+		}
+		merge(G+ba, G+bb, &u);
+		G[ba] = u;
+		G[bb] = G[--GroupN];
+	}
+	//reply space and frames
+	u32 RxOff = 0;
+	for(u8 g=0; g<GroupN; g++){
+		G[g].RxOff = RxOff;
+		RxOff += G[g].IDN*(G[g].nLen+6);
+		if(RxOff>SCS_BULK_RX){
+			GroupN = 0;
+			return 0;
+		}
+		G[g].Pkt.prepare(G[g].ID, G[g].IDN, G[g].MemAddr, G[g].nLen);
+		WireBytes += cost(G[g].IDN, G[g].nLen)-SCS_BULK_TURN;
+	}
+	//every item to the group covering it
+	for(u8 i=0; i<ItemN; i++){
+		SCSBulkItem *t = Item+i;
+		for(u8 g=0; g<GroupN; g++){
+			if(has(G+g, t->ID) && t->MemAddr>=G[g].MemAddr && t->MemAddr+t->nLen<=G[g].MemAddr+G[g].nLen){
+				t->Group = g;
+				break;
+			}
+		}
+	}
+	Planned = 1;
+	return GroupN;
+}
+
+int SCSBulkRead::exec(SCS *bus)
+{
+	if(!Planned && !plan()){
+		return 0;
+	}
+	for(u8 i=0; i<ItemN; i++){
+		Item[i].Valid = 0;
+	}
+	int Valid = 0;
+	SyncReadRx rxTab[0xfe];
+	for(u8 g=0; g<GroupN; g++){
+		Group *p = G+g;
+		u8 tabLen = 0;
+		for(u8 k=0; k<p->IDN; k++){
+			if(p->ID[k]>=tabLen){
+				tabLen = p->ID[k]+1;
+			}
+		}
+		bus->syncReadBegin(p->IDN, p->nLen, RxBuf+p->RxOff);
+		p->Pkt.send(bus);
+		bus->syncReadPacketRxAll(rxTab, tabLen);
+		for(u8 i=0; i<ItemN; i++){
+			SCSBulkItem *t = Item+i;
+			const SyncReadRx *rx = rxTab+t->ID;
+			if(t->Group!=g || !rx->Valid){
+				continue;
+			}
+			t->Valid = 1;
+			t->Error = rx->Error;
+			t->Stamp = rx->Stamp;
+			t->Dat = rx->Dat+t->MemAddr-p->MemAddr;
+			Valid++;
+		}
+	}
+	return Valid;
+}
@@ -0,0 +1,78 @@
+/*
+ * SCSBulkRead.h
+ * Bulk read of different register ranges per servo, planned into few SyncReads
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBULKREAD_H
+#define _SCSBULKREAD_H
+
+#include "SCS.h"
+#include "SCSRegMap.h"
+#include "SCSPrepared.h"
+
+#define SCS_BULK_ITEMS 64//ranges requested per plan
+#define SCS_BULK_GROUPS 16//SyncReads per plan
+#define SCS_BULK_IDS 32//servos per SyncRead
+#define SCS_BULK_RX 4096//reply bytes of all SyncReads together
+#define SCS_BULK_GAP 6//unrequested bytes read through rather than starting another range of one servo
+#define SCS_BULK_TURN 10//fixed cost of one more SyncRead in byte times (turnaround, return delay)
+
+//one requested range and its result
+struct SCSBulkItem{
+	u8 ID;
+	u8 MemAddr;
+	u8 nLen;
+	u8 Valid;//1: the servo answered in the last exec()
+	u8 Error;//servo status byte
+	u8 Group;//SyncRead carrying the range
+	u64 Stamp;//estimated arrival of the status packet, monotonic us, 0 if unknown
+	const u8 *Dat;//nLen bytes, valid until the next exec()
+};
+
+//SYNC_READ needs one address and length for all of its servos. add()
+//takes any (ID, address, length) ranges, plan() merges the ranges of
+//each servo and then merges groups while one wider SyncRead costs fewer
+//wire bytes than two (SCS_BULK_TURN per extra packet). exec() sends the
+//prepared SyncReads one after the other and fills the unified Item[]
+//table; replies stay in place in RxBuf, nothing is copied.
+class SCSBulkRead{
+public:
+	SCSBulkRead();
+	void clear();
+	int add(u8 ID, u8 MemAddr, u8 nLen);//returns the item index, -1 if full
+	int plan();//returns SyncReads planned, 0 if the plan does not fit (SCS_BULK_GROUPS, SCS_BULK_IDS, SCS_BULK_RX)
+	int exec(SCS *bus);//plans if needed, returns items valid
+	template<class Map, class Reg> int get(int i)//one field of item i, -1 if not valid
+	{
+		const SCSBulkItem *t = Item+i;
+		if(!t->Valid || Reg::addr<t->MemAddr || Reg::addr+Reg::width>t->MemAddr+t->nLen){
+			return -1;
+		}
+		return SCSField<Reg, Map::End>::decode(t->Dat+Reg::addr-t->MemAddr);
+	}
+public:
+	SCSBulkItem Item[SCS_BULK_ITEMS];
+	u8 ItemN;
+	u8 GroupN;
+	u32 WireBytes;//request and reply bytes of one exec() as planned
+private:
+	struct Group{
+		u8 MemAddr;
+		u8 nLen;
+		u8 IDN;
+		u8 ID[SCS_BULK_IDS];
+		u16 RxOff;
+		SCSSyncReadPacket Pkt;
+	};
+	static u32 cost(u8 IDN, u8 nLen){  return 8+IDN+IDN*(6+nLen)+SCS_BULK_TURN;  }
+	int merge(const Group *a, const Group *b, Group *u);//union of two groups, 0 if it does not fit
+	int has(const Group *g, u8 ID);
+private:
+	Group G[SCS_BULK_GROUPS];
+	u8 Planned;
+	u8 RxBuf[SCS_BULK_RX];
+};
+
+#endif
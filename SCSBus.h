@@ -0,0 +1,111 @@
+/*
+ * SCSBus.h
+ * Move-only owning handle of one servo bus: port, line settings and buffers
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBUS_H
+#define _SCSBUS_H
+
+#include <string.h>
+#include <new>
+#include "SCSerial.h"
+
+#define SCS_BUS_PATH 128
+
+//Series is SMS_STS, SMSBL, SMSCL or SCSCL. The handle owns the series
+//object, and with it the descriptor, the termios settings found at open
+//(restored on close) and the SyncRead buffers. Moving hands all of it to
+//another handle or thread for the cost of a pointer, the source is left
+//closed. reopen() closes and opens the same path again on the same
+//object, so timeouts, statistics and other settings survive a USB
+//re-enumeration; use a stable /dev/serial/by-id path for that. With
+//SCS_STATIC_ALLOC the series object is built inside the handle, which
+//then cannot be moved or released.
+template<class Series>
+class SCSBus{
+public:
+	SCSBus() : bus(NULL), Baud(0){  Path[0] = 0;  }
+	~SCSBus(){  close();  }
+#ifndef SCS_STATIC_ALLOC
+	SCSBus(SCSBus &&o) : bus(o.bus), Baud(o.Baud)
+	{
+		memcpy(Path, o.Path, sizeof(Path));
+		o.bus = NULL;
+	}
+	SCSBus &operator=(SCSBus &&o)
+	{
+		if(this!=&o){
+			close();
+			bus = o.bus;
+			Baud = o.Baud;
+			memcpy(Path, o.Path, sizeof(Path));
+			o.bus = NULL;
+		}
+		return *this;
+	}
+#endif
+	SCSBus(const SCSBus&) = delete;
+	SCSBus &operator=(const SCSBus&) = delete;
+
+	bool open(int baudRate, const char *serialPort)//false if the port cannot be opened, the handle keeps the path for reopen()
+	{
+		if(!serialPort || strlen(serialPort)>=sizeof(Path)){
+			return false;
+		}
+		if(!bus){
+#ifdef SCS_STATIC_ALLOC
+			bus = new(Store) Series();
+#else
+			bus = new Series();
+#endif
+			bus->Verbose = 0;
+		}
+		strcpy(Path, serialPort);
+		Baud = baudRate;
+		return reopen();
+	}
+	bool reopen()
+	{
+		if(!bus || !Path[0]){
+			return false;
+		}
+		bus->end();
+		return bus->begin(Baud, Path);
+	}
+	void close()
+	{
+		if(bus){
+			bus->end();
+#ifdef SCS_STATIC_ALLOC
+			bus->~Series();
+#else
+			delete bus;
+#endif
+			bus = NULL;
+		}
+	}
+#ifndef SCS_STATIC_ALLOC
+	Series *release()//give up ownership, the caller deletes the object
+	{
+		Series *b = bus;
+		bus = NULL;
+		return b;
+	}
+#endif
+	Series *get() const{  return bus;  }
+	Series *operator->() const{  return bus;  }
+	Series &operator*() const{  return *bus;  }
+	explicit operator bool() const{  return bus && bus->getFd()!=-1;  }
+	const char *path() const{  return Path;  }
+private:
+	Series *bus;
+	int Baud;
+	char Path[SCS_BUS_PATH];
+#ifdef SCS_STATIC_ALLOC
+	alignas(Series) u8 Store[sizeof(Series)];
+#endif
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * SCSBusGroup.cpp
+ * Runs several serial buses in parallel, one pinned I/O thread per bus
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include "SCSBusGroup.h"
+
+SCSBusGroup::SCSBusGroup()
+{
+	BusN = 0;
+	Running = 0;
+	Pending = 0;
+	Seq = 0;
+	pthread_mutex_init(&Lock, NULL);
+	pthread_cond_init(&JobCond, NULL);
+	pthread_cond_init(&DoneCond, NULL);
+}
+
+SCSBusGroup::~SCSBusGroup()
+{
+	stop();
+	pthread_cond_destroy(&DoneCond);
+	pthread_cond_destroy(&JobCond);
+	pthread_mutex_destroy(&Lock);
+}
+
+int SCSBusGroup::add(SCSerial *bus, int cpu)
+{
+	if(Running || BusN>=SCS_BUS_MAX){
+		return -1;
+	}
+	Worker *w = Bus+BusN;
+	w->Group = this;
+	w->Bus = bus;
+	w->Cpu = cpu;
+	w->Job = NULL;
+	w->Arg = NULL;
+	w->Seq = 0;
+	w->Done = 0;
+	return BusN++;
+}
+
+int SCSBusGroup::start()
+{
+	if(Running){
+		return 1;
+	}
+	Running = 1;
+	for(int i=0; i<BusN; i++){
+		Worker *w = Bus+i;
+		w->Seq = Seq;
+		w->Done = Seq;
+		if(pthread_create(&w->Thread, NULL, loop, w)!=0){
+			BusN = i;
+			stop();
+			return 0;
+		}
+		if(w->Cpu>=0){
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(w->Cpu, &set);
+			pthread_setaffinity_np(w->Thread, sizeof(set), &set);
+		}
+	}
+	return 1;
+}
+
+void SCSBusGroup::stop()
+{
+	if(!Running){
+		return;
+	}
+	pthread_mutex_lock(&Lock);
+	Running = 0;
+	pthread_cond_broadcast(&JobCond);
+	pthread_mutex_unlock(&Lock);
+	for(int i=0; i<BusN; i++){
+		pthread_join(Bus[i].Thread, NULL);
+	}
+}
+
+void *SCSBusGroup::loop(void *arg)
+{
+	Worker *w = (Worker*)arg;
+	SCSBusGroup *g = w->Group;
+	pthread_mutex_lock(&g->Lock);
+	while(1){
+		while(g->Running && w->Seq==w->Done){
+			pthread_cond_wait(&g->JobCond, &g->Lock);
+		}
+		if(!g->Running){
+			break;
+		}
+		w->Done = w->Seq;
+		SCSBusJob Job = w->Job;
+		void *Arg = w->Arg;
+		pthread_mutex_unlock(&g->Lock);
+		if(Job){
+			Job(w->Bus, Arg);
+		}
+		pthread_mutex_lock(&g->Lock);
+		if(--g->Pending==0){
+			pthread_cond_signal(&g->DoneCond);
+		}
+	}
+	pthread_mutex_unlock(&g->Lock);
+	return NULL;
+}
+
+int SCSBusGroup::run(SCSBusJob job, void *arg[])
+{
+	if(!Running){
+		return 0;
+	}
+	pthread_mutex_lock(&Lock);
+	Seq++;
+	Pending = BusN;
+	for(int i=0; i<BusN; i++){
+		Bus[i].Job = job;
+		Bus[i].Arg = arg ? arg[i] : NULL;
+		Bus[i].Seq = Seq;
+	}
+	pthread_cond_broadcast(&JobCond);
+	while(Pending){
+		pthread_cond_wait(&DoneCond, &Lock);
+	}
+	pthread_mutex_unlock(&Lock);
+	return BusN;
+}
+
+struct SCSBusCycle{
+	SCSBusSyncWrite *Wr;
+	SCSSyncRead *Rd;
+	int Result;
+};
+
+static void busCycleJob(SCSerial *bus, void *arg)
+{
+	SCSBusCycle *c = (SCSBusCycle*)arg;
+	c->Result = 0;
+	if(c->Wr && c->Wr->IDN){
+		bus->syncWrite(c->Wr->ID, c->Wr->IDN, c->Wr->MemAddr, c->Wr->nDat, c->Wr->nLen);
+	}
+	if(c->Rd){
+		c->Result = c->Rd->exec();
+	}
+}
+
+int SCSBusGroup::cycle(SCSBusSyncWrite wr[], SCSSyncRead *rd[])
+{
+	SCSBusCycle c[SCS_BUS_MAX];
+	void *arg[SCS_BUS_MAX];
+	for(int i=0; i<BusN; i++){
+		c[i].Wr = wr ? wr+i : NULL;
+		c[i].Rd = rd ? rd[i] : NULL;
+		arg[i] = c+i;
+	}
+	run(busCycleJob, arg);
+	int rxNum = 0;
+	for(int i=0; i<BusN; i++){
+		rxNum += c[i].Result;
+	}
+	return rxNum;
+}
+
+void SCSBusGroup::syncWriteAll(SCSBusSyncWrite wr[])
+{
+	cycle(wr, NULL);
+}
+
+int SCSBusGroup::syncReadAll(SCSSyncRead *rd[])
+{
+	return cycle(NULL, rd);
+}
@@ -0,0 +1,63 @@
+/*
+ * SCSBusGroup.h
+ * Runs several serial buses in parallel, one pinned I/O thread per bus
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _SCSBUSGROUP_H
+#define _SCSBUSGROUP_H
+
+#include <pthread.h>
+#include "SCSerial.h"
+#include "SCSSyncRead.h"
+
+#define SCS_BUS_MAX 8
+
+typedef void (*SCSBusJob)(SCSerial *bus, void *arg);
+
+//sync write arguments for one bus, IDN = 0 skips the bus
+struct SCSBusSyncWrite{
+	u8 *ID;
+	u8 IDN;
+	u8 MemAddr;
+	u8 *nDat;
+	u8 nLen;
+};
+
+class SCSBusGroup{
+public:
+	SCSBusGroup();
+	~SCSBusGroup();
+	int add(SCSerial *bus, int cpu = -1);//register a bus before start(), cpu<0: no pinning, returns bus index
+	int start();//spawn the I/O threads
+	void stop();
+	int run(SCSBusJob job, void *arg[]);//run job(bus[i], arg[i]) on every bus at once and wait for all, arg may be NULL
+	void syncWriteAll(SCSBusSyncWrite wr[]);//one syncWrite per bus in parallel
+	int syncReadAll(SCSSyncRead *rd[]);//one SyncRead session per bus in parallel, NULL skips, returns total valid packets
+	int cycle(SCSBusSyncWrite wr[], SCSSyncRead *rd[]);//sync write then SyncRead on every bus, joined once
+	int busNum(){  return BusN;  }
+	SCSerial *bus(int i){  return Bus[i].Bus;  }
+private:
+	struct Worker{
+		SCSBusGroup *Group;
+		SCSerial *Bus;
+		int Cpu;
+		pthread_t Thread;
+		SCSBusJob Job;
+		void *Arg;
+		unsigned int Seq;//job sequence number posted to this worker
+		unsigned int Done;//last sequence number handled
+	};
+	static void *loop(void *arg);
+	Worker Bus[SCS_BUS_MAX];
+	int BusN;
+	int Running;
+	int Pending;
+	unsigned int Seq;
+	pthread_mutex_t Lock;
+	pthread_cond_t JobCond;
+	pthread_cond_t DoneCond;
+};
+
+#endif
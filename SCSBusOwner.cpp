@@ -0,0 +1,131 @@
+/*
+ * SCSBusOwner.cpp
+ * Bus thread fed by a lock-free command mailbox, telemetry published as snapshots
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSBusOwner.h"
+#include "SCSShmBus.h"
+#include "SCSWatchdog.h"
+
+SCSBusOwner::SCSBusOwner(SCSerial *bus):Shadow(bus)
+{
+	this->bus = bus;
+	Shm = NULL;
+	Watchdog = NULL;
+	Trips = 0;
+	Dropped = 0;
+	IDN = 0;
+	Cycle = 0;
+	Loop.setJob(cycle, this);
+}
+
+SCSBusOwner::~SCSBusOwner()
+{
+	stop();
+}
+
+int SCSBusOwner::setFeedBack(const u8 ID[], u8 IDN)
+{
+	if(IDN>SCS_OWNER_ID_MAX){
+		return 0;
+	}
+	memcpy(this->ID, ID, IDN);
+	this->IDN = IDN;
+	return 1;
+}
+
+int SCSBusOwner::start(u32 periodUs)
+{
+	Loop.setPeriod(periodUs);
+	return Loop.start();
+}
+
+void SCSBusOwner::stop()
+{
+	Loop.stop();
+}
+
+int SCSBusOwner::command(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	return Queue.push(ID, Ch, MemAddr, nDat, nLen);
+}
+
+int SCSBusOwner::commandWord(u8 ID, u8 Ch, u8 MemAddr, s16 wDat, u8 negBit)
+{
+	u16 Word = wDat;
+	if(negBit && wDat<0){
+		Word = (-wDat)|(1<<negBit);
+	}
+	u8 bBuf[2];
+	if(bus->End){
+		bBuf[0] = (Word>>8);
+		bBuf[1] = (Word&0xff);
+	}else{
+		bBuf[1] = (Word>>8);
+		bBuf[0] = (Word&0xff);
+	}
+	return Queue.push(ID, Ch, MemAddr, bBuf, 2);
+}
+
+void SCSBusOwner::apply(SCSCmdQueue *q)
+{
+	u8 ID, Ch;
+	SCSCmd Cmd;
+	while(q->pop(&ID, &Ch, &Cmd)){
+		if(Cmd.MemAddr+Cmd.nLen<=SCS_SHADOW_LEN){
+			Shadow.setBlock(ID, Cmd.MemAddr, Cmd.Dat, Cmd.nLen);
+		}else{
+			bus->syncWrite(&ID, 1, Cmd.MemAddr, Cmd.Dat, Cmd.nLen);
+		}
+	}
+}
+
+void SCSBusOwner::drop(SCSCmdQueue *q)
+{
+	u8 ID, Ch;
+	SCSCmd Cmd;
+	while(q->pop(&ID, &Ch, &Cmd)){
+		Dropped++;
+	}
+}
+
+int SCSBusOwner::cycle(void *arg)
+{
+	SCSBusOwner *o = (SCSBusOwner*)arg;
+	if(o->Watchdog && o->Watchdog->poll(SCSerial::monoUs())){
+		o->drop(&o->Queue);
+		if(o->Shm && o->Shm->queue()){
+			o->drop(o->Shm->queue());
+		}
+		if(o->Trips!=o->Watchdog->Trips){
+			o->Trips = o->Watchdog->Trips;
+			for(int ID=0; ID<SCS_SHADOW_ID_MAX; ID++){
+				o->Shadow.invalidate(ID);//pending goals must not go out after a reset
+			}
+		}
+	}else{
+		o->apply(&o->Queue);
+		if(o->Shm && o->Shm->queue()){
+			o->apply(o->Shm->queue());
+		}
+		o->Shadow.flush();
+	}
+	SCSBusFrame *f = o->Frames.writeBegin();
+	f->Cycle = ++o->Cycle;
+	f->IDN = o->IDN;
+	memcpy(f->ID, o->ID, o->IDN);
+	if(o->IDN){
+		o->bus->SyncFeedBack(o->ID, o->IDN, f->Tel);
+		if(o->Watchdog){
+			o->Watchdog->check(o->ID, o->IDN, f->Tel, SCSerial::monoUs());
+		}
+	}
+	o->Frames.writeEnd();
+	if(o->Shm){
+		o->Shm->publish(f);//the writer may still read the frame it published
+	}
+	return 0;
+}
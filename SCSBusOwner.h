@@ -0,0 +1,69 @@
+/*
+ * SCSBusOwner.h
+ * Bus thread fed by a lock-free command mailbox, telemetry published as snapshots
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBUSOWNER_H
+#define _SCSBUSOWNER_H
+
+#include "SCSerial.h"
+#include "SCSShadow.h"
+#include "SCSLoop.h"
+#include "SCSCmdQueue.h"
+#include "SCSTripleBuffer.h"
+
+class SCSShmBus;
+class SCSWatchdog;
+
+#ifndef SCS_OWNER_ID_MAX
+#define SCS_OWNER_ID_MAX 32//servos in one telemetry frame
+#endif
+
+struct SCSBusFrame{
+	u32 Cycle;
+	u8 IDN;
+	u8 ID[SCS_OWNER_ID_MAX];
+	Telemetry Tel[SCS_OWNER_ID_MAX];//Tel[i] belongs to ID[i]
+};
+
+//Only the owner thread talks to the bus. Other threads queue register
+//writes with command() (latest per servo and channel wins) and copy the
+//newest feedback with telemetry(); neither side takes a lock. Each
+//period the owner writes the queued commands through an SCSShadow
+//(coalesced sync writes) and reads the feedback with SyncFeedBack().
+//With a watchdog the feedback is checked the moment it is decoded, and
+//while the watchdog is latched queued commands are dropped unsent.
+class SCSBusOwner{
+public:
+	SCSBusOwner(SCSerial *bus);
+	~SCSBusOwner();
+	int setFeedBack(const u8 ID[], u8 IDN);//servos read every period, before start()
+	int start(u32 periodUs);
+	void stop();
+	int command(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen);//any thread
+	int commandWord(u8 ID, u8 Ch, u8 MemAddr, s16 wDat, u8 negBit = 0);//any thread, two bytes in the bus byte order
+	u32 telemetry(SCSBusFrame *frame){  return Frames.read(frame);  }//any thread, returns the frame version, 0 before the first cycle
+	void setShm(SCSShmBus *shm){  Shm = shm;  }//also take commands from and publish frames to a shared memory region, before start()
+	void setWatchdog(SCSWatchdog *wd){  Watchdog = wd;  }//before start(), NULL none
+public:
+	u32 Dropped;//commands discarded while the watchdog was latched
+	SCSCmdQueue Queue;
+	SCSShadow Shadow;
+	SCSLoop Loop;
+private:
+	static int cycle(void *arg);
+	void apply(SCSCmdQueue *q);
+	void drop(SCSCmdQueue *q);
+	SCSerial *bus;
+	SCSShmBus *Shm;
+	SCSWatchdog *Watchdog;
+	u32 Trips;//watchdog trips already acted on
+	u8 IDN;
+	u8 ID[SCS_OWNER_ID_MAX];
+	u32 Cycle;
+	SCSTripleBuffer<SCSBusFrame> Frames;
+};
+
+#endif
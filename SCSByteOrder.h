@@ -0,0 +1,42 @@
+/*
+ * SCSByteOrder.h
+ * Compile-time byte order policies for 16-bit servo fields
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSBYTEORDER_H
+#define _SCSBYTEORDER_H
+
+#include "INST.h"
+
+//End 0: low byte first (SMS/STS), End 1: high byte first (SCS).
+//The series fix their order through X_Map::Order, so packing a
+//sync write payload has no per-field branch left.
+template<u8 End> struct SCSByteOrder;
+
+template<> struct SCSByteOrder<0>{
+	static void put16(u8 *p, u16 v)
+	{
+		p[0] = v&0xff;
+		p[1] = v>>8;
+	}
+	static u16 get16(const u8 *p)
+	{
+		return (u16)(p[0]|(p[1]<<8));
+	}
+};
+
+template<> struct SCSByteOrder<1>{
+	static void put16(u8 *p, u16 v)
+	{
+		p[0] = v>>8;
+		p[1] = v&0xff;
+	}
+	static u16 get16(const u8 *p)
+	{
+		return (u16)((p[0]<<8)|p[1]);
+	}
+};
+
+#endif
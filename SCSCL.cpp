@@ -1,237 +1,160 @@
-﻿/*
- * SCSCL.cpp
- * 飞特SCSCL系列串行舵机应用层程序
- * 日期: 2020.6.17
- * 作者: 
- */
-
-#include "SCSCL.h"
-
-SCSCL::SCSCL()
-{
-	End = 1;
-}
-
-SCSCL::SCSCL(u8 End):SCSerial(End)
-{
-}
-
-SCSCL::SCSCL(u8 End, u8 Level):SCSerial(End, Level)
-{
-}
-
-int SCSCL::WritePos(u8 ID, u16 Position, u16 Time, u16 Speed)
-{
-	u8 bBuf[6];
-	Host2SCS(bBuf+0, bBuf+1, Position);
-	Host2SCS(bBuf+2, bBuf+3, Time);
-	Host2SCS(bBuf+4, bBuf+5, Speed);
-	
-	return genWrite(ID, SCSCL_GOAL_POSITION_L, bBuf, 6);
-}
-
-int SCSCL::RegWritePos(u8 ID, u16 Position, u16 Time, u16 Speed)
-{
-	u8 bBuf[6];
-	Host2SCS(bBuf+0, bBuf+1, Position);
-	Host2SCS(bBuf+2, bBuf+3, Time);
-	Host2SCS(bBuf+4, bBuf+5, Speed);
-	
-	return regWrite(ID, SCSCL_GOAL_POSITION_L, bBuf, 6);
-}
-
-void SCSCL::SyncWritePos(u8 ID[], u8 IDN, u16 Position[], u16 Time[], u16 Speed[])
-{
-    u8 offbuf[IDN][6];
-    for(u8 i = 0; i<IDN; i++){
-        u8 bBuf[6];
-		u16 T, V;
-		if(Time){
-			T = Time[i];
-		}else{
-			T = 0;
-		}
-		if(Speed){
-			V = Speed[i];
-		}else{
-			V = 0;
-		}
-        Host2SCS(bBuf+0, bBuf+1, Position[i]);
-        Host2SCS(bBuf+2, bBuf+3, T);
-        Host2SCS(bBuf+4, bBuf+5, V);
-        memcpy(offbuf[i], bBuf, 6);
-    }
-    syncWrite(ID, IDN, SCSCL_GOAL_POSITION_L, (u8*)offbuf, 6);
-}
-
-int SCSCL::PWMMode(u8 ID)
-{
-	u8 bBuf[4];
-	bBuf[0] = 0;
-	bBuf[1] = 0;
-	bBuf[2] = 0;
-	bBuf[3] = 0;
-	return genWrite(ID, SCSCL_MIN_ANGLE_LIMIT_L, bBuf, 4);	
-}
-
-int SCSCL::WritePWM(u8 ID, s16 pwmOut)
-{
-	if(pwmOut<0){
-		pwmOut = -pwmOut;
-		pwmOut |= (1<<10);
-	}
-	u8 bBuf[2];
-	Host2SCS(bBuf+0, bBuf+1, pwmOut);
-	
-	return genWrite(ID, SCSCL_GOAL_TIME_L, bBuf, 2);
-}
-
-int SCSCL::EnableTorque(u8 ID, u8 Enable)
-{
-	return writeByte(ID, SCSCL_TORQUE_ENABLE, Enable);
-}
-
-int SCSCL::unLockEprom(u8 ID)
-{
-	return writeByte(ID, SCSCL_LOCK, 0);
-}
-
-int SCSCL::LockEprom(u8 ID)
-{
-	return writeByte(ID, SCSCL_LOCK, 1);
-}
-
-int SCSCL::FeedBack(int ID)
-{
-	int nLen = Read(ID, SCSCL_PRESENT_POSITION_L, Mem, sizeof(Mem));
-	if(nLen!=sizeof(Mem)){
-		Err = 1;
-		return -1;
-	}
-	Err = 0;
-	return nLen;
-}
-	
-int SCSCL::ReadPos(int ID)
-{
-	int Pos = -1;
-	if(ID==-1){
-		Pos = Mem[SCSCL_PRESENT_POSITION_L-SCSCL_PRESENT_POSITION_L];
-		Pos <<= 8;
-		Pos |= Mem[SCSCL_PRESENT_POSITION_H-SCSCL_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Pos = readWord(ID, SCSCL_PRESENT_POSITION_L);
-		if(Pos==-1){
-			Err = 1;
-		}
-	}
-	return Pos;
-}
-
-int SCSCL::ReadSpeed(int ID)
-{
-	int Speed = -1;
-	if(ID==-1){
-		Speed = Mem[SCSCL_PRESENT_SPEED_L-SCSCL_PRESENT_POSITION_L];
-		Speed <<= 8;
-		Speed |= Mem[SCSCL_PRESENT_SPEED_H-SCSCL_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Speed = readWord(ID, SCSCL_PRESENT_SPEED_L);
-		if(Speed==-1){
-			Err = 1;
-			return -1;
-		}
-	}
-	if(!Err && (Speed&(1<<15))){
-		Speed = -(Speed&~(1<<15));
-	}	
-	return Speed;
-}
-
-int SCSCL::ReadLoad(int ID)
-{
-	int Load = -1;
-	if(ID==-1){
-		Load = Mem[SCSCL_PRESENT_LOAD_L-SCSCL_PRESENT_POSITION_L];
-		Load <<= 8;
-		Load |= Mem[SCSCL_PRESENT_LOAD_H-SCSCL_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Load = readWord(ID, SCSCL_PRESENT_LOAD_L);
-		if(Load==-1){
-			Err = 1;
-		}
-	}
-	if(!Err && (Load&(1<<10))){
-		Load = -(Load&~(1<<10));
-	}	
-	return Load;
-}
-
-int SCSCL::ReadVoltage(int ID)
-{
-	int Voltage = -1;
-	if(ID==-1){
-		Voltage = Mem[SCSCL_PRESENT_VOLTAGE-SCSCL_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Voltage = readByte(ID, SCSCL_PRESENT_VOLTAGE);
-		if(Voltage==-1){
-			Err = 1;
-		}
-	}
-	return Voltage;
-}
-
-int SCSCL::ReadTemper(int ID)
-{
-	int Temper = -1;
-	if(ID==-1){
-		Temper = Mem[SCSCL_PRESENT_TEMPERATURE-SCSCL_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Temper = readByte(ID, SCSCL_PRESENT_TEMPERATURE);
-		if(Temper==-1){
-			Err = 1;
-		}
-	}
-	return Temper;
-}
-
-int SCSCL::ReadMove(int ID)
-{
-	int Move = -1;
-	if(ID==-1){
-		Move = Mem[SCSCL_MOVING-SCSCL_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Move = readByte(ID, SCSCL_MOVING);
-		if(Move==-1){
-			Err = 1;
-		}
-	}
-	return Move;
-}
-
-int SCSCL::ReadCurrent(int ID)
-{
-	int Current = -1;
-	if(ID==-1){
-		Current = Mem[SCSCL_PRESENT_CURRENT_L-SCSCL_PRESENT_POSITION_L];
-		Current <<= 8;
-		Current |= Mem[SCSCL_PRESENT_CURRENT_H-SCSCL_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Current = readWord(ID, SCSCL_PRESENT_CURRENT_L);
-		if(Current==-1){
-			Err = 1;
-			return -1;
-		}
-	}
-	if(!Err && (Current&(1<<15))){
-		Current = -(Current&~(1<<15));
-	}	
-	return Current;
-}
\ No newline at end of file
+﻿/*
+ * SCSCL.cpp
+ * 飞特SCSCL系列串行舵机应用层程序
+ * 日期: 2020.6.17
+ * 作者: 
+ */
+
+#include "SCSCL.h"
+
+SCSCL::SCSCL()
+{
+	End = 1;
+	FeedBackUs = 0;
+}
+
+SCSCL::SCSCL(u8 End):SCSerial(End)
+{
+	FeedBackUs = 0;
+}
+
+SCSCL::SCSCL(u8 End, u8 Level):SCSerial(End, Level)
+{
+	FeedBackUs = 0;
+}
+
+int SCSCL::WritePos(u8 ID, u16 Position, u16 Time, u16 Speed)
+{
+	u8 bBuf[6];
+	SCSCL_Map::Order::put16(bBuf+0, Position);
+	SCSCL_Map::Order::put16(bBuf+2, Time);
+	SCSCL_Map::Order::put16(bBuf+4, Speed);
+	
+	return genWrite(ID, SCSCL_GOAL_POSITION_L, bBuf, 6);
+}
+
+int SCSCL::RegWritePos(u8 ID, u16 Position, u16 Time, u16 Speed)
+{
+	u8 bBuf[6];
+	SCSCL_Map::Order::put16(bBuf+0, Position);
+	SCSCL_Map::Order::put16(bBuf+2, Time);
+	SCSCL_Map::Order::put16(bBuf+4, Speed);
+	
+	return regWrite(ID, SCSCL_GOAL_POSITION_L, bBuf, 6);
+}
+
+void SCSCL::SyncWritePos(const u8 ID[], u8 IDN, const u16 Position[], const u16 Time[], const u16 Speed[])
+{
+	typedef SCSCL_Map M;
+	typedef SCSRegBlock<M::GoalPosition, M::GoalSpeed> Blk;
+	if(IDN>SCS_SYNC_WRITE_IDS){
+		return;
+	}
+	u8 *p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=Blk::len){
+		Blk::set<M::GoalPosition, M::End>(p, Position[i]);
+		Blk::set<M::GoalTime, M::End>(p, Time ? Time[i] : 0);
+		Blk::set<M::GoalSpeed, M::End>(p, Speed ? Speed[i] : 0);
+	}
+	syncWrite(ID, IDN, Blk::addr, syncWriteBuf, Blk::len);
+}
+
+int SCSCL::PWMMode(u8 ID)
+{
+	u8 bBuf[4];
+	bBuf[0] = 0;
+	bBuf[1] = 0;
+	bBuf[2] = 0;
+	bBuf[3] = 0;
+	return genWrite(ID, SCSCL_MIN_ANGLE_LIMIT_L, bBuf, 4);	
+}
+
+int SCSCL::WritePWM(u8 ID, s16 pwmOut)
+{
+	if(pwmOut<0){
+		pwmOut = -pwmOut;
+		pwmOut |= (1<<10);
+	}
+	u8 bBuf[2];
+	SCSCL_Map::Order::put16(bBuf+0, pwmOut);
+	
+	return genWrite(ID, SCSCL_GOAL_TIME_L, bBuf, 2);
+}
+
+int SCSCL::EnableTorque(u8 ID, u8 Enable)
+{
+	return writeByte(ID, SCSCL_TORQUE_ENABLE, Enable);
+}
+
+int SCSCL::unLockEprom(u8 ID)
+{
+	return writeByte(ID, SCSCL_LOCK, 0);
+}
+
+int SCSCL::LockEprom(u8 ID)
+{
+	return writeByte(ID, SCSCL_LOCK, 1);
+}
+
+int SCSCL::RebaudAll(int baudRate)
+{
+	return rebaudAll(baudRate, SCSCL_BAUD_RATE, SCSCL_LOCK);
+}
+
+int SCSCL::FeedBack(int ID)
+{
+	SCSLock Guard(this);//Mem and FeedBackUs change together
+	int nLen = Read(ID, SCSCL_PRESENT_POSITION_L, Mem, sizeof(Mem));
+	if(nLen!=sizeof(Mem)){
+		Err = 1;
+		return -1;
+	}
+	Err = 0;
+	FeedBackUs = RxStamp;
+	return nLen;
+}
+	
+int SCSCL::ReadPos(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentPosition>(ID, Mem);
+}
+
+int SCSCL::ReadSpeed(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentSpeed>(ID, Mem);
+}
+
+int SCSCL::ReadLoad(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentLoad>(ID, Mem);
+}
+
+int SCSCL::ReadVoltage(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentVoltage>(ID, Mem);
+}
+
+int SCSCL::ReadTemper(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentTemperature>(ID, Mem);
+}
+
+int SCSCL::ReadMove(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::Moving>(ID, Mem);
+}
+
+int SCSCL::ReadCurrent(int ID)
+{
+	return readReg<SCSCL_Map, SCSCL_Map::PresentCurrent>(ID, Mem);
+}
+
+int SCSCL::SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[])
+{
+	return syncFeedBack<SCSCL_Map>(ID, IDN, Tel);
+}
+
+int SCSCL::FeedBack(int ID, Telemetry *Tel)
+{
+	return feedBack<SCSCL_Map>(ID, Tel);
+}
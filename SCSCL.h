@@ -1,87 +1,120 @@
-﻿/*
- * SCSCL.h
- * 飞特SCSCL系列串行舵机应用层程序
- * 日期: 2020.6.17
- * 作者: 
- */
-
-#ifndef _SCSCL_H
-#define _SCSCL_H
-
-
-#define	SCSCL_1M 0
-#define	SCSCL_0_5M 1
-#define	SCSCL_250K 2
-#define	SCSCL_128K 3
-#define	SCSCL_115200 4
-#define	SCSCL_76800	5
-#define	SCSCL_57600	6
-#define	SCSCL_38400	7
-
-//内存表定义
-//-------EPROM(只读)--------
-#define SCSCL_VERSION_L 3
-#define SCSCL_VERSION_H 4
-
-//-------EPROM(读写)--------
-#define SCSCL_ID 5
-#define SCSCL_BAUD_RATE 6
-#define SCSCL_MIN_ANGLE_LIMIT_L 9
-#define SCSCL_MIN_ANGLE_LIMIT_H 10
-#define SCSCL_MAX_ANGLE_LIMIT_L 11
-#define SCSCL_MAX_ANGLE_LIMIT_H 12
-#define SCSCL_CW_DEAD 26
-#define SCSCL_CCW_DEAD 27
-
-//-------SRAM(读写)--------
-#define SCSCL_TORQUE_ENABLE 40
-#define SCSCL_GOAL_POSITION_L 42
-#define SCSCL_GOAL_POSITION_H 43
-#define SCSCL_GOAL_TIME_L 44
-#define SCSCL_GOAL_TIME_H 45
-#define SCSCL_GOAL_SPEED_L 46
-#define SCSCL_GOAL_SPEED_H 47
-#define SCSCL_LOCK 48
-
-//-------SRAM(只读)--------
-#define SCSCL_PRESENT_POSITION_L 56
-#define SCSCL_PRESENT_POSITION_H 57
-#define SCSCL_PRESENT_SPEED_L 58
-#define SCSCL_PRESENT_SPEED_H 59
-#define SCSCL_PRESENT_LOAD_L 60
-#define SCSCL_PRESENT_LOAD_H 61
-#define SCSCL_PRESENT_VOLTAGE 62
-#define SCSCL_PRESENT_TEMPERATURE 63
-#define SCSCL_MOVING 66
-#define SCSCL_PRESENT_CURRENT_L 69
-#define SCSCL_PRESENT_CURRENT_H 70
-
-#include "SCSerial.h"
-
-class SCSCL : public SCSerial
-{
-public:
-	SCSCL();
-	SCSCL(u8 End);
-	SCSCL(u8 End, u8 Level);
-	virtual int WritePos(u8 ID, u16 Position, u16 Time, u16 Speed = 0);//普通写单个舵机位置指令
-	virtual int RegWritePos(u8 ID, u16 Position, u16 Time, u16 Speed = 0);//异步写单个舵机位置指令(RegWriteAction生效)
-	virtual void SyncWritePos(u8 ID[], u8 IDN, u16 Position[], u16 Time[], u16 Speed[]);//同步写多个舵机位置指令
-	virtual int PWMMode(u8 ID);//PWM输出模式
-	virtual int WritePWM(u8 ID, s16 pwmOut);//PWM输出模式指令
-	virtual int EnableTorque(u8 ID, u8 Enable);//扭矩控制指令
-	virtual int unLockEprom(u8 ID);//eprom解锁
-	virtual int LockEprom(u8 ID);//eprom加锁
-	virtual int FeedBack(int ID);//反馈舵机信息
-	virtual int ReadPos(int ID);//读位置
-	virtual int ReadSpeed(int ID);//读速度
-	virtual int ReadLoad(int ID);//读输出至电机的电压百分比(0~1000)
-	virtual int ReadVoltage(int ID);//读电压
-	virtual int ReadTemper(int ID);//读温度
-	virtual int ReadMove(int ID);//读移动状态
-	virtual int ReadCurrent(int ID);//读电流
-private:
-	u8 Mem[SCSCL_PRESENT_CURRENT_H-SCSCL_PRESENT_POSITION_L+1];
-};
-
+﻿/*
+ * SCSCL.h
+ * 飞特SCSCL系列串行舵机应用层程序
+ * 日期: 2020.6.17
+ * 作者: 
+ */
+
+#ifndef _SCSCL_H
+#define _SCSCL_H
+
+
+#define	SCSCL_1M 0
+#define	SCSCL_0_5M 1
+#define	SCSCL_250K 2
+#define	SCSCL_128K 3
+#define	SCSCL_115200 4
+#define	SCSCL_76800	5
+#define	SCSCL_57600	6
+#define	SCSCL_38400	7
+
+//内存表定义
+//-------EPROM(只读)--------
+#define SCSCL_VERSION_L 3
+#define SCSCL_VERSION_H 4
+
+//-------EPROM(读写)--------
+#define SCSCL_ID 5
+#define SCSCL_BAUD_RATE 6
+#define SCSCL_MIN_ANGLE_LIMIT_L 9
+#define SCSCL_MIN_ANGLE_LIMIT_H 10
+#define SCSCL_MAX_ANGLE_LIMIT_L 11
+#define SCSCL_MAX_ANGLE_LIMIT_H 12
+#define SCSCL_CW_DEAD 26
+#define SCSCL_CCW_DEAD 27
+
+//-------SRAM(读写)--------
+#define SCSCL_TORQUE_ENABLE 40
+#define SCSCL_GOAL_POSITION_L 42
+#define SCSCL_GOAL_POSITION_H 43
+#define SCSCL_GOAL_TIME_L 44
+#define SCSCL_GOAL_TIME_H 45
+#define SCSCL_GOAL_SPEED_L 46
+#define SCSCL_GOAL_SPEED_H 47
+#define SCSCL_LOCK 48
+
+//-------SRAM(只读)--------
+#define SCSCL_PRESENT_POSITION_L 56
+#define SCSCL_PRESENT_POSITION_H 57
+#define SCSCL_PRESENT_SPEED_L 58
+#define SCSCL_PRESENT_SPEED_H 59
+#define SCSCL_PRESENT_LOAD_L 60
+#define SCSCL_PRESENT_LOAD_H 61
+#define SCSCL_PRESENT_VOLTAGE 62
+#define SCSCL_PRESENT_TEMPERATURE 63
+#define SCSCL_MOVING 66
+#define SCSCL_PRESENT_CURRENT_L 69
+#define SCSCL_PRESENT_CURRENT_H 70
+
+#include "SCSerial.h"
+
+//Control table of the series, End is the fixed byte order of the model
+struct SCSCL_Map{
+	enum{ End = 1 };
+	typedef SCSByteOrder<End> Order;
+	typedef SCSCL_Map Map;
+	typedef SCSReg<SCSCL_VERSION_L, 2, 0, SCS_REG_R|SCS_REG_EPROM> Version;
+	typedef SCSReg<SCSCL_ID, 1, 0, SCS_REG_RW|SCS_REG_EPROM> ID;
+	typedef SCSReg<SCSCL_BAUD_RATE, 1, 0, SCS_REG_RW|SCS_REG_EPROM> BaudRate;
+	typedef SCSReg<SCSCL_MIN_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MinAngleLimit;
+	typedef SCSReg<SCSCL_MAX_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MaxAngleLimit;
+	typedef SCSReg<SCSCL_CW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CwDead;
+	typedef SCSReg<SCSCL_CCW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CcwDead;
+	typedef SCSReg<SCSCL_TORQUE_ENABLE, 1> TorqueEnable;
+	typedef SCSReg<SCSCL_GOAL_POSITION_L, 2, 0> GoalPosition;
+	typedef SCSReg<SCSCL_GOAL_TIME_L, 2, 10> GoalTime;//PWM in open-loop mode
+	typedef SCSReg<SCSCL_GOAL_SPEED_L, 2, 15> GoalSpeed;
+	typedef SCSReg<SCSCL_LOCK, 1> Lock;
+	typedef SCSReg<SCSCL_PRESENT_POSITION_L, 2, 0, SCS_REG_R> PresentPosition;
+	typedef SCSReg<SCSCL_PRESENT_SPEED_L, 2, 15, SCS_REG_R> PresentSpeed;
+	typedef SCSReg<SCSCL_PRESENT_LOAD_L, 2, 10, SCS_REG_R> PresentLoad;
+	typedef SCSReg<SCSCL_PRESENT_VOLTAGE, 1, 0, SCS_REG_R> PresentVoltage;
+	typedef SCSReg<SCSCL_PRESENT_TEMPERATURE, 1, 0, SCS_REG_R> PresentTemperature;
+	typedef SCSReg<SCSCL_MOVING, 1, 0, SCS_REG_R> Moving;
+	typedef SCSReg<SCSCL_PRESENT_CURRENT_L, 2, 15, SCS_REG_R> PresentCurrent;
+	typedef SCSRegBlock<PresentPosition, PresentCurrent> FeedBack;//block read by FeedBack() into Mem
+};
+
+class SCSCL : public SCSerial
+{
+public:
+	typedef SCSCL_Map Map;//control table, see SCSRegMap.h
+	SCSCL();
+	SCSCL(u8 End);
+	SCSCL(u8 End, u8 Level);
+	virtual int WritePos(u8 ID, u16 Position, u16 Time, u16 Speed = 0);//普通写单个舵机位置指令
+	virtual int RegWritePos(u8 ID, u16 Position, u16 Time, u16 Speed = 0);//异步写单个舵机位置指令(RegWriteAction生效)
+	virtual void SyncWritePos(const u8 ID[], u8 IDN, const u16 Position[], const u16 Time[], const u16 Speed[]);//同步写多个舵机位置指令
+	virtual int PWMMode(u8 ID);//PWM输出模式
+	virtual int WritePWM(u8 ID, s16 pwmOut);//PWM输出模式指令
+	virtual int EnableTorque(u8 ID, u8 Enable);//扭矩控制指令
+	virtual int unLockEprom(u8 ID);//eprom解锁
+	virtual int LockEprom(u8 ID);//eprom加锁
+	virtual int RebaudAll(int baudRate);//move all servos, whatever their current rate, to baudRate
+	virtual int FeedBack(int ID);//反馈舵机信息
+	virtual int FeedBack(int ID, Telemetry *Tel);//feedback into Tel instead of Mem, safe from several threads, returns -1 on timeout
+	virtual int ReadPos(int ID);//读位置
+	virtual int ReadSpeed(int ID);//读速度
+	virtual int ReadLoad(int ID);//读输出至电机的电压百分比(0~1000)
+	virtual int ReadVoltage(int ID);//读电压
+	virtual int ReadTemper(int ID);//读温度
+	virtual int ReadMove(int ID);//读移动状态
+	virtual int ReadCurrent(int ID);//读电流
+	u64 getFeedBackUs(){  return FeedBackUs;  }//arrival of the FeedBack() data, 0 if unknown
+	virtual int SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[]);//feedback of IDN servos from one SyncRead (pipelined reads without firmware support) into Tel[0..IDN-1], returns number of valid entries
+private:
+	u8 Mem[SCSCL_PRESENT_CURRENT_H-SCSCL_PRESENT_POSITION_L+1];
+	u64 FeedBackUs;//arrival of the status packet FeedBack() decoded into Mem, monotonic us, 0 if unknown
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * SCSCalib.cpp
+ * Midpoint calibration of a group of SMS/STS servos with sync writes and one verifying SyncRead
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "SCSCalib.h"
+
+typedef SMS_STS_Map M;
+
+template<class Reg> static int calibGet(const u8 *Img)
+{
+	return SCSField<Reg, M::End>::decode(Img+Reg::addr-SCS_CALIB_ADDR);
+}
+
+SCSCalib::SCSCalib(SMS_STS *bus)
+{
+	this->bus = bus;
+	Tolerance = 8;
+	SettleUs = SCSERIAL_EEPROM_US;
+	N = 0;
+	Packets = 0;
+	Us = 0;
+}
+
+int SCSCalib::setServos(const u8 ID[], u8 IDN)
+{
+	N = 0;
+	for(u8 i=0; i<IDN && N<SCS_CALIB_SERVOS; i++){
+		if(ID[i]<0xfe){
+			this->ID[N] = ID[i];
+			memset(R+N, 0, sizeof(R[N]));
+			R[N].ID = ID[i];
+			N++;
+		}
+	}
+	return N;
+}
+
+int SCSCalib::readImage(u8 (*Img)[SCS_CALIB_LEN], u8 Got[])
+{
+	bus->syncReadBegin(N, SCS_CALIB_LEN, rxBuff);
+	bus->syncReadPacketTx(ID, N, SCS_CALIB_ADDR, SCS_CALIB_LEN);
+	bus->syncReadPacketRxAll(rxTab, 0xfe);
+	bus->syncReadEnd();
+	Packets++;
+	int Num = 0;
+	for(u8 i=0; i<N; i++){
+		Got[i] = rxTab[ID[i]].Valid;
+		if(Got[i]){
+			memcpy(Img[i], rxTab[ID[i]].Dat, SCS_CALIB_LEN);
+			Num++;
+		}
+	}
+	return Num;
+}
+
+int SCSCalib::run()
+{
+	u64 t0 = SCSerial::monoUs();
+	Packets = 0;
+	u8 Img[SCS_CALIB_SERVOS][SCS_CALIB_LEN];
+	u8 Got[SCS_CALIB_SERVOS];
+	if(!N || !readImage(Img, Got)){
+		Us = (u32)(SCSerial::monoUs()-t0);
+		return -1;
+	}
+	u8 Cal[SCS_CALIB_SERVOS];
+	u8 Switch[SCS_CALIB_SERVOS];
+	u8 CalN = 0;
+	u8 SwitchN = 0;
+	for(u8 i=0; i<N; i++){
+		SCSCalibResult *r = R+i;
+		if(!Got[i]){
+			r->Result = SCS_CALIB_ABSENT;
+			continue;
+		}
+		r->OfsBefore = calibGet<M::Ofs>(Img[i]);
+		r->Mode = calibGet<M::Mode>(Img[i]);
+		r->PosBefore = calibGet<M::PresentPosition>(Img[i]);
+		if(r->Mode!=SMS_STS_MODE_SERVO){
+			Switch[SwitchN++] = ID[i];
+		}
+		Cal[CalN++] = ID[i];
+	}
+	if(SwitchN){
+		bus->SyncMode(Switch, SwitchN, SMS_STS_MODE_SERVO);
+		Packets += 3;
+	}
+	u8 Val[SCS_CALIB_SERVOS];
+	memset(Val, 128, CalN);
+	bus->syncWrite(Cal, CalN, SMS_STS_TORQUE_ENABLE, Val, 1);
+	Packets++;
+	usleep(SettleUs);
+	u8 Before[SCS_CALIB_SERVOS];
+	memcpy(Before, Got, N);
+	readImage(Img, Got);
+	int Num = 0;
+	for(u8 i=0; i<N; i++){
+		SCSCalibResult *r = R+i;
+		if(!Before[i]){
+			continue;
+		}
+		if(!Got[i]){
+			r->Result = SCS_CALIB_NOREPLY;
+			continue;
+		}
+		r->Ofs = calibGet<M::Ofs>(Img[i]);
+		r->Pos = calibGet<M::PresentPosition>(Img[i]);
+		int d = r->Pos-SCS_CALIB_MID;
+		if(d<=Tolerance && d>=-(int)Tolerance){
+			r->Result = SCS_CALIB_OK;
+			Num++;
+		}else{
+			r->Result = SCS_CALIB_MISMATCH;
+		}
+	}
+	Us = (u32)(SCSerial::monoUs()-t0);
+	return Num;
+}
@@ -0,0 +1,61 @@
+/*
+ * SCSCalib.h
+ * Midpoint calibration of a group of SMS/STS servos with sync writes and one verifying SyncRead
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCALIB_H
+#define _SCSCALIB_H
+
+#include "SMS_STS.h"
+
+#define SCS_CALIB_SERVOS 32//servos of one calibration run
+#define SCS_CALIB_ADDR SMS_STS_OFS_L//image read before and after, Ofs..present position
+#define SCS_CALIB_LEN (SMS_STS_PRESENT_POSITION_H-SMS_STS_OFS_L+1)
+#define SCS_CALIB_MID 2048//present position after the calibration
+
+//SCSCalibResult::Result
+#define SCS_CALIB_ABSENT 0//no reply before the calibration
+#define SCS_CALIB_OK 1//present position within Tolerance of SCS_CALIB_MID
+#define SCS_CALIB_MISMATCH 2//answered, position off the midpoint
+#define SCS_CALIB_NOREPLY 3//answered before, not after
+
+struct SCSCalibResult{
+	u8 ID;
+	u8 Result;//SCS_CALIB_*
+	u8 Mode;//mode found before, servos not in mode 0 are switched
+	s16 OfsBefore;
+	s16 PosBefore;
+	s16 Ofs;//offset written by the servo
+	s16 Pos;
+};
+
+//run() reads Ofs, Mode and present position of the group with one
+//SyncRead, switches the servos not in servo mode with SyncMode() (one
+//unlock, one mode and one lock sync write), starts the calibration of
+//all of them with one sync write of SMS_STS_TORQUE_ENABLE = 128, waits
+//SettleUs and verifies with a second SyncRead. Four to seven packets
+//for the group instead of two acknowledged writes per servo.
+class SCSCalib{
+public:
+	SCSCalib(SMS_STS *bus);
+	int setServos(const u8 ID[], u8 IDN);//returns servos set, at most SCS_CALIB_SERVOS
+	int run();//returns servos calibrated and verified, -1 if none answered
+public:
+	u16 Tolerance;//steps off SCS_CALIB_MID accepted (default 8)
+	u32 SettleUs;//wait before the read-back (default SCSERIAL_EEPROM_US)
+	u8 N;
+	SCSCalibResult R[SCS_CALIB_SERVOS];
+	u32 Packets;//instruction packets of the last run()
+	u32 Us;//duration of the last run()
+private:
+	int readImage(u8 (*Img)[SCS_CALIB_LEN], u8 Got[]);
+private:
+	SMS_STS *bus;
+	u8 ID[SCS_CALIB_SERVOS];
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_CALIB_SERVOS*(SCS_CALIB_LEN+6)];
+};
+
+#endif
@@ -0,0 +1,348 @@
+/*
+ * SCSCapture.cpp
+ * Bus traffic capture to a pcap file and a replay transport for captured sessions
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "SCSCapture.h"
+#include "SCSerial.h"
+
+#define CAP_HDR 12//ring record header: u16 length, dir, inst, u64 time
+
+//on-disk layout, u32/s32 are long and 8 bytes on LP64
+struct pcapFileHdr{
+	uint32_t Magic;
+	uint16_t Major;
+	uint16_t Minor;
+	int32_t Zone;
+	uint32_t SigFigs;
+	uint32_t SnapLen;
+	uint32_t LinkType;
+};
+
+struct pcapRecHdr{
+	uint32_t Sec;
+	uint32_t Usec;
+	uint32_t InclLen;
+	uint32_t OrigLen;
+};
+
+static_assert(sizeof(pcapFileHdr)==24, "pcap file header must be 24 bytes");
+static_assert(sizeof(pcapRecHdr)==16, "pcap record header must be 16 bytes");
+
+SCSCapture::SCSCapture()
+{
+	Head = 0;
+	Tail = 0;
+	LastInst = 0;
+	File = NULL;
+	PeriodUs = 10000;
+	Running = 0;
+	Started = 0;
+	Records = 0;
+	Dropped = 0;
+	WriteErrors = 0;
+}
+
+SCSCapture::~SCSCapture()
+{
+	close();
+}
+
+bool SCSCapture::open(const char *path)
+{
+	close();
+	File = fopen(path, "wb");
+	if(!File){
+		return false;
+	}
+	struct pcapFileHdr h = {0xa1b2c3d4, 2, 4, 0, 0, SCS_CAP_FRAME+2, SCS_CAP_LINKTYPE};
+	if(fwrite(&h, sizeof(h), 1, File)!=1){
+		fclose(File);
+		File = NULL;
+		return false;
+	}
+	WriteErrors = 0;
+	return true;
+}
+
+void SCSCapture::close()
+{
+	stop();
+	if(File){
+		drain();
+		fclose(File);
+		File = NULL;
+	}
+}
+
+void SCSCapture::add(u8 Dir, const u8 *nDat, int nLen, u64 Us)
+{
+	struct iovec iov;
+	iov.iov_base = (void*)nDat;
+	iov.iov_len = nLen;
+	add(Dir, &iov, 1, Us);
+}
+
+void SCSCapture::add(u8 Dir, const struct iovec *iov, int iovcnt, u64 Us)
+{
+	u32 Len = 0;
+	for(int i=0; i<iovcnt; i++){
+		Len += iov[i].iov_len;
+	}
+	if(Len>SCS_CAP_FRAME){
+		Len = SCS_CAP_FRAME;
+	}
+	if(!Len){
+		return;
+	}
+	u32 H = Head;
+	u32 T = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+	if(CAP_HDR+Len>SCS_CAP_RING-(H-T)){
+		Dropped++;
+		return;
+	}
+	if(Dir==SCS_CAP_TX){
+		int i = 0;
+		while(i<iovcnt-1 && !iov[i].iov_len){
+			i++;
+		}
+		const u8 *f = (const u8*)iov[i].iov_base;
+		if(iov[i].iov_len>=5 && f[0]==0xff && f[1]==0xff){
+			LastInst = f[4];
+		}
+	}
+	u8 Hdr[CAP_HDR];
+	Hdr[0] = Len&0xff;
+	Hdr[1] = Len>>8;
+	Hdr[2] = Dir;
+	Hdr[3] = LastInst;
+	memcpy(Hdr+4, &Us, 8);
+	for(u32 i=0; i<CAP_HDR; i++){
+		Ring[(H++)&(SCS_CAP_RING-1)] = Hdr[i];
+	}
+	u32 Left = Len;
+	for(int i=0; i<iovcnt && Left; i++){
+		const u8 *p = (const u8*)iov[i].iov_base;
+		for(u32 j=0; j<iov[i].iov_len && Left; j++, Left--){
+			Ring[(H++)&(SCS_CAP_RING-1)] = p[j];
+		}
+	}
+	__atomic_store_n(&Head, H, __ATOMIC_RELEASE);
+}
+
+int SCSCapture::drain()
+{
+	int Num = 0;
+	u32 H = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+	u32 T = Tail;
+	u8 Buf[2+SCS_CAP_FRAME];
+	while(T!=H){
+		u8 Hdr[CAP_HDR];
+		for(u32 i=0; i<CAP_HDR; i++){
+			Hdr[i] = Ring[(T++)&(SCS_CAP_RING-1)];
+		}
+		u32 Len = Hdr[0]|(Hdr[1]<<8);
+		u64 Us;
+		memcpy(&Us, Hdr+4, 8);
+		Buf[0] = Hdr[2];
+		Buf[1] = Hdr[3];
+		for(u32 i=0; i<Len; i++){
+			Buf[2+i] = Ring[(T++)&(SCS_CAP_RING-1)];
+		}
+		if(File && WriteErrors){
+			WriteErrors++;
+		}else if(File){
+			struct pcapRecHdr r = {(uint32_t)(Us/1000000), (uint32_t)(Us%1000000), (uint32_t)(Len+2), (uint32_t)(Len+2)};
+			if(fwrite(&r, sizeof(r), 1, File)!=1 || fwrite(Buf, Len+2, 1, File)!=1){
+				WriteErrors++;//a short record ends the file, later ones would not parse
+				continue;
+			}
+			Records++;
+			Num++;
+		}
+	}
+	__atomic_store_n(&Tail, T, __ATOMIC_RELEASE);
+	if(Num && fflush(File)!=0){
+		Records -= Num;//still buffered, lost with the flush
+		WriteErrors += Num;
+		Num = 0;
+	}
+	return Num;
+}
+
+void *SCSCapture::thread(void *arg)
+{
+	SCSCapture *c = (SCSCapture*)arg;
+	while(c->Running){
+		c->drain();
+		struct timespec ts;
+		ts.tv_sec = c->PeriodUs/1000000;
+		ts.tv_nsec = (c->PeriodUs%1000000)*1000;
+		nanosleep(&ts, NULL);
+	}
+	return NULL;
+}
+
+int SCSCapture::start(u32 periodUs)
+{
+	if(Started || !File){
+		return 0;
+	}
+	PeriodUs = periodUs;
+	Running = 1;
+	if(pthread_create(&Thread, NULL, thread, this)!=0){
+		Running = 0;
+		return 0;
+	}
+	Started = 1;
+	return 1;
+}
+
+void SCSCapture::stop()
+{
+	if(Started){
+		Running = 0;
+		pthread_join(Thread, NULL);
+		Started = 0;
+	}
+}
+
+int SCSCapture::load(const char *path, SCSCapRecord *Rec, int maxRec)
+{
+	FILE *f = fopen(path, "rb");
+	if(!f){
+		return -1;
+	}
+	struct pcapFileHdr h;
+	if(fread(&h, sizeof(h), 1, f)!=1 || h.Magic!=0xa1b2c3d4 || h.LinkType!=SCS_CAP_LINKTYPE){
+		fclose(f);
+		return -1;
+	}
+	int n = 0;
+	struct pcapRecHdr r;
+	while(n<maxRec && fread(&r, sizeof(r), 1, f)==1){
+		u8 Buf[2+SCS_CAP_FRAME];
+		if(r.InclLen<2 || r.InclLen>sizeof(Buf) || fread(Buf, r.InclLen, 1, f)!=1){
+			break;
+		}
+		Rec[n].Us = (u64)r.Sec*1000000+r.Usec;
+		Rec[n].Dir = Buf[0];
+		Rec[n].Inst = Buf[1];
+		Rec[n].Len = r.InclLen-2;
+		memcpy(Rec[n].Dat, Buf+2, Rec[n].Len);
+		n++;
+	}
+	fclose(f);
+	return n;
+}
+
+SCSReplayTransport::SCSReplayTransport()
+{
+	Rec = NULL;
+	RecN = 0;
+	Own = 0;
+	Writes = 0;
+	Mismatches = 0;
+	rewind();
+}
+
+SCSReplayTransport::~SCSReplayTransport()
+{
+	close();
+}
+
+#ifndef SCS_STATIC_ALLOC
+bool SCSReplayTransport::open(const char *path, int maxRec)
+{
+	SCSCapRecord *r = (SCSCapRecord*)malloc(maxRec*sizeof(SCSCapRecord));
+	if(!r){
+		close();
+		return false;
+	}
+	if(!open(path, r, maxRec)){
+		free(r);
+		return false;
+	}
+	Own = 1;
+	return true;
+}
+#endif
+
+bool SCSReplayTransport::open(const char *path, SCSCapRecord *Rec, int maxRec)
+{
+	close();
+	this->Rec = Rec;
+	RecN = SCSCapture::load(path, Rec, maxRec);
+	if(RecN<0){
+		close();
+		return false;
+	}
+	rewind();
+	return true;
+}
+
+void SCSReplayTransport::close()
+{
+#ifndef SCS_STATIC_ALLOC
+	if(Own){
+		free(Rec);
+	}
+#endif
+	Rec = NULL;
+	RecN = 0;
+	Own = 0;
+}
+
+void SCSReplayTransport::rewind()
+{
+	Next = 0;
+	rxPos = 0;
+	rxLen = 0;
+	Writes = 0;
+	Mismatches = 0;
+}
+
+int SCSReplayTransport::write(const u8 *nDat, int nLen)
+{
+	Writes++;
+	rxPos = rxLen = 0;
+	while(Next<RecN && Rec[Next].Dir!=SCS_CAP_TX){
+		Next++;
+	}
+	if(Next>=RecN){
+		Mismatches++;
+		return nLen;
+	}
+	SCSCapRecord *r = Rec+(Next++);
+	if(r->Len!=nLen || memcmp(r->Dat, nDat, nLen)!=0){
+		Mismatches++;
+	}
+	while(Next<RecN && Rec[Next].Dir==SCS_CAP_RX){
+		r = Rec+(Next++);
+		if(rxLen+r->Len<=(int)sizeof(rxBuf)){
+			memcpy(rxBuf+rxLen, r->Dat, r->Len);
+			rxLen += r->Len;
+		}
+	}
+	return nLen;
+}
+
+//never waits: the whole captured reply is there once write() returns,
+//a reply missing from the capture reads as an immediate timeout
+int SCSReplayTransport::read(u8 *nDat, int nLen, long)
+{
+	int n = rxLen-rxPos;
+	if(n>nLen){
+		n = nLen;
+	}
+	RxFirstUs = n>0 ? SCSerial::monoUs() : 0;
+	memcpy(nDat, rxBuf+rxPos, n);
+	rxPos += n;
+	return n;
+}
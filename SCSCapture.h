@@ -0,0 +1,100 @@
+/*
+ * SCSCapture.h
+ * Bus traffic capture to a pcap file and a replay transport for captured sessions
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCAPTURE_H
+#define _SCSCAPTURE_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include "SCSTransport.h"
+
+#ifndef SCS_CAP_RING
+#define SCS_CAP_RING 65536//bytes of the capture ring, power of 2
+#endif
+#define SCS_CAP_FRAME 1024//largest frame recorded, longer ones are truncated
+#define SCS_CAP_TX 0
+#define SCS_CAP_RX 1
+#define SCS_CAP_LINKTYPE 147//pcap LINKTYPE_USER0
+
+//Each record in the file is one pcap packet whose data is a two byte
+//pseudo header (direction SCS_CAP_TX/RX, instruction of the request it
+//belongs to) followed by the raw bytes as they went over the line.
+struct SCSCapRecord{
+	u64 Us;//monotonic time, first byte for RX
+	u8 Dir;
+	u8 Inst;
+	u16 Len;
+	u8 Dat[SCS_CAP_FRAME];
+};
+
+//The bus thread adds records into a lock-free single producer ring and
+//never blocks. A writer thread (start()) or the application (drain())
+//moves them to the file. Records that find the ring full are dropped
+//and counted.
+class SCSCapture{
+public:
+	SCSCapture();
+	~SCSCapture();
+	bool open(const char *path);//create the file and write the pcap header
+	void close();//drain the ring and close the file
+	int start(u32 periodUs = 10000);//drain from a background thread every periodUs
+	void stop();
+	int drain();//move buffered records to the file, returns records written
+	void add(u8 Dir, const struct iovec *iov, int iovcnt, u64 Us);//producer side
+	void add(u8 Dir, const u8 *nDat, int nLen, u64 Us);
+	static int load(const char *path, SCSCapRecord *Rec, int maxRec);//read a capture file back, returns records read or -1
+public:
+	u32 Records;//records written to the file
+	u32 Dropped;//records lost to a full ring
+	u32 WriteErrors;//records lost to a failed file write, nothing more is written to the file after the first
+private:
+	static void *thread(void *arg);
+private:
+	u8 Ring[SCS_CAP_RING];
+	u32 Head;
+	u32 Tail;
+	u8 LastInst;//instruction of the last TX frame, tags the replies
+	FILE *File;
+	u32 PeriodUs;
+	volatile int Running;
+	int Started;
+	pthread_t Thread;
+};
+
+//Plays a capture back to SCSerial::begin(SCSTransport*). Every write is
+//matched against the next captured TX frame (Mismatches counts the
+//differences), and the RX bytes captured after that frame become the
+//reply. No timing is reproduced, read() never waits, replays are
+//deterministic.
+class SCSReplayTransport : public SCSTransport{
+public:
+	SCSReplayTransport();
+	~SCSReplayTransport();
+#ifndef SCS_STATIC_ALLOC
+	bool open(const char *path, int maxRec = 4096);
+#endif
+	bool open(const char *path, SCSCapRecord *Rec, int maxRec);//load into caller storage
+	void rewind();
+	virtual int write(const u8 *nDat, int nLen);
+	virtual int read(u8 *nDat, int nLen, long timeOutUs);//returns the captured reply bytes at once, timeOutUs is not used
+	virtual void flush(){}//replies are queued after the request, nothing stale to drop
+	virtual void close();
+public:
+	u32 Writes;
+	u32 Mismatches;//written frames that differ from the capture
+	int RecN;
+	SCSCapRecord *Rec;
+private:
+	int Next;//next record to match
+	u8 Own;//Rec was allocated by open()
+	u8 rxBuf[SCS_CAP_RING];
+	int rxPos;
+	int rxLen;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * SCSChecksum.h
+ * Packet checksum kernels, SSE2/NEON byte sums with a scalar fallback
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCHECKSUM_H
+#define _SCSCHECKSUM_H
+
+#include "INST.h"
+
+//Define SCS_NO_SIMD to build the scalar loops only
+#if !defined(SCS_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define SCS_SUM_SSE2 1
+#elif !defined(SCS_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define SCS_SUM_NEON 1
+#endif
+
+struct SCSChecksum{
+	//8-bit sum of n bytes, 16 bytes per step with SIMD
+	static u8 sum(const u8 *p, int n)
+	{
+		u32 s = 0;
+		int i = 0;
+#if defined(SCS_SUM_SSE2)
+		if(n>=16){
+			__m128i Acc = _mm_setzero_si128();
+			const __m128i Zero = _mm_setzero_si128();
+			for(; i+16<=n; i+=16){
+				Acc = _mm_add_epi64(Acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i*)(p+i)), Zero));
+			}
+			s = _mm_cvtsi128_si32(Acc)+_mm_cvtsi128_si32(_mm_srli_si128(Acc, 8));
+		}
+#elif defined(SCS_SUM_NEON)
+		if(n>=16){
+			uint16x8_t Acc = vdupq_n_u16(0);
+			for(; i+16<=n; i+=16){
+				Acc = vpadalq_u8(Acc, vld1q_u8(p+i));//wraps only above 4096 bytes, irrelevant mod 256
+			}
+			uint32x4_t s4 = vpaddlq_u16(Acc);
+			s = vgetq_lane_u32(s4, 0)+vgetq_lane_u32(s4, 1)+vgetq_lane_u32(s4, 2)+vgetq_lane_u32(s4, 3);
+		}
+#endif
+		for(; i<n; i++){
+			s += p[i];
+		}
+		return (u8)s;
+	}
+	//checksum byte of a frame, Pkt[0..1] = 0xff 0xff, Pkt[3] = length
+	static u8 frame(const u8 *Pkt)
+	{
+		return ~sum(Pkt+2, Pkt[3]+1);
+	}
+	//packets of Stride bytes back to back from Buf (a SyncRead reply),
+	//returns how many in a row have a header, that length and a good checksum
+	static int validate(const u8 *Buf, int Len, int Stride)
+	{
+		int n = 0;
+		for(const u8 *p=Buf; p+Stride<=Buf+Len; p+=Stride, n++){
+			if(p[0]!=0xff || p[1]!=0xff || p[2]==0xff || p[3]+4!=Stride || (u8)~sum(p+2, Stride-3)!=p[Stride-1]){
+				break;
+			}
+		}
+		return n;
+	}
+};
+
+#endif
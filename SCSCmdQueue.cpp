@@ -0,0 +1,74 @@
+/*
+ * SCSCmdQueue.cpp
+ * Lock-free multi-producer command mailbox, latest command per servo and channel wins
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <sched.h>
+#include "SCSCmdQueue.h"
+
+SCSCmdQueue::SCSCmdQueue()
+{
+	memset(Slots, 0, sizeof(Slots));
+	memset(Pending, 0, sizeof(Pending));
+	Taken = 0;
+	Word = 0;
+	Pushed = 0;
+	Coalesced = 0;
+}
+
+int SCSCmdQueue::push(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(ID>=SCS_CMD_ID || Ch>=SCS_CMD_CH || nLen>SCS_CMD_LEN){
+		return 0;
+	}
+	Slot *s = &Slots[ID][Ch];
+	u32 Seq = __atomic_load_n(&s->Seq, __ATOMIC_RELAXED);
+	while((Seq&1) || !__atomic_compare_exchange_n(&s->Seq, &Seq, Seq+1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+		sched_yield();
+		Seq = __atomic_load_n(&s->Seq, __ATOMIC_RELAXED);
+	}
+	s->Cmd.MemAddr = MemAddr;
+	s->Cmd.nLen = nLen;
+	memcpy(s->Cmd.Dat, nDat, nLen);
+	__atomic_store_n(&s->Seq, Seq+2, __ATOMIC_RELEASE);
+	u32 Bit = ID*SCS_CMD_CH+Ch;
+	u64 Mask = 1ULL<<(Bit%64);
+	u64 Old = __atomic_fetch_or(&Pending[Bit/64], Mask, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&Pushed, 1, __ATOMIC_RELAXED);
+	if(Old&Mask){
+		__atomic_fetch_add(&Coalesced, 1, __ATOMIC_RELAXED);
+	}
+	return 1;
+}
+
+int SCSCmdQueue::pop(u8 *ID, u8 *Ch, SCSCmd *Cmd)
+{
+	for(int n=0; !Taken && n<SCS_CMD_WORDS; n++){
+		Word = (Word+1)%SCS_CMD_WORDS;
+		Taken = __atomic_exchange_n(&Pending[Word], 0, __ATOMIC_ACQUIRE);
+	}
+	if(!Taken){
+		return 0;
+	}
+	int b = __builtin_ctzll(Taken);
+	Taken &= Taken-1;
+	u32 Bit = Word*64+b;
+	*ID = Bit/SCS_CMD_CH;
+	*Ch = Bit%SCS_CMD_CH;
+	Slot *s = &Slots[*ID][*Ch];
+	while(1){
+		u32 Seq = __atomic_load_n(&s->Seq, __ATOMIC_ACQUIRE);
+		if(Seq&1){
+			sched_yield();
+			continue;
+		}
+		*Cmd = s->Cmd;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&s->Seq, __ATOMIC_RELAXED)==Seq){
+			return 1;
+		}
+	}
+}
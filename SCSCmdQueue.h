@@ -0,0 +1,49 @@
+/*
+ * SCSCmdQueue.h
+ * Lock-free multi-producer command mailbox, latest command per servo and channel wins
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCMDQUEUE_H
+#define _SCSCMDQUEUE_H
+
+#include "INST.h"
+
+#define SCS_CMD_ID SCS_MAX_ID
+#ifndef SCS_CMD_CH
+#define SCS_CMD_CH 4//independent commands per servo, e.g. goal, torque, mode
+#endif
+#ifndef SCS_CMD_LEN
+#define SCS_CMD_LEN 8//register bytes per command
+#endif
+#define SCS_CMD_WORDS ((SCS_CMD_ID*SCS_CMD_CH+63)/64)
+
+struct SCSCmd{
+	u8 MemAddr;
+	u8 nLen;
+	u8 Dat[SCS_CMD_LEN];
+};
+
+//Any thread may push(), one consumer (the bus thread) pops. A push to a
+//slot that has not been popped yet replaces the pending command, so a
+//slow bus coalesces commands instead of queueing them.
+class SCSCmdQueue{
+public:
+	SCSCmdQueue();
+	int push(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen);//returns 0 if ID, Ch or nLen is out of range
+	int pop(u8 *ID, u8 *Ch, SCSCmd *Cmd);//consumer only, returns 0 when nothing is pending
+	u32 Pushed;//commands pushed
+	u32 Coalesced;//commands replaced before they were popped
+private:
+	struct Slot{
+		u32 Seq;//odd while a producer writes the slot
+		SCSCmd Cmd;
+	};
+	Slot Slots[SCS_CMD_ID][SCS_CMD_CH];
+	u64 Pending[SCS_CMD_WORDS];
+	u64 Taken;//bits taken from Pending[Word] but not popped yet
+	int Word;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * SCSCoalesce.cpp
+ * Write coalescing: single-servo writes buffered and sent as sync writes
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSCoalesce.h"
+#include "SCSerial.h"
+
+SCSCoalesce::SCSCoalesce(SCS *bus, u32 windowUs, u8 minAddr)
+{
+	this->bus = bus;
+	WindowUs = windowUs;
+	MinAddr = minAddr;
+	LockAddr = SCS_COALESCE_LOCK_ADDR;
+	Writes = 0;
+	Packets = 0;
+	Acks = 0;
+	NoAcks = 0;
+	Error = 0;
+	IDN = 0;
+	FirstUs = 0;
+	Busy = 0;
+	memset(Flag, 0, sizeof(Flag));
+	memset(Pend, 0, sizeof(Pend));
+}
+
+int SCSCoalesce::add(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(Busy){
+		return 0;
+	}
+	if(ID>=SCS_COALESCE_ID || MemAddr<MinAddr || MemAddr+nLen>SCS_COALESCE_LEN || !nLen || (LockAddr>=MemAddr && LockAddr<MemAddr+nLen)){
+		flush();
+		return 0;
+	}
+	if(Pend[ID] && memchr(Flag[ID]+MemAddr, 1, nLen)){
+		flush();//the pending value goes out before it is overwritten
+	}
+	if(!IDN){
+		FirstUs = SCSerial::monoUs();
+	}
+	if(!Pend[ID]){
+		Pend[ID] = 1;
+		this->ID[IDN++] = ID;
+		Lo[ID] = MemAddr;
+		Hi[ID] = MemAddr+nLen-1;
+	}
+	memcpy(Mem[ID]+MemAddr, nDat, nLen);
+	memset(Flag[ID]+MemAddr, 1, nLen);
+	if(MemAddr<Lo[ID]){
+		Lo[ID] = MemAddr;
+	}
+	if(MemAddr+nLen-1>Hi[ID]){
+		Hi[ID] = MemAddr+nLen-1;
+	}
+	Writes++;
+	if(WindowUs && (u64)(SCSerial::monoUs()-FirstUs)>=WindowUs){
+		flush();
+	}
+	return 1;
+}
+
+int SCSCoalesce::flush()
+{
+	if(Busy || !IDN){
+		return 0;
+	}
+	Busy = 1;
+	int Sent = 0;
+	//take runs in address order; every servo still holding a run at the
+	//same address and length joins the same packet
+	while(1){
+		int Addr = -1, Len = 0;
+		for(u8 i=0; i<IDN && Addr<0; i++){
+			u8 k = ID[i];
+			for(int a=Lo[k]; a<=Hi[k]; a++){
+				if(Flag[k][a]){
+					Addr = a;
+					while(a<=Hi[k] && Flag[k][a]){
+						a++;
+					}
+					Len = a-Addr;
+					break;
+				}
+			}
+		}
+		if(Addr<0){
+			break;
+		}
+		u8 GroupID[SCS_COALESCE_ID];
+		u8 n = 0;
+		for(u8 i=0; i<IDN; i++){
+			u8 k = ID[i];
+			const u8 *f = Flag[k];
+			if(!f[Addr] || (Addr && f[Addr-1]) || (Addr+Len<SCS_COALESCE_LEN && f[Addr+Len]) || memchr(f+Addr, 0, Len)){
+				continue;
+			}
+			GroupID[n] = k;
+			memcpy(Tx+n*Len, Mem[k]+Addr, Len);
+			memset(Flag[k]+Addr, 0, Len);
+			n++;
+		}
+		if(n==1){
+			//one servo: a genWrite and its ack, Busy keeps it from coming back here
+			if(bus->genWrite(GroupID[0], Addr, Tx, Len)){
+				Acks++;
+				Error = bus->Error;
+			}else{
+				NoAcks++;
+			}
+			Sent++;
+			continue;
+		}
+		bus->syncWrite(GroupID, n, Addr, Tx, Len);
+		u8 maxIDN = SCS_SYNC_WRITE_MAX/(Len+1);
+		Sent += (n+maxIDN-1)/maxIDN;
+	}
+	for(u8 i=0; i<IDN; i++){
+		Pend[ID[i]] = 0;
+	}
+	IDN = 0;
+	Packets += Sent;
+	Busy = 0;
+	return Sent;
+}
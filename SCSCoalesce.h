@@ -0,0 +1,60 @@
+/*
+ * SCSCoalesce.h
+ * Write coalescing: single-servo writes buffered and sent as sync writes
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCOALESCE_H
+#define _SCSCOALESCE_H
+
+#include "SCS.h"
+
+#define SCS_COALESCE_ID SCS_MAX_ID
+#define SCS_COALESCE_LEN 72//addresses 0..71, as SCS_SHADOW_LEN
+#define SCS_COALESCE_MIN_ADDR 40//first SRAM byte (torque enable) of every series, the EPROM below is never buffered
+#define SCS_COALESCE_LOCK_ADDR 55//SMS_STS_LOCK and SMSBL_LOCK, 48 for SCSCL and SMSCL
+
+//Installed with SCS::setCoalesce(), genWrite/writeByte/writeWord (and
+//so WritePosEx, EnableTorque, WritePwm, ...) only record their bytes and
+//return 1: the caller gets no status packet. flush() turns the recorded
+//bytes into runs of consecutive addresses per servo (adjacent writes of
+//one servo become one run). A run found on one servo only goes out as a
+//genWrite whose ack is counted in Acks/NoAcks, runs with the same
+//address and length on several servos as one syncWrite. flush() runs on
+//its own before any other request of the bus, so reads and unbuffered
+//writes keep their order, before a write that would overwrite a byte
+//still pending, so every value reaches the servo in the order written,
+//when WindowUs has passed since the first buffered write, or when
+//called. Writes below MinAddr (EPROM) or touching LockAddr are sent at
+//once after the pending ones.
+class SCSCoalesce{
+public:
+	SCSCoalesce(SCS *bus, u32 windowUs = 0, u8 minAddr = SCS_COALESCE_MIN_ADDR);//windowUs 0: only explicit or ordering flushes
+	int add(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);//1 recorded, 0 the caller sends it itself (broadcast, below MinAddr, lock, out of range)
+	int flush();//returns packets sent
+	int pending(){  return IDN;  }//servos with buffered bytes
+public:
+	u32 WindowUs;
+	u8 MinAddr;//writes below it (the EPROM area) are sent at once
+	u8 LockAddr;//writes touching it are sent at once, 0xff none (default SCS_COALESCE_LOCK_ADDR)
+	u32 Writes;//writes recorded
+	u32 Packets;//genWrite and syncWrite packets sent
+	u32 Acks;//single-servo runs acknowledged
+	u32 NoAcks;//single-servo runs without a good status packet
+	u8 Error;//servo status byte of the last acknowledged run
+private:
+	SCS *bus;
+	u8 Mem[SCS_COALESCE_ID][SCS_COALESCE_LEN];
+	u8 Flag[SCS_COALESCE_ID][SCS_COALESCE_LEN];//1: byte written since the last flush
+	u8 Pend[SCS_COALESCE_ID];//1: ID is in ID[]
+	u8 Lo[SCS_COALESCE_ID];
+	u8 Hi[SCS_COALESCE_ID];
+	u8 ID[SCS_COALESCE_ID];//servos in the order of their first buffered write
+	u8 IDN;
+	u64 FirstUs;
+	int Busy;
+	u8 Tx[SCS_COALESCE_ID*SCS_COALESCE_LEN];
+};
+
+#endif
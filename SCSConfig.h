@@ -0,0 +1,32 @@
+/*
+ * SCSConfig.h
+ * Compile-time capacities of the library and the fixed allocation build
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCONFIG_H
+#define _SCSCONFIG_H
+
+//Every table of the library is a fixed array sized by one of these.
+//Define them on the compiler command line, for the library and its
+//users alike (CMake: SCSERVO_MAX_ID, SCSERVO_MAX_PAYLOAD,
+//SCSERVO_STATIC_ALLOC), to size a build for a small target.
+
+#ifndef SCS_MAX_ID
+#define SCS_MAX_ID 0xfe//IDs 0..SCS_MAX_ID-1 on one bus: per-ID tables, sync write buffers, statistics, health
+#endif
+
+#ifndef SCS_MAX_PAYLOAD
+#define SCS_MAX_PAYLOAD 64//largest per servo data of a SyncRead into the bus owned buffer (SCS_STATIC_ALLOC)
+#endif
+
+//SCS_STATIC_ALLOC: the library makes no heap allocation of its own.
+//Statistics and the owned SyncRead buffer (SCS_MAX_ID*(SCS_MAX_PAYLOAD+6)
+//bytes) live in the bus object, a larger syncReadBegin() gets no buffer
+//and every reply of that SyncRead is invalid. SCSBus builds the series
+//object in place and cannot be moved, SCSReplayTransport only loads into
+//caller storage, SCSMetrics and SCSPtySim keep their buffers as members.
+//Buffers inside the C library (stdio, thread stacks) are not covered.
+
+#endif
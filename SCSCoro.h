@@ -0,0 +1,233 @@
+/*
+ * SCSCoro.h
+ * C++20 coroutine interface on top of SCSAsync
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSCORO_H
+#define _SCSCORO_H
+
+//The library builds as C++11; this header is only active in translation
+//units compiled with C++20 coroutine support and is empty otherwise.
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SCS_CORO 1
+#endif
+#endif
+
+#ifdef SCS_CORO
+
+#include <coroutine>
+#include <string.h>
+#include "SCSAsync.h"
+
+#define SCS_CORO_TIMERS 32//delay() awaits pending on one SCSCoro
+
+//Coroutine returned by a control sequence, it starts running at the
+//call and stops at its first co_await. done() after co_return;
+//result() holds the returned value. The frame is destroyed with the task.
+class SCSTask{
+public:
+	struct promise_type{
+		int Result = 0;
+		SCSTask get_return_object(){  return SCSTask(std::coroutine_handle<promise_type>::from_promise(*this));  }
+		std::suspend_never initial_suspend() noexcept{  return {};  }
+		std::suspend_always final_suspend() noexcept{  return {};  }
+		void return_value(int v){  Result = v;  }
+		void unhandled_exception(){  Result = -1;  }
+	};
+	SCSTask() : h(nullptr) {}
+	explicit SCSTask(std::coroutine_handle<promise_type> h) : h(h) {}
+	SCSTask(SCSTask &&t) noexcept : h(t.h){  t.h = nullptr;  }
+	SCSTask &operator=(SCSTask &&t) noexcept
+	{
+		if(this!=&t){
+			if(h){
+				h.destroy();
+			}
+			h = t.h;
+			t.h = nullptr;
+		}
+		return *this;
+	}
+	SCSTask(const SCSTask&) = delete;
+	SCSTask &operator=(const SCSTask&) = delete;
+	~SCSTask()
+	{
+		if(h){
+			h.destroy();
+		}
+	}
+	bool done() const{  return !h || h.done();  }
+	int result() const{  return h ? h.promise().Result : -1;  }
+private:
+	std::coroutine_handle<promise_type> h;
+};
+
+class SCSCoro;
+
+//Awaitable SCS transaction. The request is queued on the bus when the
+//awaiter is created and the coroutine resumes from the completion
+//callback, inside SCSCoro::poll(). co_await yields the result of the
+//matching blocking call: Read nLen or 0, Write/writeByte 1 or 0, Ping
+//the ID or -1. If every SCSAsync slot is busy the await fails at once.
+//An awaiter destroyed while it still owns the op (never awaited, or its
+//task destroyed while suspended) hands the slot back to SCSAsync: at
+//once if the op is finished, otherwise when it completes.
+class SCSAwaitOp{
+public:
+	SCSAwaitOp(SCSAsyncOp *op, u8 *nData, int okValue, int failValue)
+		: Op(op), nData(nData), OkValue(okValue), FailValue(failValue), Result(failValue) {}
+	SCSAwaitOp(SCSAwaitOp &&a) noexcept
+		: Op(a.Op), nData(a.nData), OkValue(a.OkValue), FailValue(a.FailValue), Result(a.Result)
+	{
+		a.Op = nullptr;
+	}
+	SCSAwaitOp(const SCSAwaitOp&) = delete;
+	SCSAwaitOp &operator=(const SCSAwaitOp&) = delete;
+	~SCSAwaitOp()
+	{
+		if(!Op){
+			return;
+		}
+		if(!Op->Callback && Op->ready()){
+			Op->complete();//finished future, free the slot now
+		}else{
+			Op->Callback = drop;//in flight, or its completion is still queued on an executor
+		}
+	}
+	bool await_ready() noexcept
+	{
+		if(Op && Op->ready()){//finished before the await, still a future
+			collect(Op);
+			Op->complete();
+			Op = nullptr;
+			return true;
+		}
+		return Op==nullptr;
+	}
+	void await_suspend(std::coroutine_handle<> Continue)
+	{
+		Waiter = Continue;
+		Op->Callback = resume;
+		Op->Arg = this;
+	}
+	int await_resume() const noexcept{  return Result;  }
+	u8 Error = 0;//servo status byte of the reply
+private:
+	void collect(SCSAsyncOp *op)
+	{
+		Error = op->Error;
+		if(op->ok()){
+			if(nData){
+				memcpy(nData, op->Dat, op->nLen);
+			}
+			Result = OkValue;
+		}
+	}
+	static void resume(void *arg, SCSAsyncOp *op)
+	{
+		SCSAwaitOp *a = (SCSAwaitOp*)arg;
+		a->collect(op);
+		a->Op = nullptr;//complete() frees the slot, the awaiter may be gone after resume()
+		a->Waiter.resume();
+	}
+	static void drop(void*, SCSAsyncOp*){}
+	SCSAsyncOp *Op;
+	u8 *nData;
+	int OkValue;
+	int FailValue;
+	int Result;
+	std::coroutine_handle<> Waiter;
+};
+
+//Awaitable pause, resumed by SCSCoro::poll() once the time has passed
+class SCSAwaitDelay{
+public:
+	SCSAwaitDelay(SCSCoro *co, u32 us) : Co(co), Us(us) {}
+	bool await_ready() const noexcept{  return !Us;  }
+	bool await_suspend(std::coroutine_handle<> h);
+	void await_resume() const noexcept{}
+private:
+	SCSCoro *Co;
+	u32 Us;
+};
+
+//Awaitable versions of the SCS primitives on one bus. Sequences written
+//as coroutines interleave with each other and with other SCSAsync
+//traffic of the same bus at transaction granularity, so commissioning
+//many servos no longer serialises on every settle delay.
+//Call poll() from the bus thread until the tasks are done, and keep
+//each SCSTask alive while it waits on the bus.
+class SCSCoro{
+public:
+	SCSCoro(SCSAsync *async) : Async(async), TimerN(0) {}
+	SCSAwaitOp Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
+	{
+		return SCSAwaitOp(Async->readAsync(ID, MemAddr, nLen), nData, nLen, 0);
+	}
+	SCSAwaitOp genWrite(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+	{
+		return SCSAwaitOp(Async->writeAsync(ID, MemAddr, nDat, nLen), nullptr, 1, 0);
+	}
+	SCSAwaitOp writeByte(u8 ID, u8 MemAddr, u8 bDat)
+	{
+		return genWrite(ID, MemAddr, &bDat, 1);
+	}
+	SCSAwaitOp Ping(u8 ID)
+	{
+		return SCSAwaitOp(Async->pingAsync(ID), nullptr, ID, -1);
+	}
+	template<class Map, class Reg> SCSAwaitOp write(u8 ID, int v)//one control table field in the byte order of Map
+	{
+		u8 bBuf[Reg::width];
+		SCSField<Reg, Map::End>::encode(bBuf, v);
+		return genWrite(ID, Reg::addr, bBuf, Reg::width);
+	}
+	template<class Map> SCSAwaitOp unLockEprom(u8 ID){  return write<Map, typename Map::Lock>(ID, 0);  }
+	template<class Map> SCSAwaitOp LockEprom(u8 ID){  return write<Map, typename Map::Lock>(ID, 1);  }
+	SCSAwaitDelay delay(u32 us){  return SCSAwaitDelay(this, us);  }//e.g. SCSERIAL_EEPROM_US after an EEPROM write
+	int poll(u64 NowUs)//bus transactions and due delays, returns completions
+	{
+		int Num = Async->poll(NowUs);
+		for(int i=0; i<TimerN; ){
+			if((long long)(NowUs-Timers[i].DueUs)<0){
+				i++;
+				continue;
+			}
+			std::coroutine_handle<> h = Timers[i].h;
+			Timers[i] = Timers[--TimerN];
+			h.resume();
+			Num++;
+		}
+		return Num;
+	}
+	int pending(){  return Async->pending()+TimerN;  }
+	int addTimer(std::coroutine_handle<> h, u64 DueUs)
+	{
+		if(TimerN==SCS_CORO_TIMERS){
+			return 0;
+		}
+		Timers[TimerN].h = h;
+		Timers[TimerN++].DueUs = DueUs;
+		return 1;
+	}
+private:
+	struct Timer{
+		std::coroutine_handle<> h;
+		u64 DueUs;
+	};
+	SCSAsync *Async;
+	Timer Timers[SCS_CORO_TIMERS];
+	int TimerN;
+};
+
+inline bool SCSAwaitDelay::await_suspend(std::coroutine_handle<> h)
+{
+	return Co->addTimer(h, SCSerial::monoUs()+Us)!=0;//no free timer: continue without the pause
+}
+
+#endif
+
+#endif
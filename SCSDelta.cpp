@@ -0,0 +1,350 @@
+/*
+ * SCSDelta.cpp
+ * Change detection on decoded telemetry, compact delta records with per-field deadbands
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSDelta.h"
+
+SCSDelta::SCSDelta()
+{
+	Deadband[0] = 2;
+	Deadband[1] = 10;
+	Deadband[2] = 10;
+	Deadband[3] = 2;
+	Deadband[4] = 1;
+	Deadband[5] = 0;
+	RefreshCycles = 100;
+	Cycle = 0;
+	Stamp = 0;
+	Samples = 0;
+	Records = 0;
+	Fields = 0;
+	BytesOut = 0;
+	BytesFull = 0;
+	N = 0;
+	memset(S, 0, sizeof(S));
+	memset(Index, 0, sizeof(Index));
+}
+
+int SCSDelta::addServo(u8 ID)
+{
+	if(N>=SCS_DELTA_SERVOS || ID>=0xfe || Index[ID]){
+		return -1;
+	}
+	memset(S+N, 0, sizeof(Servo));
+	S[N].Sent.ID = ID;
+	Index[ID] = N+1;
+	return N++;
+}
+
+int SCSDelta::setServos(const u8 ID[], u8 IDN)
+{
+	int n = 0;
+	for(u8 i=0; i<IDN; i++){
+		n += addServo(ID[i])>=0;
+	}
+	return n;
+}
+
+void SCSDelta::reset()
+{
+	for(u8 i=0; i<N; i++){
+		S[i].Init = 0;
+	}
+}
+
+static int outside(int Now, int Sent, int Band)
+{
+	int d = Now-Sent;
+	return d>Band || d<-Band;
+}
+
+int SCSDelta::change(Servo *s, const SCSDeltaRecord &Now, SCSDeltaRecord *Out)
+{
+	u8 Mask = 0;
+	Samples++;
+	if(!s->Init || (RefreshCycles && s->Silent+1>=RefreshCycles)){
+		Mask = SCS_DELTA_ALL;
+	}else{
+		if(Now.Flags&2){
+			Mask |= outside(Now.Position, s->Sent.Position, Deadband[0]) ? SCS_DELTA_POSITION : 0;
+			Mask |= outside(Now.Speed, s->Sent.Speed, Deadband[1]) ? SCS_DELTA_SPEED : 0;
+			Mask |= outside(Now.Load, s->Sent.Load, Deadband[2]) ? SCS_DELTA_LOAD : 0;
+			Mask |= outside(Now.Current, s->Sent.Current, Deadband[3]) ? SCS_DELTA_CURRENT : 0;
+			Mask |= outside(Now.Voltage, s->Sent.Voltage, Deadband[4]) ? SCS_DELTA_VOLTAGE : 0;
+			Mask |= outside(Now.Temperature, s->Sent.Temperature, Deadband[5]) ? SCS_DELTA_TEMPERATURE : 0;
+			Mask |= Now.Error!=s->Sent.Error ? SCS_DELTA_ERROR : 0;
+		}
+		Mask |= Now.Flags!=s->Sent.Flags ? SCS_DELTA_FLAGS : 0;
+	}
+	if(!Mask){
+		s->Silent++;
+		return 0;
+	}
+	*Out = Now;
+	Out->Mask = Mask;
+	//only the fields sent move the consumer's values
+	if(Mask&SCS_DELTA_POSITION){
+		s->Sent.Position = Now.Position;
+	}
+	if(Mask&SCS_DELTA_SPEED){
+		s->Sent.Speed = Now.Speed;
+	}
+	if(Mask&SCS_DELTA_LOAD){
+		s->Sent.Load = Now.Load;
+	}
+	if(Mask&SCS_DELTA_CURRENT){
+		s->Sent.Current = Now.Current;
+	}
+	if(Mask&SCS_DELTA_VOLTAGE){
+		s->Sent.Voltage = Now.Voltage;
+	}
+	if(Mask&SCS_DELTA_TEMPERATURE){
+		s->Sent.Temperature = Now.Temperature;
+	}
+	if(Mask&SCS_DELTA_ERROR){
+		s->Sent.Error = Now.Error;
+	}
+	if(Mask&SCS_DELTA_FLAGS){
+		s->Sent.Flags = Now.Flags;
+	}
+	s->Init = 1;
+	s->Silent = 0;
+	Records++;
+	for(u8 m=Mask; m; m&=m-1){
+		Fields++;
+	}
+	return 1;
+}
+
+int SCSDelta::update(const SCSTelemetryFrame &f, SCSDeltaRecord Rec[])
+{
+	int n = 0;
+	Cycle++;
+	int Compared = 0;
+	for(u8 i=0; i<f.IDN; i++){
+		if(f.ID[i]>=0xfe || !Index[f.ID[i]]){
+			continue;
+		}
+		SCSDeltaRecord Now;
+		Now.ID = f.ID[i];
+		Now.Position = f.Position[i];
+		Now.Speed = f.Speed[i];
+		Now.Load = f.Load[i];
+		Now.Current = f.Current[i];
+		Now.Voltage = f.Voltage[i];
+		Now.Temperature = f.Temperature[i];
+		Now.Error = f.Error[i];
+		Now.Flags = (f.Moving[i] ? 1 : 0)|(f.Valid[i] ? 2 : 0);
+		if(f.Valid[i] && f.Stamp[i]>Stamp){
+			Stamp = f.Stamp[i];
+		}
+		Compared++;
+		n += change(S+Index[f.ID[i]]-1, Now, Rec+n);
+	}
+	BytesFull += SCS_DELTA_HEAD+Compared*SCS_DELTA_RECORD_MAX;
+	return n;
+}
+
+int SCSDelta::update(const Telemetry Tel[], const u8 ID[], u8 IDN, SCSDeltaRecord Rec[])
+{
+	int n = 0;
+	Cycle++;
+	int Compared = 0;
+	for(u8 i=0; i<IDN; i++){
+		if(ID[i]>=0xfe || !Index[ID[i]]){
+			continue;
+		}
+		const Telemetry *t = Tel+i;
+		SCSDeltaRecord Now;
+		Now.ID = ID[i];
+		Now.Position = t->Position;
+		Now.Speed = t->Speed;
+		Now.Load = t->Load;
+		Now.Current = t->Current;
+		Now.Voltage = t->Voltage;
+		Now.Temperature = t->Temperature;
+		Now.Error = t->Error;
+		Now.Flags = (t->Moving ? 1 : 0)|(t->Valid ? 2 : 0);
+		if(t->Valid && t->Stamp>Stamp){
+			Stamp = t->Stamp;
+		}
+		Compared++;
+		n += change(S+Index[ID[i]]-1, Now, Rec+n);
+	}
+	BytesFull += SCS_DELTA_HEAD+Compared*SCS_DELTA_RECORD_MAX;
+	return n;
+}
+
+int SCSDelta::size(u8 Mask)
+{
+	int n = 2;
+	for(u8 b=0; b<8; b++){
+		if(Mask&(1<<b)){
+			n += b<4 ? 2 : 1;
+		}
+	}
+	return n;
+}
+
+static u8 *put16(u8 *p, s16 v)
+{
+	p[0] = (u8)v;
+	p[1] = (u8)((u16)v>>8);
+	return p+2;
+}
+
+static s16 get16(const u8 *p)
+{
+	return (s16)(p[0]|(p[1]<<8));
+}
+
+int SCSDelta::encode(const SCSDeltaRecord Rec[], int n, u8 *Buf, int Max)
+{
+	if(n>0xff){
+		return 0;
+	}
+	int Len = SCS_DELTA_HEAD;
+	for(int i=0; i<n; i++){
+		Len += size(Rec[i].Mask);
+	}
+	if(Len>Max){
+		return 0;
+	}
+	u8 *p = Buf;
+	for(int b=0; b<4; b++){
+		*p++ = (u8)(Cycle>>(8*b));
+	}
+	for(int b=0; b<8; b++){
+		*p++ = (u8)(Stamp>>(8*b));
+	}
+	*p++ = (u8)n;
+	for(int i=0; i<n; i++){
+		const SCSDeltaRecord *r = Rec+i;
+		*p++ = r->ID;
+		*p++ = r->Mask;
+		if(r->Mask&SCS_DELTA_POSITION){
+			p = put16(p, r->Position);
+		}
+		if(r->Mask&SCS_DELTA_SPEED){
+			p = put16(p, r->Speed);
+		}
+		if(r->Mask&SCS_DELTA_LOAD){
+			p = put16(p, r->Load);
+		}
+		if(r->Mask&SCS_DELTA_CURRENT){
+			p = put16(p, r->Current);
+		}
+		if(r->Mask&SCS_DELTA_VOLTAGE){
+			*p++ = r->Voltage;
+		}
+		if(r->Mask&SCS_DELTA_TEMPERATURE){
+			*p++ = r->Temperature;
+		}
+		if(r->Mask&SCS_DELTA_ERROR){
+			*p++ = r->Error;
+		}
+		if(r->Mask&SCS_DELTA_FLAGS){
+			*p++ = r->Flags;
+		}
+	}
+	BytesOut += Len;
+	return Len;
+}
+
+int SCSDelta::decode(const u8 *Buf, int Len, SCSDeltaRecord Rec[], int Max, u32 *Cycle, u64 *Stamp)
+{
+	if(Len<SCS_DELTA_HEAD){
+		return -1;
+	}
+	u32 c = 0;
+	u64 t = 0;
+	for(int b=0; b<4; b++){
+		c |= (u32)Buf[b]<<(8*b);
+	}
+	for(int b=0; b<8; b++){
+		t |= (u64)Buf[4+b]<<(8*b);
+	}
+	int n = Buf[12];
+	if(n>Max){
+		return -1;
+	}
+	const u8 *p = Buf+SCS_DELTA_HEAD;
+	const u8 *End = Buf+Len;
+	for(int i=0; i<n; i++){
+		if(End-p<2 || End-p<size(p[1])){
+			return -1;
+		}
+		SCSDeltaRecord *r = Rec+i;
+		memset(r, 0, sizeof(SCSDeltaRecord));
+		r->ID = *p++;
+		r->Mask = *p++;
+		if(r->Mask&SCS_DELTA_POSITION){
+			r->Position = get16(p);
+			p += 2;
+		}
+		if(r->Mask&SCS_DELTA_SPEED){
+			r->Speed = get16(p);
+			p += 2;
+		}
+		if(r->Mask&SCS_DELTA_LOAD){
+			r->Load = get16(p);
+			p += 2;
+		}
+		if(r->Mask&SCS_DELTA_CURRENT){
+			r->Current = get16(p);
+			p += 2;
+		}
+		if(r->Mask&SCS_DELTA_VOLTAGE){
+			r->Voltage = *p++;
+		}
+		if(r->Mask&SCS_DELTA_TEMPERATURE){
+			r->Temperature = *p++;
+		}
+		if(r->Mask&SCS_DELTA_ERROR){
+			r->Error = *p++;
+		}
+		if(r->Mask&SCS_DELTA_FLAGS){
+			r->Flags = *p++;
+		}
+	}
+	if(Cycle){
+		*Cycle = c;
+	}
+	if(Stamp){
+		*Stamp = t;
+	}
+	return n;
+}
+
+void SCSDelta::apply(const SCSDeltaRecord &r, Telemetry *t)
+{
+	if(r.Mask&SCS_DELTA_POSITION){
+		t->Position = r.Position;
+	}
+	if(r.Mask&SCS_DELTA_SPEED){
+		t->Speed = r.Speed;
+	}
+	if(r.Mask&SCS_DELTA_LOAD){
+		t->Load = r.Load;
+	}
+	if(r.Mask&SCS_DELTA_CURRENT){
+		t->Current = r.Current;
+	}
+	if(r.Mask&SCS_DELTA_VOLTAGE){
+		t->Voltage = r.Voltage;
+	}
+	if(r.Mask&SCS_DELTA_TEMPERATURE){
+		t->Temperature = r.Temperature;
+	}
+	if(r.Mask&SCS_DELTA_ERROR){
+		t->Error = r.Error;
+	}
+	if(r.Mask&SCS_DELTA_FLAGS){
+		t->Moving = r.Flags&1;
+		t->Valid = (r.Flags>>1)&1;
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * SCSDelta.h
+ * Change detection on decoded telemetry, compact delta records with per-field deadbands
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSDELTA_H
+#define _SCSDELTA_H
+
+#include "Telemetry.h"
+#include "SCSTelemetryStore.h"
+
+#define SCS_DELTA_SERVOS SCS_SOA_SERVOS
+
+//SCSDeltaRecord::Mask, the fields a record carries
+#define SCS_DELTA_POSITION 0x01
+#define SCS_DELTA_SPEED 0x02
+#define SCS_DELTA_LOAD 0x04
+#define SCS_DELTA_CURRENT 0x08
+#define SCS_DELTA_VOLTAGE 0x10
+#define SCS_DELTA_TEMPERATURE 0x20
+#define SCS_DELTA_ERROR 0x40
+#define SCS_DELTA_FLAGS 0x80//Moving (bit 0) and Valid (bit 1)
+#define SCS_DELTA_ALL 0xff
+#define SCS_DELTA_BANDS 6//Deadband[] of Position..Temperature, in mask bit order
+
+#define SCS_DELTA_HEAD 13//encoded cycle header: Cycle u32, Stamp u64, record count u8
+#define SCS_DELTA_RECORD_MAX 14//encoded record with every field: ID, Mask, 4 x s16, 4 x u8
+
+struct SCSDeltaRecord{
+	u8 ID;
+	u8 Mask;//SCS_DELTA_*, only these fields are set
+	s16 Position;
+	s16 Speed;
+	s16 Load;
+	s16 Current;
+	u8 Voltage;
+	u8 Temperature;
+	u8 Error;
+	u8 Flags;
+};
+
+//update() (after the SyncRead decode) compares each servo with the
+//values last published for it and returns a record only for servos with
+//a change, holding only the fields that changed. A numeric field counts
+//as changed once it is more than its Deadband away from the published
+//value, so a slow drift is still sent and a consumer that applies every
+//record is never off by more than the deadband. Error and the
+//Moving/Valid flags are sent on any change; the values of a servo that
+//did not answer are not compared. The first record of a servo, and one
+//every RefreshCycles cycles without a record, carry every field so a
+//late consumer catches up. encode()/decode() pack records into a byte
+//stream (little endian) for IPC or a log, apply() folds one into a
+//Telemetry mirror.
+class SCSDelta{
+public:
+	SCSDelta();
+	int addServo(u8 ID);//returns the servo index, -1 if full
+	int setServos(const u8 ID[], u8 IDN);//returns servos added
+	void reset();//the next cycle sends every field of every servo
+	int update(const SCSTelemetryFrame &f, SCSDeltaRecord Rec[]);//returns records written to Rec[0..N)
+	int update(const Telemetry Tel[], const u8 ID[], u8 IDN, SCSDeltaRecord Rec[]);
+	int encode(const SCSDeltaRecord Rec[], int n, u8 *Buf, int Max);//header of the last update() and n records, returns bytes, 0 if Max is too small
+	static int decode(const u8 *Buf, int Len, SCSDeltaRecord Rec[], int Max, u32 *Cycle, u64 *Stamp);//returns records, -1 if Buf is malformed
+	static void apply(const SCSDeltaRecord &r, Telemetry *t);
+	static int size(u8 Mask);//encoded bytes of a record
+public:
+	u16 Deadband[SCS_DELTA_BANDS];//largest change that is not sent (default position 2, speed 10, load 10, current 2, voltage 1, temperature 0)
+	u32 RefreshCycles;//full record after this many cycles without one, 0 never (default 100)
+	u32 Cycle;//update() calls
+	u64 Stamp;//newest sample of the last update()
+	u64 Samples;//servo entries compared
+	u64 Records;
+	u64 Fields;
+	u64 BytesOut;//encode() output
+	u64 BytesFull;//what every cycle would take with every field of every servo
+	u8 N;
+private:
+	struct Servo{
+		SCSDeltaRecord Sent;//values of the consumer
+		u32 Silent;//cycles since the last record
+		u8 Init;
+	};
+	int change(Servo *s, const SCSDeltaRecord &Now, SCSDeltaRecord *Out);
+private:
+	Servo S[SCS_DELTA_SERVOS];
+	u8 Index[0xfe];//ID to servo index+1
+};
+
+#endif
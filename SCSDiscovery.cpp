@@ -0,0 +1,155 @@
+/*
+ * SCSDiscovery.cpp
+ * Fast servo discovery: baud-aware ping scan, SyncRead range scan, parallel ports
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSDiscovery.h"
+#include "SCSBusGroup.h"
+#include "SCSSyncRead.h"
+
+SCSDiscovery::SCSDiscovery(SCSerial *bus)
+{
+	this->bus = bus;
+	MarginUs = 3000;
+	clear();
+}
+
+void SCSDiscovery::clear()
+{
+	memset(Present, 0, sizeof(Present));
+	memset(Model, 0, sizeof(Model));
+	memset(Baud, 0, sizeof(Baud));
+	IDN = 0;
+}
+
+void SCSDiscovery::found(u8 ID, u16 Model)
+{
+	if(ID>=SCS_DISC_ID || Present[ID]){
+		return;
+	}
+	Present[ID] = 1;
+	this->Model[ID] = Model;
+	Baud[ID] = bus->getBaudRate();
+	u8 i = IDN++;
+	while(i && this->ID[i-1]>ID){
+		this->ID[i] = this->ID[i-1];
+		i--;
+	}
+	this->ID[i] = ID;
+}
+
+void SCSDiscovery::timeOutBegin()
+{
+	savedAdaptive = bus->AdaptiveTimeOut;
+	savedMarginUs = bus->TimeOutMarginUs;
+	bus->AdaptiveTimeOut = 1;
+	bus->TimeOutMarginUs = MarginUs;
+}
+
+void SCSDiscovery::timeOutEnd()
+{
+	bus->AdaptiveTimeOut = savedAdaptive;
+	bus->TimeOutMarginUs = savedMarginUs;
+}
+
+int SCSDiscovery::scan(u8 FirstID, u8 LastID)
+{
+	timeOutBegin();
+	for(int i=FirstID; i<=LastID && i<SCS_DISC_ID; i++){
+		int Model = bus->readWord(i, SCS_DISC_MODEL_ADDR);
+		if(Model!=-1){
+			found(i, Model);
+		}
+	}
+	timeOutEnd();
+	return IDN;
+}
+
+//Missing IDs in a range only cost their share of one reply timeout.
+//Servos that do not support SyncRead (SCSCL) are not found this way.
+int SCSDiscovery::scanSync(u8 FirstID, u8 LastID, u8 RangeN)
+{
+	SCSSyncReadBuf<SCS_DISC_ID, 2> Session(bus);
+	u8 rangeID[SCS_DISC_ID];
+	if(!RangeN){
+		return IDN;
+	}
+	timeOutBegin();
+	for(int First=FirstID; First<=LastID && First<SCS_DISC_ID; First+=RangeN){
+		u8 n = 0;
+		for(int i=First; i<First+RangeN && i<=LastID && i<SCS_DISC_ID; i++){
+			rangeID[n++] = i;
+		}
+		Session.begin(rangeID, n, SCS_DISC_MODEL_ADDR, 2);
+		if(!Session.exec()){
+			continue;
+		}
+		for(u8 i=0; i<n; i++){
+			if(bus->syncReadRxPacketSelect(Session.get(rangeID[i]))){
+				found(rangeID[i], bus->syncReadRxPacketToWrod());
+			}
+		}
+	}
+	bus->syncReadEnd();
+	timeOutEnd();
+	return IDN;
+}
+
+int SCSDiscovery::scanBauds(const int baudRate[], int baudN, u8 Sync)
+{
+	int orgBaud = bus->getBaudRate();
+	for(int i=0; i<baudN; i++){
+		if(bus->setBaudRate(baudRate[i])!=1){
+			continue;
+		}
+		if(Sync){
+			scanSync();
+		}else{
+			scan();
+		}
+	}
+	if(orgBaud>0){
+		bus->setBaudRate(orgBaud);
+	}
+	return IDN;
+}
+
+struct scanArg{
+	SCSDiscovery *Disc;
+	const int *Baud;
+	int BaudN;
+	u8 Sync;
+};
+
+static void scanJob(SCSerial *bus, void *arg)
+{
+	scanArg *a = (scanArg*)arg;
+	if(a->Disc){
+		a->Disc->scanBauds(a->Baud, a->BaudN, a->Sync);
+	}
+}
+
+int SCSDiscovery::scanGroup(SCSBusGroup *group, SCSDiscovery *disc[], const int baudRate[], int baudN, u8 Sync)
+{
+	scanArg Arg[SCS_BUS_MAX];
+	void *argv[SCS_BUS_MAX];
+	int n = group->busNum();
+	for(int i=0; i<n; i++){
+		Arg[i].Disc = disc[i];
+		Arg[i].Baud = baudRate;
+		Arg[i].BaudN = baudN;
+		Arg[i].Sync = Sync;
+		argv[i] = Arg+i;
+	}
+	group->run(scanJob, argv);
+	int Total = 0;
+	for(int i=0; i<n; i++){
+		if(disc[i]){
+			Total += disc[i]->IDN;
+		}
+	}
+	return Total;
+}
@@ -0,0 +1,46 @@
+/*
+ * SCSDiscovery.h
+ * Fast servo discovery: baud-aware ping scan, SyncRead range scan, parallel ports
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSDISCOVERY_H
+#define _SCSDISCOVERY_H
+
+#include "SCSerial.h"
+
+#define SCS_DISC_ID SCS_MAX_ID
+#define SCS_DISC_MODEL_ADDR 3//model number (SMS_STS_MODEL_L/H), same address in every series
+
+class SCSBusGroup;
+
+//Model[ID] and Baud[ID] are valid where Present[ID] is set, ID[0..IDN-1]
+//lists the servos found in ascending order. The bus timeouts are switched
+//to baud-derived values for the scan and restored afterwards.
+class SCSDiscovery{
+public:
+	SCSDiscovery(SCSerial *bus);
+	void clear();
+	int scan(u8 FirstID = 0, u8 LastID = 253);//one model read per ID, returns servos found so far
+	int scanSync(u8 FirstID = 0, u8 LastID = 253, u8 RangeN = 32);//one SyncRead of the model register per RangeN IDs
+	int scanBauds(const int baudRate[], int baudN, u8 Sync = 0);//scan at each rate, the port is left at its previous rate
+	static int scanGroup(SCSBusGroup *group, SCSDiscovery *disc[], const int baudRate[], int baudN, u8 Sync = 0);//scanBauds on every port of a started group at once, disc[i] belongs to group->bus(i)
+public:
+	unsigned long int MarginUs;//timeout margin over wire time, must cover the USB-serial latency timer
+	u8 Present[SCS_DISC_ID];
+	u16 Model[SCS_DISC_ID];
+	int Baud[SCS_DISC_ID];
+	u8 ID[SCS_DISC_ID];
+	u8 IDN;
+private:
+	void found(u8 ID, u16 Model);
+	void timeOutBegin();
+	void timeOutEnd();
+private:
+	SCSerial *bus;
+	u8 savedAdaptive;
+	unsigned long int savedMarginUs;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * SCSGroupCommit.cpp
+ * Staged RegWrite for a set of servos, one broadcast Action, SyncRead verification
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSGroupCommit.h"
+
+SCSGroupCommit::SCSGroupCommit(SCS *bus)
+{
+	this->bus = bus;
+	IDN = 0;
+}
+
+void SCSGroupCommit::clear()
+{
+	IDN = 0;
+}
+
+int SCSGroupCommit::stage(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(nLen>SCS_GROUP_LEN || ID>=0xfe){
+		return -1;
+	}
+	int i = 0;
+	while(i<IDN && this->ID[i]!=ID){
+		i++;
+	}
+	if(i==IDN){
+		if(IDN>=SCS_GROUP_MAX){
+			return -1;
+		}
+		IDN++;
+	}
+	this->ID[i] = ID;
+	this->MemAddr[i] = MemAddr;
+	this->nLen[i] = nLen;
+	memcpy(Dat[i], nDat, nLen);
+	return i;
+}
+
+int SCSGroupCommit::commit(u8 Verify)
+{
+	if(!IDN){
+		return 0;
+	}
+	Batch.clear();
+	for(u8 i=0; i<IDN; i++){
+		Batch.regWrite(ID[i], MemAddr[i], Dat[i], nLen[i]);
+		Verified[i] = 0;
+		Error[i] = 0;
+	}
+	bus->batchExec(&Batch);
+	int Num = 0;
+	for(u8 i=0; i<IDN; i++){
+		Acked[i] = Batch.Req[i].Valid;
+		Num += Acked[i];
+	}
+	bus->RegWriteAction(0xfe);
+	return Verify ? verify() : Num;
+}
+
+//one SyncRead per distinct register range
+int SCSGroupCommit::verify()
+{
+	u8 Done[SCS_GROUP_MAX];
+	u8 IDs[SCS_GROUP_MAX];
+	u8 Index[SCS_GROUP_MAX];
+	int Num = 0;
+	memset(Done, 0, sizeof(Done));
+	for(u8 i=0; i<IDN; i++){
+		if(Done[i]){
+			continue;
+		}
+		u8 n = 0;
+		for(u8 j=i; j<IDN; j++){
+			if(!Done[j] && MemAddr[j]==MemAddr[i] && nLen[j]==nLen[i]){
+				Done[j] = 1;
+				IDs[n] = ID[j];
+				Index[n++] = j;
+			}
+		}
+		bus->syncReadBegin(n, nLen[i], rxBuff);
+		bus->syncReadPacketTx(IDs, n, MemAddr[i], nLen[i]);
+		bus->syncReadPacketRxAll(rxTab, 0xfe);
+		for(u8 k=0; k<n; k++){
+			u8 j = Index[k];
+			SyncReadRx *rx = rxTab+ID[j];
+			if(!rx->Valid){
+				continue;
+			}
+			Error[j] = rx->Error;
+			Verified[j] = memcmp(rx->Dat, Dat[j], nLen[j])==0;
+			Num += Verified[j];
+		}
+	}
+	return Num;
+}
@@ -0,0 +1,57 @@
+/*
+ * SCSGroupCommit.h
+ * Staged RegWrite for a set of servos, one broadcast Action, SyncRead verification
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSGROUPCOMMIT_H
+#define _SCSGROUPCOMMIT_H
+
+#include "SCS.h"
+#include "SCSBatch.h"
+#include "SCSRegMap.h"
+
+#define SCS_GROUP_MAX SCS_BATCH_MAX//servos of one commit
+#define SCS_GROUP_LEN 8//register bytes staged per servo
+
+//commit() sends every staged REG_WRITE in one pipelined batch (the acks,
+//if the servos are at return level 1, are collected in one read instead
+//of one round trip each), fires a single broadcast RegWriteAction(0xfe)
+//so all servos start together, then reads the staged registers back with
+//one SyncRead per register range and compares them.
+class SCSGroupCommit{
+public:
+	SCSGroupCommit(SCS *bus);
+	void clear();
+	int stage(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);//returns the entry index, a second stage of the same ID replaces it, -1 if full
+	template<class Map> int stagePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0)//Acc..GoalSpeed of an SMS/STS-type map
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> Blk;
+		u8 bBuf[Blk::len];
+		Blk::template set<typename Map::Acc, Map::End>(bBuf, ACC);
+		Blk::template set<typename Map::GoalPosition, Map::End>(bBuf, Position);
+		Blk::template set<typename Map::GoalTime, Map::End>(bBuf, 0);
+		Blk::template set<typename Map::GoalSpeed, Map::End>(bBuf, Speed);
+		return stage(ID, Blk::addr, bBuf, Blk::len);
+	}
+	int commit(u8 Verify = 1);//returns servos verified (Verify=0: servos whose REG_WRITE completed), staging is kept until clear()
+public:
+	u8 IDN;
+	u8 ID[SCS_GROUP_MAX];
+	u8 Acked[SCS_GROUP_MAX];//REG_WRITE acknowledged, or no reply expected at return level 0
+	u8 Verified[SCS_GROUP_MAX];//registers read back equal to the staged data
+	u8 Error[SCS_GROUP_MAX];//servo status byte from the verification read
+private:
+	int verify();
+private:
+	SCS *bus;
+	u8 MemAddr[SCS_GROUP_MAX];
+	u8 nLen[SCS_GROUP_MAX];
+	u8 Dat[SCS_GROUP_MAX][SCS_GROUP_LEN];
+	SCSBatch Batch;
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_GROUP_MAX*(SCS_GROUP_LEN+6)];
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * SCSHealth.cpp
+ * Cached servo health records refreshed in idle bus time, lock-free queries
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <sched.h>
+#include "SCSHealth.h"
+#include "SCSDiscovery.h"
+
+SCSHealth::SCSHealth(SCSerial *bus)
+{
+	this->bus = bus;
+	MissLimit = 2;
+	CostUs = 0;
+	Steps = 0;
+	Next = 0;
+	memset(S, 0, sizeof(S));
+	memset(Tracked, 0, sizeof(Tracked));
+}
+
+void SCSHealth::add(u8 ID)
+{
+	if(ID<SCS_HEALTH_ID){
+		__atomic_store_n(&Tracked[ID], 1, __ATOMIC_RELEASE);
+	}
+}
+
+void SCSHealth::add(const SCSDiscovery *disc)
+{
+	for(u8 i=0; i<disc->IDN; i++){
+		u8 ID = disc->ID[i];
+		SCSHealthRecord rec = S[ID].R;
+		rec.Model = disc->Model[ID];
+		rec.Present = 1;
+		store(ID, &rec);
+		add(ID);
+	}
+}
+
+void SCSHealth::remove(u8 ID)
+{
+	if(ID<SCS_HEALTH_ID){
+		__atomic_store_n(&Tracked[ID], 0, __ATOMIC_RELEASE);
+	}
+}
+
+void SCSHealth::store(u8 ID, const SCSHealthRecord *rec)
+{
+	Slot *s = &S[ID];
+	u32 Seq = s->Seq;
+	__atomic_store_n(&s->Seq, Seq+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	s->R = *rec;
+	__atomic_store_n(&s->Seq, Seq+2, __ATOMIC_RELEASE);
+}
+
+int SCSHealth::get(u8 ID, SCSHealthRecord *rec) const
+{
+	if(ID>=SCS_HEALTH_ID || !__atomic_load_n(&Tracked[ID], __ATOMIC_ACQUIRE)){
+		return 0;
+	}
+	const Slot *s = &S[ID];
+	while(1){
+		u32 Seq = __atomic_load_n(&s->Seq, __ATOMIC_ACQUIRE);
+		if(Seq&1){
+			sched_yield();
+			continue;
+		}
+		memcpy(rec, &s->R, sizeof(SCSHealthRecord));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&s->Seq, __ATOMIC_RELAXED)==Seq){
+			return 1;
+		}
+	}
+}
+
+int SCSHealth::present(u8 ID) const
+{
+	SCSHealthRecord rec;
+	return get(ID, &rec) && rec.Present;
+}
+
+int SCSHealth::step(u64 NowUs)
+{
+	int ID = -1;
+	for(int i=0; i<SCS_HEALTH_ID; i++){
+		int n = (Next+i)%SCS_HEALTH_ID;
+		if(__atomic_load_n(&Tracked[n], __ATOMIC_ACQUIRE)){
+			ID = n;
+			break;
+		}
+	}
+	if(ID<0){
+		return -1;
+	}
+	Next = (ID+1)%SCS_HEALTH_ID;
+	Steps++;
+	//only the bus thread writes records, the plain copy is consistent
+	SCSHealthRecord rec = S[ID].R;
+	rec.CheckUs = NowUs;
+	rec.Checks++;
+	u8 bBuf[2];
+	int Ok = 1;
+	if(!rec.Model){
+		Ok = bus->Read(ID, SCS_HEALTH_MODEL_ADDR, bBuf, 2)==2;
+		if(Ok){
+			rec.Model = bus->End ? (bBuf[0]<<8)|bBuf[1] : (bBuf[1]<<8)|bBuf[0];
+		}
+	}
+	if(Ok){
+		Ok = bus->Read(ID, SCS_HEALTH_VOLTAGE_ADDR, bBuf, 2)==2;
+	}
+	if(Ok){
+		rec.Voltage = bBuf[0];
+		rec.Temperature = bBuf[1];
+		rec.Error = bus->Error;
+		rec.Stamp = NowUs;
+		rec.Present = 1;
+		rec.Misses = 0;
+	}else{
+		rec.Timeouts++;
+		if(rec.Misses<255){
+			rec.Misses++;
+		}
+		if(rec.Misses>=MissLimit){
+			rec.Present = 0;
+			rec.Model = 0;//read again once it is back, it may be another servo
+		}
+	}
+	store(ID, &rec);
+	return Ok;
+}
+
+int SCSHealth::idle(long BudgetUs)
+{
+	u64 Start = SCSerial::monoUs();
+	int n = 0;
+	while(1){
+		u64 Now = SCSerial::monoUs();
+		if((long)(Now-Start)+CostUs>BudgetUs){
+			break;
+		}
+		if(step(Now)<0){
+			break;
+		}
+		CostUs = (long)(SCSerial::monoUs()-Now);
+		n++;
+	}
+	return n;
+}
+
+int SCSHealth::job(void *health)
+{
+	((SCSHealth*)health)->step(SCSerial::monoUs());
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * SCSHealth.h
+ * Cached servo health records refreshed in idle bus time, lock-free queries
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSHEALTH_H
+#define _SCSHEALTH_H
+
+#include "SCSerial.h"
+
+#define SCS_HEALTH_ID SCS_MAX_ID
+#define SCS_HEALTH_MODEL_ADDR 3//model number, same address in every series
+#define SCS_HEALTH_VOLTAGE_ADDR 62//present voltage, present temperature follows
+
+class SCSDiscovery;
+
+struct SCSHealthRecord{
+	u64 Stamp;//last good reply, monotonic us, 0 never
+	u64 CheckUs;//last refresh attempt
+	u16 Model;
+	u8 Present;
+	u8 Error;//servo status byte of the last reply (SCS::Error)
+	u8 Voltage;//0.1V
+	u8 Temperature;//degree Celsius
+	u8 Misses;//timeouts in a row
+	u32 Timeouts;//total
+	u32 Checks;
+};
+
+//The bus thread calls step() or idle() whenever it has spare time, e.g.
+//from an SCSLoop job after the cycle's own traffic. Each step refreshes
+//one tracked servo with one read of voltage and temperature (plus the
+//model the first time it answers), round robin. get() and present()
+//copy a record from any thread without a lock: every record is guarded
+//by its own sequence counter, the reader retries if it raced a refresh.
+class SCSHealth{
+public:
+	SCSHealth(SCSerial *bus);
+	void add(u8 ID);
+	void add(const SCSDiscovery *disc);//track every servo found, model taken over
+	void remove(u8 ID);
+	int step(u64 NowUs);//refresh the next servo, returns 1 if it answered, 0 timeout, -1 nothing tracked
+	int idle(long BudgetUs);//refresh servos while BudgetUs lasts, returns servos refreshed
+	int get(u8 ID, SCSHealthRecord *rec) const;//O(1), 0 if ID is not tracked
+	int present(u8 ID) const;//O(1)
+	static int job(void *health);//SCSLoopJob running step(SCSerial::monoUs())
+public:
+	u8 MissLimit;//timeouts in a row before a servo counts as absent, default 2
+	long CostUs;//duration of the last refresh, idle() keeps one in reserve
+	u32 Steps;
+private:
+	struct Slot{
+		u32 Seq;
+		SCSHealthRecord R;
+	};
+	void store(u8 ID, const SCSHealthRecord *rec);
+private:
+	SCSerial *bus;
+	Slot S[SCS_HEALTH_ID];
+	u8 Tracked[SCS_HEALTH_ID];
+	u8 Next;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * SCSHotplug.cpp
+ * Background reconnect of a serial bus after its USB adapter was lost
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include "SCSHotplug.h"
+
+SCSHotplug::SCSHotplug(SCSerial *bus)
+{
+	this->bus = bus;
+	RetryMs = 100;
+	Attempts = 0;
+	Events = 0;
+	DownUs = 0;
+	Sock = -1;
+	Wake[0] = Wake[1] = -1;
+	NextUs = 0;
+	FaultUs = 0;
+	Running = 0;
+	Started = 0;
+}
+
+SCSHotplug::~SCSHotplug()
+{
+	stop();
+}
+
+int SCSHotplug::openUevent()
+{
+	int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+	if(fd == -1){
+		return -1;
+	}
+	struct sockaddr_nl sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.nl_family = AF_NETLINK;
+	sa.nl_groups = 1;//kernel events
+	if(bind(fd, (struct sockaddr*)&sa, sizeof(sa)) == -1){
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+//only "add@" events can bring the port back, the rest is discarded
+void SCSHotplug::drainUevent()
+{
+	char Buf[4096];
+	int n;
+	while((n = recv(Sock, Buf, sizeof(Buf)-1, 0))>0){
+		Buf[n] = 0;
+		if(!strncmp(Buf, "add@", 4)){
+			Events++;
+			NextUs = 0;
+		}
+	}
+}
+
+//the path check keeps a missing device from costing a full begin()
+int SCSHotplug::attempt()
+{
+	SCSLock Guard(bus);
+	if(!bus->Fault){
+		return 1;
+	}
+	if(!bus->getTransport() && bus->getPath()[0] && access(bus->getPath(), F_OK)){
+		return 0;
+	}
+	Attempts++;
+	return bus->reconnect();
+}
+
+int SCSHotplug::poll(u64 NowUs)
+{
+	if(!bus->Fault){
+		if(FaultUs){
+			DownUs += NowUs-FaultUs;
+			FaultUs = 0;
+		}
+		return 1;
+	}
+	if(!FaultUs){
+		FaultUs = NowUs;
+	}
+	if((long)(NowUs-NextUs)<0){
+		return 0;
+	}
+	NextUs = NowUs+RetryMs*1000ULL;
+	if(!attempt()){
+		return 0;
+	}
+	DownUs += NowUs-FaultUs;
+	FaultUs = 0;
+	return 1;
+}
+
+void *SCSHotplug::thread(void *arg)
+{
+	SCSHotplug *h = (SCSHotplug*)arg;
+	struct pollfd pfd[2];
+	pfd[0].fd = h->Wake[0];
+	pfd[0].events = POLLIN;
+	pfd[1].fd = h->Sock;
+	pfd[1].events = POLLIN;
+	while(h->Running){
+		//faults are found by the bus thread, the timeout bounds the reaction
+		::poll(pfd, h->Sock!=-1 ? 2 : 1, (int)h->RetryMs);
+		if(h->Sock!=-1 && (pfd[1].revents & POLLIN)){
+			h->drainUevent();
+		}
+		h->poll(SCSerial::monoUs());
+	}
+	return NULL;
+}
+
+int SCSHotplug::start(u32 retryMs)
+{
+	stop();
+	RetryMs = retryMs;
+	if(!bus->setLocking(1) || pipe2(Wake, O_CLOEXEC) == -1){
+		return 0;
+	}
+	Sock = openUevent();
+	Running = 1;
+	if(pthread_create(&Thread, NULL, thread, this) != 0){
+		Running = 0;
+		stop();
+		return 0;
+	}
+	Started = 1;
+	return 1;
+}
+
+void SCSHotplug::stop()
+{
+	Running = 0;
+	if(Started){
+		char c = 0;
+		ssize_t n = write(Wake[1], &c, 1);
+		(void)n;
+		pthread_join(Thread, NULL);
+		Started = 0;
+	}
+	if(Sock != -1){
+		close(Sock);
+		Sock = -1;
+	}
+	for(int i=0; i<2; i++){
+		if(Wake[i] != -1){
+			close(Wake[i]);
+			Wake[i] = -1;
+		}
+	}
+}
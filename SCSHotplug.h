@@ -0,0 +1,50 @@
+/*
+ * SCSHotplug.h
+ * Background reconnect of a serial bus after its USB adapter was lost
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSHOTPLUG_H
+#define _SCSHOTPLUG_H
+
+#include <pthread.h>
+#include "SCSerial.h"
+
+//While the adapter is gone SCSerial::Fault is set and every transfer
+//fails at once, so a control loop (SCSLoop with its SyncWrite/SyncRead
+//cycle) keeps its rate with invalid replies instead of blocking. start()
+//runs a thread that waits for udev "add" events on a kernel uevent
+//socket (and retries every RetryMs in case those are not visible, e.g.
+//in a container), then reopens the port under the bus lock; the loop's
+//next cycle runs on the new port. poll() does the same from the bus
+//thread for programs without the extra thread.
+class SCSHotplug{
+public:
+	SCSHotplug(SCSerial *bus);
+	~SCSHotplug();
+	int start(u32 retryMs = 100);//enables bus locking, call before other threads use the bus; returns 1 if the thread runs
+	void stop();
+	int poll(u64 NowUs);//reconnect attempt at most every RetryMs, returns 1 when the bus is healthy
+public:
+	u32 RetryMs;
+	u32 Attempts;
+	u32 Events;//uevents seen
+	u64 DownUs;//total time spent in the fault state, us
+private:
+	static void *thread(void *arg);
+	int attempt();
+	int openUevent();
+	void drainUevent();
+private:
+	SCSerial *bus;
+	int Sock;//NETLINK_KOBJECT_UEVENT socket, -1 if not available
+	int Wake[2];//pipe to end the thread
+	u64 NextUs;
+	u64 FaultUs;//start of the current fault, 0 when healthy
+	volatile int Running;
+	int Started;
+	pthread_t Thread;
+};
+
+#endif
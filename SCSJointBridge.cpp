@@ -0,0 +1,158 @@
+/*
+ * SCSJointBridge.cpp
+ * Joint state publisher and latest-value goal sink for middleware bridges
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <math.h>
+#include "SCSJointBridge.h"
+
+#define SCS_BRIDGE_RAD (2*M_PI/4096)//one position step
+#define SCS_BRIDGE_PENDING (1ULL<<63)
+
+SCSJointBridge::SCSJointBridge(SMS_STS *bus)
+{
+	this->bus = bus;
+	N = 0;
+	ACC = 0;
+	Cycles = 0;
+	Lost = 0;
+	Goals = 0;
+	Replaced = 0;
+	memset(Goal, 0, sizeof(Goal));
+	memset(&Own, 0, sizeof(Own));
+	Loan = NULL;
+	Publish = NULL;
+	Arg = NULL;
+	Loop.setJob(job, this);
+}
+
+SCSJointBridge::~SCSJointBridge()
+{
+	stop();
+}
+
+int SCSJointBridge::index(u8 ID)
+{
+	for(u8 i=0; i<N; i++){
+		if(this->ID[i]==ID){
+			return i;
+		}
+	}
+	return -1;
+}
+
+int SCSJointBridge::addJoint(u8 ID, double Offset)
+{
+	if(N>=SCS_BRIDGE_JOINTS){
+		return -1;
+	}
+	this->ID[N] = ID;
+	this->Offset[N] = Offset;
+	return N++;
+}
+
+void SCSJointBridge::setPublisher(SCSBridgeLoan loan, SCSBridgePublish publish, void *arg)
+{
+	Loan = loan;
+	Publish = publish;
+	Arg = arg;
+}
+
+int SCSJointBridge::command(u8 ID, double Position, double Velocity)
+{
+	int i = index(ID);
+	if(i<0){
+		return 0;
+	}
+	double Steps = floor((Position-Offset[i])/SCS_BRIDGE_RAD+0.5);
+	if(Steps>32767){
+		Steps = 32767;
+	}else if(Steps<-32767){
+		Steps = -32767;
+	}
+	double Speed = floor(fabs(Velocity)/SCS_BRIDGE_RAD+0.5);
+	if(Speed>65535){
+		Speed = 65535;
+	}
+	u64 w = SCS_BRIDGE_PENDING|((u64)(u16)(s16)Steps<<16)|(u16)Speed;
+	if(__atomic_exchange_n(&Goal[i], w, __ATOMIC_RELEASE)&SCS_BRIDGE_PENDING){
+		__atomic_fetch_add(&Replaced, 1, __ATOMIC_RELAXED);
+	}
+	return 1;
+}
+
+int SCSJointBridge::cycle(u64 NowUs)
+{
+	int Valid = 0;
+	if(N){
+		bus->SyncFeedBack(ID, N, Tel);
+	}
+	SCSJointState *m = Loan ? Loan(Arg) : NULL;
+	if(!m){
+		m = &Own;
+	}
+	m->Stamp = NowUs;
+	m->Cycle = ++Cycles;
+	m->N = N;
+	for(u8 i=0; i<N; i++){
+		const Telemetry *t = Tel+i;
+		m->ID[i] = ID[i];
+		m->Valid[i] = t->Valid;
+		if(!t->Valid){
+			Lost++;
+			continue;
+		}
+		Valid++;
+		m->Position[i] = t->Position*SCS_BRIDGE_RAD+Offset[i];
+		m->Velocity[i] = t->Speed*SCS_BRIDGE_RAD;
+		m->Effort[i] = t->Load/1000.0;
+	}
+	if(Publish){
+		Publish(Arg, m);
+	}
+	u8 wID[SCS_BRIDGE_JOINTS];
+	s16 Position[SCS_BRIDGE_JOINTS];
+	u16 Speed[SCS_BRIDGE_JOINTS];
+	u8 Acc[SCS_BRIDGE_JOINTS];
+	u8 n = 0;
+	for(u8 i=0; i<N; i++){
+		if(!(__atomic_load_n(&Goal[i], __ATOMIC_RELAXED)&SCS_BRIDGE_PENDING)){
+			continue;
+		}
+		u64 w = __atomic_exchange_n(&Goal[i], 0, __ATOMIC_ACQUIRE);
+		wID[n] = ID[i];
+		Position[n] = (s16)(u16)(w>>16);
+		Speed[n] = (u16)w;
+		Acc[n] = ACC;
+		n++;
+	}
+	if(n){
+		bus->SyncWritePosEx(wID, n, Position, Speed, Acc);
+		Goals += n;
+	}
+	return Valid;
+}
+
+int SCSJointBridge::start(u32 periodUs, int priority)
+{
+	Loop.setPeriod(periodUs);
+	if(priority>0){
+		Loop.setRealTime(priority);
+	}
+	return Loop.start();
+}
+
+void SCSJointBridge::stop()
+{
+	Loop.stop();
+}
+
+int SCSJointBridge::job(void *bridge)
+{
+	SCSJointBridge *b = (SCSJointBridge*)bridge;
+	b->cycle(SCSerial::monoUs());
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * SCSJointBridge.h
+ * Joint state publisher and latest-value goal sink for middleware bridges
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSJOINTBRIDGE_H
+#define _SCSJOINTBRIDGE_H
+
+#include "SMS_STS.h"
+#include "SCSLoop.h"
+
+#define SCS_BRIDGE_JOINTS 32//joints of one bridge
+
+//one cycle of joint feedback in SI units, Position[i] belongs to ID[i]
+struct SCSJointState{
+	u64 Stamp;//request time of the SyncRead, monotonic us
+	u32 Cycle;
+	u8 N;
+	u8 ID[SCS_BRIDGE_JOINTS];
+	double Position[SCS_BRIDGE_JOINTS];//rad
+	double Velocity[SCS_BRIDGE_JOINTS];//rad/s
+	double Effort[SCS_BRIDGE_JOINTS];//load, fraction of full PWM output [-1, 1]
+	u8 Valid[SCS_BRIDGE_JOINTS];
+};
+
+typedef SCSJointState *(*SCSBridgeLoan)(void *arg);//borrow the message the next cycle is decoded into, NULL: use the bridge's own
+typedef void (*SCSBridgePublish)(void *arg, SCSJointState *msg);//hand a filled message back, loaned or not
+
+//The middleware side (a ROS 2 node, a shared memory publisher, ...)
+//installs loan/publish callbacks and forwards goal messages to
+//command(). Each cycle, on the loop thread only, the bridge reads all
+//joints with one SyncRead, decodes straight into a loaned message, and
+//sends the goals that arrived since the last cycle in one
+//SyncWritePosEx. command() is wait-free and keeps only the latest goal
+//per joint.
+class SCSJointBridge{
+public:
+	SCSJointBridge(SMS_STS *bus);
+	~SCSJointBridge();
+	int addJoint(u8 ID, double Offset = 0);//Offset rad is added to the decoded position, returns the joint index, -1 if full
+	void setPublisher(SCSBridgeLoan loan, SCSBridgePublish publish, void *arg);
+	int command(u8 ID, double Position, double Velocity = 0);//any thread, Velocity 0: servo maximum, returns 0 for an unknown ID
+	int cycle(u64 NowUs);//read, publish and write once, returns valid joints
+	int start(u32 periodUs, int priority = 0);//cycle() on a dedicated SCSLoop thread, priority >0 runs it SCHED_FIFO
+	void stop();
+	static int job(void *bridge);//SCSLoopJob running cycle(SCSerial::monoUs())
+public:
+	SCSLoop Loop;
+	u8 ACC;//acceleration sent with every goal, 0: maximum
+	u32 Cycles;
+	u32 Lost;//joint reads without a valid reply
+	u32 Goals;//goals written to the bus
+	u32 Replaced;//goals overwritten by a newer one before they were sent
+private:
+	int index(u8 ID);
+private:
+	SMS_STS *bus;
+	u8 N;
+	u8 ID[SCS_BRIDGE_JOINTS];
+	double Offset[SCS_BRIDGE_JOINTS];
+	u64 Goal[SCS_BRIDGE_JOINTS];//bit 63 pending, position steps in bits 16..31, speed in bits 0..15
+	Telemetry Tel[SCS_BRIDGE_JOINTS];
+	SCSJointState Own;
+	SCSBridgeLoan Loan;
+	SCSBridgePublish Publish;
+	void *Arg;
+};
+
+#endif
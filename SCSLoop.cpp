@@ -0,0 +1,199 @@
+/*
+ * SCSLoop.cpp
+ * Fixed-rate control loop with absolute deadlines and jitter statistics
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include "SCSLoop.h"
+
+static u64 tsUs(const struct timespec *ts)
+{
+	return ts->tv_sec*1000000ULL + ts->tv_nsec/1000;
+}
+
+static void tsAdd(struct timespec *ts, u64 us)
+{
+	u64 ns = ts->tv_nsec + (us%1000000)*1000;
+	ts->tv_sec += us/1000000 + ns/1000000000;
+	ts->tv_nsec = ns%1000000000;
+}
+
+SCSLoop::SCSLoop()
+{
+	PeriodUs = 10000;
+	Job = NULL;
+	Arg = NULL;
+	Bus = NULL;
+	Wr = NULL;
+	Rd = NULL;
+	Priority = 0;
+	Cpu = -1;
+	RunCycles = 0;
+	Running = 0;
+	Started = 0;
+	clearStats();
+}
+
+SCSLoop::~SCSLoop()
+{
+	stop();
+}
+
+void SCSLoop::clearStats()
+{
+	memset(&Jitter, 0, sizeof(Jitter));
+	memset(&Period, 0, sizeof(Period));
+	memset(&Work, 0, sizeof(Work));
+	Cycles = 0;
+	Overruns = 0;
+	Skipped = 0;
+}
+
+void SCSLoop::setPeriod(u32 periodUs)
+{
+	PeriodUs = periodUs ? periodUs : 1;
+}
+
+void SCSLoop::setJob(SCSLoopJob job, void *arg)
+{
+	Job = job;
+	Arg = arg;
+}
+
+void SCSLoop::setCycle(SCS *bus, SCSBusSyncWrite *wr, SCSSyncRead *rd)
+{
+	Bus = bus;
+	Wr = wr;
+	Rd = rd;
+}
+
+int SCSLoop::setRealTime(int priority)
+{
+	Priority = priority;
+	return Running ? applySched() : 1;
+}
+
+int SCSLoop::setCpu(int cpu)
+{
+	Cpu = cpu;
+	return Running ? applySched() : 1;
+}
+
+int SCSLoop::lockMemory()
+{
+	return mlockall(MCL_CURRENT | MCL_FUTURE)==0;
+}
+
+int SCSLoop::applySched()
+{
+	int rv = 1;
+	struct sched_param sp;
+	memset(&sp, 0, sizeof(sp));
+	sp.sched_priority = Priority;
+	if(pthread_setschedparam(pthread_self(), Priority ? SCHED_FIFO : SCHED_OTHER, &sp)!=0){
+		rv = 0;
+	}
+	if(Cpu>=0){
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(Cpu, &set);
+		if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set)!=0){
+			rv = 0;
+		}
+	}
+	return rv;
+}
+
+int SCSLoop::run(u32 Cycles)
+{
+	Running = 1;
+	return loop(Cycles);
+}
+
+int SCSLoop::loop(u32 Cycles)
+{
+	if(Priority || Cpu>=0){
+		applySched();
+	}
+	u32 n = 0;
+	u64 lastUs = 0;
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	tsAdd(&next, PeriodUs);
+	while(Running && (!Cycles || n<Cycles)){
+		while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL)==EINTR);
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		u64 wakeUs = tsUs(&now);
+		u64 deadUs = tsUs(&next);
+		Jitter.add((u32)(wakeUs-deadUs));
+		if(lastUs){
+			Period.add((u32)(wakeUs-lastUs));
+		}
+		lastUs = wakeUs;
+		if(Bus && Wr && Wr->IDN){
+			Bus->syncWrite(Wr->ID, Wr->IDN, Wr->MemAddr, Wr->nDat, Wr->nLen);
+		}
+		if(Rd){
+			Rd->exec();
+		}
+		int rc = Job ? Job(Arg) : 0;
+		n++;
+		this->Cycles++;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		u64 endUs = tsUs(&now);
+		Work.add((u32)(endUs-wakeUs));
+		tsAdd(&next, PeriodUs);
+		if(endUs>tsUs(&next)){
+			Overruns++;
+			u32 Lost = (u32)((endUs-tsUs(&next))/PeriodUs);
+			Skipped += Lost;
+			tsAdd(&next, (u64)Lost*PeriodUs);
+		}
+		if(rc<0){
+			break;
+		}
+	}
+	Running = 0;
+	return n;
+}
+
+void *SCSLoop::thread(void *arg)
+{
+	SCSLoop *loop = (SCSLoop*)arg;
+	loop->loop(loop->RunCycles);
+	return NULL;
+}
+
+int SCSLoop::start(u32 Cycles)
+{
+	if(Started){
+		return 0;
+	}
+	RunCycles = Cycles;
+	Running = 1;
+	if(pthread_create(&Thread, NULL, thread, this)!=0){
+		Running = 0;
+		return 0;
+	}
+	Started = 1;
+	return 1;
+}
+
+void SCSLoop::stop()
+{
+	Running = 0;
+	if(Started){
+		pthread_join(Thread, NULL);
+		Started = 0;
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * SCSLoop.h
+ * Fixed-rate control loop with absolute deadlines and jitter statistics
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSLOOP_H
+#define _SCSLOOP_H
+
+#include <pthread.h>
+#include "SCSerial.h"
+#include "SCSStats.h"
+#include "SCSSyncRead.h"
+#include "SCSBusGroup.h"
+
+typedef int (*SCSLoopJob)(void *arg);//called once per period, return <0 to stop the loop
+
+//Each period the loop sleeps to an absolute deadline (clock_nanosleep
+//TIMER_ABSTIME), then runs the configured sync write, the SyncRead
+//session and the callback, in that order. Periods missed by an overrun
+//entirely are skipped, a late cycle runs at once.
+class SCSLoop{
+public:
+	SCSLoop();
+	~SCSLoop();
+	void setPeriod(u32 periodUs);
+	void setJob(SCSLoopJob job, void *arg);
+	void setCycle(SCS *bus, SCSBusSyncWrite *wr, SCSSyncRead *rd);//either may be NULL, wr->IDN = 0 skips the write
+	int setRealTime(int priority);//SCHED_FIFO (1..99) for the thread running the loop, 0 back to SCHED_OTHER
+	int setCpu(int cpu);//pin the thread running the loop, <0 no pinning
+	static int lockMemory();//mlockall current and future pages, returns 1 on success
+	int run(u32 Cycles = 0);//loop in the calling thread, 0 until stop() or the job returns <0, returns cycles run
+	int start(u32 Cycles = 0);//run() in a new thread
+	void stop();//ask the loop to end and join the thread started by start()
+	void clearStats();
+public:
+	SCSHist Jitter;//wake-up lateness against the deadline, us
+	SCSHist Period;//measured period, us
+	SCSHist Work;//time spent in one cycle, us
+	u32 Cycles;
+	u32 Overruns;//cycles that ended after the next deadline
+	u32 Skipped;//periods dropped after overruns
+private:
+	static void *thread(void *arg);
+	int loop(u32 Cycles);
+	int applySched();
+private:
+	u32 PeriodUs;
+	SCSLoopJob Job;
+	void *Arg;
+	SCS *Bus;
+	SCSBusSyncWrite *Wr;
+	SCSSyncRead *Rd;
+	int Priority;
+	int Cpu;
+	u32 RunCycles;
+	volatile int Running;
+	int Started;
+	pthread_t Thread;
+};
+
+#endif
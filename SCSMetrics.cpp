@@ -0,0 +1,426 @@
+/*
+ * SCSMetrics.cpp
+ * Prometheus text exporter of bus statistics and servo health, off the bus thread
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "SCSMetrics.h"
+
+static const char *InstName[SCS_STAT_INST] = {"ping", "read", "write", "reg_write", "action", "sync_read", "sync_write"};
+
+#define SCS_METRICS_LE_MIN 6//histogram bounds 2^6..2^17 us, bucket edges of SCSHist
+#define SCS_METRICS_LE_MAX 17
+
+SCSMetrics::SCSMetrics()
+{
+	BusN = 0;
+	Labels[0] = 0;
+	Collects = 0;
+	Scrapes = 0;
+	ListenFd = -1;
+	Running = 0;
+	pthread_mutex_init(&Mutex, NULL);
+}
+
+SCSMetrics::~SCSMetrics()
+{
+	stop();
+#ifndef SCS_STATIC_ALLOC
+	for(int i=0; i<BusN; i++){
+		delete B[i];
+	}
+#endif
+	pthread_mutex_destroy(&Mutex);
+}
+
+int SCSMetrics::addBus(SCSerial *bus, const char *Name, SCSHealth *Health)
+{
+	if(BusN>=SCS_METRICS_BUSES){
+		return -1;
+	}
+#ifdef SCS_STATIC_ALLOC
+	Bus *b = Pool+BusN;
+#else
+	Bus *b = new Bus;
+#endif
+	memset(b, 0, sizeof(Bus));
+	b->bus = bus;
+	b->Health = Health;
+	snprintf(b->Name, sizeof(b->Name), "%s", Name ? Name : "");
+	pthread_mutex_lock(&Mutex);
+	B[BusN] = b;
+	int n = BusN++;
+	pthread_mutex_unlock(&Mutex);
+	return n;
+}
+
+void SCSMetrics::setLabels(const char *Labels)
+{
+	pthread_mutex_lock(&Mutex);
+	snprintf(this->Labels, sizeof(this->Labels), "%s", Labels ? Labels : "");
+	pthread_mutex_unlock(&Mutex);
+}
+
+int SCSMetrics::collect()
+{
+	pthread_mutex_lock(&Mutex);
+	for(int i=0; i<BusN; i++){
+		Bus *b = B[i];
+		const SCSStats *s = b->bus->getStats();
+		b->Stats = s!=NULL;
+		b->BaudRate = b->bus->getBaudRate();
+		b->Us = SCSerial::monoUs();
+		if(s){
+			b->bus->snapshotStats(b->Inst);
+			for(int ID=0; ID<SCS_STAT_ID; ID++){
+				b->bus->snapshotStats(ID, b->ID+ID);
+			}
+			b->SyncRx = s->SyncRx;
+		}
+		b->Bytes = 0;
+		b->Tx = 0;
+		for(int k=0; k<SCS_STAT_INST; k++){
+			b->Bytes += b->Inst[k].Count.TxBytes+b->Inst[k].Count.RxBytes;
+			b->Tx += b->Inst[k].Count.Tx;
+		}
+		if(b->PrevUs && b->Us>b->PrevUs){
+			double dUs = (double)(b->Us-b->PrevUs);
+			b->TxRate = (b->Tx-b->PrevTx)*1000000.0/dUs;
+			b->Util = b->BaudRate>0 ? (b->Bytes-b->PrevBytes)*10*1000000.0/b->BaudRate/dUs : 0;
+		}
+		b->PrevUs = b->Us;
+		b->PrevBytes = b->Bytes;
+		b->PrevTx = b->Tx;
+		for(int ID=0; ID<SCS_HEALTH_ID; ID++){
+			b->HealthValid[ID] = b->Health && b->Health->get(ID, b->H+ID);
+		}
+	}
+	Collects++;
+	int n = BusN;
+	pthread_mutex_unlock(&Mutex);
+	return n;
+}
+
+int SCSMetrics::labels(char *buf, int size, const Bus *b, const char *Extra)
+{
+	return snprintf(buf, size, "bus=\"%s\"%s%s%s%s", b->Name, Labels[0] ? "," : "", Labels, Extra ? "," : "", Extra ? Extra : "");
+}
+
+static int header(FILE *f, const char *Name, const char *Type, const char *Help)
+{
+	return fprintf(f, "# HELP %s %s\n# TYPE %s %s\n", Name, Help, Name, Type);
+}
+
+int SCSMetrics::print(FILE *f)
+{
+	static const struct{
+		const char *Name;
+		const char *Help;
+		int Field;
+	}Counters[] = {
+		{"scservo_transactions_total", "Transactions per instruction", 0},
+		{"scservo_timeouts_total", "Replies that did not arrive in time", 1},
+		{"scservo_header_errors_total", "Replies with a bad header, ID or length", 2},
+		{"scservo_checksum_errors_total", "Replies with a bad checksum", 3},
+	};
+	char L[SCS_METRICS_LABELS+SCS_METRICS_NAME+64];
+	char X[64];
+	long Start = ftell(f);
+	int n = 0;
+	pthread_mutex_lock(&Mutex);
+	n += header(f, "scservo_stats_enabled", "gauge", "1 if transaction statistics are collected on the bus");
+	for(int i=0; i<BusN; i++){
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_stats_enabled{%s} %d\n", L, B[i]->Stats);
+	}
+	for(unsigned c=0; c<sizeof(Counters)/sizeof(Counters[0]); c++){
+		n += header(f, Counters[c].Name, "counter", Counters[c].Help);
+		for(int i=0; i<BusN; i++){
+			for(int k=0; k<SCS_STAT_INST; k++){
+				const SCSStatCount *s = &B[i]->Inst[k].Count;
+				u32 v = Counters[c].Field==0 ? s->Tx : Counters[c].Field==1 ? s->TimeOut : Counters[c].Field==2 ? s->Header : s->CheckSum;
+				snprintf(X, sizeof(X), "inst=\"%s\"", InstName[k]);
+				labels(L, sizeof(L), B[i], X);
+				n += fprintf(f, "%s{%s} %lu\n", Counters[c].Name, L, v);
+			}
+		}
+	}
+	n += header(f, "scservo_bytes_total", "counter", "Bytes on the line per instruction and direction");
+	for(int i=0; i<BusN; i++){
+		for(int k=0; k<SCS_STAT_INST; k++){
+			const SCSStatCount *s = &B[i]->Inst[k].Count;
+			snprintf(X, sizeof(X), "inst=\"%s\",dir=\"tx\"", InstName[k]);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_bytes_total{%s} %llu\n", L, (unsigned long long)s->TxBytes);
+			snprintf(X, sizeof(X), "inst=\"%s\",dir=\"rx\"", InstName[k]);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_bytes_total{%s} %llu\n", L, (unsigned long long)s->RxBytes);
+		}
+	}
+	n += header(f, "scservo_reply_latency_us", "histogram", "Request to complete reply, microseconds");
+	for(int i=0; i<BusN; i++){
+		for(int k=0; k<SCS_STAT_INST; k++){
+			const SCSHist *h = &B[i]->Inst[k].Reply;
+			if(!h->Count){
+				continue;
+			}
+			for(int e=SCS_METRICS_LE_MIN; e<=SCS_METRICS_LE_MAX; e++){
+				snprintf(X, sizeof(X), "inst=\"%s\",le=\"%u\"", InstName[k], 1u<<e);
+				labels(L, sizeof(L), B[i], X);
+				n += fprintf(f, "scservo_reply_latency_us_bucket{%s} %lu\n", L, h->below(1u<<e));
+			}
+			snprintf(X, sizeof(X), "inst=\"%s\",le=\"+Inf\"", InstName[k]);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_reply_latency_us_bucket{%s} %lu\n", L, h->Count);
+			snprintf(X, sizeof(X), "inst=\"%s\"", InstName[k]);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_reply_latency_us_sum{%s} %llu\n", L, (unsigned long long)h->Sum);
+			n += fprintf(f, "scservo_reply_latency_us_count{%s} %lu\n", L, h->Count);
+		}
+	}
+	n += header(f, "scservo_transactions_per_second", "gauge", "Transaction rate since the previous collect");
+	for(int i=0; i<BusN; i++){
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_transactions_per_second{%s} %.1f\n", L, B[i]->TxRate);
+	}
+	n += header(f, "scservo_bus_utilisation", "gauge", "Share of the line time used by request and reply bytes since the previous collect");
+	for(int i=0; i<BusN; i++){
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_bus_utilisation{%s} %.4f\n", L, B[i]->Util);
+	}
+	n += header(f, "scservo_syncread_replies_total", "counter", "Status packets expected by SyncRead");
+	for(int i=0; i<BusN; i++){
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_syncread_replies_total{%s} %lu\n", L, B[i]->SyncRx.Tx);
+	}
+	n += header(f, "scservo_syncread_missing_total", "counter", "SyncRead status packets that did not arrive");
+	for(int i=0; i<BusN; i++){
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_syncread_missing_total{%s} %lu\n", L, B[i]->SyncRx.TimeOut);
+	}
+	n += header(f, "scservo_syncread_completeness", "gauge", "Share of SyncRead status packets received");
+	for(int i=0; i<BusN; i++){
+		const SCSStatCount *s = &B[i]->SyncRx;
+		labels(L, sizeof(L), B[i], NULL);
+		n += fprintf(f, "scservo_syncread_completeness{%s} %.4f\n", L, s->Tx ? 1.0-(double)s->TimeOut/s->Tx : 1.0);
+	}
+	n += header(f, "scservo_servo_transactions_total", "counter", "Transactions addressed to one servo, SyncRead replies included");
+	for(int i=0; i<BusN; i++){
+		for(int ID=0; ID<SCS_STAT_ID; ID++){
+			if(B[i]->ID[ID].Count.Tx){
+				snprintf(X, sizeof(X), "id=\"%d\"", ID);
+				labels(L, sizeof(L), B[i], X);
+				n += fprintf(f, "scservo_servo_transactions_total{%s} %lu\n", L, B[i]->ID[ID].Count.Tx);
+			}
+		}
+	}
+	n += header(f, "scservo_servo_timeouts_total", "counter", "Replies of one servo that did not arrive");
+	for(int i=0; i<BusN; i++){
+		for(int ID=0; ID<SCS_STAT_ID; ID++){
+			if(B[i]->ID[ID].Count.Tx){
+				snprintf(X, sizeof(X), "id=\"%d\"", ID);
+				labels(L, sizeof(L), B[i], X);
+				n += fprintf(f, "scservo_servo_timeouts_total{%s} %lu\n", L, B[i]->ID[ID].Count.TimeOut);
+			}
+		}
+	}
+	n += header(f, "scservo_servo_reply_latency_us", "summary", "Reply latency of one servo, microseconds");
+	for(int i=0; i<BusN; i++){
+		for(int ID=0; ID<SCS_STAT_ID; ID++){
+			const SCSHist *h = &B[i]->ID[ID].Reply;
+			if(!h->Count){
+				continue;
+			}
+			snprintf(X, sizeof(X), "id=\"%d\",quantile=\"0.5\"", ID);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_servo_reply_latency_us{%s} %lu\n", L, h->percentile(50));
+			snprintf(X, sizeof(X), "id=\"%d\",quantile=\"0.99\"", ID);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_servo_reply_latency_us{%s} %lu\n", L, h->percentile(99));
+			snprintf(X, sizeof(X), "id=\"%d\"", ID);
+			labels(L, sizeof(L), B[i], X);
+			n += fprintf(f, "scservo_servo_reply_latency_us_sum{%s} %llu\n", L, (unsigned long long)h->Sum);
+			n += fprintf(f, "scservo_servo_reply_latency_us_count{%s} %lu\n", L, h->Count);
+		}
+	}
+	static const struct{
+		const char *Name;
+		const char *Type;
+		const char *Help;
+	}Health[] = {
+		{"scservo_servo_present", "gauge", "1 while the servo answers health reads"},
+		{"scservo_servo_temperature_celsius", "gauge", "Present temperature"},
+		{"scservo_servo_voltage_volts", "gauge", "Present voltage"},
+		{"scservo_servo_error_bits", "gauge", "Status byte of the last reply"},
+		{"scservo_servo_health_timeouts_total", "counter", "Health reads without a reply"},
+		{"scservo_servo_last_seen_seconds", "gauge", "Age of the last good health reply"},
+	};
+	for(unsigned c=0; c<sizeof(Health)/sizeof(Health[0]); c++){
+		n += header(f, Health[c].Name, Health[c].Type, Health[c].Help);
+		for(int i=0; i<BusN; i++){
+			for(int ID=0; ID<SCS_HEALTH_ID; ID++){
+				if(!B[i]->HealthValid[ID]){
+					continue;
+				}
+				const SCSHealthRecord *r = B[i]->H+ID;
+				snprintf(X, sizeof(X), "id=\"%d\"", ID);
+				labels(L, sizeof(L), B[i], X);
+				switch(c){
+					case 0: n += fprintf(f, "%s{%s} %d\n", Health[c].Name, L, r->Present); break;
+					case 1: n += fprintf(f, "%s{%s} %d\n", Health[c].Name, L, r->Temperature); break;
+					case 2: n += fprintf(f, "%s{%s} %.1f\n", Health[c].Name, L, r->Voltage/10.0); break;
+					case 3: n += fprintf(f, "%s{%s} %d\n", Health[c].Name, L, r->Error); break;
+					case 4: n += fprintf(f, "%s{%s} %lu\n", Health[c].Name, L, r->Timeouts); break;
+					default: n += fprintf(f, "%s{%s} %.3f\n", Health[c].Name, L, r->Stamp && B[i]->Us>r->Stamp ? (B[i]->Us-r->Stamp)/1000000.0 : 0.0); break;
+				}
+			}
+		}
+	}
+	pthread_mutex_unlock(&Mutex);
+	return Start>=0 ? (int)(ftell(f)-Start) : n;
+}
+
+int SCSMetrics::writeFile(const char *Path)
+{
+	char Tmp[512];
+	snprintf(Tmp, sizeof(Tmp), "%s.tmp", Path);
+	FILE *f = fopen(Tmp, "w");
+	if(!f){
+		return 0;
+	}
+	collect();
+	print(f);
+	if(fclose(f)!=0 || rename(Tmp, Path)!=0){
+		unlink(Tmp);
+		return 0;
+	}
+	return 1;
+}
+
+void SCSMetrics::answer(int fd)
+{
+	char Req[1024];
+	int Len = 0;
+	struct pollfd pfd = {fd, POLLIN, 0};
+	while(Len<(int)sizeof(Req)-1 && poll(&pfd, 1, 1000)>0){
+		int r = read(fd, Req+Len, sizeof(Req)-1-Len);
+		if(r<=0){
+			break;
+		}
+		Len += r;
+		Req[Len] = 0;
+		if(strstr(Req, "\r\n\r\n") || strstr(Req, "\n\n")){
+			break;
+		}
+	}
+	Req[Len] = 0;
+	size_t BodyLen = 0;
+	int Found = !strncmp(Req, "GET /metrics", 12) || !strncmp(Req, "GET / ", 6);
+#ifdef SCS_STATIC_ALLOC
+	if(Found){
+		FILE *f = fmemopen(Body, sizeof(Body), "w");
+		if(f){
+			collect();
+			print(f);
+			fflush(f);
+			long n = ftell(f);
+			BodyLen = n>0 ? n : 0;
+			fclose(f);
+		}
+		Scrapes++;
+	}
+#else
+	char *Body = NULL;
+	if(Found){
+		FILE *f = open_memstream(&Body, &BodyLen);
+		if(f){
+			collect();
+			print(f);
+			fclose(f);
+		}
+		Scrapes++;
+	}
+#endif
+	char Head[160];
+	int HeadLen = snprintf(Head, sizeof(Head), "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n", Found ? "200 OK" : "404 Not Found", (unsigned long)BodyLen);
+	if(write(fd, Head, HeadLen)==HeadLen && BodyLen){
+		size_t Sent = 0;
+		while(Sent<BodyLen){
+			ssize_t w = write(fd, Body+Sent, BodyLen-Sent);
+			if(w<=0){
+				break;
+			}
+			Sent += w;
+		}
+	}
+#ifndef SCS_STATIC_ALLOC
+	free(Body);
+#endif
+}
+
+void *SCSMetrics::thread(void *arg)
+{
+	SCSMetrics *m = (SCSMetrics*)arg;
+	while(m->Running){
+		struct pollfd pfd = {m->ListenFd, POLLIN, 0};
+		if(poll(&pfd, 1, 200)<=0){
+			continue;
+		}
+		int fd = accept(m->ListenFd, NULL, NULL);
+		if(fd<0){
+			continue;
+		}
+		m->answer(fd);
+		close(fd);
+	}
+	return NULL;
+}
+
+int SCSMetrics::serve(int Port)
+{
+	if(Running){
+		return 1;
+	}
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd<0){
+		return 0;
+	}
+	int On = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &On, sizeof(On));
+	struct sockaddr_in a;
+	memset(&a, 0, sizeof(a));
+	a.sin_family = AF_INET;
+	a.sin_addr.s_addr = htonl(INADDR_ANY);
+	a.sin_port = htons(Port);
+	if(bind(fd, (struct sockaddr*)&a, sizeof(a))!=0 || listen(fd, 4)!=0){
+		close(fd);
+		return 0;
+	}
+	ListenFd = fd;
+	Running = 1;
+	if(pthread_create(&Thread, NULL, thread, this)!=0){
+		Running = 0;
+		close(fd);
+		ListenFd = -1;
+		return 0;
+	}
+	return 1;
+}
+
+void SCSMetrics::stop()
+{
+	if(!Running){
+		return;
+	}
+	Running = 0;
+	pthread_join(Thread, NULL);
+	close(ListenFd);
+	ListenFd = -1;
+}
@@ -0,0 +1,87 @@
+/*
+ * SCSMetrics.h
+ * Prometheus text exporter of bus statistics and servo health, off the bus thread
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSMETRICS_H
+#define _SCSMETRICS_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "SCSerial.h"
+#include "SCSStats.h"
+#include "SCSHealth.h"
+
+#define SCS_METRICS_BUSES 8
+#define SCS_METRICS_NAME 32
+#define SCS_METRICS_LABELS 128
+#ifndef SCS_METRICS_BODY
+#define SCS_METRICS_BODY 262144//largest scrape answer of the fixed allocation build
+#endif
+
+//collect() copies the SCSStats of every bus (enableStats()) and the
+//SCSHealth records without taking the bus lock: the bus thread keeps
+//running and pays nothing for the exporter, a counter read while it is
+//updated is at most one transaction behind. print() writes the last
+//snapshot in the Prometheus text format (an OpenTelemetry collector
+//takes it through its prometheus receiver): counters per instruction,
+//reply latency histograms, per-ID latency summaries, SyncRead
+//completeness, line utilisation and rates since the previous collect(),
+//and temperature, voltage and error bits per servo. Publish with
+//writeFile() for a node_exporter textfile collector or serve() for a
+//scrape endpoint.
+class SCSMetrics{
+public:
+	SCSMetrics();
+	~SCSMetrics();
+	int addBus(SCSerial *bus, const char *Name, SCSHealth *Health = NULL);//returns the bus index, -1 if full
+	void setLabels(const char *Labels);//added to every series, e.g. robot="r17",site="lab"
+	int collect();//snapshot every bus, returns buses collected
+	int print(FILE *f);//text format of the last snapshot, returns bytes written
+	int writeFile(const char *Path);//collect() and replace Path atomically, 1 on success
+	int serve(int Port);//thread answering GET /metrics with a fresh collect(), 1 if listening
+	void stop();
+public:
+	u32 Collects;
+	u32 Scrapes;
+private:
+	struct Bus{
+		SCSerial *bus;
+		SCSHealth *Health;
+		char Name[SCS_METRICS_NAME];
+		int Stats;//statistics were enabled at the last collect
+		int BaudRate;
+		u64 Us;
+		u64 Bytes;
+		u32 Tx;
+		u64 PrevUs;
+		u64 PrevBytes;
+		u32 PrevTx;
+		double TxRate;//transactions/s since the previous collect
+		double Util;//share of the line time in use
+		SCSStatInst Inst[SCS_STAT_INST];
+		SCSStatCount SyncRx;
+		SCSStatID ID[SCS_STAT_ID];
+		SCSHealthRecord H[SCS_HEALTH_ID];
+		u8 HealthValid[SCS_HEALTH_ID];
+	};
+	int labels(char *buf, int size, const Bus *b, const char *Extra);
+	static void *thread(void *arg);
+	void answer(int fd);
+private:
+	Bus *B[SCS_METRICS_BUSES];
+#ifdef SCS_STATIC_ALLOC
+	Bus Pool[SCS_METRICS_BUSES];
+	char Body[SCS_METRICS_BODY];//answer() of the serve() thread
+#endif
+	int BusN;
+	char Labels[SCS_METRICS_LABELS];
+	pthread_mutex_t Mutex;//collect() and print() of different threads
+	int ListenFd;
+	volatile int Running;
+	pthread_t Thread;
+};
+
+#endif
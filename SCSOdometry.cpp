@@ -0,0 +1,102 @@
+/*
+ * SCSOdometry.cpp
+ * Wheel-mode encoder unwrapping, velocity estimation and odometry from SyncRead telemetry
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <math.h>
+#include "SCSOdometry.h"
+
+SCSOdometry::SCSOdometry(SCSerial *bus)
+{
+	this->bus = bus;
+	Alpha = 0.5;
+	N = 0;
+	Cycles = 0;
+	memset(W, 0, sizeof(W));
+	memset(Index, 0, sizeof(Index));
+}
+
+int SCSOdometry::addWheel(u8 ID, double MetersPerTick, int Dir)
+{
+	if(N>=SCS_ODOM_WHEELS || ID>=0xfe || Index[ID]){
+		return -1;
+	}
+	SCSWheel *w = W+N;
+	memset(w, 0, sizeof(SCSWheel));
+	w->ID = ID;
+	w->Dir = Dir<0 ? -1 : 1;
+	w->MetersPerTick = MetersPerTick;
+	this->ID[N] = ID;
+	Index[ID] = N+1;
+	return N++;
+}
+
+void SCSOdometry::reset()
+{
+	for(u8 i=0; i<N; i++){
+		W[i].Ticks = 0;
+		W[i].Distance = 0;
+		W[i].Velocity = 0;
+		W[i].Speed = 0;
+		W[i].Init = 0;
+	}
+}
+
+int SCSOdometry::update(const Telemetry Tel[], const u8 ID[], u8 IDN)
+{
+	int n = 0;
+	for(u8 i=0; i<IDN; i++){
+		if(ID[i]>=0xfe || !Index[ID[i]]){
+			continue;
+		}
+		SCSWheel *w = W+Index[ID[i]]-1;
+		const Telemetry *t = Tel+i;
+		w->Valid = t->Valid;
+		if(!t->Valid){
+			w->Missed++;
+			continue;
+		}
+		s16 Raw = ((t->Position%SCS_ODOM_TICKS)+SCS_ODOM_TICKS)%SCS_ODOM_TICKS;
+		if(!w->Init){
+			w->Raw = Raw;
+			w->Stamp = t->Stamp;
+			w->Init = 1;
+			n++;
+			continue;
+		}
+		double dt = (double)(long long)(t->Stamp-w->Stamp)*1e-6;
+		int Step = Raw-w->Raw;
+		//the turn count is ambiguous, pick the wrap nearest the servo's speed
+		double Expect = dt>0 ? t->Speed*dt : 0;
+		Step += (int)floor((Expect-Step)/SCS_ODOM_TICKS+0.5)*SCS_ODOM_TICKS;
+		w->Raw = Raw;
+		w->Stamp = t->Stamp;
+		w->Ticks += Step*w->Dir;
+		w->Distance = w->Ticks*w->MetersPerTick;
+		if(dt>0){
+			w->Velocity += Alpha*(Step*w->Dir/dt-w->Velocity);
+			w->Speed = w->Velocity*w->MetersPerTick;
+		}
+		n++;
+	}
+	Cycles++;
+	return n;
+}
+
+int SCSOdometry::cycle()
+{
+	if(!bus || !N){
+		return 0;
+	}
+	bus->SyncFeedBack(ID, N, Tel);
+	return update(Tel, ID, N);
+}
+
+int SCSOdometry::job(void *odometry)
+{
+	((SCSOdometry*)odometry)->cycle();
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * SCSOdometry.h
+ * Wheel-mode encoder unwrapping, velocity estimation and odometry from SyncRead telemetry
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSODOMETRY_H
+#define _SCSODOMETRY_H
+
+#include "SCSerial.h"
+
+#define SCS_ODOM_WHEELS 16//wheels of one odometry
+#define SCS_ODOM_TICKS 4096//encoder steps per turn
+
+struct SCSWheel{
+	u8 ID;
+	int Dir;//+1 or -1, mirrored wheels of a base count forward both
+	double MetersPerTick;//wheel circumference / SCS_ODOM_TICKS, 0: distances stay 0
+	long long Ticks;//unwrapped position since the first sample, signed by Dir
+	double Distance;//Ticks in m
+	double Velocity;//estimated from position and timestamps, ticks/s, filtered
+	double Speed;//Velocity in m/s
+	u64 Stamp;//arrival of the last good sample
+	u8 Valid;//1: the last update had a good reply
+	u32 Missed;
+	s16 Raw;//last encoder reading, 0..SCS_ODOM_TICKS-1
+	u8 Init;
+};
+
+//update() takes the Telemetry[] of one SyncFeedBack (any order, other
+//servos are skipped) and for each wheel unwraps the encoder, averages the
+//position step over the real time between the two replies and adds the
+//step to the odometry. A step is taken as the wrap that lies closest to
+//the servo's own speed reading times the elapsed time, so a few lost
+//cycles at full speed do not lose turns. No allocation, one pass.
+class SCSOdometry{
+public:
+	SCSOdometry(SCSerial *bus = NULL);
+	int addWheel(u8 ID, double MetersPerTick = 0, int Dir = 1);//returns the wheel index, -1 if full
+	void reset();//odometry back to 0, the next sample starts over
+	int update(const Telemetry Tel[], const u8 ID[], u8 IDN);//returns wheels updated
+	int cycle();//SyncFeedBack of the wheels on the bus, then update(), returns wheels updated
+	static int job(void *odometry);//SCSLoopJob running cycle()
+public:
+	double Alpha;//velocity filter, 1: raw step/dt (default 0.5)
+	u8 N;
+	SCSWheel W[SCS_ODOM_WHEELS];
+	u32 Cycles;
+private:
+	SCSerial *bus;
+	u8 ID[SCS_ODOM_WHEELS];
+	u8 Index[0xfe];//ID to wheel index+1, 0 not a wheel
+	Telemetry Tel[SCS_ODOM_WHEELS];
+};
+
+#endif
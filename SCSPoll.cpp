@@ -0,0 +1,178 @@
+/*
+ * SCSPoll.cpp
+ * Rate-based telemetry polling with a bus-time budget per tick
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSPoll.h"
+#include "SCSRetry.h"
+
+SCSPoller::SCSPoller(SCSerial *bus)
+{
+	this->bus = bus;
+	BudgetUs = 1000;
+	Ticks = 0;
+	Deferred = 0;
+	LastBusUs = 0;
+	Hedged = 0;
+	Retry = NULL;
+	EntryN = 0;
+}
+
+void SCSPoller::clear()
+{
+	EntryN = 0;
+}
+
+int SCSPoller::add(u8 ID, u8 MemAddr, u8 nLen, u32 RateHz)
+{
+	if(EntryN>=SCS_POLL_ENTRIES || !nLen || nLen>SCS_POLL_LEN || !RateHz || find(ID, MemAddr)){
+		return -1;
+	}
+	SCSPollEntry *e = Entry+EntryN;
+	memset(e, 0, sizeof(SCSPollEntry));
+	e->ID = ID;
+	e->MemAddr = MemAddr;
+	e->nLen = nLen;
+	e->PeriodUs = 1000000/RateHz;
+	return EntryN++;
+}
+
+SCSPollEntry *SCSPoller::find(u8 ID, u8 MemAddr)
+{
+	for(int i=0; i<EntryN; i++){
+		if(Entry[i].ID==ID && Entry[i].MemAddr==MemAddr){
+			return Entry+i;
+		}
+	}
+	return NULL;
+}
+
+u32 SCSPoller::busUs(u8 IDN, u8 nLen)
+{
+	int Baud = bus->getBaudRate();
+	if(Baud<=0){
+		return 0;
+	}
+	u32 Bytes = IDN+8+(u32)IDN*(nLen+6);
+	return (u32)(((u64)Bytes*10*1000000ULL+Baud-1)/Baud)+bus->ReturnDelayUs*IDN;
+}
+
+//demoted servos keep their phase but wait a multiple of the period
+u32 SCSPoller::period(SCSPollEntry *e)
+{
+	return Retry ? e->PeriodUs*Retry->demote(e->ID) : e->PeriodUs;
+}
+
+int SCSPoller::read(Group *g, u64 NowUs)
+{
+	bus->syncReadBegin(g->IDN, g->nLen, rxBuff);
+	bus->syncReadPacketTx(g->ID, g->IDN, g->MemAddr, g->nLen);
+	u64 Stamp = SCSerial::monoUs();
+	bus->syncReadPacketRxAll(rxTab, 0xfe);
+	int Num = 0;
+	for(u8 i=0; i<g->IDN; i++){
+		SCSPollEntry *e = Entry+g->Index[i];
+		SyncReadRx *rx = rxTab+g->ID[i];
+		e->Polls++;
+		if(g->ID[i]>=0xfe || !rx->Valid){
+			e->Misses++;
+			if(Retry){
+				Retry->report(e->ID, 0);
+				//due again at once: the next tick carries it in its SyncRead
+				if(e->Retries+1<Retry->Policy.Attempts){
+					e->Retries++;
+					e->DueUs = NowUs;
+					Hedged++;
+				}else{
+					e->Retries = 0;
+				}
+			}
+			continue;
+		}
+		if(Retry){
+			Retry->report(e->ID, 1);
+		}
+		e->Retries = 0;
+		memcpy(e->Dat, rx->Dat, e->nLen);
+		e->Valid = 1;
+		e->Error = rx->Error;
+		e->Stamp = rx->Stamp ? rx->Stamp : Stamp;
+		Num++;
+	}
+	return Num;
+}
+
+int SCSPoller::tick(u64 NowUs)
+{
+	u8 Due[SCS_POLL_ENTRIES];
+	double Rank[SCS_POLL_ENTRIES];
+	int DueN = 0;
+	Ticks++;
+	//overdue entries, most late (in periods) first
+	for(int i=0; i<EntryN; i++){
+		SCSPollEntry *e = Entry+i;
+		if(e->DueUs>NowUs){
+			continue;
+		}
+		double r = (double)(NowUs-e->DueUs)/period(e);
+		int k = DueN++;
+		while(k>0 && Rank[k-1]<r){
+			Due[k] = Due[k-1];
+			Rank[k] = Rank[k-1];
+			k--;
+		}
+		Due[k] = i;
+		Rank[k] = r;
+	}
+	Group Groups[SCS_POLL_GROUPS];
+	int GroupN = 0;
+	u32 Used = 0;
+	for(int k=0; k<DueN; k++){
+		SCSPollEntry *e = Entry+Due[k];
+		int g = 0;
+		while(g<GroupN && (Groups[g].MemAddr!=e->MemAddr || Groups[g].nLen!=e->nLen)){
+			g++;
+		}
+		u32 Cost;
+		if(g<GroupN){
+			Cost = busUs(Groups[g].IDN+1, e->nLen)-busUs(Groups[g].IDN, e->nLen);
+		}else{
+			Cost = busUs(1, e->nLen);
+		}
+		if(Used+Cost>BudgetUs || (g==GroupN && GroupN==SCS_POLL_GROUPS)){
+			Deferred++;
+			continue;
+		}
+		if(g==GroupN){
+			Groups[g].MemAddr = e->MemAddr;
+			Groups[g].nLen = e->nLen;
+			Groups[g].IDN = 0;
+			GroupN++;
+		}
+		Group *p = Groups+g;
+		p->ID[p->IDN] = e->ID;
+		p->Index[p->IDN++] = Due[k];
+		Used += Cost;
+		//keep the phase, but do not build a backlog after a long stall
+		u32 Period = period(e);
+		e->DueUs += Period;
+		if(e->DueUs<=NowUs){
+			e->DueUs = NowUs+Period;
+		}
+	}
+	LastBusUs = Used;
+	int Num = 0;
+	for(int g=0; g<GroupN; g++){
+		Num += read(Groups+g, NowUs);
+	}
+	return Num;
+}
+
+int SCSPoller::job(void *poller)
+{
+	((SCSPoller*)poller)->tick(SCSerial::monoUs());
+	return 0;
+}
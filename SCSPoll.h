@@ -0,0 +1,77 @@
+/*
+ * SCSPoll.h
+ * Rate-based telemetry polling with a bus-time budget per tick
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSPOLL_H
+#define _SCSPOLL_H
+
+#include "SCSerial.h"
+
+class SCSRetry;
+
+#define SCS_POLL_ENTRIES 64//(servo, register range) entries of one poller
+#define SCS_POLL_LEN 16//register bytes per entry
+#define SCS_POLL_GROUPS 8//distinct register ranges read in one tick
+
+//One (servo, register range) at a target rate. Dat holds the last
+//payload read, Stamp the arrival of its status packet.
+struct SCSPollEntry{
+	u8 ID;
+	u8 MemAddr;
+	u8 nLen;
+	u8 Valid;//1: Dat is from a good status packet
+	u8 Error;//servo status byte
+	u32 PeriodUs;
+	u64 DueUs;//next deadline
+	u64 Stamp;//arrival of the last good status packet, monotonic us
+	u32 Polls;//reads requested
+	u32 Misses;//reads without a good reply
+	u8 Retries;//consecutive misses read again in the next tick
+	u8 Dat[SCS_POLL_LEN];
+};
+
+//Each tick the overdue entries are ranked by lateness relative to their
+//period and packed into SyncReads, one per register range, until the
+//estimated bus time (request, replies, return delays at the current
+//baud rate) would exceed BudgetUs. Entries that do not fit stay due and
+//rise in rank, so slow fields rotate through the spare slots.
+class SCSPoller{
+public:
+	SCSPoller(SCSerial *bus);
+	int add(u8 ID, u8 MemAddr, u8 nLen, u32 RateHz);//returns the entry index, -1 if full or nLen too large
+	void clear();
+	int tick(u64 NowUs);//run this tick's SyncReads, returns entries read
+	static int job(void *poller);//SCSLoopJob running tick(SCSerial::monoUs())
+	SCSPollEntry *get(int i){  return Entry+i;  }
+	SCSPollEntry *find(u8 ID, u8 MemAddr);
+	u32 busUs(u8 IDN, u8 nLen);//estimated bus time of one SyncRead of IDN servos
+	void setRetry(SCSRetry *retry){  Retry = retry;  }//hedge missed reads into the next tick and demote flaky servos, NULL: off
+public:
+	u32 BudgetUs;//bus time per tick, default 1000us
+	u32 Ticks;
+	u32 Deferred;//due entries pushed to a later tick by the budget
+	u32 LastBusUs;//estimated bus time of the last tick
+	u32 Hedged;//missed entries read again in the following tick
+	int EntryN;
+	SCSPollEntry Entry[SCS_POLL_ENTRIES];
+private:
+	struct Group{
+		u8 MemAddr;
+		u8 nLen;
+		u8 IDN;
+		u8 ID[SCS_POLL_ENTRIES];
+		u8 Index[SCS_POLL_ENTRIES];
+	};
+	int read(Group *g, u64 NowUs);
+	u32 period(SCSPollEntry *e);
+private:
+	SCSerial *bus;
+	SCSRetry *Retry;
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_POLL_ENTRIES*(SCS_POLL_LEN+6)];
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * SCSPredict.cpp
+ * Servo state extrapolation from timestamped telemetry with an age-based confidence
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <math.h>
+#include "SCSPredict.h"
+
+SCSPredictor::SCSPredictor()
+{
+	SpeedWeight = 0.5;
+	Alpha = 0.5;
+	FreshUs = 2000;
+	MaxAgeUs = 50000;
+	N = 0;
+	memset(S, 0, sizeof(S));
+	memset(Index, 0, sizeof(Index));
+}
+
+int SCSPredictor::addServo(u8 ID)
+{
+	if(N>=SCS_PRED_SERVOS || ID>=0xfe || Index[ID]){
+		return -1;
+	}
+	memset(S+N, 0, sizeof(SCSPredState));
+	S[N].ID = ID;
+	Index[ID] = N+1;
+	return N++;
+}
+
+int SCSPredictor::setServos(const u8 ID[], u8 IDN)
+{
+	int n = 0;
+	for(u8 i=0; i<IDN; i++){
+		n += addServo(ID[i])>=0;
+	}
+	return n;
+}
+
+void SCSPredictor::reset()
+{
+	for(u8 i=0; i<N; i++){
+		u8 ID = S[i].ID;
+		memset(S+i, 0, sizeof(SCSPredState));
+		S[i].ID = ID;
+	}
+}
+
+void SCSPredictor::sample(SCSPredState *s, s16 Position, s16 Speed, u64 Stamp)
+{
+	if(s->Init && Stamp<=s->Stamp){
+		return;//held or repeated
+	}
+	if(s->Init){
+		SCSPrediction p;
+		extrapolate(s, Stamp, &p);
+		double dt = (Stamp-s->Stamp)*1e-6;
+		int Step = Position-s->Position;
+		//a wheel crossing the end of the turn, pick the wrap nearest the speed reading
+		Step += (int)floor((Speed*dt-Step)/SCS_PRED_TICKS+0.5)*SCS_PRED_TICKS;
+		double Miss = fabs(p.Position-(s->Position+Step));
+		s->Residual += Alpha*(Miss-s->Residual);
+		s->Velocity += Alpha*(Step/dt-s->Velocity);
+	}else{
+		s->Velocity = Speed;
+		s->Init = 1;
+	}
+	s->Position = Position;
+	s->Speed = Speed;
+	s->Stamp = Stamp;
+	s->Samples++;
+}
+
+int SCSPredictor::update(const SCSTelemetryFrame &f)
+{
+	int n = 0;
+	for(u8 i=0; i<f.IDN; i++){
+		if(!f.Valid[i] || f.ID[i]>=0xfe || !Index[f.ID[i]]){
+			continue;
+		}
+		SCSPredState *s = S+Index[f.ID[i]]-1;
+		u32 Samples = s->Samples;
+		sample(s, f.Position[i], f.Speed[i], f.Stamp[i]);
+		n += s->Samples!=Samples;
+	}
+	return n;
+}
+
+int SCSPredictor::update(const Telemetry Tel[], const u8 ID[], u8 IDN)
+{
+	int n = 0;
+	for(u8 i=0; i<IDN; i++){
+		if(!Tel[i].Valid || ID[i]>=0xfe || !Index[ID[i]]){
+			continue;
+		}
+		SCSPredState *s = S+Index[ID[i]]-1;
+		u32 Samples = s->Samples;
+		sample(s, Tel[i].Position, Tel[i].Speed, Tel[i].Stamp);
+		n += s->Samples!=Samples;
+	}
+	return n;
+}
+
+void SCSPredictor::extrapolate(const SCSPredState *s, u64 AtUs, SCSPrediction *p) const
+{
+	p->ID = s->ID;
+	if(!s->Init){
+		p->Position = 0;
+		p->Speed = 0;
+		p->AgeUs = 0;
+		p->Confidence = 0;
+		return;
+	}
+	long long Age = (long long)(AtUs-s->Stamp);
+	long long Ahead = Age<(long long)MaxAgeUs ? Age : MaxAgeUs;
+	p->Speed = SpeedWeight*s->Speed+(1-SpeedWeight)*s->Velocity;
+	p->Position = s->Position+p->Speed*Ahead*1e-6;
+	p->AgeUs = Age>0 ? (u32)Age : 0;
+	if(p->AgeUs<=FreshUs){
+		p->Confidence = 1;
+	}else if(p->AgeUs>=MaxAgeUs || MaxAgeUs<=FreshUs){
+		p->Confidence = 0;
+	}else{
+		p->Confidence = 1-(double)(p->AgeUs-FreshUs)/(MaxAgeUs-FreshUs);
+	}
+}
+
+int SCSPredictor::predict(u8 ID, u64 AtUs, SCSPrediction *p) const
+{
+	if(ID>=0xfe || !Index[ID]){
+		return 0;
+	}
+	extrapolate(S+Index[ID]-1, AtUs, p);
+	return 1;
+}
+
+int SCSPredictor::predictAll(u64 AtUs, SCSPrediction p[]) const
+{
+	int n = 0;
+	for(u8 i=0; i<N; i++){
+		extrapolate(S+i, AtUs, p+i);
+		n += S[i].Init;
+	}
+	return n;
+}
@@ -0,0 +1,69 @@
+/*
+ * SCSPredict.h
+ * Servo state extrapolation from timestamped telemetry with an age-based confidence
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSPREDICT_H
+#define _SCSPREDICT_H
+
+#include "Telemetry.h"
+#include "SCSTelemetryStore.h"
+
+#define SCS_PRED_SERVOS SCS_SOA_SERVOS
+#define SCS_PRED_TICKS 4096//encoder steps per turn
+
+struct SCSPrediction{
+	u8 ID;
+	double Position;//steps at the requested time, not wrapped to one turn
+	double Speed;//steps/s used for the extrapolation
+	u32 AgeUs;//requested time minus the arrival of the newest sample
+	double Confidence;//1 fresh ... 0 at MaxAgeUs or without a sample
+};
+
+struct SCSPredState{
+	u8 ID;
+	u8 Init;
+	s16 Position;//newest sample
+	s16 Speed;//servo's own speed reading of the newest sample
+	u64 Stamp;
+	double Velocity;//position steps over real time, filtered
+	double Residual;//|prediction - sample| of the last samples, filtered, steps
+	u32 Samples;
+};
+
+//update() takes a SCSTelemetryFrame of SCSTelemetryStore::read() (or the
+//Telemetry[] of SyncFeedBack) and keeps the newest sample of each servo;
+//held entries and repeated frames change nothing. predict() extrapolates
+//the position to any time with a constant speed that blends the servo's
+//own speed reading and the measured position rate, so the controller can
+//run at its own rate on the state at its own time. The extrapolation
+//stops at MaxAgeUs past the sample and Confidence falls linearly from 1
+//at FreshUs to 0 at MaxAgeUs. Residual tracks how far the previous
+//prediction missed each new sample, a measure of the jitter.
+class SCSPredictor{
+public:
+	SCSPredictor();
+	int addServo(u8 ID);//returns the servo index, -1 if full
+	int setServos(const u8 ID[], u8 IDN);//returns servos added
+	void reset();//forget the samples
+	int update(const SCSTelemetryFrame &f);//returns new samples taken
+	int update(const Telemetry Tel[], const u8 ID[], u8 IDN);
+	int predict(u8 ID, u64 AtUs, SCSPrediction *p) const;//0 if ID is not a predicted servo
+	int predictAll(u64 AtUs, SCSPrediction p[]) const;//p[0..N) in addServo() order, returns servos with a sample
+public:
+	double SpeedWeight;//share of the speed reading in the extrapolation speed, the rest is the position rate (default 0.5)
+	double Alpha;//filter of the position rate and Residual (default 0.5)
+	u32 FreshUs;//full confidence up to this age (default 2000)
+	u32 MaxAgeUs;//no confidence and no further extrapolation from this age (default 50000)
+	u8 N;
+	SCSPredState S[SCS_PRED_SERVOS];
+private:
+	void sample(SCSPredState *s, s16 Position, s16 Speed, u64 Stamp);
+	void extrapolate(const SCSPredState *s, u64 AtUs, SCSPrediction *p) const;
+private:
+	u8 Index[0xfe];//ID to servo index+1, 0 not predicted
+};
+
+#endif
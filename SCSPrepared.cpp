@@ -0,0 +1,101 @@
+/*
+ * SCSPrepared.cpp
+ * Pre-encoded sync write and sync read frames for commands repeated every cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSPrepared.h"
+
+SCSSyncWritePacket::SCSSyncWritePacket()
+{
+	IDN = 0;
+	MemAddr = 0;
+	nLen = 0;
+	Len = 0;
+	Sum = 0;
+}
+
+int SCSSyncWritePacket::prepare(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	if(!IDN || !nLen || (nLen+1)*IDN>SCS_SYNC_WRITE_MAX){
+		return 0;
+	}
+	this->IDN = IDN;
+	this->MemAddr = MemAddr;
+	this->nLen = nLen;
+	u8 mesLen = (nLen+1)*IDN+4;
+	Frame[0] = 0xff;
+	Frame[1] = 0xff;
+	Frame[2] = 0xfe;
+	Frame[3] = mesLen;
+	Frame[4] = INST_SYNC_WRITE;
+	Frame[5] = MemAddr;
+	Frame[6] = nLen;
+	Sum = 0xfe + mesLen + INST_SYNC_WRITE + MemAddr + nLen;
+	u8 *p = Frame+7;
+	for(u8 i=0; i<IDN; i++){
+		*p++ = ID[i];
+		Sum += ID[i];
+		memset(p, 0, nLen);
+		p += nLen;
+	}
+	Len = p-Frame+1;
+	return 1;
+}
+
+void SCSSyncWritePacket::set(u8 i, const u8 *nDat)
+{
+	u8 *p = Frame+8+i*(nLen+1);
+	for(u8 k=0; k<nLen; k++){
+		Sum += nDat[k]-p[k];
+		p[k] = nDat[k];
+	}
+}
+
+const u8 *SCSSyncWritePacket::frame()
+{
+	Frame[Len-1] = ~Sum;
+	return Frame;
+}
+
+void SCSSyncWritePacket::send(SCS *bus)
+{
+	if(Len){
+		bus->writePrepared(frame(), Len);
+	}
+}
+
+SCSSyncReadPacket::SCSSyncReadPacket()
+{
+	IDN = 0;
+	MemAddr = 0;
+	nLen = 0;
+	Len = 0;
+}
+
+int SCSSyncReadPacket::prepare(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	if(!IDN || IDN>0xfe){
+		return 0;
+	}
+	this->IDN = IDN;
+	this->MemAddr = MemAddr;
+	this->nLen = nLen;
+	u8 Sum = 0xfe + (IDN+4) + INST_SYNC_READ + MemAddr + nLen;
+	Frame[0] = 0xff;
+	Frame[1] = 0xff;
+	Frame[2] = 0xfe;
+	Frame[3] = IDN+4;
+	Frame[4] = INST_SYNC_READ;
+	Frame[5] = MemAddr;
+	Frame[6] = nLen;
+	for(u8 i=0; i<IDN; i++){
+		Frame[7+i] = ID[i];
+		Sum += ID[i];
+	}
+	Frame[7+IDN] = ~Sum;
+	Len = IDN+8;
+	return 1;
+}
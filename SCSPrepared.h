@@ -0,0 +1,83 @@
+/*
+ * SCSPrepared.h
+ * Pre-encoded sync write and sync read frames for commands repeated every cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSPREPARED_H
+#define _SCSPREPARED_H
+
+#include "SCS.h"
+#include "SCSRegMap.h"
+
+#define SCS_PREP_FRAME (255+4)//one packet at length byte 255
+
+//SYNC_WRITE frame for a fixed ID list, address and length. The header,
+//the IDs and their checksum contribution are encoded once by prepare();
+//set() patches one servo's payload in place and keeps a running byte
+//sum, so a cycle costs the changed bytes and one checksum store instead
+//of re-framing the packet. Everything must fit one packet
+//(SCS_SYNC_WRITE_MAX servo data bytes).
+class SCSSyncWritePacket{
+public:
+	SCSSyncWritePacket();
+	int prepare(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//1, 0 if the frame would not fit one packet
+	void set(u8 i, const u8 *nDat);//payload of servo ID[i], nLen bytes
+	void set(u8 i, u8 Off, u8 bDat)//one payload byte
+	{
+		u8 *p = Frame+8+i*(nLen+1)+Off;
+		Sum += bDat-*p;
+		*p = bDat;
+	}
+	template<class Map, class Reg> void set(u8 i, int v)//one field, must lie inside MemAddr..MemAddr+nLen
+	{
+		u8 bBuf[Reg::width];
+		SCSField<Reg, Map::End>::encode(bBuf, v);
+		for(u8 k=0; k<Reg::width; k++){
+			set(i, Reg::addr-MemAddr+k, bBuf[k]);
+		}
+	}
+	template<class Map> void setPosEx(u8 i, s16 Position, u16 Speed, u8 ACC = 0)//prepared at Map::Acc with the Acc..GoalSpeed length
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+		u8 bBuf[PosExBlock::len];
+		PosExBlock::template set<typename Map::Acc, Map::End>(bBuf, ACC);
+		PosExBlock::template set<typename Map::GoalPosition, Map::End>(bBuf, Position);
+		PosExBlock::template set<typename Map::GoalTime, Map::End>(bBuf, 0);
+		PosExBlock::template set<typename Map::GoalSpeed, Map::End>(bBuf, Speed);
+		set(i, bBuf);
+	}
+	void send(SCS *bus);
+	const u8 *frame();//complete frame with the current checksum
+	int length(){  return Len;  }
+public:
+	u8 IDN;
+	u8 MemAddr;
+	u8 nLen;
+private:
+	u8 Frame[SCS_PREP_FRAME];
+	int Len;
+	u8 Sum;//bytes 2..Len-2 of the frame
+};
+
+//SYNC_READ request for a fixed ID list, encoded once. send() takes the
+//place of syncReadPacketTx(), decode the replies with
+//syncReadPacketRxAll() as usual (after syncReadBegin()).
+class SCSSyncReadPacket{
+public:
+	SCSSyncReadPacket();
+	int prepare(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//1, 0 if IDN is 0 or above 0xfe
+	int send(SCS *bus){  return bus->syncReadPrepared(Frame, Len, IDN, nLen);  }//returns reply bytes received
+	const u8 *frame(){  return Frame;  }
+	int length(){  return Len;  }
+public:
+	u8 IDN;
+	u8 MemAddr;
+	u8 nLen;
+private:
+	u8 Frame[254+8];
+	int Len;
+};
+
+#endif
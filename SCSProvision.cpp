@@ -0,0 +1,250 @@
+/*
+ * SCSProvision.cpp
+ * Declarative EPROM provisioning of SMS/STS servos: bulk read, diff, batched write, read-back
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "SCSProvision.h"
+
+typedef SMS_STS_Map M;
+
+template<class Reg> static void provSet(u8 *Img, int v)
+{
+	SCSField<Reg, M::End>::encode(Img+Reg::addr-SCS_PROV_ADDR, v);
+}
+
+SCSProvision::SCSProvision(SMS_STS *bus)
+{
+	this->bus = bus;
+	Packets = 0;
+	Bytes = 0;
+	clear();
+}
+
+void SCSProvision::clear()
+{
+	ServoN = 0;
+}
+
+int SCSProvision::add(const SCSServoConfig &Cfg)
+{
+	if(ServoN>=SCS_PROV_SERVOS || Cfg.ID>=0xfe){
+		return -1;
+	}
+	this->Cfg[ServoN] = Cfg;
+	Result[ServoN] = SCS_PROV_ABSENT;
+	return ServoN++;
+}
+
+int SCSProvision::readImage(const u8 ID[], u8 IDN, u8 (*Img)[SCS_PROV_LEN], u8 Got[])
+{
+	bus->syncReadBegin(IDN, SCS_PROV_LEN, rxBuff);
+	bus->syncReadPacketTx((u8*)ID, IDN, SCS_PROV_ADDR, SCS_PROV_LEN);
+	bus->syncReadPacketRxAll(rxTab, 0xfe);
+	bus->syncReadEnd();
+	int Num = 0;
+	for(u8 i=0; i<IDN; i++){
+		Got[i] = ID[i]<0xfe && rxTab[ID[i]].Valid;
+		if(Got[i]){
+			memcpy(Img[i], rxTab[ID[i]].Dat, SCS_PROV_LEN);
+			Num++;
+		}
+	}
+	return Num;
+}
+
+int SCSProvision::plan()
+{
+	u8 ID[SCS_PROV_SERVOS];
+	u8 Got[SCS_PROV_SERVOS];
+	for(int i=0; i<ServoN; i++){
+		ID[i] = Cfg[i].ID;
+	}
+	if(!ServoN || !readImage(ID, ServoN, Current, Got)){
+		return -1;
+	}
+	int Num = 0;
+	for(int i=0; i<ServoN; i++){
+		SCSServoConfig *c = Cfg+i;
+		if(!Got[i]){
+			Result[i] = SCS_PROV_ABSENT;
+			continue;
+		}
+		u8 *t = Target[i];
+		memcpy(t, Current[i], SCS_PROV_LEN);
+		if(c->Set&SCS_PROV_ID){
+			provSet<M::ID>(t, c->NewID);
+		}
+		if(c->Set&SCS_PROV_BAUD){
+			provSet<M::BaudRate>(t, c->Baud);
+		}
+		if(c->Set&SCS_PROV_LIMITS){
+			provSet<M::MinAngleLimit>(t, c->MinAngle);
+			provSet<M::MaxAngleLimit>(t, c->MaxAngle);
+		}
+		if(c->Set&SCS_PROV_DEAD){
+			provSet<M::CwDead>(t, c->CwDead);
+			provSet<M::CcwDead>(t, c->CcwDead);
+		}
+		if(c->Set&SCS_PROV_OFS){
+			provSet<M::Ofs>(t, c->Ofs);
+		}
+		if(c->Set&SCS_PROV_MODE){
+			provSet<M::Mode>(t, c->Mode);
+		}
+		Result[i] = memcmp(t, Current[i], SCS_PROV_LEN) ? SCS_PROV_PLANNED : SCS_PROV_UNCHANGED;
+	}
+	//a new ID must not land on another servo that keeps its ID, or on another new ID
+	for(int i=0; i<ServoN; i++){
+		if(Result[i]!=SCS_PROV_PLANNED){
+			continue;
+		}
+		u8 NewID = Target[i][0];
+		for(int j=0; j<ServoN; j++){
+			if(j==i || Result[j]==SCS_PROV_ABSENT || Result[j]==SCS_PROV_CONFLICT){
+				continue;
+			}
+			u8 Other = (Result[j]==SCS_PROV_PLANNED) ? Target[j][0] : Current[j][0];
+			if(NewID!=Cfg[i].ID && Other==NewID){
+				Result[i] = SCS_PROV_CONFLICT;
+				break;
+			}
+		}
+		if(Result[i]==SCS_PROV_PLANNED){
+			Num++;
+		}
+	}
+	return Num;
+}
+
+//one sync write per address range that differs on some servo within
+//First..Last (image offsets), small gaps are written through
+int SCSProvision::writeRanges(int First, int Last)
+{
+	int Num = 0;
+	int k = First;
+	while(k<=Last){
+		int Lo = k;
+		int Hi = -1;
+		for(int j=k; j<=Last && (Hi<0 || j-Hi<=SCS_PROV_GAP); j++){
+			for(int i=0; i<ServoN; i++){
+				if(Result[i]==SCS_PROV_PLANNED && Target[i][j]!=Current[i][j]){
+					if(Hi<0){
+						Lo = j;
+					}
+					Hi = j;
+					break;
+				}
+			}
+		}
+		if(Hi<0){
+			break;
+		}
+		u8 ID[SCS_PROV_SERVOS];
+		u8 IDN = 0;
+		u8 nLen = Hi-Lo+1;
+		for(int i=0; i<ServoN; i++){
+			if(Result[i]==SCS_PROV_PLANNED && memcmp(Target[i]+Lo, Current[i]+Lo, nLen)){
+				memcpy(txBuff+IDN*nLen, Target[i]+Lo, nLen);
+				ID[IDN++] = Cfg[i].ID;
+			}
+		}
+		bus->syncWrite(ID, IDN, SCS_PROV_ADDR+Lo, txBuff, nLen);
+		Packets++;
+		Bytes += IDN*nLen;
+		Num++;
+		k = Hi+1;
+	}
+	return Num;
+}
+
+void SCSProvision::lockAll(u8 Lock)
+{
+	bus->writeByte(0xfe, SMS_STS_LOCK, Lock);
+	Packets++;
+}
+
+int SCSProvision::apply()
+{
+	Packets = 0;
+	Bytes = 0;
+	int Write = 0;
+	for(int i=0; i<ServoN; i++){
+		Write |= Result[i]==SCS_PROV_PLANNED;
+	}
+	int HostBaud = bus->getBaudRate();
+	int Num = 0;
+	if(Write){
+		lockAll(0);
+		//everything but ID and baud first, those move the servo away
+		writeRanges(M::BaudRate::addr+1-SCS_PROV_ADDR, SCS_PROV_LEN-1);
+		writeRanges(0, M::BaudRate::addr-SCS_PROV_ADDR);
+		usleep(SCSERIAL_EEPROM_US);
+		//lock at every rate the servos run at now
+		int Rates[SCSERIAL_BAUD_CODES];
+		int RateN = 0;
+		Rates[RateN++] = HostBaud;
+		for(int i=0; i<ServoN; i++){
+			u8 Code = Target[i][M::BaudRate::addr-SCS_PROV_ADDR];
+			if(Result[i]!=SCS_PROV_PLANNED || Code>=SCSERIAL_BAUD_CODES){
+				continue;
+			}
+			int Rate = SCSerial::baudTable[Code];
+			int r = 0;
+			while(r<RateN && Rates[r]!=Rate){
+				r++;
+			}
+			if(r==RateN){
+				Rates[RateN++] = Rate;
+			}
+		}
+		for(int r=0; r<RateN; r++){
+			if(bus->setBaudRate(Rates[r])!=1){
+				continue;
+			}
+			lockAll(1);
+			usleep(SCSERIAL_EEPROM_US);
+			u8 ID[SCS_PROV_SERVOS];
+			u8 Index[SCS_PROV_SERVOS];
+			u8 IDN = 0;
+			for(int i=0; i<ServoN; i++){
+				u8 Code = Target[i][M::BaudRate::addr-SCS_PROV_ADDR];
+				if(Result[i]==SCS_PROV_PLANNED && Code<SCSERIAL_BAUD_CODES && SCSerial::baudTable[Code]==Rates[r]){
+					Index[IDN] = i;
+					ID[IDN++] = Target[i][0];
+				}
+			}
+			if(!IDN){
+				continue;
+			}
+			u8 Img[SCS_PROV_SERVOS][SCS_PROV_LEN];
+			u8 Got[SCS_PROV_SERVOS];
+			readImage(ID, IDN, Img, Got);
+			for(u8 k=0; k<IDN; k++){
+				int i = Index[k];
+				if(Got[k] && !memcmp(Img[k], Target[i], SCS_PROV_LEN)){
+					Result[i] = SCS_PROV_VERIFIED;
+					Num++;
+				}else{
+					Result[i] = SCS_PROV_MISMATCH;
+				}
+			}
+		}
+		if(bus->getBaudRate()!=HostBaud){
+			bus->setBaudRate(HostBaud);
+		}
+		//servos at a rate that could not be set
+		for(int i=0; i<ServoN; i++){
+			if(Result[i]==SCS_PROV_PLANNED){
+				Result[i] = SCS_PROV_MISMATCH;
+			}
+		}
+	}
+	for(int i=0; i<ServoN; i++){
+		Num += Result[i]==SCS_PROV_UNCHANGED;
+	}
+	return Num;
+}
@@ -0,0 +1,82 @@
+/*
+ * SCSProvision.h
+ * Declarative EPROM provisioning of SMS/STS servos: bulk read, diff, batched write, read-back
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSPROVISION_H
+#define _SCSPROVISION_H
+
+#include "SMS_STS.h"
+
+#define SCS_PROV_SERVOS 32//servos of one provisioning run
+#define SCS_PROV_ADDR SMS_STS_ID//EPROM image read and compared, ID..Mode
+#define SCS_PROV_LEN (SMS_STS_MODE-SMS_STS_ID+1)
+#define SCS_PROV_GAP 6//unchanged bytes written through rather than starting another sync write
+
+//SCSServoConfig::Set bits
+#define SCS_PROV_ID 0x01
+#define SCS_PROV_BAUD 0x02
+#define SCS_PROV_LIMITS 0x04//MinAngle and MaxAngle
+#define SCS_PROV_DEAD 0x08//CwDead and CcwDead
+#define SCS_PROV_OFS 0x10
+#define SCS_PROV_MODE 0x20
+
+//SCSProvision::Result
+#define SCS_PROV_ABSENT 0//no reply to the bulk read
+#define SCS_PROV_UNCHANGED 1//already configured, nothing written
+#define SCS_PROV_PLANNED 2//plan() found differences
+#define SCS_PROV_VERIFIED 3//written and read back equal
+#define SCS_PROV_MISMATCH 4//written, read back differs or no reply
+#define SCS_PROV_CONFLICT 5//new ID is taken by another servo
+
+//Target values of one servo; only the fields selected in Set are
+//provisioned, everything else is left as found.
+struct SCSServoConfig{
+	u8 ID;//current ID
+	u8 Set;//SCS_PROV_* fields to provision
+	u8 NewID;
+	u8 Baud;//baud code, SMS_STS_1M ...
+	u16 MinAngle;
+	u16 MaxAngle;
+	u8 CwDead;
+	u8 CcwDead;
+	s16 Ofs;
+	u8 Mode;
+};
+
+//plan() reads the EPROM image of every configured servo with one
+//SyncRead and builds the target images. apply() writes the bytes that
+//differ: one sync write per changed address range across all servos,
+//with one broadcast unlock and one broadcast lock per baud rate; IDs and
+//baud codes are written last in one sync write, then the servos are read
+//back at their new IDs and rates. The host is left at its original rate.
+class SCSProvision{
+public:
+	SCSProvision(SMS_STS *bus);
+	void clear();
+	int add(const SCSServoConfig &Cfg);//returns the servo index, -1 if full
+	int plan();//returns servos that need writes, -1 if no configured servo answered
+	int apply();//plan() first, returns servos verified, unchanged ones included
+	int run(){  return plan()<0 ? -1 : apply();  }
+public:
+	int ServoN;
+	SCSServoConfig Cfg[SCS_PROV_SERVOS];
+	u8 Result[SCS_PROV_SERVOS];
+	u8 Current[SCS_PROV_SERVOS][SCS_PROV_LEN];//image found by plan()
+	u8 Target[SCS_PROV_SERVOS][SCS_PROV_LEN];
+	u32 Packets;//sync writes and lock writes sent by the last apply()
+	u32 Bytes;//servo data bytes written by the last apply()
+private:
+	int readImage(const u8 ID[], u8 IDN, u8 (*Img)[SCS_PROV_LEN], u8 Got[]);
+	int writeRanges(int First, int Last);
+	void lockAll(u8 Lock);
+private:
+	SMS_STS *bus;
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_PROV_SERVOS*(SCS_PROV_LEN+6)];
+	u8 txBuff[SCS_PROV_SERVOS*SCS_PROV_LEN];
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * SCSPtySim.cpp
+ * SCSSim servos behind a pseudo terminal, in real time, for the unchanged serial stack
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include "SCSPtySim.h"
+#include "SCSerial.h"
+
+SCSPtySim::SCSPtySim(SCSSim *sim)
+{
+	this->sim = sim;
+	Master = -1;
+	Slave = -1;
+	Path[0] = 0;
+	Link[0] = 0;
+	StartUs = 0;
+#ifndef SCS_STATIC_ALLOC
+	Out = new Chunk[SCS_PTYSIM_CHUNKS];
+#endif
+	OutHead = OutTail = 0;
+	Requests = 0;
+	Overflows = 0;
+	FollowBaud = 1;
+	Running = 0;
+	Started = 0;
+	pthread_mutex_init(&Mutex, NULL);
+}
+
+SCSPtySim::~SCSPtySim()
+{
+	close();
+#ifndef SCS_STATIC_ALLOC
+	delete[] Out;
+#endif
+	pthread_mutex_destroy(&Mutex);
+}
+
+int SCSPtySim::open(const char *link)
+{
+	close();
+	Master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if(Master == -1 || grantpt(Master) || unlockpt(Master) || !ptsname(Master)){
+		close();
+		return 0;
+	}
+	snprintf(Path, sizeof(Path), "%s", ptsname(Master));
+	Slave = ::open(Path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if(Slave == -1){
+		close();
+		return 0;
+	}
+	struct termios opt;
+	tcgetattr(Slave, &opt);
+	cfmakeraw(&opt);
+	tcsetattr(Slave, TCSANOW, &opt);
+	fcntl(Master, F_SETFL, fcntl(Master, F_GETFL) | O_NONBLOCK);
+	if(link){
+		unlink(link);
+		if(symlink(Path, link)){
+			close();
+			return 0;
+		}
+		snprintf(Link, sizeof(Link), "%s", link);
+	}
+	StartUs = SCSerial::monoUs()-sim->Clock;
+	OutHead = OutTail = 0;
+	return 1;
+}
+
+void SCSPtySim::close()
+{
+	stop();
+	if(Link[0]){
+		unlink(Link);
+		Link[0] = 0;
+	}
+	if(Slave != -1){
+		::close(Slave);
+		Slave = -1;
+	}
+	if(Master != -1){
+		::close(Master);
+		Master = -1;
+	}
+	Path[0] = 0;
+}
+
+void SCSPtySim::hostBaud()
+{
+	static const struct{ speed_t Speed; int Rate; } Table[] = {
+		{B9600, 9600}, {B19200, 19200}, {B38400, 38400}, {B57600, 57600},
+		{B115200, 115200}, {B230400, 230400}, {B460800, 460800}, {B500000, 500000},
+		{B576000, 576000}, {B921600, 921600}, {B1000000, 1000000}, {B1152000, 1152000},
+		{B1500000, 1500000}, {B2000000, 2000000}, {B2500000, 2500000}, {B3000000, 3000000},
+	};
+	struct termios opt;
+	if(tcgetattr(Slave, &opt)){
+		return;
+	}
+	speed_t s = cfgetospeed(&opt);
+	for(u32 i=0; i<sizeof(Table)/sizeof(Table[0]); i++){
+		if(Table[i].Speed==s){
+			sim->BaudRate = Table[i].Rate;
+			return;
+		}
+	}
+}
+
+//the motion model runs on real time, never behind the requests' virtual time
+void SCSPtySim::sync(u64 NowUs)
+{
+	u64 Virtual = NowUs-StartUs;
+	if(Virtual>sim->Clock){
+		sim->step(Virtual-sim->Clock);
+	}
+}
+
+void SCSPtySim::release(u64 NowUs)
+{
+	while(OutTail!=OutHead){
+		Chunk *c = Out+(OutTail%SCS_PTYSIM_CHUNKS);
+		if((long)(c->ReleaseUs-NowUs)>0){
+			return;
+		}
+		int Pos = 0;
+		while(Pos<c->Len){
+			int n = write(Master, c->Dat+Pos, c->Len-Pos);
+			if(n<=0){
+				if(n<0 && errno==EAGAIN){
+					struct pollfd pfd = {Master, POLLOUT, 0};
+					::poll(&pfd, 1, 10);
+					continue;
+				}
+				break;
+			}
+			Pos += n;
+		}
+		OutTail++;
+	}
+}
+
+int SCSPtySim::run(long timeOutUs)
+{
+	if(Master == -1){
+		return 0;
+	}
+	u64 EndUs = SCSerial::monoUs()+timeOutUs;
+	int Done = 0;
+	u8 Buf[4096];
+	while(1){
+		u64 Now = SCSerial::monoUs();
+		long Wait = (long)(EndUs-Now);
+		if(Wait<=0 || (Started && !Running)){
+			break;
+		}
+		if(OutTail!=OutHead){
+			long Due = (long)(Out[OutTail%SCS_PTYSIM_CHUNKS].ReleaseUs-Now);
+			if(Due<Wait){
+				Wait = Due<0 ? 0 : Due;
+			}
+		}
+		if(Wait>10000){
+			Wait = 10000;//keep stop() responsive
+		}
+		struct pollfd pfd = {Master, POLLIN, 0};
+		struct timespec ts = {Wait/1000000, (Wait%1000000)*1000};
+		ppoll(&pfd, 1, &ts, NULL);
+		Now = SCSerial::monoUs();
+		lock();
+		int n = read(Master, Buf, sizeof(Buf));
+		if(n>0){
+			Requests++;
+			if(FollowBaud){
+				hostBaud();
+			}
+			sync(Now);
+			u32 Rx = sim->RxPackets;
+			sim->write(Buf, n);
+			Done += sim->RxPackets-Rx;
+			if(sim->available()){
+				if(OutHead-OutTail>=SCS_PTYSIM_CHUNKS){
+					Overflows++;
+					sim->flush();
+				}else{
+					Chunk *c = Out+(OutHead%SCS_PTYSIM_CHUNKS);
+					c->Len = sim->read(c->Dat, sizeof(c->Dat));
+					c->ReleaseUs = StartUs+sim->Clock;
+					OutHead++;
+				}
+			}
+		}else{
+			sync(Now);
+		}
+		release(SCSerial::monoUs());
+		unlock();
+	}
+	return Done;
+}
+
+void *SCSPtySim::thread(void *arg)
+{
+	SCSPtySim *p = (SCSPtySim*)arg;
+	while(p->Running){
+		p->run(100000);
+	}
+	return NULL;
+}
+
+int SCSPtySim::start()
+{
+	if(Master == -1 || Started){
+		return 0;
+	}
+	Running = 1;
+	Started = 1;
+	if(pthread_create(&Thread, NULL, thread, this) != 0){
+		Running = 0;
+		Started = 0;
+		return 0;
+	}
+	return 1;
+}
+
+void SCSPtySim::stop()
+{
+	if(!Started){
+		return;
+	}
+	Running = 0;
+	pthread_join(Thread, NULL);
+	Started = 0;
+}
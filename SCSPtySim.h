@@ -0,0 +1,70 @@
+/*
+ * SCSPtySim.h
+ * SCSSim servos behind a pseudo terminal, in real time, for the unchanged serial stack
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSPTYSIM_H
+#define _SCSPTYSIM_H
+
+#include <pthread.h>
+#include "SCSSim.h"
+
+#define SCS_PTYSIM_CHUNKS 64//reply blocks waiting for their release time
+
+//Opens a pty pair and serves the SCSSim on the master side: the host
+//opens path() (or a symlink to it) with SCSerial::begin() like a USB
+//adapter. The virtual clock of the simulator is tied to real time. The
+//status packets of a request become readable only when real time has
+//caught up with the simulated request wire time, return delays and
+//reply wire time, so baud rate and return delay pace the host as on a
+//real bus. The host's line rate is taken from the termios of the slave
+//side: set SCSSim::End to 1 for SCSCL servos.
+class SCSPtySim{
+public:
+	SCSPtySim(SCSSim *sim);
+	~SCSPtySim();
+	int open(const char *link = NULL);//create the pty, link: optional symlink to the slave, returns 1 on success
+	const char *path(){  return Path;  }
+	int start();//serve in a thread, the sim must not be touched meanwhile without lock()
+	void stop();
+	int run(long timeOutUs);//serve in the calling thread for at most timeOutUs, returns requests executed
+	void close();
+	void lock(){  pthread_mutex_lock(&Mutex);  }//hold the sim against the serving thread
+	void unlock(){  pthread_mutex_unlock(&Mutex);  }
+public:
+	u32 Requests;//request chunks read from the host
+	u32 Overflows;//reply blocks dropped, more than SCS_PTYSIM_CHUNKS pending
+	u8 FollowBaud;//1 (default): SCSSim::BaudRate follows the host termios
+private:
+	static void *thread(void *arg);
+	void sync(u64 NowUs);
+	void release(u64 NowUs);
+	void hostBaud();
+private:
+	SCSSim *sim;
+	int Master;
+	int Slave;//kept open so the master sees no hangup between host sessions
+	char Path[64];
+	char Link[128];
+	u64 StartUs;//real time of virtual clock 0
+	struct Chunk{
+		u64 ReleaseUs;
+		int Len;
+		u8 Dat[SCS_SIM_TX_MAX];
+	};
+#ifdef SCS_STATIC_ALLOC
+	Chunk Out[SCS_PTYSIM_CHUNKS];
+#else
+	Chunk *Out;//ring of SCS_PTYSIM_CHUNKS
+#endif
+	u32 OutHead;
+	u32 OutTail;
+	pthread_mutex_t Mutex;
+	volatile int Running;
+	int Started;
+	pthread_t Thread;
+};
+
+#endif
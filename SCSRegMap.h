@@ -0,0 +1,84 @@
+/*
+ * SCSRegMap.h
+ * Compile-time control table descriptors and field codec
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSREGMAP_H
+#define _SCSREGMAP_H
+
+#include "INST.h"
+#include "SCSByteOrder.h"
+
+#define SCS_REG_R 1
+#define SCS_REG_W 2
+#define SCS_REG_RW 3
+#define SCS_REG_EPROM 4//lives in EEPROM, writes need the lock cleared
+
+//One control table entry. SignBit is the direction bit of a
+//sign-magnitude field (15 or 10), 0 for unsigned fields.
+template<u8 Addr, u8 Width, u8 SignBit = 0, u8 Access = SCS_REG_RW>
+struct SCSReg{
+	static const int addr = Addr;
+	static const int width = Width;
+	static const int signBit = SignBit;
+	static const int access = Access;
+	static_assert(Width==1 || Width==2, "SCSReg: fields are 1 or 2 bytes");
+	static_assert(SignBit<Width*8, "SCSReg: sign bit outside the field");
+};
+
+//Field codec, End is the byte order of the model (0: little, 1: big).
+//Everything is resolved at compile time, p points at the first byte
+//of the field.
+template<class Reg, u8 End>
+struct SCSField{
+	static u16 raw(const u8 *p)
+	{
+		return Reg::width==1 ? p[0] : SCSByteOrder<End>::get16(p);
+	}
+	static void raw(u8 *p, u16 v)
+	{
+		if(Reg::width==1){
+			p[0] = (u8)v;
+		}else{
+			SCSByteOrder<End>::put16(p, v);
+		}
+	}
+	static int decode(const u8 *p)
+	{
+		int v = raw(p);
+		if(Reg::signBit && (v&(1<<Reg::signBit))){
+			v = -(v&~(1<<Reg::signBit));
+		}
+		return v;
+	}
+	static void encode(u8 *p, int v)
+	{
+		static_assert(Reg::access & SCS_REG_W, "SCSField: read-only field");
+		if(Reg::signBit && v<0){
+			v = (-v)|(1<<Reg::signBit);
+		}
+		raw(p, (u16)v);
+	}
+};
+
+//Contiguous range of fields moved by one Read/genWrite, First..Last inclusive
+template<class First, class Last>
+struct SCSRegBlock{
+	static const int addr = First::addr;
+	static const int len = Last::addr+Last::width-First::addr;
+	static_assert(Last::addr>=First::addr, "SCSRegBlock: Last before First");
+	template<class Reg, u8 End> static int get(const u8 *blk)
+	{
+		static_assert(Reg::addr>=addr && Reg::addr+Reg::width<=addr+len, "SCSRegBlock: field outside the block");
+		return SCSField<Reg, End>::decode(blk+Reg::addr-addr);
+	}
+	template<class Reg, u8 End> static void set(u8 *blk, int v)
+	{
+		static_assert(Reg::addr>=addr && Reg::addr+Reg::width<=addr+len, "SCSRegBlock: field outside the block");
+		SCSField<Reg, End>::encode(blk+Reg::addr-addr, v);
+	}
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * SCSRetry.cpp
+ * Retry policy with escalating timeouts and per-servo health scoring
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include "SCSRetry.h"
+#include "SCSTrace.h"
+
+SCSRetry::SCSRetry(SCSerial *bus)
+{
+	this->bus = bus;
+	Policy.Attempts = 3;
+	Policy.MarginUs = 1000;
+	Policy.BackOff = 2;
+	Policy.MaxMarginUs = 20000;
+	DemoteScore = SCS_HEALTH_MAX/2;
+	reset();
+}
+
+void SCSRetry::reset()
+{
+	Retries = 0;
+	Failures = 0;
+	for(int i=0; i<0xfe; i++){
+		Health[i].Score = SCS_HEALTH_MAX;
+		Health[i].Run = 0;
+		Health[i].Ok = 0;
+		Health[i].Fail = 0;
+	}
+}
+
+//exponential moving score, a miss costs a quarter, a good reply wins back an eighth of the gap
+void SCSRetry::report(u8 ID, int Ok)
+{
+	if(ID>=0xfe){
+		return;
+	}
+	SCSHealth *h = Health+ID;
+	if(Ok){
+		h->Score += (SCS_HEALTH_MAX-h->Score+7)/8;
+		h->Run = 0;
+		h->Ok++;
+	}else{
+		h->Score -= (h->Score+3)/4;
+		if(h->Run<0xff){
+			h->Run++;
+		}
+		h->Fail++;
+	}
+}
+
+u32 SCSRetry::demote(u8 ID)
+{
+	if(ID>=0xfe){
+		return 1;
+	}
+	u32 Mul = 1;
+	u32 s = Health[ID].Score;
+	while(s<DemoteScore && Mul<SCS_HEALTH_DEMOTE_MAX){
+		Mul *= 2;
+		s *= 2;
+	}
+	return Mul;
+}
+
+void SCSRetry::begin()
+{
+	savedAdaptive = bus->AdaptiveTimeOut;
+	savedMarginUs = bus->TimeOutMarginUs;
+}
+
+void SCSRetry::attempt(int n, u8 ID)
+{
+	u32 Margin = Policy.MarginUs;
+	for(int i=0; i<n && Margin<Policy.MaxMarginUs; i++){
+		Margin *= Policy.BackOff;
+	}
+	if(Margin>Policy.MaxMarginUs){
+		Margin = Policy.MaxMarginUs;
+	}
+	if(n){
+		Retries++;
+		if(bus->getTrace()){
+			bus->getTrace()->add(SCS_TRACE_RETRY, bus->getTraceTag(), ID, 0, 0, 0, n);
+		}
+	}
+	bus->AdaptiveTimeOut = 1;
+	bus->TimeOutMarginUs = Margin;
+}
+
+void SCSRetry::end()
+{
+	bus->AdaptiveTimeOut = savedAdaptive;
+	bus->TimeOutMarginUs = savedMarginUs;
+}
+
+int SCSRetry::Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
+{
+	int rv = 0;
+	begin();
+	for(int n=0; n<Policy.Attempts || !n; n++){
+		attempt(n, ID);
+		rv = bus->Read(ID, MemAddr, nData, nLen);
+		if(rv==nLen){
+			break;
+		}
+	}
+	end();
+	report(ID, rv==nLen);
+	if(rv!=nLen){
+		Failures++;
+		return 0;
+	}
+	return rv;
+}
+
+int SCSRetry::Ping(u8 ID)
+{
+	int rv = -1;
+	begin();
+	for(int n=0; n<Policy.Attempts || !n; n++){
+		attempt(n, ID);
+		rv = bus->Ping(ID);
+		if(rv!=-1){
+			break;
+		}
+	}
+	end();
+	report(ID, rv!=-1);
+	if(rv==-1){
+		Failures++;
+	}
+	return rv;
+}
+
+int SCSRetry::genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen)
+{
+	int rv = 0;
+	begin();
+	for(int n=0; n<Policy.Attempts || !n; n++){
+		attempt(n, ID);
+		rv = bus->genWrite(ID, MemAddr, nDat, nLen);
+		if(rv){
+			break;
+		}
+	}
+	end();
+	if(ID!=0xfe && bus->Level){
+		report(ID, rv);
+	}
+	if(!rv){
+		Failures++;
+	}
+	return rv;
+}
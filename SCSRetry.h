@@ -0,0 +1,64 @@
+/*
+ * SCSRetry.h
+ * Retry policy with escalating timeouts and per-servo health scoring
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSRETRY_H
+#define _SCSRETRY_H
+
+#include "SCSerial.h"
+
+#define SCS_HEALTH_MAX 1000//score of a servo that always answers
+#define SCS_HEALTH_DEMOTE_MAX 8//largest poll period multiplier of a flaky servo
+
+//Attempts per transaction. Each attempt waits the wire time of the
+//request and reply plus a margin, starting at MarginUs and multiplied by
+//BackOff on every further attempt up to MaxMarginUs, so a first miss
+//costs a short timeout instead of the full IOTimeOut.
+struct SCSRetryPolicy{
+	u8 Attempts;//tries per transaction, 1: no retry
+	u32 MarginUs;
+	u8 BackOff;
+	u32 MaxMarginUs;
+};
+
+struct SCSHealth{
+	u16 Score;//0..SCS_HEALTH_MAX, decays on misses and recovers on good replies
+	u8 Run;//consecutive misses
+	u32 Ok;
+	u32 Fail;
+};
+
+//Runs transactions on bus under Policy and keeps a health score per ID.
+//SCSPoller::setRetry() uses the same object: a missed entry is read
+//again inside the next tick's SyncRead, and servos whose score falls
+//below DemoteScore are polled at a multiple of their period.
+class SCSRetry{
+public:
+	SCSRetry(SCSerial *bus);
+	int Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen);//returns nLen, 0 after the last attempt failed
+	int Ping(u8 ID);
+	int genWrite(u8 ID, u8 MemAddr, u8 *nDat, u8 nLen);//ack retried, the write itself is repeated
+	void report(u8 ID, int Ok);//account one transaction in the health of ID
+	int score(u8 ID){  return ID<0xfe ? Health[ID].Score : 0;  }
+	u32 demote(u8 ID);//poll period multiplier of ID, 1 for a healthy servo
+	void reset();
+public:
+	SCSRetryPolicy Policy;//default 3 attempts, 1000us margin doubling up to 20000us
+	u16 DemoteScore;//score below which the poll rate halves, and again at each halving of the score
+	u32 Retries;//attempts after the first
+	u32 Failures;//transactions that failed every attempt
+	SCSHealth Health[0xfe];
+private:
+	void begin();
+	void attempt(int n, u8 ID);
+	void end();
+private:
+	SCSerial *bus;
+	u8 savedAdaptive;
+	unsigned long int savedMarginUs;
+};
+
+#endif
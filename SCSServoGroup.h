@@ -0,0 +1,184 @@
+/*
+ * SCSServoGroup.h
+ * Servo group built once from an ID list: prepared frames, command and telemetry buffers, one cycle call
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSERVOGROUP_H
+#define _SCSSERVOGROUP_H
+
+#include <string.h>
+#include "SCSerial.h"
+#include "SCSPrepared.h"
+#include "Telemetry.h"
+
+#ifndef SCS_GROUP_SERVOS
+#define SCS_GROUP_SERVOS 31//largest group whose position frame fits one sync write packet
+#endif
+
+#define SCS_GROUP_POSITION 0//Acc..GoalSpeed, servo mode 0
+#define SCS_GROUP_WHEEL 1//Acc..GoalSpeed with speed only, servo mode 1
+#define SCS_GROUP_PWM 2//GoalTime as PWM, servo mode 2
+
+//Family is a series with an acceleration register (SMS_STS, SMSBL,
+//SMSCL) or its map. init() encodes the SYNC_WRITE frame of the group's
+//mode and the SYNC_READ frame of the feedback block once; setPosition(),
+//setSpeed() and setPwm() patch one servo's payload in place (i is the
+//index in the ID list, see index()). cycle() sends the command frame,
+//if anything was set since the last one, together with the SyncRead in
+//a single write and decodes the replies into Tel[]. No command goes out
+//before every servo of the group has been given one, so an unset servo
+//is never driven to zero. Arms, grippers and wheels are separate groups,
+//each run at its own rate, e.g. as the job of its own SCSLoop.
+template<class Family>
+class ServoGroup{
+public:
+	typedef typename Family::Map Map;
+	typedef typename Map::FeedBack FB;
+	typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+
+	ServoGroup(SCSerial *bus) : IDN(0), Mode(SCS_GROUP_POSITION), Cycles(0), Lost(0), Writes(0), bus(bus), Dirty(0), SetN(0)
+	{
+		memset(Set, 0, sizeof(Set));
+	}
+	int init(const u8 ID[], u8 IDN, u8 Mode = SCS_GROUP_POSITION)//1, 0 if IDN is 0 or above SCS_GROUP_SERVOS
+	{
+		if(!IDN || IDN>SCS_GROUP_SERVOS || Mode>SCS_GROUP_PWM){
+			return 0;
+		}
+		memcpy(this->ID, ID, IDN);
+		this->IDN = IDN;
+		memset(Tel, 0, sizeof(Tel));
+		Read.prepare(ID, IDN, FB::addr, FB::len);
+		return setMode(Mode);
+	}
+	int setMode(u8 Mode)//switch the command frame, every servo needs a new command afterwards
+	{
+		if(Mode==SCS_GROUP_PWM){
+			Write.prepare(ID, IDN, Map::GoalTime::addr, Map::GoalTime::width);
+		}else if(Mode<=SCS_GROUP_WHEEL){
+			Write.prepare(ID, IDN, PosExBlock::addr, PosExBlock::len);
+		}else{
+			return 0;
+		}
+		this->Mode = Mode;
+		memset(Set, 0, sizeof(Set));
+		SetN = 0;
+		Dirty = 0;
+		return 1;
+	}
+	int applyMode()//write the operating mode register of every servo in one sync write
+	{
+		u8 m[SCS_GROUP_SERVOS];
+		memset(m, Mode, IDN);
+		bus->syncWrite(ID, IDN, Map::Mode::addr, m, 1);
+		return IDN;
+	}
+	int index(u8 ServoID)//-1 if not in the group
+	{
+		for(u8 i=0; i<IDN; i++){
+			if(ID[i]==ServoID){
+				return i;
+			}
+		}
+		return -1;
+	}
+	void setPosition(u8 i, s16 Position, u16 Speed = 0, u8 ACC = 0)//SCS_GROUP_POSITION
+	{
+		Write.template setPosEx<Map>(i, Position, Speed, ACC);
+		mark(i);
+	}
+	void setSpeed(u8 i, s16 Speed, u8 ACC = 0)//SCS_GROUP_WHEEL
+	{
+		Write.template setPosEx<Map>(i, 0, 0, ACC);
+		Write.template set<Map, typename Map::GoalSpeed>(i, Speed);
+		mark(i);
+	}
+	void setPwm(u8 i, s16 Pwm)//SCS_GROUP_PWM
+	{
+		Write.template set<Map, typename Map::GoalTime>(i, Pwm);
+		mark(i);
+	}
+	void hold()//position mode: command every servo to its last valid feedback position
+	{
+		for(u8 i=0; i<IDN; i++){
+			if(Tel[i].Valid){
+				setPosition(i, Tel[i].Position);
+			}
+		}
+	}
+	int ready(){  return SetN==IDN;  }//every servo has a command
+	int write()//send the command frame now, returns 1 if sent
+	{
+		if(!ready()){
+			return 0;
+		}
+		Write.send(bus);
+		Dirty = 0;
+		Writes++;
+		return 1;
+	}
+	int read()//SyncRead of the feedback block into Tel[], returns valid entries
+	{
+		return exchange(NULL, 0);
+	}
+	int cycle()//command frame (if changed) and SyncRead in one write, returns valid entries
+	{
+		if(Dirty && ready()){
+			Dirty = 0;
+			Writes++;
+			return exchange(Write.frame(), Write.length());
+		}
+		return exchange(NULL, 0);
+	}
+	static int job(void *group)//SCSLoopJob running cycle()
+	{
+		((ServoGroup*)group)->cycle();
+		return 0;
+	}
+public:
+	u8 IDN;
+	u8 ID[SCS_GROUP_SERVOS];
+	u8 Mode;//SCS_GROUP_*
+	Telemetry Tel[SCS_GROUP_SERVOS];//feedback of ID[i], Valid for this cycle
+	u32 Cycles;
+	u32 Lost;//servo reads without a valid reply
+	u32 Writes;//command frames sent
+private:
+	void mark(u8 i)
+	{
+		if(!Set[i]){
+			Set[i] = 1;
+			SetN++;
+		}
+		Dirty = 1;
+	}
+	int exchange(const u8 *Pre, int PreLen)
+	{
+		int Valid = bus->syncReadPrepared(Read.frame(), Read.length(), IDN, FB::len, rxBuff, rxTab, 0xfe, Pre, PreLen);
+		for(u8 i=0; i<IDN; i++){
+			SyncReadRx *rx = rxTab+ID[i];
+			Tel[i].Valid = rx->Valid;
+			if(!rx->Valid){
+				Lost++;
+				continue;
+			}
+			SCSerial::decodeFeedBack<Map>(rx->Dat, rx->Error, Tel+i);
+			Tel[i].Stamp = rx->Stamp;
+		}
+		Cycles++;
+		return Valid;
+	}
+private:
+	SCSerial *bus;
+	SCSSyncWritePacket Write;
+	SCSSyncReadPacket Read;
+	u8 Dirty;
+	u8 SetN;
+	u8 Set[SCS_GROUP_SERVOS];
+	u8 rxBuff[SCS_GROUP_SERVOS*(FB::len+6)];
+	SyncReadRx rxTab[0xfe];
+};
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * SCSShadow.cpp
+ * Control table shadow with dirty tracking and coalesced sync writes
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#include <string.h>
+#include "SCSShadow.h"
+
+#define SHADOW_DIRTY 1
+#define SHADOW_KNOWN 2
+
+SCSShadow::SCSShadow(SCS *bus)
+{
+	this->bus = bus;
+	memset(Mem, 0, sizeof(Mem));
+	memset(Flag, 0, sizeof(Flag));
+	memset(dirtyLo, 0xff, sizeof(dirtyLo));
+	memset(dirtyHi, 0, sizeof(dirtyHi));
+}
+
+int SCSShadow::setByte(u8 ID, u8 MemAddr, u8 bDat)
+{
+	if(ID>=SCS_SHADOW_ID_MAX || MemAddr>=SCS_SHADOW_LEN){
+		return 0;
+	}
+	u8 *f = &Flag[ID][MemAddr];
+	if((*f&SHADOW_KNOWN) && Mem[ID][MemAddr]==bDat){
+		return 0;
+	}
+	Mem[ID][MemAddr] = bDat;
+	*f = SHADOW_KNOWN|SHADOW_DIRTY;
+	if(MemAddr<dirtyLo[ID]){
+		dirtyLo[ID] = MemAddr;
+	}
+	if(MemAddr>dirtyHi[ID]){
+		dirtyHi[ID] = MemAddr;
+	}
+	return 1;
+}
+
+int SCSShadow::setWord(u8 ID, u8 MemAddr, s16 wDat, u8 negBit)
+{
+	u16 Word = wDat;
+	if(negBit && wDat<0){
+		Word = (-wDat)|(1<<negBit);
+	}
+	u8 bBuf[2];
+	if(bus->End){
+		bBuf[0] = (Word>>8);
+		bBuf[1] = (Word&0xff);
+	}else{
+		bBuf[1] = (Word>>8);
+		bBuf[0] = (Word&0xff);
+	}
+	return setBlock(ID, MemAddr, bBuf, 2)!=0;
+}
+
+int SCSShadow::setBlock(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	int Changed = 0;
+	for(u8 i=0; i<nLen; i++){
+		Changed += setByte(ID, MemAddr+i, nDat[i]);
+	}
+	return Changed;
+}
+
+void SCSShadow::load(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(ID>=SCS_SHADOW_ID_MAX){
+		return;
+	}
+	for(u8 i=0; i<nLen && (MemAddr+i)<SCS_SHADOW_LEN; i++){
+		Mem[ID][MemAddr+i] = nDat[i];
+		Flag[ID][MemAddr+i] = SHADOW_KNOWN;
+	}
+}
+
+void SCSShadow::invalidate(u8 ID)
+{
+	if(ID>=SCS_SHADOW_ID_MAX){
+		return;
+	}
+	memset(Flag[ID], 0, SCS_SHADOW_LEN);
+	dirtyLo[ID] = 0xff;
+	dirtyHi[ID] = 0;
+}
+
+//first contiguous run of known bytes that covers dirty bytes
+//clean bytes inside the run are re-sent with their known value
+int SCSShadow::span(u8 ID, u8 *MemAddr, u8 *nLen)
+{
+	u8 i = dirtyLo[ID];
+	while(i<=dirtyHi[ID] && !(Flag[ID][i]&SHADOW_DIRTY)){
+		i++;
+	}
+	if(i>dirtyHi[ID]){
+		dirtyLo[ID] = 0xff;
+		dirtyHi[ID] = 0;
+		return 0;
+	}
+	u8 Lo = i;
+	u8 Hi = i;
+	for(; i<=dirtyHi[ID] && (Flag[ID][i]&SHADOW_KNOWN); i++){
+		if(Flag[ID][i]&SHADOW_DIRTY){
+			Hi = i;
+		}
+	}
+	*MemAddr = Lo;
+	*nLen = Hi-Lo+1;
+	return 1;
+}
+
+int SCSShadow::sendGroup(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	u8 Dat[251];
+	u8 n = 0;
+	int Packet = 0;
+	u8 maxIDN = 251/(nLen+1);//length byte of one packet is (nLen+1)*IDN+4
+	for(u8 i=0; i<IDN; i+=n){
+		n = IDN-i;
+		if(n>maxIDN){
+			n = maxIDN;
+		}
+		for(u8 j=0; j<n; j++){
+			memcpy(Dat+j*nLen, Mem[ID[i+j]]+MemAddr, nLen);
+		}
+		bus->syncWrite(ID+i, n, MemAddr, Dat, nLen);
+		Packet++;
+	}
+	for(u8 i=0; i<IDN; i++){
+		for(u8 j=0; j<nLen; j++){
+			Flag[ID[i]][MemAddr+j] &= ~SHADOW_DIRTY;
+		}
+		if(MemAddr==dirtyLo[ID[i]]){
+			dirtyLo[ID[i]] += nLen;
+		}
+		if(dirtyLo[ID[i]]>dirtyHi[ID[i]]){
+			dirtyLo[ID[i]] = 0xff;
+			dirtyHi[ID[i]] = 0;
+		}
+	}
+	return Packet;
+}
+
+int SCSShadow::flush()
+{
+	u8 spanAddr[SCS_SHADOW_ID_MAX];
+	u8 spanLen[SCS_SHADOW_ID_MAX];
+	u8 ID[SCS_SHADOW_ID_MAX];
+	int Packet = 0;
+	while(1){
+		u8 IDN = 0;
+		for(u16 i=0; i<SCS_SHADOW_ID_MAX; i++){
+			if(dirtyLo[i]<=dirtyHi[i] && span(i, spanAddr+i, spanLen+i)){
+				ID[IDN++] = i;
+			}
+		}
+		if(!IDN){
+			return Packet;
+		}
+		//a single packet over the union of all spans wins when the grouped
+		//packets would cost more bytes on the wire and the union is known
+		u8 uLo = 0xff;
+		u8 uHi = 0;
+		for(u8 i=0; i<IDN; i++){
+			if(spanAddr[ID[i]]<uLo){
+				uLo = spanAddr[ID[i]];
+			}
+			if(spanAddr[ID[i]]+spanLen[ID[i]]-1>uHi){
+				uHi = spanAddr[ID[i]]+spanLen[ID[i]]-1;
+			}
+		}
+		int sepCost = 0;
+		for(u8 i=0; i<IDN; i++){
+			u8 j = 0;
+			while(j<i && (spanAddr[ID[j]]!=spanAddr[ID[i]] || spanLen[ID[j]]!=spanLen[ID[i]])){
+				j++;
+			}
+			sepCost += (j==i ? 8 : 0) + spanLen[ID[i]]+1;
+		}
+		int uKnown = 1;
+		for(u8 i=0; i<IDN && uKnown; i++){
+			for(u8 j=uLo; j<=uHi; j++){
+				if(!(Flag[ID[i]][j]&SHADOW_KNOWN)){
+					uKnown = 0;
+					break;
+				}
+			}
+		}
+		if(uKnown && (8+IDN*(uHi-uLo+2))<sepCost){
+			Packet += sendGroup(ID, IDN, uLo, uHi-uLo+1);
+			continue;
+		}
+		//one packet per distinct (MemAddr, nLen), servos keep their order
+		for(u8 i=0; i<IDN; i++){
+			if(!spanLen[ID[i]]){
+				continue;
+			}
+			u8 Addr = spanAddr[ID[i]];
+			u8 Len = spanLen[ID[i]];
+			u8 Group[SCS_SHADOW_ID_MAX];
+			u8 GroupN = 0;
+			for(u8 j=i; j<IDN; j++){
+				if(spanLen[ID[j]]==Len && spanAddr[ID[j]]==Addr){
+					Group[GroupN++] = ID[j];
+					spanLen[ID[j]] = 0;
+				}
+			}
+			Packet += sendGroup(Group, GroupN, Addr, Len);
+		}
+	}
+}
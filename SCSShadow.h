@@ -0,0 +1,40 @@
+/*
+ * SCSShadow.h
+ * Control table shadow with dirty tracking and coalesced sync writes
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _SCSSHADOW_H
+#define _SCSSHADOW_H
+
+#include "SCS.h"
+
+#define SCS_SHADOW_LEN 72//covers the memory tables of all series (addresses 0..70)
+#define SCS_SHADOW_ID_MAX 254
+
+//Setters only record the value and mark changed bytes dirty, flush()
+//groups servos with the same dirty range into as few syncWrite packets
+//as possible. Bytes that were never set or loaded are never sent.
+class SCSShadow{
+public:
+	SCSShadow(SCS *bus);
+	int setByte(u8 ID, u8 MemAddr, u8 bDat);//returns 1 if the byte changed
+	int setWord(u8 ID, u8 MemAddr, s16 wDat, u8 negBit = 0);//negBit: direction bit, 0 = no direction bit
+	int setBlock(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);//returns number of changed bytes
+	void load(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);//record values already on the servo, e.g. after Read()
+	void invalidate(u8 ID);//forget everything known about ID
+	int isDirty(u8 ID){  return ID<SCS_SHADOW_ID_MAX && dirtyLo[ID]<=dirtyHi[ID];  }
+	int flush();//send all dirty ranges, returns number of syncWrite packets
+public:
+	u8 Mem[SCS_SHADOW_ID_MAX][SCS_SHADOW_LEN];
+private:
+	u8 Flag[SCS_SHADOW_ID_MAX][SCS_SHADOW_LEN];
+	u8 dirtyLo[SCS_SHADOW_ID_MAX];
+	u8 dirtyHi[SCS_SHADOW_ID_MAX];
+	SCS *bus;
+	int span(u8 ID, u8 *MemAddr, u8 *nLen);
+	int sendGroup(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);
+};
+
+#endif
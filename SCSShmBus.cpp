@@ -0,0 +1,151 @@
+/*
+ * SCSShmBus.cpp
+ * Shared memory telemetry ring and command mailbox of a bus daemon
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <new>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "SCSShmBus.h"
+
+SCSShmBus::SCSShmBus()
+{
+	Region = NULL;
+	Retries = 0;
+}
+
+SCSShmBus::~SCSShmBus()
+{
+	detach();
+}
+
+static SCSShmBusRegion *shmBusMap(const char *name, int oflag)
+{
+	int fd = shm_open(name, oflag, 0600);
+	if(fd == -1){
+		return NULL;
+	}
+	if((oflag & O_CREAT) && ftruncate(fd, sizeof(SCSShmBusRegion)) != 0){
+		close(fd);
+		return NULL;
+	}
+	void *p = mmap(NULL, sizeof(SCSShmBusRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	return p==MAP_FAILED ? NULL : (SCSShmBusRegion*)p;
+}
+
+int SCSShmBus::create(const char *name)
+{
+	detach();
+	SCSShmBusRegion *r = shmBusMap(name, O_RDWR | O_CREAT);
+	if(!r){
+		return 0;
+	}
+	memset((void*)r, 0, sizeof(SCSShmBusRegion));//raw mapping, Queue is constructed below
+	new(&r->Queue) SCSCmdQueue();
+	r->Size = sizeof(SCSShmBusRegion);
+	__atomic_store_n(&r->Magic, SCS_SHMBUS_MAGIC, __ATOMIC_RELEASE);
+	Region = r;
+	return 1;
+}
+
+int SCSShmBus::attach(const char *name)
+{
+	detach();
+	SCSShmBusRegion *r = shmBusMap(name, O_RDWR);
+	if(!r){
+		return 0;
+	}
+	if(__atomic_load_n(&r->Magic, __ATOMIC_ACQUIRE)!=SCS_SHMBUS_MAGIC || r->Size!=sizeof(SCSShmBusRegion)){
+		munmap(r, sizeof(SCSShmBusRegion));
+		return 0;
+	}
+	Region = r;
+	return 1;
+}
+
+void SCSShmBus::detach()
+{
+	if(Region){
+		munmap(Region, sizeof(SCSShmBusRegion));
+		Region = NULL;
+	}
+}
+
+void SCSShmBus::unlink(const char *name)
+{
+	shm_unlink(name);
+}
+
+void SCSShmBus::publish(const SCSBusFrame *frame)
+{
+	if(!Region){
+		return;
+	}
+	u32 n = Region->Head+1;
+	SCSShmBusSlot *s = &Region->Slot[(n-1)&(SCS_SHMBUS_FRAMES-1)];
+	u32 Seq = s->Seq;
+	__atomic_store_n(&s->Seq, Seq+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	//only the servos in use, readers ignore Tel[] past IDN
+	memcpy(&s->Frame, frame, (const u8*)(frame->Tel+frame->IDN)-(const u8*)frame);
+	__atomic_store_n(&s->Seq, Seq+2, __ATOMIC_RELEASE);
+	__atomic_store_n(&Region->Head, n, __ATOMIC_RELEASE);
+}
+
+u32 SCSShmBus::head()
+{
+	return Region ? __atomic_load_n(&Region->Head, __ATOMIC_ACQUIRE) : 0;
+}
+
+int SCSShmBus::frame(u32 n, SCSBusFrame *frame)
+{
+	if(!Region || !n){
+		return 0;
+	}
+	SCSShmBusSlot *s = &Region->Slot[(n-1)&(SCS_SHMBUS_FRAMES-1)];
+	while(1){
+		u32 Head = __atomic_load_n(&Region->Head, __ATOMIC_ACQUIRE);
+		if(n>Head || Head-n>=SCS_SHMBUS_FRAMES){
+			return 0;
+		}
+		u32 Seq = __atomic_load_n(&s->Seq, __ATOMIC_ACQUIRE);
+		if(Seq&1){
+			sched_yield();
+			continue;
+		}
+		memcpy(frame, &s->Frame, sizeof(SCSBusFrame));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&s->Seq, __ATOMIC_RELAXED)==Seq){
+			//the slot may have moved on to a newer frame before the copy
+			return frame->IDN<=SCS_OWNER_ID_MAX && __atomic_load_n(&Region->Head, __ATOMIC_ACQUIRE)-n<SCS_SHMBUS_FRAMES;
+		}
+		Retries++;
+	}
+}
+
+u32 SCSShmBus::latest(SCSBusFrame *frame)
+{
+	while(1){
+		u32 n = head();
+		if(!n){
+			return 0;
+		}
+		if(this->frame(n, frame)){
+			return n;
+		}
+	}
+}
+
+int SCSShmBus::command(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(!Region){
+		return 0;
+	}
+	return Region->Queue.push(ID, Ch, MemAddr, nDat, nLen);
+}
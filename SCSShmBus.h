@@ -0,0 +1,58 @@
+/*
+ * SCSShmBus.h
+ * Shared memory telemetry ring and command mailbox of a bus daemon
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSHMBUS_H
+#define _SCSSHMBUS_H
+
+#include "SCSCmdQueue.h"
+#include "SCSBusOwner.h"
+
+#define SCS_SHMBUS_FRAMES 16//telemetry frames kept, power of 2
+#define SCS_SHMBUS_MAGIC 0x53435342//"SCSB"
+
+//one telemetry frame under a sequence lock, Seq is odd while the daemon writes it
+struct SCSShmBusSlot{
+	u32 Seq;
+	SCSBusFrame Frame;
+};
+
+//The whole region is plain data without pointers, so each process may
+//map it at any address. Magic is stored last by the creator.
+struct SCSShmBusRegion{
+	u32 Magic;
+	u32 Size;//sizeof(SCSShmBusRegion) of the creator
+	u32 Head;//frames published, frame n lives in Slot[(n-1)%SCS_SHMBUS_FRAMES]
+	SCSShmBusSlot Slot[SCS_SHMBUS_FRAMES];
+	SCSCmdQueue Queue;//any process pushes, the daemon pops
+};
+
+//The daemon creates the region and hands it to its SCSBusOwner
+//(setShm()), which publishes every cycle's frame and takes commands from
+//the region as well as from its own queue. Client processes attach and
+//call latest(), frame() and command(); nothing blocks the daemon, a
+//reader that is overtaken retries or misses the frame.
+class SCSShmBus{
+public:
+	SCSShmBus();
+	~SCSShmBus();
+	int create(const char *name);//daemon side, shm_open a new cleared region
+	int attach(const char *name);//client side, 0 if missing or of another build
+	void detach();
+	static void unlink(const char *name);
+	void publish(const SCSBusFrame *frame);//daemon only, single writer
+	u32 head();//frames published so far
+	u32 latest(SCSBusFrame *frame);//copy the newest frame, returns its number, 0 before the first one
+	int frame(u32 n, SCSBusFrame *frame);//copy frame n, 0 if not published or already overwritten
+	int command(u8 ID, u8 Ch, u8 MemAddr, const u8 *nDat, u8 nLen);//any process
+	SCSCmdQueue *queue(){  return Region ? &Region->Queue : NULL;  }
+public:
+	u32 Retries;//reads restarted because the daemon rewrote the slot
+private:
+	SCSShmBusRegion *Region;
+};
+
+#endif
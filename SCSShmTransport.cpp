@@ -0,0 +1,111 @@
+/*
+ * SCSShmTransport.cpp
+ * Shared memory byte pipe transport between threads or processes
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "SCSShmTransport.h"
+#include "SCSerial.h"
+
+SCSShmTransport::SCSShmTransport(SCSShmLink *link, int busEnd)
+{
+	tx = &link->Ring[busEnd ? 1 : 0];
+	rx = &link->Ring[busEnd ? 0 : 1];
+}
+
+int SCSShmTransport::write(const u8 *nDat, int nLen)
+{
+	u32 Head = tx->Head;
+	u32 Tail = __atomic_load_n(&tx->Tail, __ATOMIC_ACQUIRE);
+	if((u32)nLen>SCS_SHM_RING-(Head-Tail)){
+		return -1;
+	}
+	for(int i=0; i<nLen; i++){
+		tx->Buf[(Head+i)&(SCS_SHM_RING-1)] = nDat[i];
+	}
+	__atomic_store_n(&tx->Head, Head+nLen, __ATOMIC_RELEASE);
+	return nLen;
+}
+
+int SCSShmTransport::available()
+{
+	return __atomic_load_n(&rx->Head, __ATOMIC_ACQUIRE)-rx->Tail;
+}
+
+int SCSShmTransport::read(u8 *nDat, int nLen, long timeOutUs)
+{
+	u64 deadline = SCSerial::monoUs()+timeOutUs;
+	int rvLen = 0;
+	RxFirstUs = 0;
+	while(1){
+		u32 Head = __atomic_load_n(&rx->Head, __ATOMIC_ACQUIRE);
+		u32 Tail = rx->Tail;
+		if(Head!=Tail){
+			if(!RxFirstUs){
+				RxFirstUs = SCSerial::monoUs();
+			}
+			while(Tail!=Head && rvLen<nLen){
+				nDat[rvLen++] = rx->Buf[Tail++&(SCS_SHM_RING-1)];
+			}
+			__atomic_store_n(&rx->Tail, Tail, __ATOMIC_RELEASE);
+		}
+		if(rvLen>=nLen || (long)(deadline-SCSerial::monoUs())<=0){
+			return rvLen;
+		}
+		if(Head==Tail){
+			sched_yield();
+		}
+	}
+}
+
+void SCSShmTransport::flush()
+{
+	__atomic_store_n(&rx->Tail, __atomic_load_n(&rx->Head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+static SCSShmLink *shmMap(const char *name, int oflag)
+{
+	int fd = shm_open(name, oflag, 0600);
+	if(fd == -1){
+		return NULL;
+	}
+	if((oflag & O_CREAT) && ftruncate(fd, sizeof(SCSShmLink)) != 0){
+		close(fd);
+		return NULL;
+	}
+	void *p = mmap(NULL, sizeof(SCSShmLink), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	return p==MAP_FAILED ? NULL : (SCSShmLink*)p;
+}
+
+SCSShmLink *SCSShmTransport::create(const char *name)
+{
+	SCSShmLink *link = shmMap(name, O_RDWR | O_CREAT);
+	if(link){
+		memset(link, 0, sizeof(SCSShmLink));
+	}
+	return link;
+}
+
+SCSShmLink *SCSShmTransport::attach(const char *name)
+{
+	return shmMap(name, O_RDWR);
+}
+
+void SCSShmTransport::detach(SCSShmLink *link)
+{
+	if(link){
+		munmap(link, sizeof(SCSShmLink));
+	}
+}
+
+void SCSShmTransport::unlink(const char *name)
+{
+	shm_unlink(name);
+}
@@ -0,0 +1,46 @@
+/*
+ * SCSShmTransport.h
+ * Shared memory byte pipe transport between threads or processes
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSHMTRANSPORT_H
+#define _SCSSHMTRANSPORT_H
+
+#include "SCSTransport.h"
+
+#define SCS_SHM_RING 4096//bytes per direction, power of 2
+
+//single producer, single consumer byte ring, free-running indices
+struct SCSShmRing{
+	u32 Head;
+	u32 Tail;
+	u8 Buf[SCS_SHM_RING];
+};
+
+//Ring[0] carries requests, Ring[1] carries replies
+struct SCSShmLink{
+	SCSShmRing Ring[2];
+};
+
+//The host end runs SCSerial, the bus end is a bridge or simulator
+//serving the other side of the link. read() spins (with sched_yield)
+//since there is no descriptor to wait on.
+class SCSShmTransport : public SCSTransport{
+public:
+	SCSShmTransport(SCSShmLink *link, int busEnd = 0);
+	virtual int write(const u8 *nDat, int nLen);
+	virtual int read(u8 *nDat, int nLen, long timeOutUs);
+	virtual void flush();
+	int available();
+	static SCSShmLink *create(const char *name);//shm_open a new link (cleared), NULL on failure
+	static SCSShmLink *attach(const char *name);//map an existing link
+	static void detach(SCSShmLink *link);
+	static void unlink(const char *name);
+private:
+	SCSShmRing *tx;
+	SCSShmRing *rx;
+};
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * SCSSim.cpp
+ * In-process bus of simulated SMS/STS servos for benchmarks and tests without hardware
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <math.h>
+#include "SCSSim.h"
+
+#define SIM_MAX_SPEED 4000//steps/s when the goal speed is 0
+#define SIM_STEPS 4096
+
+static const int simBaud[8] = {1000000, 500000, 250000, 128000, 115200, 76800, 57600, 38400};
+
+SCSSim::SCSSim(int baudRate)
+{
+	BaudRate = baudRate;
+	ReturnDelayUs = 0;
+	LossRate = 0;
+	Seed = 0x2545f491;
+	Clock = 0;
+	RxPackets = 0;
+	TxPackets = 0;
+	Lost = 0;
+	End = 0;
+	rxLen = 0;
+	txLen = 0;
+	txPos = 0;
+	stepClock = 0;
+	memset(Present, 0, sizeof(Present));
+	memset(ErrorByte, 0, sizeof(ErrorByte));
+	memset(regLen, 0, sizeof(regLen));
+}
+
+int SCSSim::baudIndex(int baudRate)
+{
+	for(int i=0; i<8; i++){
+		if(simBaud[i]==baudRate){
+			return i;
+		}
+	}
+	return -1;
+}
+
+void SCSSim::addServo(u8 ID, u16 Model)
+{
+	if(ID>=SCS_SIM_ID_MAX){
+		return;
+	}
+	u8 *m = Mem[ID];
+	memset(m, 0, SCS_SIM_MEM);
+	Present[ID] = 1;
+	ErrorByte[ID] = 0;
+	regLen[ID] = 0;
+	int Baud = baudIndex(BaudRate);
+	setWord(ID, 3, Model);
+	m[5] = ID;
+	m[6] = Baud<0 ? 0 : Baud;
+	setWord(ID, 11, SIM_STEPS-1);
+	m[40] = 1;
+	setWord(ID, 42, SIM_STEPS/2);
+	m[55] = 1;
+	setWord(ID, 56, SIM_STEPS/2);
+	m[62] = 120;
+	m[63] = 35;
+	posF[ID] = SIM_STEPS/2;
+}
+
+void SCSSim::removeServo(u8 ID)
+{
+	if(ID<SCS_SIM_ID_MAX){
+		Present[ID] = 0;
+	}
+}
+
+u16 SCSSim::getWord(u8 ID, u8 MemAddr)
+{
+	const u8 *m = Mem[ID]+MemAddr;
+	return End ? ((m[0]<<8)|m[1]) : ((m[1]<<8)|m[0]);
+}
+
+void SCSSim::setWord(u8 ID, u8 MemAddr, u16 wDat)
+{
+	u8 *m = Mem[ID]+MemAddr;
+	if(End){
+		m[0] = wDat>>8;
+		m[1] = wDat&0xff;
+	}else{
+		m[1] = wDat>>8;
+		m[0] = wDat&0xff;
+	}
+}
+
+u32 SCSSim::wireUs(int nLen)
+{
+	return BaudRate>0 ? (u32)(((u64)nLen*10*1000000ULL)/BaudRate) : 0;
+}
+
+int SCSSim::hears(u8 ID)
+{
+	return ID<SCS_SIM_ID_MAX && Present[ID] && Mem[ID][6]==baudIndex(BaudRate);
+}
+
+int SCSSim::lose()
+{
+	if(LossRate<=0){
+		return 0;
+	}
+	//xorshift32, u32 is wider than 32 bits on LP64
+	Seed ^= (Seed<<13)&0xffffffff;
+	Seed ^= Seed>>17;
+	Seed ^= (Seed<<5)&0xffffffff;
+	return (Seed/4294967296.0)<LossRate;
+}
+
+void SCSSim::step(u64 us)
+{
+	Clock += us;
+	double dt = (Clock-stepClock)/1000000.0;
+	stepClock = Clock;
+	if(dt<=0){
+		return;
+	}
+	for(int ID=0; ID<SCS_SIM_ID_MAX; ID++){
+		if(!Present[ID]){
+			continue;
+		}
+		u8 *m = Mem[ID];
+		double v = 0;
+		if(m[40] && m[33]==0){
+			u16 g = getWord(ID, 42);
+			double goal = (g&0x8000) ? 0 : (g>SIM_STEPS-1 ? SIM_STEPS-1 : g);
+			u16 s = getWord(ID, 46)&0x7fff;
+			double vMax = s ? s : SIM_MAX_SPEED;
+			double d = goal-posF[ID];
+			double stepD = vMax*dt;
+			if(fabs(d)<=stepD){
+				posF[ID] = goal;
+			}else{
+				posF[ID] += d>0 ? stepD : -stepD;
+				v = d>0 ? vMax : -vMax;
+			}
+		}else if(m[40] && m[33]==1){
+			u16 s = getWord(ID, 46);
+			v = (s&0x8000) ? -(double)(s&0x7fff) : s;
+			posF[ID] = fmod(posF[ID]+v*dt, SIM_STEPS);
+			if(posF[ID]<0){
+				posF[ID] += SIM_STEPS;
+			}
+		}
+		setWord(ID, 56, ((u16)(posF[ID]+0.5))%SIM_STEPS);
+		setWord(ID, 58, v<0 ? (((u16)-v)|0x8000) : (u16)v);
+		m[66] = v!=0;
+	}
+}
+
+void SCSSim::memWrite(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	int n = nLen;
+	if(MemAddr+n>SCS_SIM_MEM){
+		n = SCS_SIM_MEM-MemAddr;
+	}
+	u8 Torque = Mem[ID][40];
+	memcpy(Mem[ID]+MemAddr, nDat, n);
+	if(MemAddr<=40 && MemAddr+n>40 && Mem[ID][40]==128){
+		//midpoint calibration: the present position becomes the middle step
+		u16 o = getWord(ID, 31);
+		int Ofs = (o&0x800) ? -(o&0x7ff) : (o&0x7ff);
+		Ofs += (int)(posF[ID]+0.5)-SIM_STEPS/2;
+		setWord(ID, 31, Ofs<0 ? (((u16)-Ofs)|0x800) : (u16)Ofs);
+		posF[ID] = SIM_STEPS/2;
+		setWord(ID, 42, SIM_STEPS/2);
+		setWord(ID, 56, SIM_STEPS/2);
+		Mem[ID][40] = Torque;
+	}
+	u8 newID = Mem[ID][5];
+	if(newID!=ID && newID<SCS_SIM_ID_MAX && !Present[newID]){
+		memcpy(Mem[newID], Mem[ID], SCS_SIM_MEM);
+		Present[newID] = 1;
+		ErrorByte[newID] = ErrorByte[ID];
+		posF[newID] = posF[ID];
+		regLen[newID] = 0;
+		Present[ID] = 0;
+	}
+}
+
+void SCSSim::reply(u8 ID, const u8 *nDat, u8 nLen)
+{
+	if(lose()){
+		Lost++;
+		return;
+	}
+	if(txPos==txLen){
+		txPos = txLen = 0;
+	}
+	if(txLen+nLen+6>SCS_SIM_TX_MAX){
+		return;
+	}
+	Clock += ReturnDelayUs + wireUs(nLen+6);
+	u8 *p = txBuf+txLen;
+	p[0] = 0xff;
+	p[1] = 0xff;
+	p[2] = ID;
+	p[3] = nLen+2;
+	p[4] = ErrorByte[ID];
+	u8 CheckSum = ID+nLen+2+ErrorByte[ID];
+	for(int i=0; i<nLen; i++){
+		p[5+i] = nDat[i];
+		CheckSum += nDat[i];
+	}
+	p[5+nLen] = ~CheckSum;
+	txLen += nLen+6;
+	TxPackets++;
+}
+
+void SCSSim::exec(const u8 *pkt, int pktLen)
+{
+	u8 ID = pkt[2];
+	u8 Inst = pkt[4];
+	const u8 *par = pkt+5;
+	int parLen = pktLen-6;
+	RxPackets++;
+	step(0);
+	switch(Inst){
+	case INST_PING:
+		if(ID==0xfe){
+			for(int i=0; i<SCS_SIM_ID_MAX; i++){
+				if(hears(i)){
+					reply(i, NULL, 0);
+				}
+			}
+		}else if(hears(ID)){
+			reply(ID, NULL, 0);
+		}
+		break;
+	case INST_READ:
+		if(parLen>=2 && ID!=0xfe && hears(ID) && par[0]+par[1]<=SCS_SIM_MEM){
+			reply(ID, Mem[ID]+par[0], par[1]);
+		}
+		break;
+	case INST_WRITE:
+	case INST_REG_WRITE:
+		if(parLen<1){
+			break;
+		}
+		for(int i=0; i<SCS_SIM_ID_MAX; i++){
+			if((ID==0xfe || ID==i) && hears(i)){
+				if(Inst==INST_WRITE){
+					memWrite(i, par[0], par+1, parLen-1);
+				}else{
+					regAddr[i] = par[0];
+					regLen[i] = parLen-1;
+					memcpy(regDat[i], par+1, parLen-1);
+				}
+			}
+		}
+		if(ID!=0xfe && hears(ID)){
+			reply(ID, NULL, 0);
+		}
+		break;
+	case INST_REG_ACTION:
+		for(int i=0; i<SCS_SIM_ID_MAX; i++){
+			if((ID==0xfe || ID==i) && hears(i) && regLen[i]){
+				u8 n = regLen[i];
+				regLen[i] = 0;
+				memWrite(i, regAddr[i], regDat[i], n);
+			}
+		}
+		if(ID!=0xfe && hears(ID)){
+			reply(ID, NULL, 0);
+		}
+		break;
+	case INST_SYNC_READ:
+		if(parLen<2 || par[0]+par[1]>SCS_SIM_MEM){
+			break;
+		}
+		for(int i=2; i<parLen; i++){
+			if(hears(par[i])){
+				reply(par[i], Mem[par[i]]+par[0], par[1]);
+			}
+		}
+		break;
+	case INST_SYNC_WRITE:
+		if(parLen<2){
+			break;
+		}
+		for(int i=2; i+par[1]+1<=parLen; i+=par[1]+1){
+			if(hears(par[i])){
+				memWrite(par[i], par[0], par+i+1, par[1]);
+			}
+		}
+		break;
+	}
+}
+
+int SCSSim::write(const u8 *nDat, int nLen)
+{
+	Clock += wireUs(nLen);
+	for(int i=0; i<nLen; i++){
+		if(rxLen==SCS_SIM_RX_MAX){
+			rxLen = 0;
+		}
+		rxBuf[rxLen++] = nDat[i];
+	}
+	int Pos = 0;
+	while(rxLen-Pos>=4){
+		if(rxBuf[Pos]!=0xff || rxBuf[Pos+1]!=0xff || rxBuf[Pos+2]==0xff){
+			Pos++;
+			continue;
+		}
+		int pktLen = rxBuf[Pos+3]+4;
+		if(pktLen<6){
+			Pos++;
+			continue;
+		}
+		if(rxLen-Pos<pktLen){
+			break;
+		}
+		u8 CheckSum = 0;
+		for(int i=2; i<pktLen-1; i++){
+			CheckSum += rxBuf[Pos+i];
+		}
+		if((u8)~CheckSum==rxBuf[Pos+pktLen-1]){
+			exec(rxBuf+Pos, pktLen);
+			Pos += pktLen;
+		}else{
+			Pos++;
+		}
+	}
+	rxLen -= Pos;
+	memmove(rxBuf, rxBuf+Pos, rxLen);
+	return nLen;
+}
+
+int SCSSim::read(u8 *nDat, int nLen)
+{
+	int n = txLen-txPos;
+	if(n>nLen){
+		n = nLen;
+	}
+	memcpy(nDat, txBuf+txPos, n);
+	txPos += n;
+	return n;
+}
+
+void SCSSim::flush()
+{
+	txPos = txLen = 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * SCSSim.h
+ * In-process bus of simulated SMS/STS servos for benchmarks and tests without hardware
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSIM_H
+#define _SCSSIM_H
+
+#include "INST.h"
+
+#define SCS_SIM_ID_MAX 254
+#define SCS_SIM_MEM 256//control table bytes per servo
+#define SCS_SIM_RX_MAX 1024//request bytes buffered until a packet is complete
+#define SCS_SIM_TX_MAX 8192//status bytes pending for the host
+
+class SCSSim{
+public:
+	SCSSim(int baudRate = 1000000);
+	void addServo(u8 ID, u16 Model = 0x0309);//servo with SMS/STS power-on defaults, answers at the current baud rate
+	void removeServo(u8 ID);
+	int isPresent(u8 ID){  return ID<SCS_SIM_ID_MAX && Present[ID];  }
+	int write(const u8 *nDat, int nLen);//host to bus, complete packets are executed and answered
+	int read(u8 *nDat, int nLen);//bus to host, returns bytes taken
+	int available(){  return txLen-txPos;  }
+	void flush();//drop status bytes not read yet
+	void step(u64 us);//advance the virtual clock and the motion model
+	static int baudIndex(int baudRate);//index of a rate in the servo baud table, -1 if none
+public:
+	int BaudRate;//host side rate, servos only hear packets at their own rate
+	u32 ReturnDelayUs;//delay before each status packet
+	double LossRate;//probability (0..1) that a status packet is lost
+	u32 Seed;//loss generator state
+	u64 Clock;//virtual bus time in us: request, return delay and reply wire time
+	u32 RxPackets;//requests executed
+	u32 TxPackets;//status packets sent
+	u32 Lost;//status packets dropped by the loss model
+	u8 End;//byte order of the emulated series, 0 for SMS/STS
+	u8 Present[SCS_SIM_ID_MAX];
+	u8 Mem[SCS_SIM_ID_MAX][SCS_SIM_MEM];
+	u8 ErrorByte[SCS_SIM_ID_MAX];//error field of status packets
+private:
+	void exec(const u8 *pkt, int pktLen);
+	void reply(u8 ID, const u8 *nDat, u8 nLen);
+	void memWrite(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);
+	int hears(u8 ID);
+	int lose();
+	u32 wireUs(int nLen);
+	u16 getWord(u8 ID, u8 MemAddr);
+	void setWord(u8 ID, u8 MemAddr, u16 wDat);
+private:
+	u8 rxBuf[SCS_SIM_RX_MAX];
+	int rxLen;
+	u8 txBuf[SCS_SIM_TX_MAX];
+	int txLen;
+	int txPos;
+	u8 regAddr[SCS_SIM_ID_MAX];
+	u8 regLen[SCS_SIM_ID_MAX];
+	u8 regDat[SCS_SIM_ID_MAX][SCS_SIM_MEM];
+	double posF[SCS_SIM_ID_MAX];//motion model position in steps
+	u64 stepClock;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * SCSSimBus.h
+ * Runs a servo class (SMS_STS, SMSBL, SMSCL, SCSCL) against an SCSSim instead of a serial port
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSIMBUS_H
+#define _SCSSIMBUS_H
+
+#include "SCSSim.h"
+
+template<class Family>
+class SCSSimBus : public Family
+{
+public:
+	SCSSimBus(SCSSim *sim) : Sim(sim)
+	{
+		this->baudRate = sim->BaudRate;
+		this->End = sim->End;
+	}
+	virtual bool begin(int baudRate, const char* serialPort){  setBaudRate(baudRate);  return true;  }
+	virtual void end(){}
+	virtual int setBaudRate(int baudRate)
+	{
+		this->baudRate = baudRate;
+		Sim->BaudRate = baudRate;
+		return 1;
+	}
+public:
+	SCSSim *Sim;
+protected:
+	int writeSCS(unsigned char *nDat, int nLen)
+	{
+		if(this->txBufLen+nLen>(int)sizeof(this->txBuf)){
+			wFlushSCS();
+			if(nLen>(int)sizeof(this->txBuf)){
+				Sim->write(nDat, nLen);
+				this->txLastLen += nLen;
+				return nLen;
+			}
+		}
+		memcpy(this->txBuf+this->txBufLen, nDat, nLen);
+		this->txBufLen += nLen;
+		return nLen;
+	}
+	int writeSCS(unsigned char bDat)
+	{
+		return writeSCS(&bDat, 1);
+	}
+	int writeSCSv(const struct iovec *iov, int iovcnt)
+	{
+		return SCS::writeSCSv(iov, iovcnt);
+	}
+	//a short reply costs the full timeout on the virtual clock, as it would on the wire
+	int readSCS(unsigned char *nDat, int nLen)
+	{
+		int n = Sim->read(nDat, nLen);
+		if(n<nLen){
+			Sim->step(this->rxTimeOutUs(nLen));
+		}
+		this->txLastLen = 0;
+		return n;
+	}
+	void rFlushSCS()
+	{
+		Sim->flush();
+	}
+	void wFlushSCS()
+	{
+		if(this->txBufLen){
+			Sim->write(this->txBuf, this->txBufLen);
+			this->txLastLen += this->txBufLen;
+			this->txBufLen = 0;
+		}
+	}
+};
+
+#endif
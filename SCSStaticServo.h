@@ -0,0 +1,251 @@
+/*
+ * SCSStaticServo.h
+ * Statically dispatched servo stack: Servo<Family, Transport>
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSTATICSERVO_H
+#define _SCSSTATICSERVO_H
+
+#include <string.h>
+#include "INST.h"
+#include "SCSRegMap.h"
+#include "SCSChecksum.h"
+#include "SCSStatus.h"
+#include "SCSerial.h"
+
+//Family is a series class (SMS_STS, SMSBL, SMSCL, SCSCL) or its map
+//(SMS_STS_Map ...), only the control table is taken from it. Transport
+//is a concrete transport type held by value (SCSSerialTransport,
+//SCSTcpTransport, ...), so every transport call is a direct call and
+//the whole packet path can be inlined. Frames are built in one buffer
+//and handed over with a single write, there are no per-byte calls.
+//The virtual classes are unchanged and remain the general interface.
+template<class Family, class Transport>
+class Servo
+{
+public:
+	typedef typename Family::Map Map;
+	typedef typename Map::Order Order;
+
+	Servo() : Level(1), Error(0), Err(0), BaudRate(1000000), MarginUs(3000) {}
+	void setBaudRate(int baudRate)//servo bus rate used for the reply timeout
+	{
+		BaudRate = baudRate;
+		Port.setBaudRate(baudRate);
+	}
+	int genWrite(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+	{
+		return request(ID, INST_WRITE, MemAddr, nDat, nLen) ? ack(ID) : 0;
+	}
+	int regWrite(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+	{
+		return request(ID, INST_REG_WRITE, MemAddr, nDat, nLen) ? ack(ID) : 0;
+	}
+	int RegWriteAction(u8 ID = 0xfe)
+	{
+		return request(ID, INST_REG_ACTION, 0, NULL, 0) ? ack(ID) : 0;
+	}
+	int Ping(u8 ID)
+	{
+		if(!request(ID, INST_PING, 0, NULL, 0)){
+			return -1;
+		}
+		const u8 *Pkt = status(ID, 0);
+		return Pkt ? Pkt[2] : -1;
+	}
+	int Read(u8 ID, u8 MemAddr, u8 *nData, u8 nLen)
+	{
+		if(!request(ID, INST_READ, MemAddr, &nLen, 1)){
+			return 0;
+		}
+		const u8 *Pkt = status(ID, nLen);
+		if(!Pkt){
+			return 0;
+		}
+		memcpy(nData, Pkt+5, nLen);
+		return nLen;
+	}
+	//IDN servos, nLen bytes of nDat each, split at the 255-byte packet limit
+	void syncWrite(const u8 ID[], u8 IDN, u8 MemAddr, const u8 *nDat, u8 nLen)
+	{
+		u8 maxIDN = SCS_SYNC_WRITE_MAX/(nLen+1);
+		if(!maxIDN){
+			return;
+		}
+		Port.flush();
+		u8 n;
+		for(u8 k=0; k<IDN; k+=n){
+			n = IDN-k;
+			if(n>maxIDN){
+				n = maxIDN;
+			}
+			u8 *p = txBuf;
+			*p++ = 0xff;
+			*p++ = 0xff;
+			*p++ = 0xfe;
+			*p++ = (nLen+1)*n+4;
+			*p++ = INST_SYNC_WRITE;
+			*p++ = MemAddr;
+			*p++ = nLen;
+			for(u8 i=k; i<k+n; i++){
+				*p++ = ID[i];
+				memcpy(p, nDat+i*nLen, nLen);
+				p += nLen;
+			}
+			finish(p);
+		}
+	}
+	//one field of the control table, ID=-1 decodes it from the FeedBack() block
+	template<class Reg> int read(int ID)
+	{
+		u8 bBuf[Reg::width];
+		const u8 *p = Mem+Reg::addr-Map::FeedBack::addr;
+		if(ID!=-1){
+			Err = 0;
+			if(Read(ID, Reg::addr, bBuf, Reg::width)!=Reg::width){
+				Err = 1;
+				return -1;
+			}
+			p = bBuf;
+		}
+		return SCSField<Reg, Map::End>::decode(p);
+	}
+	template<class Reg> int write(u8 ID, int v)
+	{
+		u8 bBuf[Reg::width];
+		SCSField<Reg, Map::End>::encode(bBuf, v);
+		return genWrite(ID, Reg::addr, bBuf, Reg::width);
+	}
+	int FeedBack(int ID)
+	{
+		if(Read(ID, Map::FeedBack::addr, Mem, sizeof(Mem))!=sizeof(Mem)){
+			Err = 1;
+			return -1;
+		}
+		Err = 0;
+		return sizeof(Mem);
+	}
+	int ReadPos(int ID){  return read<typename Map::PresentPosition>(ID);  }
+	int ReadSpeed(int ID){  return read<typename Map::PresentSpeed>(ID);  }
+	int ReadLoad(int ID){  return read<typename Map::PresentLoad>(ID);  }
+	int ReadVoltage(int ID){  return read<typename Map::PresentVoltage>(ID);  }
+	int ReadTemper(int ID){  return read<typename Map::PresentTemperature>(ID);  }
+	int ReadMove(int ID){  return read<typename Map::Moving>(ID);  }
+	int ReadCurrent(int ID){  return read<typename Map::PresentCurrent>(ID);  }
+	int EnableTorque(u8 ID, u8 Enable){  return write<typename Map::TorqueEnable>(ID, Enable);  }
+	//Acc..GoalSpeed in one write, series with an acceleration register
+	int WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0)
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+		u8 bBuf[PosExBlock::len];
+		posEx(bBuf, Position, Speed, ACC);
+		return genWrite(ID, PosExBlock::addr, bBuf, sizeof(bBuf));
+	}
+	void SyncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[])
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+		u8 offbuf[0xfe*PosExBlock::len];
+		for(u8 i=0; i<IDN; i++){
+			posEx(offbuf+i*PosExBlock::len, Position[i], Speed ? Speed[i] : 0, ACC ? ACC[i] : 0);
+		}
+		syncWrite(ID, IDN, PosExBlock::addr, offbuf, PosExBlock::len);
+	}
+	//GoalPosition..GoalSpeed, series without an acceleration register (SCSCL)
+	int WritePos(u8 ID, u16 Position, u16 Time, u16 Speed = 0)
+	{
+		typedef SCSRegBlock<typename Map::GoalPosition, typename Map::GoalSpeed> PosBlock;
+		u8 bBuf[PosBlock::len];
+		PosBlock::template set<typename Map::GoalPosition, Map::End>(bBuf, Position);
+		PosBlock::template set<typename Map::GoalTime, Map::End>(bBuf, Time);
+		PosBlock::template set<typename Map::GoalSpeed, Map::End>(bBuf, Speed);
+		return genWrite(ID, PosBlock::addr, bBuf, sizeof(bBuf));
+	}
+public:
+	Transport Port;
+	u8 Level;//reply level, 0: only READ and PING reply
+	u8 Error;//servo status byte of the last reply
+	int Err;
+	int BaudRate;
+	long MarginUs;//reply timeout margin over the wire time
+	u8 Mem[Map::FeedBack::len];
+private:
+	static void posEx(u8 *p, s16 Position, u16 Speed, u8 ACC)
+	{
+		typedef SCSRegBlock<typename Map::Acc, typename Map::GoalSpeed> PosExBlock;
+		PosExBlock::template set<typename Map::Acc, Map::End>(p, ACC);
+		PosExBlock::template set<typename Map::GoalPosition, Map::End>(p, Position);
+		PosExBlock::template set<typename Map::GoalTime, Map::End>(p, 0);
+		PosExBlock::template set<typename Map::GoalSpeed, Map::End>(p, Speed);
+	}
+	//checksum and send the frame built in txBuf up to End
+	int finish(u8 *End)
+	{
+		*End = ~SCSChecksum::sum(txBuf+2, End-txBuf-2);
+		End++;
+		return Port.write(txBuf, End-txBuf)==End-txBuf;
+	}
+	int request(u8 ID, u8 Inst, u8 MemAddr, const u8 *nDat, u8 nLen)
+	{
+		Port.flush();
+		u8 *p = txBuf;
+		*p++ = 0xff;
+		*p++ = 0xff;
+		*p++ = ID;
+		*p++ = nDat ? nLen+3 : 2;
+		*p++ = Inst;
+		if(nDat){
+			*p++ = MemAddr;
+			memcpy(p, nDat, nLen);
+			p += nLen;
+		}
+		return finish(p);
+	}
+	int ack(u8 ID)
+	{
+		if(ID==0xfe || !Level){
+			return 1;
+		}
+		return status(ID, 0) ? 1 : 0;
+	}
+	//status packet of ID with nLen payload bytes, leading garbage is skipped
+	const u8 *status(u8 ID, u8 nLen)
+	{
+		int Need = nLen+6;
+		long TimeOutUs = (long)((Need*10*1000000LL)/BaudRate)+MarginUs;
+		u64 Deadline = SCSerial::monoUs()+TimeOutUs;
+		int rxLen = 0;
+		int Pos = 0;
+		while(1){
+			int pktLen;
+			u8 Result;
+			while((pktLen = SCSStatus::find(rxBuf, rxLen, &Pos, &Result))>0){
+				const u8 *p = rxBuf+Pos;
+				if(SCSStatus::match(p, ID, nLen)==SCS_STAT_OK){
+					Error = p[4];
+					return p;
+				}
+				Pos += pktLen;
+			}
+			long Left = (long)(Deadline-SCSerial::monoUs());
+			if(Left<=0 || rxLen==(int)sizeof(rxBuf)){
+				return NULL;
+			}
+			int Want = SCSStatus::need(rxBuf+Pos, rxLen-Pos, Need);
+			if(Want>(int)sizeof(rxBuf)-rxLen){
+				Want = sizeof(rxBuf)-rxLen;
+			}
+			int n = Port.read(rxBuf+rxLen, Want, Left);
+			if(n<=0){
+				return NULL;
+			}
+			rxLen += n;
+		}
+	}
+private:
+	u8 txBuf[255+6];
+	u8 rxBuf[SCS_STATUS_SCAN];
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * SCSStats.cpp
+ * Per-transaction counters and latency histograms for the SCS layer
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#include <string.h>
+#include <time.h>
+#include "SCSStats.h"
+
+static u64 statUs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000ULL + ts.tv_nsec/1000;
+}
+
+//values below 4 get their own bucket, above that 4 buckets per power of 2
+static u8 histIndex(u32 us)
+{
+	if(us<4){
+		return us;
+	}
+	u8 e = 31-__builtin_clz(us);
+	return 4 + (e-2)*4 + ((us>>(e-2))&3);
+}
+
+static u32 histValue(u8 Index)
+{
+	if(Index<4){
+		return Index;
+	}
+	u8 e = (Index-4)/4+2;
+	return (u32)(4+(Index-4)%4)<<(e-2);
+}
+
+void SCSHist::add(u32 us)
+{
+	Count++;
+	Sum += us;
+	if(us>Max){
+		Max = us;
+	}
+	Bucket[histIndex(us)]++;
+}
+
+u32 SCSHist::percentile(double p) const
+{
+	if(!Count){
+		return 0;
+	}
+	u64 Rank = (u64)(p*Count/100.0+0.5);
+	if(Rank<1){
+		Rank = 1;
+	}
+	u64 n = 0;
+	for(u8 i=0; i<SCS_HIST_N; i++){
+		n += Bucket[i];
+		if(n>=Rank){
+			return histValue(i);
+		}
+	}
+	return Max;
+}
+
+u32 SCSHist::below(u32 us) const
+{
+	u32 n = 0;
+	for(u8 i=0; i+1<SCS_HIST_N && histValue(i+1)<=us; i++){
+		n += Bucket[i];
+	}
+	return n;
+}
+
+SCSStats::SCSStats()
+{
+	clear();
+}
+
+void SCSStats::clear()
+{
+	memset(Inst, 0, sizeof(Inst));
+	memset(ID, 0, sizeof(ID));
+	memset(&SyncRx, 0, sizeof(SyncRx));
+	SyncIDN = 0;
+	txUs = 0;
+}
+
+int SCSStats::instIndex(u8 Inst)
+{
+	switch(Inst){
+		case INST_PING: return 0;
+		case INST_READ: return 1;
+		case INST_WRITE: return 2;
+		case INST_REG_WRITE: return 3;
+		case INST_REG_ACTION: return 4;
+		case INST_SYNC_READ: return 5;
+		case INST_SYNC_WRITE: return 6;
+		default: return -1;
+	}
+}
+
+void SCSStats::begin(u8 Inst, u16 txLen)
+{
+	int i = instIndex(Inst);
+	txUs = statUs();
+	if(i>=0){
+		this->Inst[i].Count.TxBytes += txLen;
+	}
+}
+
+static void countResult(SCSStatCount *c, u8 Result, u16 rxLen)
+{
+	c->Tx++;
+	c->RxBytes += rxLen;
+	if(Result==SCS_STAT_TIMEOUT){
+		c->TimeOut++;
+	}else if(Result==SCS_STAT_HEADER || Result==SCS_STAT_WRONGID){
+		c->Header++;
+	}else if(Result==SCS_STAT_CHECKSUM){
+		c->CheckSum++;
+	}
+}
+
+void SCSStats::end(u8 ID, u8 Inst, u8 Result, u16 rxLen, u64 rxFirstUs)
+{
+	u64 Now = statUs();
+	u32 Reply = (u32)(Now-txUs);
+	int i = instIndex(Inst);
+	if(i>=0){
+		SCSStatInst *s = this->Inst+i;
+		countResult(&s->Count, Result, rxLen);
+		if(Result==SCS_STAT_OK){
+			s->Reply.add(Reply);
+			if(rxFirstUs>=txUs){
+				s->FirstByte.add((u32)(rxFirstUs-txUs));
+			}
+		}
+	}
+	if(ID<SCS_STAT_ID){
+		countResult(&this->ID[ID].Count, Result, rxLen);
+		if(Result==SCS_STAT_OK){
+			this->ID[ID].Reply.add(Reply);
+		}
+	}
+}
+
+void SCSStats::syncBegin(const u8 ID[], u8 IDN)
+{
+	if(IDN>SCS_STAT_ID){
+		IDN = SCS_STAT_ID;
+	}
+	memcpy(SyncID, ID, IDN);
+	SyncIDN = IDN;
+}
+
+void SCSStats::syncEnd(u8 ID, u8 Result)
+{
+	countResult(&SyncRx, Result, 0);
+	if(ID<SCS_STAT_ID){
+		countResult(&this->ID[ID].Count, Result, 0);
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * SCSStats.h
+ * Per-transaction counters and latency histograms for the SCS layer
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _SCSSTATS_H
+#define _SCSSTATS_H
+
+#include "INST.h"
+
+#define SCS_HIST_N 124//log-linear buckets, 4 per power of 2 up to 2^32 us
+#define SCS_STAT_INST 7//PING, READ, WRITE, REG_WRITE, ACTION, SYNC_READ, SYNC_WRITE
+#define SCS_STAT_ID SCS_MAX_ID
+
+//transaction outcome
+#define SCS_STAT_OK 0
+#define SCS_STAT_TIMEOUT 1
+#define SCS_STAT_HEADER 2//bad header, ID or length
+#define SCS_STAT_CHECKSUM 3
+#define SCS_STAT_NOREPLY 4//no status packet expected (broadcast, Level=0, sync write)
+#define SCS_STAT_WRONGID 5//valid packet of another servo or length, counted with the header errors
+
+struct SCSHist{
+	u32 Count;
+	u32 Max;
+	u64 Sum;
+	u32 Bucket[SCS_HIST_N];
+	void add(u32 us);
+	u32 percentile(double p) const;//lower bound of the bucket holding the p-th percentile (0..100), in us
+	u32 mean() const{  return Count ? (u32)(Sum/Count) : 0;  }
+	u32 below(u32 us) const;//samples under us, exact when us is a bucket edge (any power of 2)
+};
+
+struct SCSStatCount{
+	u32 Tx;//transactions
+	u32 TimeOut;
+	u32 Header;
+	u32 CheckSum;
+	u64 TxBytes;
+	u64 RxBytes;
+};
+
+//per instruction: request-to-first-byte and full-reply latency
+struct SCSStatInst{
+	SCSStatCount Count;
+	SCSHist FirstByte;
+	SCSHist Reply;
+};
+
+//per servo ID: full-reply latency only
+struct SCSStatID{
+	SCSStatCount Count;
+	SCSHist Reply;
+};
+
+class SCSStats{
+public:
+	SCSStats();
+	void clear();
+	static int instIndex(u8 Inst);//instruction to Inst[] index, -1 if unknown
+	void begin(u8 Inst, u16 txLen);//request flushed to the transport
+	void end(u8 ID, u8 Inst, u8 Result, u16 rxLen, u64 rxFirstUs);//reply handled, rxFirstUs: first byte arrival (0 if none)
+	void syncBegin(const u8 ID[], u8 IDN);//remember the IDs of a SyncRead for per-ID accounting
+	void syncEnd(u8 ID, u8 Result);//per-ID outcome of a SyncRead reply
+public:
+	SCSStatInst Inst[SCS_STAT_INST];
+	SCSStatID ID[SCS_STAT_ID];
+	u8 SyncID[SCS_STAT_ID];
+	u8 SyncIDN;
+	SCSStatCount SyncRx;//per-servo outcome of every SyncRead, Tx: replies expected, TimeOut: missing
+private:
+	u64 txUs;
+};
+
+#endif
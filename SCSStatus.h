@@ -0,0 +1,64 @@
+/*
+ * SCSStatus.h
+ * Status packet decoder shared by every reply path
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSSTATUS_H
+#define _SCSSTATUS_H
+
+#include "INST.h"
+#include "SCSStats.h"
+#include "SCSChecksum.h"
+
+//status packet: 0xff 0xff ID Len Error Dat[Len-2] CheckSum
+struct SCSStatus{
+	//packet at p: its length, 0 if Len bytes do not complete it yet,
+	//-SCS_STAT_HEADER or -SCS_STAT_CHECKSUM if p does not start one
+	static int check(const u8 *p, int Len)
+	{
+		if(Len<4){
+			return (Len<1 || p[0]==0xff) && (Len<2 || p[1]==0xff) && (Len<3 || p[2]!=0xff) ? 0 : -SCS_STAT_HEADER;
+		}
+		if((p[0]&p[1])!=0xff || p[2]==0xff || p[3]<2){
+			return -SCS_STAT_HEADER;
+		}
+		int pktLen = p[3]+4;
+		if(Len<pktLen){
+			return 0;
+		}
+		return (u8)~SCSChecksum::sum(p+2, pktLen-3)==p[pktLen-1] ? pktLen : -SCS_STAT_CHECKSUM;
+	}
+	//Next valid packet in Buf[*Pos..Len): returns its length with *Pos
+	//at its first byte, or 0 with *Pos at the start of an incomplete
+	//packet (or Len). Skipped bytes set *Result to the last reason.
+	static int find(const u8 *Buf, int Len, int *Pos, u8 *Result)
+	{
+		int i = *Pos;
+		while(i<Len){
+			int n = check(Buf+i, Len-i);
+			if(n>=0){
+				*Pos = i;
+				return n;
+			}
+			*Result = -n;
+			i++;
+		}
+		*Pos = Len;
+		return 0;
+	}
+	//SCS_STAT_OK if the packet is the reply of ID (0xfe: any) with nLen payload bytes
+	static u8 match(const u8 *p, u8 ID, u8 nLen)
+	{
+		return ((p[2]==ID) | (ID==0xfe)) & (p[3]==nLen+2) ? SCS_STAT_OK : SCS_STAT_WRONGID;
+	}
+	//bytes still missing from the incomplete packet at the start of Buf, Want: expected packet length
+	static int need(const u8 *Buf, int Len, int Want)
+	{
+		int n = (Len>=4 ? Buf[3]+4 : Want)-Len;
+		return n>0 ? n : 1;
+	}
+};
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * SCSSyncRead.cpp
+ * Reusable SyncRead session with preallocated storage
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#include <string.h>
+#include "SCSSyncRead.h"
+
+SCSSyncRead::SCSSyncRead(SCS *bus, u8 *rxBuff, u16 rxBuffSize)
+{
+	this->bus = bus;
+	this->rxBuff = rxBuff;
+	this->rxBuffSize = rxBuffSize;
+	IDN = 0;
+	MemAddr = 0;
+	nLen = 0;
+	memset(Rx, 0, sizeof(Rx));
+}
+
+int SCSSyncRead::begin(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen)
+{
+	if(IDN>sizeof(this->ID) || IDN*(nLen+6)>rxBuffSize){
+		return 0;
+	}
+	memcpy(this->ID, ID, IDN);
+	this->IDN = IDN;
+	this->MemAddr = MemAddr;
+	this->nLen = nLen;
+	return 1;
+}
+
+int SCSSyncRead::exec()
+{
+	if(!IDN){
+		return 0;
+	}
+	bus->syncReadBegin(IDN, nLen, rxBuff);
+	bus->syncReadPacketTx(ID, IDN, MemAddr, nLen);
+	return bus->syncReadPacketRxAll(Rx, sizeof(Rx)/sizeof(Rx[0]));
+}
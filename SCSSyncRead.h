@@ -0,0 +1,43 @@
+/*
+ * SCSSyncRead.h
+ * Reusable SyncRead session with preallocated storage
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _SCSSYNCREAD_H
+#define _SCSSYNCREAD_H
+
+#include "SCS.h"
+
+//The ID set and register range are configured once, exec() then runs
+//one SyncRead cycle without touching the heap. Rx[] is indexed by ID and
+//its payload pointers stay valid until the next exec().
+class SCSSyncRead{
+public:
+	SCSSyncRead(SCS *bus, u8 *rxBuff, u16 rxBuffSize);//caller storage, e.g. a static array
+	int begin(const u8 ID[], u8 IDN, u8 MemAddr, u8 nLen);//returns 0 if the set does not fit the storage
+	int exec();//send the SyncRead and decode all replies, returns number of valid packets
+	SyncReadRx *get(u8 ID){  return Rx+ID;  }
+public:
+	u8 ID[0xfe];
+	u8 IDN;
+	u8 MemAddr;
+	u8 nLen;
+	SyncReadRx Rx[0xfe];
+private:
+	SCS *bus;
+	u8 *rxBuff;
+	u16 rxBuffSize;
+};
+
+//Session with storage fixed at compile time
+template<u8 MaxIDN, u8 MaxLen>
+class SCSSyncReadBuf : public SCSSyncRead{
+public:
+	SCSSyncReadBuf(SCS *bus):SCSSyncRead(bus, Buf, sizeof(Buf)){}
+private:
+	u8 Buf[MaxIDN*(MaxLen+6)];
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * SCSTdma.cpp
+ * Time-division bus cycle: per traffic class slots, background steps admitted by predicted time
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSerial.h"
+#include "SCSTdma.h"
+
+SCSTdma::SCSTdma()
+{
+	PeriodUs = 10000;
+	GuardUs = 200;
+	Cycles = 0;
+	JobsDone = 0;
+	JobsFailed = 0;
+	TaskN = 0;
+	memset(Slot, 0, sizeof(Slot));
+	memset(Head, 0, sizeof(Head));
+	memset(Tail, 0, sizeof(Tail));
+	for(u8 c=0; c<SCS_TDMA_CLASSES; c++){
+		Slot[c].Weight = 1;
+	}
+	pthread_mutex_init(&Mutex, NULL);
+	share();
+}
+
+SCSTdma::~SCSTdma()
+{
+	pthread_mutex_destroy(&Mutex);
+}
+
+void SCSTdma::setPeriod(u32 periodUs)
+{
+	PeriodUs = periodUs ? periodUs : 1;
+	share();
+}
+
+void SCSTdma::share()
+{
+	u32 Fixed = 0;
+	u32 Weights = 0;
+	for(u8 c=0; c<SCS_TDMA_CLASSES; c++){
+		Fixed += Slot[c].FixedUs;
+		Weights += Slot[c].Weight;
+	}
+	u32 Free = PeriodUs>GuardUs+Fixed ? PeriodUs-GuardUs-Fixed : 0;
+	for(u8 c=0; c<SCS_TDMA_CLASSES; c++){
+		Slot[c].BudgetUs = Slot[c].FixedUs+(Weights ? (u32)((u64)Free*Slot[c].Weight/Weights) : 0);
+	}
+}
+
+int SCSTdma::setSlot(u8 Class, u32 FixedUs, u8 Weight)
+{
+	if(Class>=SCS_TDMA_CLASSES){
+		return 0;
+	}
+	u32 Fixed = FixedUs;
+	for(u8 c=0; c<SCS_TDMA_CLASSES; c++){
+		if(c!=Class){
+			Fixed += Slot[c].FixedUs;
+		}
+	}
+	if(Fixed+GuardUs>PeriodUs){
+		return 0;
+	}
+	Slot[Class].FixedUs = FixedUs;
+	Slot[Class].Weight = Weight;
+	share();
+	return 1;
+}
+
+int SCSTdma::addTask(u8 Class, SCSLoopJob Step, void *Arg, u32 PredUs, u32 Every)
+{
+	if(Class>=SCS_TDMA_CLASSES || !Step || TaskN>=SCS_TDMA_TASKS){
+		return -1;
+	}
+	Task *t = T+TaskN;
+	t->Step = Step;
+	t->Arg = Arg;
+	t->CostUs = PredUs;
+	t->Every = Every ? Every : 1;
+	t->Class = Class;
+	t->Due = 0;
+	return TaskN++;
+}
+
+int SCSTdma::submit(u8 Class, SCSLoopJob Step, void *Arg, u32 PredUs)
+{
+	if(Class>=SCS_TDMA_CLASSES || !Step){
+		return 0;
+	}
+	pthread_mutex_lock(&Mutex);
+	u32 n = Tail[Class];
+	if(n-__atomic_load_n(&Head[Class], __ATOMIC_ACQUIRE)>=SCS_TDMA_JOBS){
+		pthread_mutex_unlock(&Mutex);
+		return 0;
+	}
+	Job *j = &J[Class][n&(SCS_TDMA_JOBS-1)];
+	j->Step = Step;
+	j->Arg = Arg;
+	j->CostUs = PredUs;
+	__atomic_store_n(&Tail[Class], n+1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&Mutex);
+	return 1;
+}
+
+int SCSTdma::pending(u8 Class)
+{
+	if(Class>=SCS_TDMA_CLASSES){
+		return 0;
+	}
+	return __atomic_load_n(&Tail[Class], __ATOMIC_ACQUIRE)-__atomic_load_n(&Head[Class], __ATOMIC_ACQUIRE);
+}
+
+//runs one step, an overrun raises the cost to the time measured
+int SCSTdma::run(SCSTdmaSlot *s, SCSLoopJob Step, void *Arg, u32 *CostUs)
+{
+	u64 t0 = SCSerial::monoUs();
+	int Result = Step(Arg);
+	u32 Us = (u32)(SCSerial::monoUs()-t0);
+	if(Us>*CostUs){
+		s->Overruns++;
+		*CostUs = Us;
+	}
+	s->Runs++;
+	return Result;
+}
+
+int SCSTdma::cycle(u64 StartUs)
+{
+	u64 CycleEnd = StartUs+PeriodUs-GuardUs;
+	u64 SlotEnd = StartUs;
+	int Steps = 0;
+	for(u8 c=0; c<SCS_TDMA_CLASSES; c++){
+		SCSTdmaSlot *s = Slot+c;
+		u64 Begin = SCSerial::monoUs();
+		SlotEnd += s->BudgetUs;//slots follow each other from the cycle start, time left by one class passes on
+		if(SlotEnd>CycleEnd){
+			SlotEnd = CycleEnd;
+		}
+		for(u8 i=0; i<TaskN; i++){
+			Task *t = T+i;
+			if(t->Class!=c){
+				continue;
+			}
+			if(Cycles%t->Every==0){
+				t->Due = 1;
+			}
+			if(!t->Due){
+				continue;
+			}
+			if(c!=SCS_TDMA_CONTROL && SCSerial::monoUs()+t->CostUs>SlotEnd){
+				s->Deferred++;
+				continue;
+			}
+			run(s, t->Step, t->Arg, &t->CostUs);
+			t->Due = 0;
+			Steps++;
+		}
+		while(Head[c]!=__atomic_load_n(&Tail[c], __ATOMIC_ACQUIRE)){
+			Job *j = &J[c][Head[c]&(SCS_TDMA_JOBS-1)];
+			if(c!=SCS_TDMA_CONTROL && SCSerial::monoUs()+j->CostUs>SlotEnd){
+				s->Deferred++;
+				break;
+			}
+			int Result = run(s, j->Step, j->Arg, &j->CostUs);
+			Steps++;
+			if(Result<=0){
+				if(Result<0){
+					JobsFailed++;
+				}else{
+					JobsDone++;
+				}
+				__atomic_store_n(&Head[c], Head[c]+1, __ATOMIC_RELEASE);
+			}
+			if(c==SCS_TDMA_CONTROL){
+				break;//one control job step per cycle, it is never deferred
+			}
+		}
+		s->Used.add((u32)(SCSerial::monoUs()-Begin));
+	}
+	Cycles++;
+	return Steps;
+}
+
+u32 SCSTdma::controlBoundUs()
+{
+	u32 Us = 0;
+	for(u8 i=0; i<TaskN; i++){
+		if(T[i].Class==SCS_TDMA_CONTROL){
+			Us += T[i].CostUs;
+		}
+	}
+	return Us;
+}
+
+int SCSTdma::job(void *tdma)
+{
+	((SCSTdma*)tdma)->cycle(SCSerial::monoUs());
+	return 0;
+}
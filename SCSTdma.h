@@ -0,0 +1,91 @@
+/*
+ * SCSTdma.h
+ * Time-division bus cycle: per traffic class slots, background steps admitted by predicted time
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTDMA_H
+#define _SCSTDMA_H
+
+#include <pthread.h>
+#include "SCSLoop.h"
+#include "SCSStats.h"
+
+#define SCS_TDMA_CONTROL 0//goal writes, always run first, never deferred
+#define SCS_TDMA_FEEDBACK 1
+#define SCS_TDMA_HEALTH 2
+#define SCS_TDMA_BACKGROUND 3//EEPROM programming and other long sequences
+#define SCS_TDMA_CLASSES 4
+#define SCS_TDMA_TASKS 16//periodic tasks of all classes
+#define SCS_TDMA_JOBS 8//queued step jobs, power of 2
+
+//Per class slot and its accounting
+struct SCSTdmaSlot{
+	u32 FixedUs;//reserved every cycle
+	u8 Weight;//share of the time left after all fixed slots
+	u32 BudgetUs;//FixedUs plus the weighted share, updated by setSlot()/setPeriod()
+	u32 Runs;//steps run
+	u32 Deferred;//steps that did not fit the slot and waited for a later cycle
+	u32 Overruns;//steps that took longer than admitted
+	SCSHist Used;//time used per cycle, us
+};
+
+//One bus cycle is cut into slots, in class order: control, feedback,
+//health, background. cycle() runs the periodic tasks of each class,
+//then the queued job steps of that class, and admits a step only if its
+//cost ends inside the slot of the class and before the next cycle (less
+//GuardUs). Control tasks are never deferred, everything else can only
+//take time it was granted, so as long as the costs hold the control
+//tasks start within a few microseconds of every cycle start and finish
+//within controlBoundUs(). The cost of a step is the larger of its
+//prediction (e.g. SCSBudget::cycleUs() of its transactions) and the
+//longest run measured so far, a step that overruns is counted and its
+//cost grows. A step function is an SCSLoopJob (SCSHealth::job works as a
+//health task): periodic task results are ignored, a job step returns >0
+//while more steps follow, 0 when done, <0 on failure.
+class SCSTdma{
+public:
+	SCSTdma();
+	~SCSTdma();
+	void setPeriod(u32 periodUs);//the cycle, same as the SCSLoop period
+	int setSlot(u8 Class, u32 FixedUs, u8 Weight = 0);//0 if Class is out of range or the fixed slots exceed the period
+	int addTask(u8 Class, SCSLoopJob Step, void *Arg, u32 PredUs, u32 Every = 1);//periodic, every Every cycles, returns the task index or -1
+	int submit(u8 Class, SCSLoopJob Step, void *Arg, u32 PredUs);//any thread, one step per admission until Step returns <=0, 0 if the queue is full
+	int pending(u8 Class);//jobs queued or running
+	int cycle(u64 StartUs);//bus thread, returns steps run
+	u32 controlBoundUs();//worst case control latency from the cycle start: the costs of all control tasks
+	static int job(void *tdma);//SCSLoopJob running cycle(SCSerial::monoUs())
+public:
+	u32 GuardUs;//kept free at the end of every cycle for wake-up jitter, default 200
+	u32 Cycles;
+	u32 JobsDone;
+	u32 JobsFailed;
+	SCSTdmaSlot Slot[SCS_TDMA_CLASSES];
+private:
+	struct Task{
+		SCSLoopJob Step;
+		void *Arg;
+		u32 CostUs;
+		u32 Every;
+		u8 Class;
+		u8 Due;
+	};
+	struct Job{
+		SCSLoopJob Step;
+		void *Arg;
+		u32 CostUs;
+	};
+	void share();
+	int run(SCSTdmaSlot *s, SCSLoopJob Step, void *Arg, u32 *CostUs);
+private:
+	u32 PeriodUs;
+	Task T[SCS_TDMA_TASKS];
+	u8 TaskN;
+	Job J[SCS_TDMA_CLASSES][SCS_TDMA_JOBS];
+	u32 Head[SCS_TDMA_CLASSES];//consumer
+	u32 Tail[SCS_TDMA_CLASSES];//producers, under Mutex
+	pthread_mutex_t Mutex;
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * SCSTelemetryStore.h
+ * Structure-of-arrays telemetry of all servos on a bus, one consistent cycle per snapshot
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTELEMETRYSTORE_H
+#define _SCSTELEMETRYSTORE_H
+
+#include <string.h>
+#include "SCS.h"
+#include "SCSRegMap.h"
+#include "SCSTripleBuffer.h"
+
+#ifndef SCS_SOA_SERVOS
+#define SCS_SOA_SERVOS 64//servos of one store, a multiple of 16 keeps every array 16-byte aligned
+#endif
+
+//One cycle, field by field. Index i of every array belongs to ID[i], so
+//vectorised consumers read Position[0..IDN) without a gather pass.
+//Entries whose reply was lost keep the values of the last good cycle
+//with Valid[i] = 0.
+struct alignas(16) SCSTelemetryFrame{
+	u64 Stamp[SCS_SOA_SERVOS];//arrival of the status packet, monotonic us
+	s16 Position[SCS_SOA_SERVOS];
+	s16 Speed[SCS_SOA_SERVOS];
+	s16 Load[SCS_SOA_SERVOS];
+	s16 Current[SCS_SOA_SERVOS];
+	u8 Voltage[SCS_SOA_SERVOS];
+	u8 Temperature[SCS_SOA_SERVOS];
+	u8 Moving[SCS_SOA_SERVOS];
+	u8 Error[SCS_SOA_SERVOS];
+	u8 Valid[SCS_SOA_SERVOS];
+	u8 ID[SCS_SOA_SERVOS];
+	u8 IDN;
+	u32 Cycle;
+	u32 ValidN;//entries valid in this cycle
+};
+
+//update() (bus thread) runs one SyncRead of the Map::FeedBack block and
+//decodes every reply straight into the snapshot being written, then
+//publishes it. read() copies the latest complete cycle from any thread
+//without a lock (SCSTripleBuffer).
+template<class Map>
+class SCSTelemetryStore{
+public:
+	SCSTelemetryStore() : IDN(0), Cycle(0) {}
+	int setServos(const u8 ID[], u8 IDN)//before the first update(), returns 0 if IDN is too large
+	{
+		if(IDN>SCS_SOA_SERVOS){
+			return 0;
+		}
+		memcpy(this->ID, ID, IDN);
+		this->IDN = IDN;
+		return 1;
+	}
+	int update(SCS *bus, u64 NowUs)//returns servos decoded, NowUs stamps replies without a timestamp
+	{
+		typedef typename Map::FeedBack FB;
+		bus->syncReadBegin(IDN, FB::len, rxBuff);
+		bus->syncReadPacketTx(ID, IDN, FB::addr, FB::len);
+		bus->syncReadPacketRxAll(rxTab, 0xfe);
+		bus->syncReadEnd();
+		const SCSTelemetryFrame *Prev = Frames.published();
+		SCSTelemetryFrame *f = Frames.writeBegin();
+		f->IDN = IDN;
+		f->Cycle = ++Cycle;
+		f->ValidN = 0;
+		for(u8 i=0; i<IDN; i++){
+			const SyncReadRx *rx = rxTab+ID[i];
+			f->ID[i] = ID[i];
+			if(ID[i]>=0xfe || !rx->Valid){
+				if(Prev && i<Prev->IDN && Prev->ID[i]==ID[i]){
+					hold(f, Prev, i);
+				}else{
+					clearEntry(f, i);
+				}
+				f->Valid[i] = 0;
+				continue;
+			}
+			const u8 *d = rx->Dat;
+			f->Position[i] = FB::template get<typename Map::PresentPosition, Map::End>(d);
+			f->Speed[i] = FB::template get<typename Map::PresentSpeed, Map::End>(d);
+			f->Load[i] = FB::template get<typename Map::PresentLoad, Map::End>(d);
+			f->Current[i] = FB::template get<typename Map::PresentCurrent, Map::End>(d);
+			f->Voltage[i] = FB::template get<typename Map::PresentVoltage, Map::End>(d);
+			f->Temperature[i] = FB::template get<typename Map::PresentTemperature, Map::End>(d);
+			f->Moving[i] = FB::template get<typename Map::Moving, Map::End>(d);
+			f->Error[i] = rx->Error;
+			f->Stamp[i] = rx->Stamp ? rx->Stamp : NowUs;
+			f->Valid[i] = 1;
+			f->ValidN++;
+		}
+		Frames.writeEnd();
+		return f->ValidN;
+	}
+	u32 read(SCSTelemetryFrame *frame) const{  return Frames.read(frame);  }//any thread, returns the version, 0 before the first update()
+	u32 version() const{  return Frames.version();  }
+public:
+	u8 IDN;
+	u8 ID[SCS_SOA_SERVOS];
+	u32 Cycle;
+private:
+	static void hold(SCSTelemetryFrame *f, const SCSTelemetryFrame *p, u8 i)
+	{
+		f->Position[i] = p->Position[i];
+		f->Speed[i] = p->Speed[i];
+		f->Load[i] = p->Load[i];
+		f->Current[i] = p->Current[i];
+		f->Voltage[i] = p->Voltage[i];
+		f->Temperature[i] = p->Temperature[i];
+		f->Moving[i] = p->Moving[i];
+		f->Error[i] = p->Error[i];
+		f->Stamp[i] = p->Stamp[i];
+	}
+	static void clearEntry(SCSTelemetryFrame *f, u8 i)
+	{
+		f->Position[i] = f->Speed[i] = f->Load[i] = f->Current[i] = 0;
+		f->Voltage[i] = f->Temperature[i] = f->Moving[i] = f->Error[i] = 0;
+		f->Stamp[i] = 0;
+	}
+private:
+	SCSTripleBuffer<SCSTelemetryFrame> Frames;
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_SOA_SERVOS*(Map::FeedBack::len+6)];
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * SCSTelemetryView.h
+ * Feedback views over raw SyncRead bytes, fields decoded on first access
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTELEMETRYVIEW_H
+#define _SCSTELEMETRYVIEW_H
+
+#include <string.h>
+#include "SCS.h"
+#include "SCSRegMap.h"
+#include "SCSPrepared.h"
+#include "Telemetry.h"
+
+#ifndef SCS_VIEW_SERVOS
+#define SCS_VIEW_SERVOS 64//servos of one SCSLazyFeedBack
+#endif
+
+//One servo's Map::FeedBack block as it came off the wire. Each accessor
+//decodes its field the first time it is called after bind() and returns
+//the memoised value afterwards, so a consumer that only looks at
+//moving() costs one byte load. The bytes are not copied: the view is
+//valid until the buffer it was bound to is reused.
+template<class Map>
+class SCSTelemetryView{
+public:
+	typedef typename Map::FeedBack FB;
+	SCSTelemetryView() : Error(0), Valid(0), Stamp(0), Dat(NULL), Done(0) {}
+	void bind(const u8 *Dat, u8 Error, u64 Stamp)//raw block of a good status packet, NULL: no reply
+	{
+		this->Dat = Dat;
+		this->Error = Error;
+		this->Stamp = Stamp;
+		Valid = Dat!=NULL;
+		Done = 0;
+	}
+	int position(){  return get<typename Map::PresentPosition, 0>();  }
+	int speed(){  return get<typename Map::PresentSpeed, 1>();  }
+	int load(){  return get<typename Map::PresentLoad, 2>();  }
+	int voltage(){  return get<typename Map::PresentVoltage, 3>();  }
+	int temperature(){  return get<typename Map::PresentTemperature, 4>();  }
+	int moving(){  return get<typename Map::Moving, 5>();  }
+	int current(){  return get<typename Map::PresentCurrent, 6>();  }
+	const u8 *raw() const{  return Dat;  }
+	void decode(Telemetry *t)//every field, as SyncFeedBack() would
+	{
+		t->Position = position();
+		t->Speed = speed();
+		t->Load = load();
+		t->Voltage = voltage();
+		t->Temperature = temperature();
+		t->Moving = moving();
+		t->Current = current();
+		t->Error = Error;
+		t->Valid = Valid;
+		t->Stamp = Stamp;
+	}
+public:
+	u8 Error;//servo status byte
+	u8 Valid;//1: bound to a good status packet, the accessors return 0 otherwise
+	u64 Stamp;//arrival of the status packet, monotonic us, 0 if unknown
+private:
+	template<class Reg, int Bit> int get()
+	{
+		if(!(Done & (1<<Bit))){
+			Val[Bit] = Dat ? FB::template get<Reg, Map::End>(Dat) : 0;
+			Done |= 1<<Bit;
+		}
+		return Val[Bit];
+	}
+private:
+	const u8 *Dat;
+	u8 Done;//bit n: Val[n] is decoded
+	s16 Val[7];
+};
+
+//Bulk feedback without decoding: update() runs one SyncRead of the
+//feedback block from a prebuilt frame and only binds a view per servo
+//to the reply bytes. View[i] belongs to ID[i] until the next update().
+template<class Map>
+class SCSLazyFeedBack{
+public:
+	typedef typename Map::FeedBack FB;
+	SCSLazyFeedBack() : IDN(0), Cycle(0), tabLen(0) {}
+	int setServos(const u8 ID[], u8 IDN)//returns 0 if IDN is 0 or too large
+	{
+		if(!IDN || IDN>SCS_VIEW_SERVOS){
+			return 0;
+		}
+		memcpy(this->ID, ID, IDN);
+		this->IDN = IDN;
+		tabLen = 0;
+		for(u8 i=0; i<IDN; i++){
+			if(ID[i]>=tabLen){
+				tabLen = ID[i]+1;//rxTab is cleared up to the highest ID only
+			}
+		}
+		return Read.prepare(ID, IDN, FB::addr, FB::len);
+	}
+	int update(SCS *bus)//returns valid replies
+	{
+		int Valid = bus->syncReadPrepared(Read.frame(), Read.length(), IDN, FB::len, rxBuff, rxTab, tabLen);
+		for(u8 i=0; i<IDN; i++){
+			const SyncReadRx *rx = rxTab+ID[i];
+			View[i].bind(rx->Valid ? rx->Dat : NULL, rx->Error, rx->Stamp);
+		}
+		Cycle++;
+		return Valid;
+	}
+	SCSTelemetryView<Map> *get(u8 ServoID)//NULL if not in the set
+	{
+		for(u8 i=0; i<IDN; i++){
+			if(ID[i]==ServoID){
+				return View+i;
+			}
+		}
+		return NULL;
+	}
+public:
+	u8 IDN;
+	u8 ID[SCS_VIEW_SERVOS];
+	u32 Cycle;
+	SCSTelemetryView<Map> View[SCS_VIEW_SERVOS];
+private:
+	SCSSyncReadPacket Read;
+	u8 tabLen;
+	SyncReadRx rxTab[0xfe];
+	u8 rxBuff[SCS_VIEW_SERVOS*(FB::len+6)];
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * SCSTrace.cpp
+ * Lock-free flight recorder of bus events with nanosecond timestamps
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <time.h>
+#include "SCSTrace.h"
+
+SCSTrace::SCSTrace()
+{
+	memset(Ev, 0, sizeof(Ev));
+	memset(TxNs, 0, sizeof(TxNs));
+	Head = 0;
+	Tail = 0;
+	FaultPending = 0;
+	DumpOnFault = 1;
+	Written = 0;
+	Lost = 0;
+	Dumps = 0;
+	File = NULL;
+	Path[0] = 0;
+	PeriodUs = 100000;
+	Running = 0;
+	Started = 0;
+}
+
+SCSTrace::~SCSTrace()
+{
+	stop();
+}
+
+u64 SCSTrace::monoNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+void SCSTrace::add(u8 Type, u8 Tag, u8 ID, u8 Inst, u8 Result, u16 Len, u16 Aux, u32 LatNs)
+{
+	u64 Ns = monoNs();
+	u32 i = __atomic_fetch_add(&Head, 1, __ATOMIC_RELAXED);
+	SCSTraceEvent *e = Ev+(i&(SCS_TRACE_EVENTS-1));
+	__atomic_store_n(&e->Seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	e->Ns = Ns;
+	e->LatNs = LatNs;
+	e->Len = Len;
+	e->Aux = Aux;
+	e->Type = Type;
+	e->Tag = Tag;
+	e->ID = ID;
+	e->Inst = Inst;
+	e->Result = Result;
+	__atomic_store_n(&e->Seq, i+1, __ATOMIC_RELEASE);
+}
+
+void SCSTrace::tx(u8 Tag, u8 Inst, u16 Len)
+{
+	TxNs[Tag] = monoNs();
+	add(SCS_TRACE_TX, Tag, 0xff, Inst, 0, Len, 0);
+}
+
+void SCSTrace::rx(u8 Tag, u8 ID, u8 Inst, u8 Result, u16 Len)
+{
+	u64 Ns = monoNs();
+	u64 Lat = TxNs[Tag] && Ns>TxNs[Tag] ? Ns-TxNs[Tag] : 0;
+	add(SCS_TRACE_RX, Tag, ID, Inst, Result, Len, 0, Lat>0xffffffffULL ? 0xffffffff : (u32)Lat);
+}
+
+void SCSTrace::fault(u8 Tag, int Err)
+{
+	add(SCS_TRACE_FAULT, Tag, 0xff, 0, 0, 0, (u16)Err);
+	FaultPending = 1;
+}
+
+//1 complete, 0 still being written, -1 overwritten by a later event
+int SCSTrace::copy(u32 i, SCSTraceEvent *e)
+{
+	const SCSTraceEvent *s = Ev+(i&(SCS_TRACE_EVENTS-1));
+	u32 Seq = __atomic_load_n(&s->Seq, __ATOMIC_ACQUIRE);
+	if(Seq!=i+1){
+		return Seq && (int)(Seq-(i+1))>0 ? -1 : 0;
+	}
+	*e = *s;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if(__atomic_load_n(&s->Seq, __ATOMIC_RELAXED)!=Seq){
+		return -1;
+	}
+	return 1;
+}
+
+int SCSTrace::snapshot(SCSTraceEvent *Out, int Max)
+{
+	u32 h = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+	u32 n = h<SCS_TRACE_EVENTS ? h : SCS_TRACE_EVENTS;
+	if(n>(u32)Max){
+		n = Max;
+	}
+	int k = 0;
+	for(u32 i=h-n; i!=h; i++){
+		if(copy(i, Out+k)==1){
+			k++;
+		}
+	}
+	return k;
+}
+
+const char *SCSTrace::typeName(u8 Type)
+{
+	switch(Type){
+		case SCS_TRACE_TX: return "tx";
+		case SCS_TRACE_RX: return "rx";
+		case SCS_TRACE_SYNC: return "sync";
+		case SCS_TRACE_RETRY: return "retry";
+		case SCS_TRACE_FAULT: return "fault";
+		case SCS_TRACE_USER: return "mark";
+		default: return "?";
+	}
+}
+
+void SCSTrace::print(FILE *f, const SCSTraceEvent *e)
+{
+	fprintf(f, "%llu %u %s %u 0x%02x %u %u %u %lu\n", (unsigned long long)e->Ns, (unsigned)e->Tag, typeName(e->Type), (unsigned)e->ID, (unsigned)e->Inst, (unsigned)e->Result, (unsigned)e->Len, (unsigned)e->Aux, e->LatNs);
+}
+
+int SCSTrace::dump(FILE *f)
+{
+	u32 h = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+	u32 n = h<SCS_TRACE_EVENTS ? h : SCS_TRACE_EVENTS;
+	int k = 0;
+	fprintf(f, "#ns tag type id inst result len aux lat_ns\n");
+	for(u32 i=h-n; i!=h; i++){
+		SCSTraceEvent e;
+		if(copy(i, &e)==1){
+			print(f, &e);
+			k++;
+		}
+	}
+	Dumps++;
+	return k;
+}
+
+int SCSTrace::dump(const char *Path)
+{
+	FILE *f = fopen(Path, "w");
+	if(!f){
+		return -1;
+	}
+	int n = dump(f);
+	fclose(f);
+	return n;
+}
+
+//writer thread side: new events to File
+int SCSTrace::flush()
+{
+	u32 h = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+	int n = 0;
+	if(h-Tail>SCS_TRACE_EVENTS){
+		Lost += h-Tail-SCS_TRACE_EVENTS;
+		Tail = h-SCS_TRACE_EVENTS;
+	}
+	while(Tail!=h){
+		SCSTraceEvent e;
+		int r = copy(Tail, &e);
+		if(!r){
+			break;//a producer is still filling it, next round
+		}
+		if(r>0){
+			print(File, &e);
+			n++;
+		}else{
+			Lost++;
+		}
+		Tail++;
+	}
+	if(n){
+		fflush(File);
+		Written += n;
+	}
+	return n;
+}
+
+void *SCSTrace::thread(void *arg)
+{
+	SCSTrace *t = (SCSTrace*)arg;
+	struct timespec ts;
+	ts.tv_sec = t->PeriodUs/1000000;
+	ts.tv_nsec = (t->PeriodUs%1000000)*1000;
+	while(t->Running){
+		nanosleep(&ts, NULL);
+		t->flush();
+		if(t->FaultPending && t->DumpOnFault){
+			char Fault[SCS_TRACE_PATH+8];
+			snprintf(Fault, sizeof(Fault), "%s.fault", t->Path);
+			t->FaultPending = 0;
+			t->dump(Fault);
+		}
+	}
+	t->flush();
+	return NULL;
+}
+
+int SCSTrace::start(const char *Path, u32 PeriodUs)
+{
+	if(Started){
+		return 0;
+	}
+	File = fopen(Path, "a");
+	if(!File){
+		return 0;
+	}
+	snprintf(this->Path, sizeof(this->Path), "%s", Path);
+	fprintf(File, "#ns tag type id inst result len aux lat_ns\n");
+	this->PeriodUs = PeriodUs ? PeriodUs : 1;
+	Tail = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+	Running = 1;
+	if(pthread_create(&Thread, NULL, thread, this)!=0){
+		Running = 0;
+		fclose(File);
+		File = NULL;
+		return 0;
+	}
+	Started = 1;
+	return 1;
+}
+
+void SCSTrace::stop()
+{
+	if(!Started){
+		return;
+	}
+	Running = 0;
+	pthread_join(Thread, NULL);
+	Started = 0;
+	fclose(File);
+	File = NULL;
+}
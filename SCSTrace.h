@@ -0,0 +1,88 @@
+/*
+ * SCSTrace.h
+ * Lock-free flight recorder of bus events with nanosecond timestamps
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTRACE_H
+#define _SCSTRACE_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "INST.h"
+
+#ifndef SCS_TRACE_EVENTS
+#define SCS_TRACE_EVENTS 8192//events kept, power of 2
+#endif
+static_assert((SCS_TRACE_EVENTS&(SCS_TRACE_EVENTS-1))==0, "SCS_TRACE_EVENTS must be a power of 2");
+#define SCS_TRACE_PATH 256
+
+#define SCS_TRACE_TX 1//request framed and flushed, Inst, Len bytes
+#define SCS_TRACE_RX 2//reply handled, Result SCS_STAT_*, Len bytes, LatNs since the TX
+#define SCS_TRACE_SYNC 3//SyncRead decoded, Len replies of Aux expected
+#define SCS_TRACE_RETRY 4//another attempt, Aux attempt number
+#define SCS_TRACE_FAULT 5//port lost, Aux errno
+#define SCS_TRACE_USER 6//mark(), Aux from the caller
+
+struct SCSTraceEvent{
+	u64 Ns;//CLOCK_MONOTONIC
+	u32 Seq;//index+1 once complete, 0 while written
+	u32 LatNs;
+	u16 Len;
+	u16 Aux;
+	u8 Type;//SCS_TRACE_*
+	u8 Tag;//bus, see SCS::setTrace()
+	u8 ID;//0xff unknown
+	u8 Inst;
+	u8 Result;
+};
+
+//add() claims a slot with one atomic increment and never blocks or
+//waits, any number of threads and buses can share one trace. The ring
+//keeps the newest SCS_TRACE_EVENTS events, older ones are overwritten.
+//Readers copy a slot and keep it only if its sequence did not move
+//(the same scheme as SCSHealth). start() runs a writer thread that
+//appends new events to a text file and, after fault(), also writes the
+//whole ring to Path.fault; dump() does it on demand.
+class SCSTrace{
+public:
+	SCSTrace();
+	~SCSTrace();
+	void add(u8 Type, u8 Tag, u8 ID, u8 Inst, u8 Result, u16 Len, u16 Aux, u32 LatNs = 0);//any thread
+	void tx(u8 Tag, u8 Inst, u16 Len);
+	void rx(u8 Tag, u8 ID, u8 Inst, u8 Result, u16 Len);
+	void mark(u8 Tag, u16 Aux){  add(SCS_TRACE_USER, Tag, 0xff, 0, 0, 0, Aux);  }
+	void fault(u8 Tag, int Err);//records the fault and asks the writer thread for a dump
+	int snapshot(SCSTraceEvent *Ev, int Max);//newest complete events, oldest first, returns count
+	int dump(FILE *f);//the whole ring as text, returns events written
+	int dump(const char *Path);
+	int start(const char *Path, u32 PeriodUs = 100000);//append new events to Path from a background thread
+	void stop();//write what is left and join the thread
+	static u64 monoNs();
+	static const char *typeName(u8 Type);
+public:
+	u8 DumpOnFault;//1 (default): the writer thread dumps the ring after fault()
+	u32 Written;//events written by the writer thread
+	u32 Lost;//events overwritten before the writer thread got to them
+	u32 Dumps;
+private:
+	int copy(u32 i, SCSTraceEvent *e);//event i if its slot still holds it complete
+	static void print(FILE *f, const SCSTraceEvent *e);
+	int flush();
+	static void *thread(void *arg);
+private:
+	SCSTraceEvent Ev[SCS_TRACE_EVENTS];
+	u32 Head;//events claimed
+	u64 TxNs[256];//last TX per tag
+	u32 Tail;//writer thread
+	volatile int FaultPending;
+	FILE *File;
+	char Path[SCS_TRACE_PATH];
+	u32 PeriodUs;
+	volatile int Running;
+	int Started;
+	pthread_t Thread;
+};
+
+#endif
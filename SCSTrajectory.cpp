@@ -0,0 +1,188 @@
+/*
+ * SCSTrajectory.cpp
+ * Waypoint streaming with host-side interpolation, one sync write per bus cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <math.h>
+#include <string.h>
+#include "SCSTrajectory.h"
+
+SCSTrajectory::SCSTrajectory(SMS_STS *bus)
+{
+	this->bus = bus;
+	Mode = SCS_TRAJ_LINEAR;
+	ACC = 0;
+	MinSpeed = 20;
+	Ticks = 0;
+	Underruns = 0;
+	IDN = 0;
+	memset(Q, 0, sizeof(Q));
+}
+
+int SCSTrajectory::addServo(u8 ID)
+{
+	int i = index(ID);
+	if(i>=0){
+		return i;
+	}
+	if(IDN>=SCS_TRAJ_SERVOS){
+		return -1;
+	}
+	memset(Q+IDN, 0, sizeof(Queue));
+	this->ID[IDN] = ID;
+	Position[IDN] = 0;
+	Speed[IDN] = 0;
+	return IDN++;
+}
+
+int SCSTrajectory::index(u8 ID)
+{
+	for(int i=0; i<IDN; i++){
+		if(this->ID[i]==ID){
+			return i;
+		}
+	}
+	return -1;
+}
+
+void SCSTrajectory::clear()
+{
+	for(int i=0; i<IDN; i++){
+		Queue *q = Q+i;
+		__atomic_store_n(&q->Tail, __atomic_load_n(&q->Head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	}
+}
+
+int SCSTrajectory::push(u8 ID, u64 TimeUs, s16 Position)
+{
+	int i = index(ID);
+	if(i<0){
+		return -1;
+	}
+	Queue *q = Q+i;
+	u32 Head = q->Head;
+	u32 Tail = __atomic_load_n(&q->Tail, __ATOMIC_ACQUIRE);
+	if(Head-Tail>=SCS_TRAJ_QUEUE || (q->LastUs && TimeUs<=q->LastUs)){
+		return 0;
+	}
+	SCSWaypoint *w = q->W+(Head&(SCS_TRAJ_QUEUE-1));
+	w->TimeUs = TimeUs;
+	w->Position = Position;
+	q->LastUs = TimeUs;
+	__atomic_store_n(&q->Head, Head+1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+int SCSTrajectory::pending(u8 ID)
+{
+	int i = index(ID);
+	if(i<0){
+		return -1;
+	}
+	return __atomic_load_n(&Q[i].Head, __ATOMIC_ACQUIRE)-__atomic_load_n(&Q[i].Tail, __ATOMIC_ACQUIRE);
+}
+
+//slope at b in steps/s from its neighbours, one-sided at either end
+double SCSTrajectory::tangent(const SCSWaypoint *a, const SCSWaypoint *b, const SCSWaypoint *c)
+{
+	if(!a){
+		a = b;
+	}
+	if(!c){
+		c = b;
+	}
+	if(c->TimeUs==a->TimeUs){
+		return 0;
+	}
+	return (c->Position-a->Position)*1000000.0/(double)(c->TimeUs-a->TimeUs);
+}
+
+//position and velocity of one servo at NowUs, 0 before its first waypoint
+//is due, 2 holding after the last one
+int SCSTrajectory::sample(Queue *q, u64 NowUs, double *Pos, double *Vel)
+{
+	u32 Head = __atomic_load_n(&q->Head, __ATOMIC_ACQUIRE);
+	u32 Tail = q->Tail;
+	while(Tail!=Head && q->W[Tail&(SCS_TRAJ_QUEUE-1)].TimeUs<=NowUs){
+		q->Prev[1] = q->Prev[0];
+		q->Prev[0] = q->W[Tail&(SCS_TRAJ_QUEUE-1)];
+		if(q->Passed<2){
+			q->Passed++;
+		}
+		Tail++;
+	}
+	__atomic_store_n(&q->Tail, Tail, __ATOMIC_RELEASE);
+	if(!q->Passed){
+		return 0;
+	}
+	const SCSWaypoint *s = q->Prev;
+	if(Tail==Head){
+		if(q->Moving){
+			Underruns++;
+			q->Moving = 0;
+		}
+		*Pos = s->Position;
+		*Vel = 0;
+		return 2;
+	}
+	const SCSWaypoint *e = q->W+(Tail&(SCS_TRAJ_QUEUE-1));
+	double dt = (e->TimeUs-s->TimeUs)/1000000.0;
+	double u = (NowUs-s->TimeUs)/1000000.0/dt;
+	if(Mode==SCS_TRAJ_CUBIC){
+		const SCSWaypoint *n = Head-Tail>1 ? q->W+((Tail+1)&(SCS_TRAJ_QUEUE-1)) : NULL;
+		double m0 = tangent(q->Passed>1 ? q->Prev+1 : NULL, s, e)*dt;
+		double m1 = tangent(s, e, n)*dt;
+		double u2 = u*u;
+		double u3 = u2*u;
+		*Pos = (2*u3-3*u2+1)*s->Position+(u3-2*u2+u)*m0+(-2*u3+3*u2)*e->Position+(u3-u2)*m1;
+		*Vel = ((6*u2-6*u)*s->Position+(3*u2-4*u+1)*m0+(-6*u2+6*u)*e->Position+(3*u2-2*u)*m1)/dt;
+	}else{
+		*Pos = s->Position+u*(e->Position-s->Position);
+		*Vel = (e->Position-s->Position)/dt;
+	}
+	q->Moving = 1;
+	return 1;
+}
+
+int SCSTrajectory::tick(u64 NowUs)
+{
+	u8 IDs[SCS_TRAJ_SERVOS];
+	u8 Accs[SCS_TRAJ_SERVOS];
+	s16 Pos[SCS_TRAJ_SERVOS];
+	u16 Spd[SCS_TRAJ_SERVOS];
+	u8 n = 0;
+	Ticks++;
+	for(u8 i=0; i<IDN; i++){
+		double p, v;
+		int Rc = sample(Q+i, NowUs, &p, &v);
+		if(!Rc){
+			continue;
+		}
+		if(Rc==2 && Speed[i]){
+			v = Speed[i];//settle on the final waypoint at the last speed
+		}
+		p = floor(p+0.5);
+		p = p>32767 ? 32767 : (p<-32767 ? -32767 : p);
+		v = fabs(v);
+		v = v>32767 ? 32767 : (v<MinSpeed ? MinSpeed : v);
+		Position[i] = (s16)p;
+		Speed[i] = (u16)v;
+		IDs[n] = ID[i];
+		Accs[n] = ACC;
+		Pos[n] = Position[i];
+		Spd[n] = Speed[i];
+		n++;
+	}
+	if(n){
+		bus->SyncWritePosEx(IDs, n, Pos, Spd, Accs);
+	}
+	return n;
+}
+
+int SCSTrajectory::job(void *trajectory)
+{
+	((SCSTrajectory*)trajectory)->tick(SCSerial::monoUs());
+	return 0;
+}
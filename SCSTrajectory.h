@@ -0,0 +1,67 @@
+/*
+ * SCSTrajectory.h
+ * Waypoint streaming with host-side interpolation, one sync write per bus cycle
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTRAJECTORY_H
+#define _SCSTRAJECTORY_H
+
+#include "SMS_STS.h"
+
+#define SCS_TRAJ_SERVOS 32//servos of one trajectory
+#define SCS_TRAJ_QUEUE 64//lookahead waypoints per servo, power of 2
+
+#define SCS_TRAJ_LINEAR 0
+#define SCS_TRAJ_CUBIC 1//cubic Hermite, tangents from the neighbouring waypoints
+
+struct SCSWaypoint{
+	u64 TimeUs;//monotonic time (SCSerial::monoUs) the position is due
+	s16 Position;
+};
+
+//One producer pushes timestamped waypoints per servo (any thread, the
+//queues are single producer, single consumer), the bus thread calls
+//tick() once per cycle, e.g. as the job of an SCSLoop. tick() samples
+//every servo at the current time and sends all goals in one
+//SyncWritePosEx, the goal speed follows the interpolated velocity.
+//After the last queued waypoint a servo holds its position.
+class SCSTrajectory{
+public:
+	SCSTrajectory(SMS_STS *bus);
+	int addServo(u8 ID);//returns the servo index, -1 if full
+	void clear();//drop every queued waypoint, servos hold
+	int push(u8 ID, u64 TimeUs, s16 Position);//1 queued, 0 queue full or not after the previous waypoint, -1 unknown ID
+	int pending(u8 ID);//waypoints queued, -1 unknown ID
+	int tick(u64 NowUs);//interpolate and send one sync write, returns servos commanded
+	static int job(void *trajectory);//SCSLoopJob running tick(SCSerial::monoUs())
+public:
+	u8 Mode;//SCS_TRAJ_LINEAR (default) or SCS_TRAJ_CUBIC
+	u8 ACC;//acceleration sent with every goal, 0: maximum
+	u16 MinSpeed;//goal speed floor, 0 would mean maximum speed to the servo
+	u32 Ticks;
+	u32 Underruns;//times a moving servo ran out of waypoints, the end of a trajectory counts too
+	u8 IDN;
+	u8 ID[SCS_TRAJ_SERVOS];
+	s16 Position[SCS_TRAJ_SERVOS];//last goal sent
+	u16 Speed[SCS_TRAJ_SERVOS];
+private:
+	struct Queue{
+		u32 Head;
+		u32 Tail;
+		SCSWaypoint W[SCS_TRAJ_QUEUE];
+		u64 LastUs;//time of the last waypoint pushed, producer side
+		SCSWaypoint Prev[2];//last two waypoints passed, Prev[0] starts the current segment
+		u8 Passed;//valid entries of Prev
+		u8 Moving;
+	};
+	int index(u8 ID);
+	int sample(Queue *q, u64 NowUs, double *Pos, double *Vel);
+	double tangent(const SCSWaypoint *a, const SCSWaypoint *b, const SCSWaypoint *c);
+private:
+	SMS_STS *bus;
+	Queue Q[SCS_TRAJ_SERVOS];
+};
+
+#endif
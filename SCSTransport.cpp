@@ -0,0 +1,359 @@
+/*
+ * SCSTransport.cpp
+ * Byte transports SCSerial can run over instead of its built-in serial port
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "SCSTransport.h"
+#include "SCSerial.h"
+
+int SCSTransport::writev(const struct iovec *iov, int iovcnt)
+{
+	u8 Buf[1024];
+	int nLen = 0;
+	for(int i=0; i<iovcnt; i++){
+		if(nLen+iov[i].iov_len>sizeof(Buf)){
+			nLen = -1;
+			break;
+		}
+		memcpy(Buf+nLen, iov[i].iov_base, iov[i].iov_len);
+		nLen += iov[i].iov_len;
+	}
+	if(nLen>=0){
+		return write(Buf, nLen);
+	}
+	nLen = 0;
+	for(int i=0; i<iovcnt; i++){
+		if(write((const u8*)iov[i].iov_base, iov[i].iov_len)<0){
+			return -1;
+		}
+		nLen += iov[i].iov_len;
+	}
+	return nLen;
+}
+
+SCSFdTransport::SCSFdTransport()
+{
+	fd = -1;
+	rxPos = 0;
+	rxLen = 0;
+	Datagram = 0;
+}
+
+SCSFdTransport::~SCSFdTransport()
+{
+	close();
+}
+
+void SCSFdTransport::attach(int fd)
+{
+	close();
+	this->fd = fd;
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+void SCSFdTransport::close()
+{
+	if(fd != -1){
+		::close(fd);
+		fd = -1;
+	}
+	rxPos = rxLen = 0;
+	Fault = 0;
+}
+
+int SCSFdTransport::writevAll(int fd, struct iovec *iov, int iovcnt)
+{
+	int Sent = 0;
+	while(iovcnt){
+		int n = ::writev(fd, iov, iovcnt);
+		if(n<0){
+			if(errno==EINTR){
+				continue;
+			}
+			struct pollfd pfd = {fd, POLLOUT, 0};
+			if(errno==EAGAIN && poll(&pfd, 1, 100)>0){
+				continue;
+			}
+			return -1;
+		}
+		Sent += n;
+		while(iovcnt && (size_t)n>=iov->iov_len){
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if(iovcnt){
+			iov->iov_base = (u8*)iov->iov_base+n;
+			iov->iov_len -= n;
+		}
+	}
+	return Sent;
+}
+
+int SCSFdTransport::write(const u8 *nDat, int nLen)
+{
+	struct iovec iov;
+	iov.iov_base = (void*)nDat;
+	iov.iov_len = nLen;
+	return writevAll(fd, &iov, 1);
+}
+
+int SCSFdTransport::writev(const struct iovec *iov, int iovcnt)
+{
+	struct iovec v[IOV_MAX];
+	if(iovcnt>IOV_MAX){
+		return SCSTransport::writev(iov, iovcnt);
+	}
+	memcpy(v, iov, iovcnt*sizeof(struct iovec));
+	return writevAll(fd, v, iovcnt);
+}
+
+//A non-blocking stream read returns 0 only at the end of the stream: a
+//TCP peer that closed or a pty hangup. Datagram errors (ICMP port
+//unreachable ...) only lose that reply, the gateway may come back.
+int SCSFdTransport::lost(int n)
+{
+	if(n>0 || Datagram || (n<0 && (errno==EAGAIN || errno==EINTR))){
+		return 0;
+	}
+	Fault = n ? errno : EPIPE;
+	return 1;
+}
+
+int SCSFdTransport::fill(long timeOutUs)
+{
+	if(fd == -1 || Fault){
+		return -1;
+	}
+	if(rxPos==rxLen){
+		rxPos = rxLen = 0;
+	}else if(rxPos && rxLen==SCS_TRANSPORT_RX){
+		memmove(rxBuf, rxBuf+rxPos, rxLen-rxPos);
+		rxLen -= rxPos;
+		rxPos = 0;
+	}
+	if(rxLen==SCS_TRANSPORT_RX){
+		return 0;
+	}
+	int n = ::read(fd, rxBuf+rxLen, SCS_TRANSPORT_RX-rxLen);
+	if(lost(n)){
+		return -1;
+	}
+	if(n<=0 && timeOutUs>0){
+		struct pollfd pfd = {fd, POLLIN, 0};
+		struct timespec ts;
+		ts.tv_sec = timeOutUs/1000000;
+		ts.tv_nsec = (timeOutUs%1000000)*1000;
+		if(ppoll(&pfd, 1, &ts, NULL)<=0){
+			return 0;
+		}
+		n = ::read(fd, rxBuf+rxLen, SCS_TRANSPORT_RX-rxLen);
+		if(lost(n)){
+			return -1;
+		}
+	}
+	if(n<=0){
+		return 0;
+	}
+	if(!RxFirstUs){
+		RxFirstUs = SCSerial::monoUs();
+	}
+	rxLen += n;
+	return n;
+}
+
+int SCSFdTransport::read(u8 *nDat, int nLen, long timeOutUs)
+{
+	u64 deadline = SCSerial::monoUs()+timeOutUs;
+	int rvLen = 0;
+	RxFirstUs = 0;
+	if(rxPos!=rxLen){
+		RxFirstUs = SCSerial::monoUs();
+	}
+	while(1){
+		int n = rxLen-rxPos;
+		if(n>nLen-rvLen){
+			n = nLen-rvLen;
+		}
+		memcpy(nDat+rvLen, rxBuf+rxPos, n);
+		rxPos += n;
+		rvLen += n;
+		if(rvLen>=nLen){
+			break;
+		}
+		//a zero timeout still takes what the descriptor has ready
+		long Left = (long)(deadline-SCSerial::monoUs());
+		if(Left<0){
+			Left = 0;
+		}
+		int Got = fill(Left);
+		if(Got<0 || (!Got && !Left)){
+			break;
+		}
+	}
+	return rvLen;
+}
+
+void SCSFdTransport::flush()
+{
+	rxPos = rxLen = 0;
+	while(fill(0)>0){
+		rxPos = rxLen = 0;
+	}
+}
+
+bool SCSSerialTransport::open(const char *serialPort, int baudRate)
+{
+	close();
+	int fd = ::open(serialPort, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(fd == -1){
+		perror("open:");
+		return false;
+	}
+	tcgetattr(fd, &opt);
+	cfmakeraw(&opt);
+	opt.c_cflag &= ~(PARENB | CSTOPB | CSIZE);
+	opt.c_cflag |= CS8 | CREAD | CLOCAL;
+	attach(fd);
+	if(SCSerial::applySpeed(fd, &opt, baudRate) != 1){
+		perror("tcsetattr:");
+		close();
+		return false;
+	}
+	return true;
+}
+
+int SCSSerialTransport::setBaudRate(int baudRate)
+{
+	if(fd == -1){
+		return -1;
+	}
+	return SCSerial::applySpeed(fd, &opt, baudRate);
+}
+
+void SCSSerialTransport::flush()
+{
+	if(fd != -1){
+		tcflush(fd, TCIFLUSH);
+	}
+	SCSFdTransport::flush();
+}
+
+static int netSocket(const char *host, int port, int type, struct addrinfo **res)
+{
+	char Port[16];
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = type;
+	snprintf(Port, sizeof(Port), "%d", port);
+	if(getaddrinfo(host, Port, &hints, res) != 0){
+		return -1;
+	}
+	int fd = socket((*res)->ai_family, type | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if(fd == -1){
+		freeaddrinfo(*res);
+	}
+	return fd;
+}
+
+SCSTcpTransport::SCSTcpTransport()
+{
+	Host[0] = 0;
+	Port = 0;
+	TimeOutMs = 0;
+}
+
+bool SCSTcpTransport::open(const char *host, int port, int timeOutMs)
+{
+	close();
+	if(host!=Host){
+		if(strlen(host)>=sizeof(Host)){
+			return false;
+		}
+		strcpy(Host, host);
+	}
+	Port = port;
+	TimeOutMs = timeOutMs;
+	struct addrinfo *res;
+	int fd = netSocket(host, port, SOCK_STREAM, &res);
+	if(fd == -1){
+		return false;
+	}
+	int rc = connect(fd, res->ai_addr, res->ai_addrlen);
+	freeaddrinfo(res);
+	if(rc != 0 && errno == EINPROGRESS){
+		struct pollfd pfd = {fd, POLLOUT, 0};
+		int Err = 0;
+		socklen_t Len = sizeof(Err);
+		if(poll(&pfd, 1, timeOutMs)>0 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &Err, &Len)==0 && !Err){
+			rc = 0;
+		}
+	}
+	if(rc != 0){
+		::close(fd);
+		return false;
+	}
+	int On = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &On, sizeof(On));
+	this->fd = fd;
+	return true;
+}
+
+int SCSTcpTransport::reopen()
+{
+	if(!Host[0]){
+		return 0;
+	}
+	return open(Host, Port, TimeOutMs) ? 1 : 0;
+}
+
+SCSUdpTransport::SCSUdpTransport()
+{
+	Datagram = 1;
+}
+
+bool SCSUdpTransport::open(const char *host, int port, int localPort)
+{
+	close();
+	struct addrinfo *res;
+	int fd = netSocket(host, port, SOCK_DGRAM, &res);
+	if(fd == -1){
+		return false;
+	}
+	int rc = 0;
+	if(localPort){
+		struct sockaddr_storage local;
+		memset(&local, 0, sizeof(local));
+		local.ss_family = res->ai_family;
+		if(res->ai_family == AF_INET6){
+			((struct sockaddr_in6*)&local)->sin6_port = htons(localPort);
+		}else{
+			((struct sockaddr_in*)&local)->sin_port = htons(localPort);
+		}
+		rc = bind(fd, (struct sockaddr*)&local, res->ai_addrlen);
+	}
+	if(rc == 0){
+		rc = connect(fd, res->ai_addr, res->ai_addrlen);
+	}
+	freeaddrinfo(res);
+	if(rc != 0){
+		::close(fd);
+		return false;
+	}
+	this->fd = fd;
+	return true;
+}
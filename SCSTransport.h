@@ -0,0 +1,89 @@
+/*
+ * SCSTransport.h
+ * Byte transports SCSerial can run over instead of its built-in serial port
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTRANSPORT_H
+#define _SCSTRANSPORT_H
+
+#include <termios.h>
+#include <sys/uio.h>
+#include "INST.h"
+
+#define SCS_TRANSPORT_RX 4096//receive buffer, holds at least one datagram
+#define SCS_TRANSPORT_HOST 256//host name kept by SCSTcpTransport for reopen()
+
+//A transport moves whole request frames out and reply bytes in.
+//SCSerial still frames packets, computes the reply timeout and keeps
+//statistics, the transport only carries bytes.
+class SCSTransport{
+public:
+	SCSTransport():RxFirstUs(0), Fault(0){}
+	virtual ~SCSTransport(){}
+	virtual int write(const u8 *nDat, int nLen) = 0;//send buffered frames, returns nLen or -1
+	virtual int writev(const struct iovec *iov, int iovcnt);//gather send, default joins the segments and calls write()
+	virtual int read(u8 *nDat, int nLen, long timeOutUs) = 0;//returns bytes received within timeOutUs
+	virtual void flush() = 0;//discard received bytes
+	virtual int setBaudRate(int baudRate){  return 1;  }//line rate where the transport owns the line
+	virtual void close(){}
+	virtual int reopen(){  return 0;  }//open the link again after a Fault, 1 on success
+public:
+	u64 RxFirstUs;//arrival of the first byte of the last read, 0 if none
+	int Fault;//errno once the link is gone (EPIPE: the peer closed the stream), reads fail at once until it is opened again
+};
+
+//Any pollable file descriptor: stream or datagram
+class SCSFdTransport : public SCSTransport{
+public:
+	SCSFdTransport();
+	virtual ~SCSFdTransport();
+	virtual int write(const u8 *nDat, int nLen);
+	virtual int writev(const struct iovec *iov, int iovcnt);
+	virtual int read(u8 *nDat, int nLen, long timeOutUs);
+	virtual void flush();
+	virtual void close();
+	int getFd(){  return fd;  }
+	static int writevAll(int fd, struct iovec *iov, int iovcnt);//writev() until every segment is sent, iov is consumed
+	void attach(int fd);//takes ownership of an open descriptor (e.g. a pty master)
+protected:
+	int fill(long timeOutUs);//wait at most timeOutUs and append ready bytes to rxBuf, -1 on a lost link
+	int lost(int n);//n from ::read(), sets Fault and returns 1 on end of stream or a read error
+protected:
+	int fd;
+	u8 Datagram;//a zero-length read is an empty datagram, not the end of the stream
+	u8 rxBuf[SCS_TRANSPORT_RX];
+	int rxPos;
+	int rxLen;
+};
+
+class SCSSerialTransport : public SCSFdTransport{
+public:
+	bool open(const char *serialPort, int baudRate);//raw 8N1
+	virtual int setBaudRate(int baudRate);
+	virtual void flush();
+private:
+	struct termios opt;
+};
+
+//Ethernet-to-RS485 gateway in TCP server mode
+class SCSTcpTransport : public SCSFdTransport{
+public:
+	SCSTcpTransport();
+	bool open(const char *host, int port, int timeOutMs = 1000);//connect with TCP_NODELAY
+	virtual int reopen();//connect again to the host of the last open()
+private:
+	char Host[SCS_TRANSPORT_HOST];
+	int Port;
+	int TimeOutMs;
+};
+
+//Ethernet-to-RS485 gateway in UDP mode, one datagram per flushed request
+class SCSUdpTransport : public SCSFdTransport{
+public:
+	SCSUdpTransport();
+	bool open(const char *host, int port, int localPort = 0);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * SCSTripleBuffer.h
+ * Wait-free publisher, retrying readers: latest-value snapshot between threads
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTRIPLEBUFFER_H
+#define _SCSTRIPLEBUFFER_H
+
+#include "INST.h"
+
+//One writer rotates through three buffers and never waits. Any number
+//of readers copy the latest complete buffer; a reader that is overtaken
+//by two publishes while copying (buffer sequence changed) copies again.
+template<class T>
+class SCSTripleBuffer{
+public:
+	SCSTripleBuffer():Latest(0),Writing(0),Version(0)
+	{
+		for(int i=0; i<3; i++){
+			Seq[i] = 0;
+		}
+	}
+	T *writeBegin()//writer only
+	{
+		Writing = (Latest+1)%3;
+		__atomic_store_n(&Seq[Writing], Seq[Writing]+1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		return Buf+Writing;
+	}
+	void writeEnd()//publish the buffer returned by writeBegin()
+	{
+		__atomic_store_n(&Seq[Writing], Seq[Writing]+1, __ATOMIC_RELEASE);
+		__atomic_store_n(&Latest, Writing, __ATOMIC_RELEASE);
+		__atomic_store_n(&Version, Version+1, __ATOMIC_RELEASE);
+	}
+	u32 read(T *out) const//copy the latest value, returns its version (0: nothing published yet)
+	{
+		while(1){
+			u32 v = __atomic_load_n(&Version, __ATOMIC_ACQUIRE);
+			u32 i = __atomic_load_n(&Latest, __ATOMIC_ACQUIRE);
+			u32 s = __atomic_load_n(&Seq[i], __ATOMIC_ACQUIRE);
+			if(s&1){
+				continue;
+			}
+			*out = Buf[i];
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if(__atomic_load_n(&Seq[i], __ATOMIC_RELAXED)==s){
+				return v;
+			}
+		}
+	}
+	u32 version() const{  return __atomic_load_n(&Version, __ATOMIC_ACQUIRE);  }
+	const T *published() const{  return Version ? Buf+Latest : 0;  }//writer only: the buffer published last, NULL before the first publish
+private:
+	T Buf[3];
+	u32 Seq[3];//odd while the buffer is being written
+	u32 Latest;
+	u32 Writing;
+	u32 Version;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * SCSTune.cpp
+ * Kernel-side latency tuning of a servo port and a ping-pong check of the result
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sched.h>
+#include <algorithm>
+#include "SCSTune.h"
+
+SCSTune::SCSTune(SCSerial *bus)
+{
+	this->bus = bus;
+	LatencyTimer = 1;
+	LowLatency = 1;
+	IrqPriority = 0;
+	Verbose = 1;
+	memset(&Report, 0, sizeof(Report));
+	Report.LatencyTimerWas = Report.LatencyTimer = -1;
+	Report.LowLatency = -1;
+	Report.Irq = Report.IrqThread = -1;
+}
+
+static int readInt(const char *path, int *v)
+{
+	FILE *fp = fopen(path, "r");
+	if(!fp){
+		return 0;
+	}
+	int n = fscanf(fp, "%d", v);
+	fclose(fp);
+	return n==1;
+}
+
+int SCSTune::findIrq(const char *tty)
+{
+	char path[PATH_MAX];
+	char dev[PATH_MAX];
+	int Irq;
+	//native UARTs export it on the tty, ttyS0 ...
+	if(snprintf(path, sizeof(path), "/sys/class/tty/%s/irq", tty)>=(int)sizeof(path)){
+		return -1;
+	}
+	if(readInt(path, &Irq) && Irq>0){
+		return Irq;
+	}
+	//USB adapters and platform UARTs: the nearest parent device with an irq
+	if(snprintf(path, sizeof(path), "/sys/class/tty/%s/device", tty)>=(int)sizeof(path) || !realpath(path, dev)){
+		return -1;
+	}
+	char *p;
+	while((p = strrchr(dev, '/')) && p!=dev){
+		//a truncated path would name another file, go up a level instead
+		if(snprintf(path, sizeof(path), "%s/irq", dev)<(int)sizeof(path) && readInt(path, &Irq) && Irq>0){
+			return Irq;
+		}
+		*p = 0;
+	}
+	return -1;
+}
+
+int SCSTune::findIrqThread(int Irq)
+{
+	char path[64];
+	char comm[64];
+	char name[32];
+	if(Irq<=0){
+		return -1;
+	}
+	int nLen = snprintf(name, sizeof(name), "irq/%d-", Irq);
+	DIR *d = opendir("/proc");
+	if(!d){
+		return -1;
+	}
+	int pid = -1;
+	struct dirent *e;
+	while(pid==-1 && (e = readdir(d))){
+		if(e->d_name[0]<'1' || e->d_name[0]>'9'){
+			continue;
+		}
+		if(snprintf(path, sizeof(path), "/proc/%s/comm", e->d_name)>=(int)sizeof(path)){
+			continue;
+		}
+		FILE *fp = fopen(path, "r");
+		if(!fp){
+			continue;
+		}
+		if(fgets(comm, sizeof(comm), fp) && !strncmp(comm, name, nLen)){
+			pid = atoi(e->d_name);
+		}
+		fclose(fp);
+	}
+	closedir(d);
+	return pid;
+}
+
+int SCSTune::apply()
+{
+	int fd = bus->getFd();
+	if(fd==-1){
+		return -1;
+	}
+	int Changed = 0;
+	Report.LatencyTimerWas = bus->getLatencyTimer();
+	if(Report.LatencyTimerWas>=0 && Report.LatencyTimerWas!=LatencyTimer && bus->setLatencyTimer(LatencyTimer)==1){
+		Changed++;
+	}
+	Report.LatencyTimer = bus->getLatencyTimer();
+	int Low = bus->getLowLatency();
+	if(Low==0 && LowLatency && bus->setLowLatency(1)==1){
+		Changed++;
+	}
+	Report.LowLatency = bus->getLowLatency();
+	//epoll wakes on the first byte with VMIN=1, VTIME=0; VMIN=0 would
+	//make the non-blocking reads return 0, which reads as a hangup
+	struct termios opt;
+	if(tcgetattr(fd, &opt)==0 && (opt.c_cc[VMIN]!=1 || opt.c_cc[VTIME]) && bus->setReadMode(1, 0)==1){
+		Changed++;
+	}
+	if(tcgetattr(fd, &opt)==0){
+		Report.VMin = opt.c_cc[VMIN];
+		Report.VTime = opt.c_cc[VTIME];
+	}
+	char path[64];
+	char dev[PATH_MAX];
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+	int n = readlink(path, dev, sizeof(dev)-1);
+	if(n>0){
+		dev[n] = 0;
+		const char *tty = strrchr(dev, '/');
+		Report.Irq = findIrq(tty ? tty+1 : dev);
+	}
+	Report.IrqThread = findIrqThread(Report.Irq);
+	if(Report.IrqThread!=-1){
+		struct sched_param sp;
+		if(IrqPriority>0 && sched_getparam(Report.IrqThread, &sp)==0 && sp.sched_priority!=IrqPriority){
+			sp.sched_priority = IrqPriority;
+			if(sched_setscheduler(Report.IrqThread, SCHED_FIFO, &sp)==0){
+				Changed++;
+			}
+		}
+		int Policy = sched_getscheduler(Report.IrqThread);
+		if((Policy==SCHED_FIFO || Policy==SCHED_RR) && sched_getparam(Report.IrqThread, &sp)==0){
+			Report.IrqPriority = sp.sched_priority;
+		}else{
+			Report.IrqPriority = 0;
+		}
+	}
+	return Changed;
+}
+
+int SCSTune::measure(u8 ID, int Samples)
+{
+	if(Samples>SCS_TUNE_SAMPLES){
+		Samples = SCS_TUNE_SAMPLES;
+	}
+	u32 n = 0;
+	Report.Lost = 0;
+	for(int i=0; i<Samples; i++){
+		u64 t0 = SCSerial::monoUs();
+		if(bus->Ping(ID)==ID){
+			Us[n++] = (u32)(SCSerial::monoUs()-t0);
+		}else{
+			Report.Lost++;
+		}
+	}
+	Report.Samples = n;
+	if(!n){
+		Report.MinUs = Report.P50Us = Report.P99Us = Report.MaxUs = 0;
+		return 0;
+	}
+	std::sort(Us, Us+n);
+	Report.MinUs = Us[0];
+	Report.P50Us = Us[(n-1)/2];
+	Report.P99Us = Us[(n-1)*99/100];
+	Report.MaxUs = Us[n-1];
+	return n;
+}
+
+int SCSTune::check(u32 CycleUs, int Transactions)
+{
+	Report.CycleUs = CycleUs;
+	Report.NeedUs = Report.P99Us*Transactions;
+	Report.Meets = Report.Samples && Report.NeedUs<=CycleUs;
+	if(Report.Meets){
+		return 1;
+	}
+	if(!Report.Samples){
+		fprintf(stderr, "SCSTune: no ping replies, cycle of %luus not verified\n", CycleUs);
+		return 0;
+	}
+	fprintf(stderr, "SCSTune: %d round trip(s) need %luus at p99, the cycle is %luus\n", Transactions, Report.NeedUs, CycleUs);
+	if(Report.LatencyTimer>1){
+		fprintf(stderr, "SCSTune: USB latency timer is %dms (needs write access to sysfs to lower it)\n", Report.LatencyTimer);
+	}
+	if(Report.LowLatency==0){
+		fprintf(stderr, "SCSTune: ASYNC_LOW_LATENCY is off\n");
+	}
+	if(Report.IrqThread!=-1 && !Report.IrqPriority){
+		fprintf(stderr, "SCSTune: IRQ thread %d is not real-time\n", Report.IrqThread);
+	}
+	return 0;
+}
+
+int SCSTune::tune(u8 ID, u32 CycleUs, int Transactions)
+{
+	apply();
+	measure(ID);
+	int rv = check(CycleUs, Transactions);
+	if(Verbose){
+		print(stdout);
+	}
+	return rv;
+}
+
+void SCSTune::print(FILE *fp)
+{
+	fprintf(fp, "latency timer:%d->%dms low latency:%d vmin:%d vtime:%d\n",
+		Report.LatencyTimerWas, Report.LatencyTimer, Report.LowLatency, Report.VMin, Report.VTime);
+	fprintf(fp, "irq:%d thread:%d priority:%d\n", Report.Irq, Report.IrqThread, Report.IrqPriority);
+	fprintf(fp, "ping %lu/%lu min:%luus p50:%luus p99:%luus max:%luus",
+		Report.Samples, Report.Samples+Report.Lost, Report.MinUs, Report.P50Us, Report.P99Us, Report.MaxUs);
+	if(Report.CycleUs){
+		fprintf(fp, " cycle:%luus %s", Report.CycleUs, Report.Meets ? "ok" : "too short");
+	}
+	fprintf(fp, "\n");
+}
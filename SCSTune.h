@@ -0,0 +1,65 @@
+/*
+ * SCSTune.h
+ * Kernel-side latency tuning of a servo port and a ping-pong check of the result
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSTUNE_H
+#define _SCSTUNE_H
+
+#include <stdio.h>
+#include "SCSerial.h"
+
+#define SCS_TUNE_SAMPLES 1000//ping-pong samples kept for the percentiles
+
+struct SCSTuneReport{
+	int LatencyTimerWas;//USB-serial latency timer before tuning in ms, -1 not a USB-serial port
+	int LatencyTimer;//after tuning
+	int LowLatency;//ASYNC_LOW_LATENCY after tuning, -1 not supported by the driver
+	int VMin;//termios VMIN/VTIME after tuning
+	int VTime;
+	int Irq;//interrupt line of the port (the USB host controller for adapters), -1 not found
+	int IrqThread;//pid of its threaded handler (threadirqs or PREEMPT_RT), -1 none
+	int IrqPriority;//SCHED_FIFO priority of that thread after tuning, 0 not real-time
+	u32 Samples;//ping-pong replies
+	u32 Lost;
+	u32 MinUs;
+	u32 P50Us;
+	u32 P99Us;
+	u32 MaxUs;
+	u32 CycleUs;//cycle time checked against, 0 none
+	u32 NeedUs;//P99Us times the transactions of one cycle
+	int Meets;//1 the cycle fits, 0 it does not
+};
+
+//Optional tuning step right after begin(): apply() sets the latency
+//timer of a USB-serial adapter, ASYNC_LOW_LATENCY, first-byte wakeup
+//VMIN/VTIME and the real-time priority of the port's IRQ thread, and
+//records what it ended up with (settings the driver or the permissions
+//refuse stay as they were). measure() times Ping round trips, check()
+//compares the p99 turnaround with a cycle time and warns on stderr
+//when the port can't meet it. tune() runs all three. Writing sysfs and
+//changing another thread's priority need root or CAP_SYS_NICE.
+class SCSTune{
+public:
+	SCSTune(SCSerial *bus);
+	int apply();//returns the settings changed, -1 port not open
+	int measure(u8 ID, int Samples = 200);//returns replies, fills the latency fields of Report
+	int check(u32 CycleUs, int Transactions = 1);//1 if Transactions round trips fit in CycleUs
+	int tune(u8 ID, u32 CycleUs, int Transactions = 1);//apply, measure and check, returns check()
+	void print(FILE *fp);
+	static int findIrq(const char *tty);//interrupt line of /dev/<tty>, -1 if unknown
+	static int findIrqThread(int Irq);//pid of "irq/<Irq>-..." , -1 if none
+public:
+	int LatencyTimer;//ms to set, default 1
+	u8 LowLatency;//default 1
+	int IrqPriority;//SCHED_FIFO priority for the IRQ thread, 0 leaves it alone (default)
+	u8 Verbose;//tune() prints the report to stdout, default 1
+	SCSTuneReport Report;
+private:
+	SCSerial *bus;
+	u32 Us[SCS_TUNE_SAMPLES];
+};
+
+#endif
@@ -0,0 +1,544 @@
+/*
+ * SCSUring.cpp
+ * io_uring back-end: serial ports of several buses sharing one submission ring
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "SCSUring.h"
+#include "SCSStatus.h"
+#include "SCSPrepared.h"
+#include "SCSerial.h"
+
+//same numbers on every architecture since 5.1
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+//user_data: the port with the kind in the low bits, 0 for timeouts
+#define SCS_URING_WRITE 1
+#define SCS_URING_READ 2
+
+SCSUring::SCSUring()
+{
+	fd = -1;
+	sqRing = cqRing = NULL;
+	sqes = NULL;
+	sqRingSize = cqRingSize = sqesSize = 0;
+	sqLocal = sqSubmitted = 0;
+	Inflight = 0;
+	PortN = 0;
+	Enters = 0;
+	Cycles = 0;
+	MarginUs = 3000;
+	ReturnDelayUs = 0;
+}
+
+SCSUring::~SCSUring()
+{
+	close();
+}
+
+int SCSUring::supported()
+{
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	int rfd = syscall(__NR_io_uring_setup, 1, &p);
+	if(rfd<0){
+		return 0;
+	}
+	::close(rfd);
+	return 1;
+}
+
+int SCSUring::init(unsigned Entries)
+{
+	close();
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	fd = syscall(__NR_io_uring_setup, Entries, &p);
+	if(fd<0){
+		fd = -1;
+		return 0;
+	}
+	sqRingSize = p.sq_off.array+p.sq_entries*sizeof(unsigned);
+	cqRingSize = p.cq_off.cqes+p.cq_entries*sizeof(struct io_uring_cqe);
+	int Single = p.features & IORING_FEAT_SINGLE_MMAP;
+	if(Single){
+		if(cqRingSize>sqRingSize){
+			sqRingSize = cqRingSize;
+		}
+		cqRingSize = sqRingSize;
+	}
+	sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if(sqRing==MAP_FAILED){
+		sqRing = NULL;
+		close();
+		return 0;
+	}
+	if(Single){
+		cqRing = sqRing;
+	}else{
+		cqRing = mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if(cqRing==MAP_FAILED){
+			cqRing = NULL;
+			close();
+			return 0;
+		}
+	}
+	sqesSize = p.sq_entries*sizeof(struct io_uring_sqe);
+	sqes = (struct io_uring_sqe*)mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if(sqes==MAP_FAILED){
+		sqes = NULL;
+		close();
+		return 0;
+	}
+	u8 *sq = (u8*)sqRing;
+	u8 *cq = (u8*)cqRing;
+	sqHead = (unsigned*)(sq+p.sq_off.head);
+	sqTail = (unsigned*)(sq+p.sq_off.tail);
+	sqMask = (unsigned*)(sq+p.sq_off.ring_mask);
+	sqArray = (unsigned*)(sq+p.sq_off.array);
+	sqEntries = p.sq_entries;
+	cqHead = (unsigned*)(cq+p.cq_off.head);
+	cqTail = (unsigned*)(cq+p.cq_off.tail);
+	cqMask = (unsigned*)(cq+p.cq_off.ring_mask);
+	cqEntries = p.cq_entries;
+	cqes = (struct io_uring_cqe*)(cq+p.cq_off.cqes);
+	sqLocal = sqSubmitted = *sqTail;
+	Inflight = 0;
+	return 1;
+}
+
+void SCSUring::close()
+{
+	if(sqes){
+		munmap(sqes, sqesSize);
+		sqes = NULL;
+	}
+	if(cqRing && cqRing!=sqRing){
+		munmap(cqRing, cqRingSize);
+	}
+	cqRing = NULL;
+	if(sqRing){
+		munmap(sqRing, sqRingSize);
+		sqRing = NULL;
+	}
+	if(fd!=-1){
+		::close(fd);
+		fd = -1;
+	}
+}
+
+int SCSUring::attach(SCSUringTransport *port)
+{
+	if(PortN==SCS_URING_PORTS){
+		return 0;
+	}
+	Port[PortN++] = port;
+	return 1;
+}
+
+void SCSUring::detach(SCSUringTransport *port)
+{
+	for(int i=0; i<PortN; i++){
+		if(Port[i]==port){
+			Port[i] = Port[--PortN];
+			return;
+		}
+	}
+}
+
+//room for a chain of n entries, a chain must not be split by a submit
+void SCSUring::reserve(unsigned n)
+{
+	if(sqLocal-__atomic_load_n(sqHead, __ATOMIC_ACQUIRE)+n>sqEntries || Inflight+n>cqEntries){
+		drain();
+	}
+}
+
+struct io_uring_sqe *SCSUring::sqe(u8 Op, void *Ptr, int Kind)
+{
+	unsigned Idx = sqLocal & *sqMask;
+	struct io_uring_sqe *e = sqes+Idx;
+	memset(e, 0, sizeof(*e));
+	e->opcode = Op;
+	e->user_data = Ptr ? (u64)(uintptr_t)Ptr | Kind : 0;
+	sqArray[Idx] = Idx;
+	sqLocal++;
+	Inflight++;
+	return e;
+}
+
+int SCSUring::enter(unsigned MinComplete)
+{
+	if(fd==-1){
+		return -1;
+	}
+	__atomic_store_n(sqTail, sqLocal, __ATOMIC_RELEASE);
+	unsigned Submit = sqLocal-sqSubmitted;
+	while(1){
+		int rc = syscall(__NR_io_uring_enter, fd, Submit, MinComplete, MinComplete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		Enters++;
+		if(rc>=0){
+			sqSubmitted += rc;
+			break;
+		}
+		if(errno==EBUSY || errno==EAGAIN){
+			reap();//completion queue full, make room and retry
+		}else if(errno!=EINTR){
+			return -1;
+		}
+	}
+	reap();
+	return 1;
+}
+
+//every entry posts exactly one completion, so waiting for Inflight of
+//them returns once the whole batch is done, normally in one call
+int SCSUring::drain()
+{
+	while(Inflight){
+		if(enter(Inflight)<0){
+			return -1;
+		}
+	}
+	return 1;
+}
+
+void SCSUring::reap()
+{
+	unsigned Head = *cqHead;
+	unsigned Tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+	while(Head!=Tail){
+		struct io_uring_cqe *c = cqes+(Head & *cqMask);
+		u64 Data = c->user_data;
+		int Res = c->res;
+		Head++;
+		Inflight--;
+		if(Data){
+			SCSUringTransport *p = (SCSUringTransport*)(uintptr_t)(Data & ~(u64)3);
+			p->complete(Data & 3, Res);
+		}
+	}
+	__atomic_store_n(cqHead, Head, __ATOMIC_RELEASE);
+}
+
+int SCSUring::syncReadAll(SCSUringSyncRead rd[], int n)
+{
+	if(fd==-1){
+		return 0;
+	}
+	Cycles++;
+	for(int i=0; i<n; i++){
+		SCSUringTransport *p = rd[i].Port;
+		rd[i].Valid = 0;
+		int Want = 0;
+		p->rxPos = p->rxLen = 0;//stray bytes of an earlier cycle
+		if(rd[i].Write){
+			p->queue(rd[i].Write->frame(), rd[i].Write->length());
+		}
+		if(rd[i].Read){
+			SCSSyncReadPacket *r = rd[i].Read;
+			const u8 *ID = r->frame()+7;
+			for(u8 k=0; k<r->IDN; k++){
+				if(ID[k]<rd[i].tabLen){
+					rd[i].rxTab[ID[k]].Valid = 0;
+				}
+			}
+			p->queue(r->frame(), r->length());
+			Want = r->IDN*(r->nLen+6);
+			if(Want>SCS_TRANSPORT_RX){
+				Want = SCS_TRANSPORT_RX;
+			}
+		}
+		u32 SettleUs = p->wireUs(p->txLen+Want)+(rd[i].Read ? rd[i].Read->IDN*ReturnDelayUs : 0);
+		p->Want = Want;
+		p->RxFirstUs = 0;
+		p->DeadlineUs = SCSerial::monoUs()+SettleUs+MarginUs;
+		p->armRead(Want, MarginUs, SettleUs ? SettleUs : 1);
+	}
+	drain();
+	//replies that came in pieces: one more read round for all buses at once
+	while(1){
+		int More = 0;
+		u64 NowUs = SCSerial::monoUs();
+		for(int i=0; i<n; i++){
+			SCSUringTransport *p = rd[i].Port;
+			if(p->Want>0 && p->ReadRes>0 && NowUs<p->DeadlineUs){
+				p->armRead(p->Want, (long)(p->DeadlineUs-NowUs));
+				More++;
+			}
+		}
+		if(!More){
+			break;
+		}
+		drain();
+	}
+	int Valid = 0;
+	for(int i=0; i<n; i++){
+		SCSUringTransport *p = rd[i].Port;
+		p->txLen = p->txDone = 0;
+		p->WriteBusy = 0;
+		if(!rd[i].Read){
+			continue;
+		}
+		int Len = p->rxLen;
+		memcpy(rd[i].rxBuff, p->rxBuf, Len);
+		p->rxPos = p->rxLen = 0;
+		u8 nLen = rd[i].Read->nLen;
+		int Pos = 0;
+		int pktLen;
+		u8 Result;
+		while((pktLen = SCSStatus::find(rd[i].rxBuff, Len, &Pos, &Result))>0){
+			u8 *q = rd[i].rxBuff+Pos;
+			if(SCSStatus::match(q, 0xfe, nLen)==SCS_STAT_OK && q[2]<rd[i].tabLen){
+				SyncReadRx *r = rd[i].rxTab+q[2];
+				if(!r->Valid){
+					rd[i].Valid++;
+				}
+				r->Valid = 1;
+				r->Error = q[4];
+				r->Dat = q+5;
+				r->Stamp = p->RxFirstUs ? p->RxFirstUs+p->wireUs(Pos) : 0;
+			}
+			Pos += pktLen;
+		}
+		Valid += rd[i].Valid;
+	}
+	return Valid;
+}
+
+SCSUringTransport::SCSUringTransport(SCSUring *ring)
+{
+	Ring = ring;
+	BaudRate = 1000000;
+	txLen = txDone = 0;
+	WriteBusy = ReadBusy = 0;
+	ReadRes = 0;
+	Want = 0;
+	DeadlineUs = 0;
+	Attached = 0;
+}
+
+SCSUringTransport::~SCSUringTransport()
+{
+	close();
+}
+
+bool SCSUringTransport::open(const char *serialPort, int baudRate)
+{
+	if(Ring->fd==-1 || !SCSSerialTransport::open(serialPort, baudRate)){
+		return false;
+	}
+	//the ring does the waiting, a non-blocking descriptor would only give EAGAIN
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+	if(!Ring->attach(this)){
+		SCSFdTransport::close();
+		return false;
+	}
+	Attached = 1;
+	BaudRate = baudRate;
+	return true;
+}
+
+void SCSUringTransport::close()
+{
+	if(Attached){
+		Ring->drain();
+		Ring->detach(this);
+		Attached = 0;
+	}
+	txLen = txDone = 0;
+	SCSFdTransport::close();
+}
+
+int SCSUringTransport::setBaudRate(int baudRate)
+{
+	BaudRate = baudRate;
+	return SCSSerialTransport::setBaudRate(baudRate);
+}
+
+u32 SCSUringTransport::wireUs(int nLen)
+{
+	return BaudRate>0 ? (u32)((nLen*10*1000000LL)/BaudRate) : 0;
+}
+
+int SCSUringTransport::queue(const u8 *nDat, int nLen)
+{
+	int Sent = 0;
+	while(nLen){
+		if(txLen==SCS_URING_TX && sendQueued()<0){
+			return -1;
+		}
+		int n = SCS_URING_TX-txLen;
+		if(n>nLen){
+			n = nLen;
+		}
+		memcpy(txBuf+txLen, nDat, n);
+		txLen += n;
+		nDat += n;
+		nLen -= n;
+		Sent += n;
+	}
+	return Sent;
+}
+
+int SCSUringTransport::sendQueued()
+{
+	while(txDone<txLen){
+		Ring->reserve(1);
+		struct io_uring_sqe *e = Ring->sqe(IORING_OP_WRITE, this, SCS_URING_WRITE);
+		e->fd = fd;
+		e->addr = (u64)(uintptr_t)(txBuf+txDone);
+		e->len = txLen-txDone;
+		e->off = (u64)-1;
+		WriteBusy = 1;
+		Ring->drain();
+		if(WriteBusy){
+			break;//failed, see complete()
+		}
+	}
+	int rv = txDone==txLen ? txLen : -1;
+	txLen = txDone = 0;
+	return rv;
+}
+
+int SCSUringTransport::write(const u8 *nDat, int nLen)
+{
+	if(fd==-1 || queue(nDat, nLen)<0){
+		return -1;
+	}
+	return sendQueued()<0 ? -1 : nLen;
+}
+
+int SCSUringTransport::writev(const struct iovec *iov, int iovcnt)
+{
+	if(fd==-1){
+		return -1;
+	}
+	int nLen = 0;
+	for(int i=0; i<iovcnt; i++){
+		if(queue((const u8*)iov[i].iov_base, iov[i].iov_len)<0){
+			return -1;
+		}
+		nLen += iov[i].iov_len;
+	}
+	return sendQueued()<0 ? -1 : nLen;
+}
+
+static void setTs(struct __kernel_timespec *ts, long us)
+{
+	if(us<0){
+		us = 0;
+	}
+	ts->tv_sec = us/1000000;
+	ts->tv_nsec = (us%1000000)*1000;
+}
+
+void SCSUringTransport::armRead(int nLen, long timeOutUs, u32 SettleUs)
+{
+	struct io_uring_sqe *e;
+	Ring->reserve(4);
+	if(SettleUs && txLen){
+		e = Ring->sqe(IORING_OP_WRITE, this, SCS_URING_WRITE);
+		e->fd = fd;
+		e->addr = (u64)(uintptr_t)txBuf;
+		e->len = txLen;
+		e->off = (u64)-1;
+		WriteBusy = 1;
+		if(!nLen){
+			return;
+		}
+		e->flags = IOSQE_IO_HARDLINK;
+		//start reading once the replies should be there
+		setTs(&SettleTs, SettleUs);
+		e = Ring->sqe(IORING_OP_TIMEOUT, NULL, 0);
+		e->addr = (u64)(uintptr_t)&SettleTs;
+		e->len = 1;
+		e->flags = IOSQE_IO_HARDLINK;
+	}
+	if(!nLen){
+		return;
+	}
+	e = Ring->sqe(IORING_OP_READ, this, SCS_URING_READ);
+	e->fd = fd;
+	e->addr = (u64)(uintptr_t)(rxBuf+rxLen);
+	e->len = nLen;
+	e->off = (u64)-1;
+	e->flags = IOSQE_IO_LINK;
+	ReadBusy = 1;
+	ReadRes = 0;
+	setTs(&ReadTs, timeOutUs);
+	e = Ring->sqe(IORING_OP_LINK_TIMEOUT, NULL, 0);
+	e->addr = (u64)(uintptr_t)&ReadTs;
+	e->len = 1;
+}
+
+void SCSUringTransport::complete(int Kind, int Res)
+{
+	if(Kind==SCS_URING_WRITE){
+		if(Res>0){
+			txDone += Res;
+			WriteBusy = 0;
+		}
+		return;
+	}
+	ReadBusy = 0;
+	ReadRes = Res;
+	if(Res>0){
+		if(!RxFirstUs){
+			RxFirstUs = SCSerial::monoUs();
+		}
+		rxLen += Res;
+		Want -= Res;
+	}
+}
+
+int SCSUringTransport::read(u8 *nDat, int nLen, long timeOutUs)
+{
+	u64 deadline = SCSerial::monoUs()+timeOutUs;
+	int rvLen = 0;
+	RxFirstUs = 0;
+	if(rxPos!=rxLen){
+		RxFirstUs = SCSerial::monoUs();
+	}
+	while(fd!=-1){
+		int n = rxLen-rxPos;
+		if(n>nLen-rvLen){
+			n = nLen-rvLen;
+		}
+		memcpy(nDat+rvLen, rxBuf+rxPos, n);
+		rxPos += n;
+		rvLen += n;
+		if(rvLen>=nLen){
+			break;
+		}
+		rxPos = rxLen = 0;
+		long Left = (long)(deadline-SCSerial::monoUs());
+		armRead(nLen-rvLen>SCS_TRANSPORT_RX ? SCS_TRANSPORT_RX : nLen-rvLen, Left);
+		Ring->drain();
+		if(ReadRes<=0){
+			break;
+		}
+	}
+	return rvLen;
+}
+
+void SCSUringTransport::flush()
+{
+	if(fd!=-1){
+		tcflush(fd, TCIFLUSH);
+	}
+	rxPos = rxLen = 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * SCSUring.h
+ * io_uring back-end: serial ports of several buses sharing one submission ring
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSURING_H
+#define _SCSURING_H
+
+#include <linux/io_uring.h>
+#include "SCSTransport.h"
+#include "SCS.h"
+
+#define SCS_URING_ENTRIES 64//submission queue entries, power of 2
+#define SCS_URING_PORTS 16//transports attached to one ring
+#define SCS_URING_TX 1024//request bytes held per port
+
+class SCSUringTransport;
+class SCSSyncWritePacket;
+class SCSSyncReadPacket;
+
+//One bus of SCSUring::syncReadAll(): an optional sync write sent ahead
+//of the SYNC_READ request, the replies decoded into caller storage.
+struct SCSUringSyncRead{
+	SCSUringTransport *Port;
+	SCSSyncWritePacket *Write;//NULL: none
+	SCSSyncReadPacket *Read;//NULL: only the write is sent
+	u8 *rxBuff;//Read->IDN*(Read->nLen+6) bytes
+	SyncReadRx *rxTab;//indexed by ID, tabLen entries
+	u8 tabLen;
+	int Valid;//status packets decoded
+};
+
+//The ring is set up with the raw io_uring_setup/io_uring_enter system
+//calls, no liburing. Each attached port reads through a READ entry
+//linked to a LINK_TIMEOUT, which takes the place of the epoll wait of the
+//built-in port: a blocking transaction costs one io_uring_enter for the
+//request and one for the whole reply, instead of write, epoll_wait and
+//a read per chunk. syncReadAll() goes further: the requests of every
+//bus, a timeout for the expected wire time and the reply reads are
+//queued as linked chains and submitted together, then waited for
+//together: a whole multi-bus cycle normally takes two
+//system calls however many buses there are (the kernel ends the first
+//wait when the wire time timeouts fire). A ring belongs to one thread.
+class SCSUring{
+public:
+	SCSUring();
+	~SCSUring();
+	int init(unsigned Entries = SCS_URING_ENTRIES);//1 on success, 0 if the kernel refuses io_uring
+	void close();//ports must be closed first
+	int syncReadAll(SCSUringSyncRead rd[], int n);//one cycle over n buses, returns total valid packets
+	static int supported();//1 if io_uring_setup works here (kernel, seccomp)
+public:
+	u32 Enters;//io_uring_enter calls
+	u32 Cycles;//syncReadAll calls
+	long MarginUs;//syncReadAll: wait for the replies beyond their wire time, default 3000
+	u32 ReturnDelayUs;//syncReadAll: servo return delay per status packet, part of the expected reply time
+private:
+	friend class SCSUringTransport;
+	void reserve(unsigned n);//room for n more entries and their completions, waits for the batch in flight if needed
+	struct io_uring_sqe *sqe(u8 Op, void *Ptr, int Kind);//next entry, completion goes to Ptr's complete(Kind), NULL Ptr: ignored
+	int enter(unsigned MinComplete);//submit what is queued, wait for MinComplete completions, reap them
+	int drain();//submit and wait until nothing is in flight
+	void reap();
+	int attach(SCSUringTransport *port);
+	void detach(SCSUringTransport *port);
+private:
+	int fd;
+	void *sqRing;
+	void *cqRing;
+	struct io_uring_sqe *sqes;
+	size_t sqRingSize;
+	size_t cqRingSize;
+	size_t sqesSize;
+	unsigned *sqHead;
+	unsigned *sqTail;
+	unsigned *sqMask;
+	unsigned *sqArray;
+	unsigned sqEntries;
+	unsigned *cqHead;
+	unsigned *cqTail;
+	unsigned *cqMask;
+	unsigned cqEntries;
+	struct io_uring_cqe *cqes;
+	unsigned sqLocal;//tail including entries not yet submitted
+	unsigned sqSubmitted;
+	unsigned Inflight;//entries whose completion has not been reaped
+	SCSUringTransport *Port[SCS_URING_PORTS];
+	int PortN;
+};
+
+//Serial port driven through an SCSUring, for SCSerial::begin(&port, baud)
+//and for SCSUring::syncReadAll(). The descriptor is kept blocking, the
+//ring waits instead of epoll.
+class SCSUringTransport : public SCSSerialTransport{
+public:
+	SCSUringTransport(SCSUring *ring);
+	virtual ~SCSUringTransport();
+	bool open(const char *serialPort, int baudRate);
+	virtual int write(const u8 *nDat, int nLen);
+	virtual int writev(const struct iovec *iov, int iovcnt);
+	virtual int read(u8 *nDat, int nLen, long timeOutUs);
+	virtual void flush();
+	virtual int setBaudRate(int baudRate);
+	virtual void close();
+public:
+	int BaudRate;
+private:
+	friend class SCSUring;
+	int queue(const u8 *nDat, int nLen);//append to the request buffer without sending
+	int sendQueued();//write the request buffer and wait for it
+	void armRead(int nLen, long timeOutUs, u32 SettleUs = 0);//READ + LINK_TIMEOUT into rxBuf, SettleUs>0: behind the queued write and a timeout for the expected reply time
+	void complete(int Kind, int Res);
+	u32 wireUs(int nLen);
+private:
+	SCSUring *Ring;
+	u8 Attached;
+	u8 txBuf[SCS_URING_TX];
+	int txLen;
+	int txDone;//bytes of txBuf written so far
+	u8 WriteBusy;
+	u8 ReadBusy;
+	int ReadRes;//result of the last READ, bytes or -errno
+	int Want;//syncReadAll: reply bytes still expected
+	u64 DeadlineUs;
+	struct __kernel_timespec SettleTs;
+	struct __kernel_timespec ReadTs;
+};
+
+#endif
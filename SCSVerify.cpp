@@ -0,0 +1,129 @@
+/*
+ * SCSVerify.cpp
+ * Fire-and-forget writes checked later by a SyncRead of the written registers
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "SCSVerify.h"
+
+SCSVerify::SCSVerify(SCS *bus, u32 periodUs)
+{
+	this->bus = bus;
+	PeriodUs = periodUs;
+	Callback = NULL;
+	Arg = NULL;
+	DueUs = 0;
+	Writes = 0;
+	Checks = 0;
+	Mismatches = 0;
+	Missed = 0;
+	Lo = SCS_VERIFY_LEN;
+	Hi = 0;
+	memset(Flag, 0, sizeof(Flag));
+	memset(LastError, 0, sizeof(LastError));
+	memset(Known, 0, sizeof(Known));
+}
+
+void SCSVerify::setCallback(SCSVerifyCallback cb, void *arg)
+{
+	Callback = cb;
+	Arg = arg;
+}
+
+int SCSVerify::write(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen)
+{
+	if(ID>=SCS_VERIFY_ID || !nLen || MemAddr+nLen>SCS_VERIFY_LEN){
+		return 0;
+	}
+	bus->syncWrite(&ID, 1, MemAddr, nDat, nLen);
+	memcpy(Mem[ID]+MemAddr, nDat, nLen);
+	memset(Flag[ID]+MemAddr, 1, nLen);
+	Known[ID] = 1;
+	if(MemAddr<Lo){
+		Lo = MemAddr;
+	}
+	if(MemAddr+nLen-1>Hi){
+		Hi = MemAddr+nLen-1;
+	}
+	Writes++;
+	return 1;
+}
+
+void SCSVerify::forget(u8 ID)
+{
+	if(ID<SCS_VERIFY_ID){
+		memset(Flag[ID], 0, SCS_VERIFY_LEN);
+		Known[ID] = 0;
+	}
+}
+
+void SCSVerify::report(u8 Kind, u8 ID, u8 MemAddr, u8 Want, u8 Got, u8 Error)
+{
+	if(Callback){
+		SCSVerifyEvent ev = {Kind, ID, MemAddr, Want, Got, Error};
+		Callback(Arg, &ev);
+	}
+}
+
+int SCSVerify::check(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen, u8 Error)
+{
+	if(ID>=SCS_VERIFY_ID || !Known[ID]){
+		return 0;
+	}
+	int Events = 0;
+	Checks++;
+	const u8 *f = Flag[ID];
+	for(u8 i=0; i<nLen && MemAddr+i<SCS_VERIFY_LEN; i++){
+		u8 a = MemAddr+i;
+		if(f[a] && Mem[ID][a]!=nDat[i]){
+			Mismatches++;
+			report(SCS_VERIFY_MISMATCH, ID, a, Mem[ID][a], nDat[i], Error);
+			Events++;
+			break;//one event per servo and check
+		}
+	}
+	if(Error && Error!=LastError[ID]){
+		report(SCS_VERIFY_ERROR, ID, 0, 0, 0, Error);
+		Events++;
+	}
+	LastError[ID] = Error;
+	return Events;
+}
+
+int SCSVerify::verify(u64 NowUs)
+{
+	if((long)(NowUs-DueUs)<0 || Lo>Hi){
+		return 0;
+	}
+	DueUs = NowUs+PeriodUs;
+	u8 ID[SCS_VERIFY_IDS];
+	u8 IDN = 0;
+	for(int i=0; i<SCS_VERIFY_ID && IDN<SCS_VERIFY_IDS; i++){
+		if(Known[i]){
+			ID[IDN++] = i;
+		}
+	}
+	if(!IDN){
+		return 0;
+	}
+	u8 nLen = Hi-Lo+1;
+	bus->syncReadBegin(IDN, nLen);
+	bus->syncReadPacketTx(ID, IDN, Lo, nLen);
+	SyncReadRx rxTab[SCS_VERIFY_ID];
+	u8 tabLen = ID[IDN-1]+1;
+	bus->syncReadPacketRxAll(rxTab, tabLen);
+	int Events = 0;
+	for(u8 i=0; i<IDN; i++){
+		const SyncReadRx *rx = rxTab+ID[i];
+		if(!rx->Valid){
+			Missed++;
+			report(SCS_VERIFY_MISSED, ID[i], 0, 0, 0, 0);
+			Events++;
+			continue;
+		}
+		Events += check(ID[i], Lo, rx->Dat, nLen, rx->Error);
+	}
+	return Events;
+}
@@ -0,0 +1,66 @@
+/*
+ * SCSVerify.h
+ * Fire-and-forget writes checked later by a SyncRead of the written registers
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSVERIFY_H
+#define _SCSVERIFY_H
+
+#include "SCS.h"
+
+#define SCS_VERIFY_ID 0xfe
+#define SCS_VERIFY_LEN 72//addresses 0..71, as SCS_SHADOW_LEN
+#define SCS_VERIFY_IDS 64//servos checked by one SyncRead
+
+#define SCS_VERIFY_MISMATCH 1//register reads back another value than written
+#define SCS_VERIFY_MISSED 2//servo did not answer the verification read
+#define SCS_VERIFY_ERROR 3//servo status byte changed to a non-zero value
+
+struct SCSVerifyEvent{
+	u8 Kind;//SCS_VERIFY_*
+	u8 ID;
+	u8 MemAddr;//first mismatching byte
+	u8 Want;
+	u8 Got;
+	u8 Error;//servo status byte of the reply
+};
+
+typedef void (*SCSVerifyCallback)(void *arg, const SCSVerifyEvent *ev);
+
+//write() sends a one-servo sync write, which never gets a status packet
+//whatever the servo's return level, and remembers the bytes. Every
+//PeriodUs verify() reads the written range of all servos back with one
+//SyncRead and reports mismatches, missing replies and new error bits
+//through the callback. A control loop that already runs a SyncRead over
+//the same registers can hand its replies to check() instead.
+class SCSVerify{
+public:
+	SCSVerify(SCS *bus, u32 periodUs = 100000);
+	void setCallback(SCSVerifyCallback cb, void *arg);
+	int write(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen);//0 if out of range
+	int verify(u64 NowUs);//SyncRead check when the period is due, returns events reported
+	int check(u8 ID, u8 MemAddr, const u8 *nDat, u8 nLen, u8 Error);//compare a reply read elsewhere, returns events reported
+	void forget(u8 ID);//stop checking ID, e.g. after the servo changed a register on its own
+public:
+	u32 PeriodUs;
+	u32 Writes;
+	u32 Checks;//servo checks done
+	u32 Mismatches;
+	u32 Missed;
+private:
+	void report(u8 Kind, u8 ID, u8 MemAddr, u8 Want, u8 Got, u8 Error);
+	SCS *bus;
+	SCSVerifyCallback Callback;
+	void *Arg;
+	u64 DueUs;
+	u8 Mem[SCS_VERIFY_ID][SCS_VERIFY_LEN];//last values written
+	u8 Flag[SCS_VERIFY_ID][SCS_VERIFY_LEN];//1: byte written and checked
+	u8 LastError[SCS_VERIFY_ID];
+	u8 Known[SCS_VERIFY_ID];//1: ID has written bytes
+	u8 Lo;//range of all written bytes
+	u8 Hi;
+};
+
+#endif
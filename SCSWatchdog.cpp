@@ -0,0 +1,148 @@
+/*
+ * SCSWatchdog.cpp
+ * Telemetry threshold watchdog cutting torque with one prebuilt frame
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#include <string.h>
+#include "INST.h"
+#include "SCSChecksum.h"
+#include "SCSerial.h"
+#include "SCSWatchdog.h"
+
+SCSWatchdog::SCSWatchdog(SCS *bus)
+{
+	this->bus = bus;
+	MaxTemperature = 0;
+	MaxCurrent = 0;
+	MaxLoad = 0;
+	StaleUs = 0;
+	Broadcast = 1;
+	Trips = 0;
+	Cuts = 0;
+	IDN = 0;
+	Latched = 0;
+	Requested = 0;
+	memset(&Last, 0, sizeof(Last));
+	memset(&React, 0, sizeof(React));
+	memset(Index, 0xff, sizeof(Index));
+	setServos(NULL, 0);
+}
+
+int SCSWatchdog::setServos(const u8 ID[], u8 IDN, u8 TorqueAddr)
+{
+	Bcast[0] = 0xff;
+	Bcast[1] = 0xff;
+	Bcast[2] = 0xfe;
+	Bcast[3] = 4;
+	Bcast[4] = INST_WRITE;
+	Bcast[5] = TorqueAddr;
+	Bcast[6] = 0;
+	Bcast[7] = ~SCSChecksum::sum(Bcast+2, 5);
+	if(!IDN || IDN>SCS_WD_SERVOS){
+		return 0;
+	}
+	for(u8 i=0; i<IDN; i++){
+		if(ID[i]>=sizeof(Index)){
+			return 0;//broadcast or out of range
+		}
+	}
+	memset(Index, 0xff, sizeof(Index));
+	for(u8 i=0; i<IDN; i++){
+		Index[ID[i]] = i;
+	}
+	memcpy(this->ID, ID, IDN);
+	this->IDN = IDN;
+	memset(SeenUs, 0, sizeof(SeenUs));
+	if(!Cut.prepare(ID, IDN, TorqueAddr, 1)){
+		return 0;
+	}
+	for(u8 i=0; i<IDN; i++){
+		Cut.set(i, 0, 0);
+	}
+	return 1;
+}
+
+void SCSWatchdog::cut()
+{
+	if(Broadcast){
+		bus->writePrepared(Bcast, sizeof(Bcast));
+	}else{
+		Cut.send(bus);
+	}
+	Cuts++;
+}
+
+int SCSWatchdog::trip(u8 ID, u8 Cause, int Value, u64 SampleUs)
+{
+	cut();
+	u64 CutUs = SCSerial::monoUs();
+	React.add(CutUs>SampleUs ? (u32)(CutUs-SampleUs) : 0);
+	Trips++;
+	Last.ID = ID;
+	Last.Cause = Cause;
+	Last.Value = Value;
+	Last.SampleUs = SampleUs;
+	Last.CutUs = CutUs;
+	__atomic_store_n(&Latched, 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+int SCSWatchdog::check(const u8 ID[], u8 IDN, const Telemetry Tel[], u64 NowUs)
+{
+	if(Latched){
+		return 1;
+	}
+	for(u8 i=0; i<IDN; i++){
+		const Telemetry *t = Tel+i;
+		u8 k = ID[i]<sizeof(Index) ? Index[ID[i]] : 0xff;
+		if(k==0xff || !t->Valid){
+			continue;
+		}
+		SeenUs[k] = t->Stamp;
+		if(MaxTemperature && t->Temperature>MaxTemperature){
+			return trip(ID[i], SCS_WD_TEMPERATURE, t->Temperature, t->Stamp);
+		}
+		if(MaxCurrent && (t->Current>MaxCurrent || t->Current<-MaxCurrent)){
+			return trip(ID[i], SCS_WD_CURRENT, t->Current, t->Stamp);
+		}
+		if(MaxLoad && (t->Load>MaxLoad || t->Load<-MaxLoad)){
+			return trip(ID[i], SCS_WD_LOAD, t->Load, t->Stamp);
+		}
+	}
+	if(!StaleUs){
+		return 0;
+	}
+	for(u8 k=0; k<this->IDN; k++){
+		if(!SeenUs[k]){
+			SeenUs[k] = NowUs;//armed by the first check
+		}else if(NowUs-SeenUs[k]>StaleUs){
+			return trip(this->ID[k], SCS_WD_STALE, (int)(NowUs-SeenUs[k]), SeenUs[k]+StaleUs);
+		}
+	}
+	return 0;
+}
+
+int SCSWatchdog::poll(u64 NowUs)
+{
+	if(__atomic_exchange_n(&Requested, 0, __ATOMIC_ACQ_REL) && !Latched){
+		return trip(0xfe, SCS_WD_REQUEST, 0, NowUs);
+	}
+	if(Latched){
+		cut();//a broadcast gets no reply, repeat it while latched
+	}
+	return Latched;
+}
+
+void SCSWatchdog::reset()
+{
+	memset(SeenUs, 0, sizeof(SeenUs));
+	__atomic_store_n(&Requested, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&Latched, 0, __ATOMIC_RELEASE);
+}
+
+u32 SCSWatchdog::boundUs(u32 PeriodUs) const
+{
+	return PeriodUs+React.Max+StaleUs;
+}
@@ -0,0 +1,79 @@
+/*
+ * SCSWatchdog.h
+ * Telemetry threshold watchdog cutting torque with one prebuilt frame
+ * Date: 2026.10.14
+ * Author:
+ */
+
+#ifndef _SCSWATCHDOG_H
+#define _SCSWATCHDOG_H
+
+#include "SCS.h"
+#include "Telemetry.h"
+#include "SCSStats.h"
+#include "SCSPrepared.h"
+
+#define SCS_WD_SERVOS 64//servos watched by one watchdog
+#define SCS_WD_TORQUE_ADDR 40//torque enable, same address in every series
+
+#define SCS_WD_TEMPERATURE 1
+#define SCS_WD_CURRENT 2//present current (SMS_STS_PRESENT_CURRENT_L), 6.5mA
+#define SCS_WD_LOAD 3
+#define SCS_WD_STALE 4//no valid reply for StaleUs
+#define SCS_WD_REQUEST 5//request() from another thread
+
+struct SCSWatchdogTrip{
+	u8 ID;//0xfe for a request
+	u8 Cause;//SCS_WD_*
+	int Value;//reading that crossed the limit, age in us for SCS_WD_STALE
+	u64 SampleUs;//when the fault was observable: reply arrival, stale deadline or request
+	u64 CutUs;//torque off frame handed to the transport
+};
+
+//Runs on the bus thread. check() is fed the decoded feedback of each
+//cycle, right after the SyncRead; a reading over a limit (or a servo
+//silent for StaleUs) sends the prebuilt torque off frame at once, a
+//broadcast WRITE or a SYNC_WRITE to the watched servos, and latches.
+//While latched poll() is true and every poll() resends the frame, the
+//owner of the bus drops queued commands instead of writing them
+//(SCSBusOwner::setWatchdog does both). Only reset() clears the latch,
+//torque stays off until the application enables it again.
+//React holds the sample-to-cut time of every trip; a fault that starts
+//right after a sample is seen one period later, so the worst case for
+//a loop of PeriodUs is boundUs(PeriodUs).
+class SCSWatchdog{
+public:
+	SCSWatchdog(SCS *bus);
+	int setServos(const u8 ID[], u8 IDN, u8 TorqueAddr = SCS_WD_TORQUE_ADDR);//0 if IDN is 0 or above SCS_WD_SERVOS, or an ID is 0xfe or above
+	int check(const u8 ID[], u8 IDN, const Telemetry Tel[], u64 NowUs);//bus thread, returns 1 if latched
+	int poll(u64 NowUs);//bus thread, before the cycle's commands: serves request(), resends the cut while latched, returns 1 if latched
+	void request(){  __atomic_store_n(&Requested, 1, __ATOMIC_RELEASE);  }//any thread, trip at the next poll()
+	void reset();//clear the latch and re-arm the stale timers
+	int tripped() const{  return __atomic_load_n(&Latched, __ATOMIC_ACQUIRE);  }
+	u32 boundUs(u32 PeriodUs) const;//worst case fault-to-cut: one period plus the slowest measured reaction (plus StaleUs if set)
+public:
+	u8 MaxTemperature;//degree Celsius, 0 off
+	s16 MaxCurrent;//absolute, 6.5mA, 0 off
+	s16 MaxLoad;//absolute, 0.1%, 0 off
+	u32 StaleUs;//0 off
+	u8 Broadcast;//1 (default): broadcast WRITE, every servo on the bus; 0: SYNC_WRITE of the watched servos
+	u32 Trips;
+	u32 Cuts;//torque off frames sent, resends included
+	SCSWatchdogTrip Last;//first trip since the last reset()
+	SCSHist React;//SampleUs to CutUs of every trip, us
+private:
+	int trip(u8 ID, u8 Cause, int Value, u64 SampleUs);
+	void cut();
+private:
+	SCS *bus;
+	u8 IDN;
+	u8 ID[SCS_WD_SERVOS];
+	u64 SeenUs[SCS_WD_SERVOS];//last valid reply, 0 until armed
+	u8 Index[0xfe];//ID to watch index, 0xff not watched
+	SCSSyncWritePacket Cut;
+	u8 Bcast[8];
+	int Latched;
+	int Requested;
+};
+
+#endif
@@ -1,146 +1,1036 @@
-/*
- * SCSerial.h
- * 飞特串行舵机硬件接口层程序
- * 日期: 2022.3.29
- * 作者: 
- */
-
-#include "SCSerial.h"
-
-SCSerial::SCSerial()
-{
-	IOTimeOut = 100;
-	fd = -1;
-	txBufLen = 0;
-}
-
-SCSerial::SCSerial(u8 End):SCS(End)
-{
-	IOTimeOut = 100;
-	fd = -1;
-	txBufLen = 0;
-}
-
-SCSerial::SCSerial(u8 End, u8 Level):SCS(End, Level)
-{
-	IOTimeOut = 100;
-	fd = -1;
-	txBufLen = 0;
-}
-
-bool SCSerial::begin(int baudRate, const char* serialPort)
-{
-	if(fd != -1){
-		close(fd);
-		fd = -1;
-	}
-	//printf("servo port:%s\n", serialPort);
-    if(serialPort == NULL)
-		return false;
-    fd = open(serialPort, O_RDWR | O_NOCTTY | O_NONBLOCK);
-    if(fd == -1){
-		perror("open:");
-        return false;
-	}
-    fcntl(fd, F_SETFL, FNDELAY);
-    tcgetattr(fd, &orgopt);
-    tcgetattr(fd, &curopt);
-    speed_t CR_BAUDRATE = baudRate;
-    cfsetispeed(&curopt, CR_BAUDRATE);
-    cfsetospeed(&curopt, CR_BAUDRATE);
-
-	printf("serial speed %d\n", baudRate);
-    //Mostly 8N1
-    curopt.c_cflag &= ~PARENB;
-    curopt.c_cflag &= ~CSTOPB;
-    curopt.c_cflag &= ~CSIZE;
-    curopt.c_cflag |= CS8;
-    curopt.c_cflag |= CREAD;
-    curopt.c_cflag |= CLOCAL;//disable modem statuc check
-    cfmakeraw(&curopt);//make raw mode
-    curopt.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
-    if(tcsetattr(fd, TCSANOW, &curopt) == 0){
-        return true;
-    }else{
-		perror("tcsetattr:");
-		return false;
-	}
-}
-
-int SCSerial::setBaudRate(int baudRate)
-{ 
-    if(fd==-1){
-		return -1;
-	}
-    tcgetattr(fd, &orgopt);
-    tcgetattr(fd, &curopt);
-    speed_t CR_BAUDRATE = baudRate;
-    cfsetispeed(&curopt, CR_BAUDRATE);
-    cfsetospeed(&curopt, CR_BAUDRATE);
-    return 1;
-}
-
-int SCSerial::readSCS(unsigned char *nDat, int nLen)
-{	
-    int fs_sel;
-    fd_set fs_read;
-	int rvLen = 0;
-
-    struct timeval time;
-
-    FD_ZERO(&fs_read);
-    FD_SET(fd,&fs_read);
-
-    time.tv_sec = 0;
-    time.tv_usec = IOTimeOut*1000;
-
-    //使用select实现串口的多路通信
-	while(1){
-		fs_sel = select(fd+1, &fs_read, NULL, NULL, &time);
-		if(fs_sel){
-			rvLen += read(fd, nDat+rvLen, nLen-rvLen);
-			//printf("nLen = %d rvLen = %d\n", nLen, rvLen);
-			if(rvLen<nLen){
-				continue;
-			}else{
-				return rvLen;
-			}
-		}else{
-			//printf("serial read fd read return 0\n");
-			return rvLen;
-		}
-	}
-}
-
-int SCSerial::writeSCS(unsigned char *nDat, int nLen)
-{
-	while(nLen--){
-		txBuf[txBufLen++] = *nDat++;
-	}
-	return txBufLen;
-}
-
-int SCSerial::writeSCS(unsigned char bDat)
-{
-	txBuf[txBufLen++] = bDat;
-	return txBufLen;
-}
-
-void SCSerial::rFlushSCS()
-{
-	tcflush(fd, TCIFLUSH);
-}
-
-void SCSerial::wFlushSCS()
-{
-	if(txBufLen){
-		txBufLen = write(fd, txBuf, txBufLen);
-		txBufLen = 0;
-	}
-}
-
-void SCSerial::end()
-{
-	fd = -1;
-	close(fd);
-}
+﻿/*
+ * SCSerial.h
+ * 飞特串行舵机硬件接口层程序
+ * 日期: 2022.3.29
+ * 作者: 
+ */
+
+#include "SCSerial.h"
+#include "SCSCapture.h"
+#include "SCSBatch.h"
+#include "SCSTrace.h"
+#include <errno.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <sys/uio.h>
+
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+#ifndef IBSHIFT
+#define IBSHIFT 16
+#endif
+
+//struct termios2 from asm/termbits.h, which can't be included next to termios.h
+struct scs_termios2
+{
+	tcflag_t c_iflag;
+	tcflag_t c_oflag;
+	tcflag_t c_cflag;
+	tcflag_t c_lflag;
+	cc_t c_line;
+	cc_t c_cc[19];
+	speed_t c_ispeed;
+	speed_t c_ospeed;
+};
+#define SCS_TCGETS2 _IOR('T', 0x2A, struct scs_termios2)
+#define SCS_TCSETS2 _IOW('T', 0x2B, struct scs_termios2)
+
+//servo baud rate codes 0..7 (SMS_STS_1M..SMS_STS_38400, same in every series)
+const int SCSerial::baudTable[SCSERIAL_BAUD_CODES] = {1000000, 500000, 250000, 128000, 115200, 76800, 57600, 38400};
+
+static speed_t baudToSpeed(int baudRate)
+{
+	switch(baudRate){
+		case 9600: return B9600;
+		case 19200: return B19200;
+		case 38400: return B38400;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		case 460800: return B460800;
+		case 500000: return B500000;
+		case 576000: return B576000;
+		case 921600: return B921600;
+		case 1000000: return B1000000;
+		case 1152000: return B1152000;
+		case 1500000: return B1500000;
+		case 2000000: return B2000000;
+		case 2500000: return B2500000;
+		case 3000000: return B3000000;
+		default: return B0;
+	}
+}
+
+
+SCSerial::SCSerial()
+{
+	IOTimeOut = 100;
+	fd = -1;
+	epfd = -1;
+	txBufLen = 0;
+	txLastLen = 0;
+	baudRate = 0;
+	AdaptiveTimeOut = 0;
+	TimeOutMarginUs = 0;
+	ReturnDelayUs = 0;
+	rxHead = rxTail = 0;
+	rxRingUs = 0;
+	Transport = NULL;
+	Capture = NULL;
+	Dir = SCSERIAL_DIR_NONE;
+	DirFd = -1;
+	DirActiveLow = 0;
+	DirTurnUs = 0;
+	DirDrain = 1;
+	Echo = 0;
+	EchoLen = 0;
+	EchoSkipped = 0;
+	NoSyncRead = 0;
+	SyncReadMisses = 0;
+	Verbose = 1;
+	Fault = 0;
+	Faults = 0;
+	Reconnects = 0;
+	PortPath[0] = 0;
+}
+
+SCSerial::SCSerial(u8 End):SCS(End)
+{
+	IOTimeOut = 100;
+	fd = -1;
+	epfd = -1;
+	txBufLen = 0;
+	txLastLen = 0;
+	baudRate = 0;
+	AdaptiveTimeOut = 0;
+	TimeOutMarginUs = 0;
+	ReturnDelayUs = 0;
+	rxHead = rxTail = 0;
+	rxRingUs = 0;
+	Transport = NULL;
+	Capture = NULL;
+	Dir = SCSERIAL_DIR_NONE;
+	DirFd = -1;
+	DirActiveLow = 0;
+	DirTurnUs = 0;
+	DirDrain = 1;
+	Echo = 0;
+	EchoLen = 0;
+	EchoSkipped = 0;
+	NoSyncRead = 0;
+	SyncReadMisses = 0;
+	Verbose = 1;
+	Fault = 0;
+	Faults = 0;
+	Reconnects = 0;
+	PortPath[0] = 0;
+}
+
+SCSerial::SCSerial(u8 End, u8 Level):SCS(End, Level)
+{
+	IOTimeOut = 100;
+	fd = -1;
+	epfd = -1;
+	txBufLen = 0;
+	txLastLen = 0;
+	baudRate = 0;
+	AdaptiveTimeOut = 0;
+	TimeOutMarginUs = 0;
+	ReturnDelayUs = 0;
+	rxHead = rxTail = 0;
+	rxRingUs = 0;
+	Transport = NULL;
+	Capture = NULL;
+	Dir = SCSERIAL_DIR_NONE;
+	DirFd = -1;
+	DirActiveLow = 0;
+	DirTurnUs = 0;
+	DirDrain = 1;
+	Echo = 0;
+	EchoLen = 0;
+	EchoSkipped = 0;
+	NoSyncRead = 0;
+	SyncReadMisses = 0;
+	Verbose = 1;
+	Fault = 0;
+	Faults = 0;
+	Reconnects = 0;
+	PortPath[0] = 0;
+}
+
+//an injected transport is not owned, end() closes it but the destructor leaves it alone
+SCSerial::~SCSerial()
+{
+	closePort();
+	if(DirFd != -1){
+		close(DirFd);
+		DirFd = -1;
+	}
+}
+
+//restore the line settings found at begin() and release the descriptors
+void SCSerial::closePort()
+{
+	if(epfd != -1){
+		close(epfd);
+		epfd = -1;
+	}
+	if(fd != -1){
+		tcsetattr(fd, TCSANOW, &orgopt);
+		close(fd);
+		fd = -1;
+	}
+	rxHead = rxTail = 0;
+	txBufLen = 0;
+}
+
+bool SCSerial::begin(SCSTransport *transport, int baudRate)
+{
+	closePort();
+	Fault = 0;
+	Transport = transport;
+	this->baudRate = baudRate;
+	return Transport!=NULL;
+}
+
+bool SCSerial::begin(int baudRate, const char* serialPort)
+{
+	Transport = NULL;
+	closePort();
+	Fault = 0;
+	//printf("servo port:%s\n", serialPort);
+    if(serialPort == NULL)
+		return false;
+	if(serialPort!=PortPath && strlen(serialPort)<sizeof(PortPath)){
+		strcpy(PortPath, serialPort);
+	}
+    fd = open(serialPort, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(fd == -1){
+		perror("open:");
+        return false;
+	}
+    fcntl(fd, F_SETFL, FNDELAY);
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if(epfd == -1 || epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == -1){
+		perror("epoll:");
+		if(epfd != -1){
+			close(epfd);
+			epfd = -1;
+		}
+		close(fd);
+		fd = -1;
+		return false;
+	}
+	rxHead = rxTail = 0;
+    tcgetattr(fd, &orgopt);
+    tcgetattr(fd, &curopt);
+
+	if(Verbose){
+		printf("serial speed %d\n", baudRate);
+	}
+    //Mostly 8N1
+    curopt.c_cflag &= ~PARENB;
+    curopt.c_cflag &= ~CSTOPB;
+    curopt.c_cflag &= ~CSIZE;
+    curopt.c_cflag |= CS8;
+    curopt.c_cflag |= CREAD;
+    curopt.c_cflag |= CLOCAL;//disable modem statuc check
+    cfmakeraw(&curopt);//make raw mode
+    curopt.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+    if(baudRate == SCSERIAL_BAUD_AUTO){
+		if(setSpeed(baudTable[0]) != 1){
+			perror("tcsetattr:");
+			return false;
+		}
+		return detectBaudRate() > 0;
+	}
+    if(setSpeed(baudRate) == 1){
+        return true;
+    }else{
+		perror("tcsetattr:");
+		return false;
+	}
+}
+
+int SCSerial::setSpeed(int baudRate)
+{
+	if(applySpeed(fd, &curopt, baudRate) != 1){
+		return -1;
+	}
+	this->baudRate = baudRate;
+	return 1;
+}
+
+int SCSerial::applySpeed(int fd, struct termios *opt, int baudRate)
+{
+	speed_t CR_BAUDRATE = baudToSpeed(baudRate);
+	if(CR_BAUDRATE != B0){
+		cfsetispeed(opt, CR_BAUDRATE);
+		cfsetospeed(opt, CR_BAUDRATE);
+	}
+	if(tcsetattr(fd, TCSADRAIN, opt) != 0){
+		return -1;
+	}
+	if(CR_BAUDRATE == B0){
+		//arbitrary rate, e.g. 76800, 128000 or 250000 of the servo baud table
+		struct scs_termios2 tio;
+		if(ioctl(fd, SCS_TCGETS2, &tio) == -1){
+			return -1;
+		}
+		tio.c_cflag &= ~(CBAUD | (CBAUD<<IBSHIFT));
+		tio.c_cflag |= BOTHER | (BOTHER<<IBSHIFT);
+		tio.c_ispeed = baudRate;
+		tio.c_ospeed = baudRate;
+		if(ioctl(fd, SCS_TCSETS2, &tio) == -1){
+			return -1;
+		}
+	}
+	return 1;
+}
+
+int SCSerial::setLowLatency(u8 Enable)
+{
+	struct serial_struct ser;
+	if(fd==-1 || ioctl(fd, TIOCGSERIAL, &ser) == -1){
+		return -1;
+	}
+	if(Enable){
+		ser.flags |= ASYNC_LOW_LATENCY;
+	}else{
+		ser.flags &= ~ASYNC_LOW_LATENCY;
+	}
+	if(ioctl(fd, TIOCSSERIAL, &ser) == -1){
+		return -1;
+	}
+	return 1;
+}
+
+int SCSerial::getLowLatency()
+{
+	struct serial_struct ser;
+	if(fd==-1 || ioctl(fd, TIOCGSERIAL, &ser) == -1){
+		return -1;
+	}
+	return (ser.flags&ASYNC_LOW_LATENCY) ? 1 : 0;
+}
+
+int SCSerial::latencyTimerPath(char *path, int size)
+{
+	char dev[128];
+	if(fd==-1){
+		return -1;
+	}
+	snprintf(path, size, "/proc/self/fd/%d", fd);
+	int n = readlink(path, dev, sizeof(dev)-1);
+	if(n<=0){
+		return -1;
+	}
+	dev[n] = 0;
+	const char *tty = strrchr(dev, '/');
+	snprintf(path, size, "/sys/bus/usb-serial/devices/%s/latency_timer", tty ? tty+1 : dev);
+	return 1;
+}
+
+int SCSerial::setLatencyTimer(int ms)
+{
+	char path[128];
+	if(latencyTimerPath(path, sizeof(path))!=1){
+		return -1;
+	}
+	FILE *fp = fopen(path, "w");
+	if(!fp){
+		return -1;
+	}
+	int n = fprintf(fp, "%d", ms);
+	if(fclose(fp)!=0 || n<=0){
+		return -1;
+	}
+	return 1;
+}
+
+int SCSerial::getLatencyTimer()
+{
+	char path[128];
+	int ms = -1;
+	if(latencyTimerPath(path, sizeof(path))!=1){
+		return -1;
+	}
+	FILE *fp = fopen(path, "r");
+	if(!fp){
+		return -1;
+	}
+	if(fscanf(fp, "%d", &ms)!=1){
+		ms = -1;
+	}
+	fclose(fp);
+	return ms;
+}
+
+int SCSerial::setReadMode(u8 vMin, u8 vTime)
+{
+	if(fd==-1){
+		return -1;
+	}
+	curopt.c_cc[VMIN] = vMin;
+	curopt.c_cc[VTIME] = vTime;
+	//goes through applySpeed so a termios2 rate is set again
+	return setSpeed(baudRate);
+}
+
+int SCSerial::setDirection(int Mode, int Gpio, u8 ActiveLow, unsigned long int TurnUs)
+{
+	if(fd==-1){
+		return -1;
+	}
+	if(DirFd!=-1){
+		close(DirFd);
+		DirFd = -1;
+	}
+	struct serial_rs485 rs;
+	memset(&rs, 0, sizeof(rs));
+	if(Dir==SCSERIAL_DIR_RS485 && Mode!=SCSERIAL_DIR_RS485){
+		ioctl(fd, TIOCSRS485, &rs);//back to RS232 mode
+	}
+	Dir = SCSERIAL_DIR_NONE;
+	DirActiveLow = ActiveLow;
+	DirTurnUs = TurnUs;
+	if(Mode==SCSERIAL_DIR_RS485){
+		rs.flags = SER_RS485_ENABLED;
+		rs.flags |= ActiveLow ? SER_RS485_RTS_AFTER_SEND : SER_RS485_RTS_ON_SEND;
+		rs.delay_rts_after_send = (TurnUs+999)/1000;//ms, the driver waits for the shift register itself
+		if(ioctl(fd, TIOCSRS485, &rs) == -1){
+			return -1;
+		}
+	}else if(Mode==SCSERIAL_DIR_GPIO){
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", Gpio);
+		DirFd = open(path, O_WRONLY | O_CLOEXEC);
+		if(DirFd == -1){
+			return -1;
+		}
+	}else if(Mode!=SCSERIAL_DIR_RTS && Mode!=SCSERIAL_DIR_NONE){
+		return -1;
+	}
+	Dir = Mode;
+	dirSet(0);
+	return 1;
+}
+
+void SCSerial::dirSet(int Tx)
+{
+	int Level = (Tx!=0)!=(DirActiveLow!=0);
+	if(Dir==SCSERIAL_DIR_RTS){
+		int Bits = TIOCM_RTS;
+		ioctl(fd, Level ? TIOCMBIS : TIOCMBIC, &Bits);
+	}else if(Dir==SCSERIAL_DIR_GPIO){
+		pwrite(DirFd, Level ? "1" : "0", 1, 0);
+	}
+}
+
+int SCSerial::setBaudRate(int baudRate)
+{ 
+	if(Transport){
+		if(Transport->setBaudRate(baudRate) != 1){
+			return -1;
+		}
+		this->baudRate = baudRate;
+		return 1;
+	}
+    if(fd==-1){
+		return -1;
+	}
+    return setSpeed(baudRate);
+}
+
+int SCSerial::baudCode(int baudRate)
+{
+	for(int i=0; i<SCSERIAL_BAUD_CODES; i++){
+		if(baudTable[i]==baudRate){
+			return i;
+		}
+	}
+	return -1;
+}
+
+//broadcast ping at the current rate, any reply byte counts since
+//several servos answering at once collide on the bus
+int SCSerial::probe(unsigned long int marginUs)
+{
+	u8 savedAdaptive = AdaptiveTimeOut;
+	unsigned long int savedMarginUs = TimeOutMarginUs;
+	AdaptiveTimeOut = 1;
+	TimeOutMarginUs = marginUs;
+	rFlushSCS();
+	writeBuf(0xfe, 0, NULL, 0, INST_PING);
+	wFlushSCS();
+	u8 bBuf[6];
+	int Size = readSCS(bBuf, 6);
+	AdaptiveTimeOut = savedAdaptive;
+	TimeOutMarginUs = savedMarginUs;
+	return Size>0;
+}
+
+int SCSerial::detectBaudRate(unsigned long int marginUs)
+{
+	for(int i=0; i<SCSERIAL_BAUD_CODES; i++){
+		if(setBaudRate(baudTable[i])==1 && probe(marginUs)){
+			return baudTable[i];
+		}
+	}
+	setBaudRate(baudTable[0]);
+	return -1;
+}
+
+//Every rate of the table that answers gets an unlock and a broadcast
+//write of the new code, the EEPROM is locked again at the target rate.
+int SCSerial::rebaudAll(int baudRate, u8 BaudAddr, u8 LockAddr, unsigned long int marginUs)
+{
+	int Code = baudCode(baudRate);
+	if(Code<0){
+		return -1;
+	}
+	int Moved = 0;
+	for(int i=0; i<SCSERIAL_BAUD_CODES; i++){
+		if(i==Code || setBaudRate(baudTable[i])!=1 || !probe(marginUs)){
+			continue;
+		}
+		writeByte(0xfe, LockAddr, 0);
+		writeByte(0xfe, BaudAddr, Code);
+		usleep(SCSERIAL_EEPROM_US);
+		Moved++;
+	}
+	if(setBaudRate(baudRate)!=1){
+		return -1;
+	}
+	writeByte(0xfe, LockAddr, 1);
+	usleep(SCSERIAL_EEPROM_US);
+	return probe(marginUs) ? Moved : -1;
+}
+
+u64 SCSerial::monoUs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000ULL + ts.tv_nsec/1000;
+}
+
+int SCSerial::rxFill()
+{
+	int rvLen = 0;
+	while(1){
+		unsigned int nFree = SCSERIAL_RX_RING-(rxHead-rxTail);
+		unsigned int pos = rxHead&(SCSERIAL_RX_RING-1);
+		unsigned int n = SCSERIAL_RX_RING-pos;
+		if(n>nFree){
+			n = nFree;
+		}
+		if(!n){
+			return rvLen;
+		}
+		int rd = read(fd, rxRing+pos, n);
+		if(rd<=0){
+			if(!rd){
+				ioFault(ENODEV);//hangup
+			}else if(errno!=EAGAIN && errno!=EINTR){
+				ioFault(errno);
+			}
+			return rvLen;
+		}
+		if(rxHead==rxTail){
+			rxRingUs = monoUs()-wireUs(rd);//the first byte arrived a line time before the last
+		}
+		rxHead += rd;
+		rvLen += rd;
+		if((unsigned int)rd<n){
+			return rvLen;
+		}
+	}
+}
+
+int SCSerial::rxTake(unsigned char *nDat, int nLen)
+{
+	int rvLen = 0;
+	while(rvLen<nLen && rxTail!=rxHead){
+		unsigned int pos = rxTail&(SCSERIAL_RX_RING-1);
+		unsigned int n = SCSERIAL_RX_RING-pos;
+		if(n>(rxHead-rxTail)){
+			n = rxHead-rxTail;
+		}
+		if(n>(unsigned int)(nLen-rvLen)){
+			n = nLen-rvLen;
+		}
+		memcpy(nDat+rvLen, rxRing+pos, n);
+		rxTail += n;
+		rvLen += n;
+	}
+	return rvLen;
+}
+
+int SCSerial::rxWait(long timeOutUs)
+{
+	struct epoll_event ev;
+#ifdef SYS_epoll_pwait2
+	static int pwait2 = 1;
+	if(pwait2){
+		struct timespec ts;
+		ts.tv_sec = timeOutUs/1000000;
+		ts.tv_nsec = (timeOutUs%1000000)*1000;
+		int n = syscall(SYS_epoll_pwait2, epfd, &ev, 1, &ts, NULL, 0);
+		if(n>=0 || errno!=ENOSYS){
+			return n;
+		}
+		pwait2 = 0;
+	}
+#endif
+	return epoll_wait(epfd, &ev, 1, (timeOutUs+999)/1000);
+}
+
+int SCSerial::rxPoll(int timeOutUs)
+{
+	if(fd==-1){
+		return 0;
+	}
+	rxFill();
+	if(rxHead==rxTail && timeOutUs>0 && rxWait(timeOutUs)>0){
+		rxFill();
+	}
+	return rxHead-rxTail;
+}
+
+int SCSerial::sendRaw(const u8 *nDat, int nLen)
+{
+	writeSCS((unsigned char*)nDat, nLen);
+	wFlushSCS();
+	return nLen;
+}
+
+int SCSerial::recvRaw(u8 *nDat, int nLen)
+{
+	int rvLen = 0;
+	if(EchoLen && !echoSkip(monoUs())){
+		return 0;//echo still on its way
+	}
+	if(Transport){
+		rvLen = Transport->read(nDat, nLen, 0);
+		if(Transport->Fault){
+			ioFault(Transport->Fault);
+		}
+	}else if(fd!=-1 || rxHead!=rxTail){
+		if(fd!=-1){
+			rxFill();
+		}
+		rvLen = rxTake(nDat, nLen);
+	}
+	if(Capture && rvLen>0){
+		Capture->add(SCS_CAP_RX, nDat, rvLen, monoUs());
+	}
+	return rvLen;
+}
+
+void SCSerial::setAdaptiveTimeOut(unsigned long int marginUs, unsigned long int returnDelayUs)
+{
+	TimeOutMarginUs = marginUs;
+	ReturnDelayUs = returnDelayUs;
+	AdaptiveTimeOut = 1;
+}
+
+u32 SCSerial::wireUs(int nLen)
+{
+	if(baudRate<=0){
+		return 0;
+	}
+	return (u32)(((u64)nLen*10*1000000ULL)/baudRate);
+}
+
+//wire time of the pending request and the reply (8N1, 10 bits per byte)
+//plus one return delay per expected status packet and the margin
+long SCSerial::rxTimeOutUs(int nLen)
+{
+	if(!AdaptiveTimeOut || baudRate<=0){
+		return IOTimeOut*1000;
+	}
+	long wireUs = ((long)(txLastLen+nLen)*10*1000000L + baudRate-1)/baudRate;
+	return wireUs + ReturnDelayUs*rxPacketNum + TimeOutMarginUs;
+}
+
+int SCSerial::echoSkip(u64 deadline)
+{
+	u8 Drop[64];
+	while(EchoLen>0){
+		int n = EchoLen<(int)sizeof(Drop) ? EchoLen : (int)sizeof(Drop);
+		if(Transport){
+			long timeOutUs = (long)(deadline-monoUs());
+			n = Transport->read(Drop, n, timeOutUs>0 ? timeOutUs : 0);
+			if(Transport->Fault){
+				ioFault(Transport->Fault);
+			}
+		}else{
+			rxFill();
+			n = rxTake(Drop, n);
+			if(!n){
+				long timeOutUs = (long)(deadline-monoUs());
+				if(timeOutUs<=0 || rxWait(timeOutUs)<0){
+					break;
+				}
+				continue;
+			}
+		}
+		if(n<=0){
+			break;
+		}
+		EchoLen -= n;
+		EchoSkipped += n;
+	}
+	return EchoLen<=0;
+}
+
+//Direction control keeps the driver enabled from before the first bit
+//until the last stop bit has left the UART (tcdrain, or the frame time
+//counted from the write for adapters whose tcdrain returns early or
+//late), plus DirTurnUs.
+int SCSerial::txWrite(struct iovec *iov, int iovcnt, int nLen)
+{
+	int Manual = Dir==SCSERIAL_DIR_RTS || Dir==SCSERIAL_DIR_GPIO;
+	u64 StartUs = 0;
+	if(Manual){
+		dirSet(1);
+		StartUs = monoUs();
+	}
+	int rvLen = SCSFdTransport::writevAll(fd, iov, iovcnt);
+	if(rvLen<0){
+		ioFault(errno);
+	}
+	if(Manual){
+		if(DirDrain){
+			tcdrain(fd);
+		}else{
+			u64 EndUs = StartUs+wireUs(nLen);
+			while((long)(EndUs-monoUs())>0){
+			}
+		}
+		if(DirTurnUs){
+			u64 EndUs = monoUs()+DirTurnUs;
+			while((long)(EndUs-monoUs())>0){
+			}
+		}
+		dirSet(0);
+	}
+	return rvLen;
+}
+
+int SCSerial::readSCS(unsigned char *nDat, int nLen)
+{
+	int rvLen = readBytes(nDat, nLen);
+	if(Capture && rvLen>0){
+		Capture->add(SCS_CAP_RX, nDat, rvLen, rxFirstUs ? rxFirstUs : monoUs());
+	}
+	return rvLen;
+}
+
+int SCSerial::readBytes(unsigned char *nDat, int nLen)
+{
+	u64 deadline = monoUs() + rxTimeOutUs(nLen);
+	txLastLen = 0;
+	rxFirstUs = 0;
+	if(EchoLen && !echoSkip(deadline)){
+		EchoLen = 0;//lost on the line, resync with the next request
+	}
+	if(Transport){
+		int rvLen = Transport->read(nDat, nLen, (long)(deadline-monoUs()));
+		rxFirstUs = Transport->RxFirstUs;
+		if(Transport->Fault){
+			ioFault(Transport->Fault);
+		}
+		return rvLen;
+	}
+	if(Fault){
+		return 0;
+	}
+	int Filled = 0;
+	if(rxHead==rxTail && fd!=-1){
+		rxFill();
+		Filled = 1;
+	}
+	if(rxHead!=rxTail){
+		rxFirstUs = rxRingUs;
+	}
+	int rvLen = rxTake(nDat, nLen);
+	if(rvLen>=nLen || fd==-1){
+		return rvLen;
+	}
+	if(!Filled){
+		rxFill();
+		rvLen += rxTake(nDat+rvLen, nLen-rvLen);
+	}
+	while(rvLen<nLen){
+		long timeOutUs = (long)(deadline-monoUs());
+		if(timeOutUs<=0){
+			break;
+		}
+		int n = rxWait(timeOutUs);
+		if(n<0 && errno!=EINTR){
+			break;
+		}
+		if(n>0){
+			rxFill();
+			if(Fault){
+				break;
+			}
+			if(!rxFirstUs && rxHead!=rxTail){
+				rxFirstUs = rxRingUs;
+			}
+			rvLen += rxTake(nDat+rvLen, nLen-rvLen);
+		}
+	}
+	return rvLen;
+}
+
+int SCSerial::writeSCS(unsigned char *nDat, int nLen)
+{
+	if((txBufLen+nLen)>(int)sizeof(txBuf)){
+		wFlushSCS();
+		if(nLen>(int)sizeof(txBuf)){
+			struct iovec iov;
+			iov.iov_base = nDat;
+			iov.iov_len = nLen;
+			return writeSCSv(&iov, 1);
+		}
+	}
+	memcpy(txBuf+txBufLen, nDat, nLen);
+	txBufLen += nLen;
+	return txBufLen;
+}
+
+int SCSerial::writeSCSv(const struct iovec *iov, int iovcnt)
+{
+	int nLen = 0;
+	for(int i=0; i<iovcnt; i++){
+		nLen += iov[i].iov_len;
+	}
+	if(txBufLen+nLen<=(int)sizeof(txBuf)){
+		for(int i=0; i<iovcnt; i++){
+			memcpy(txBuf+txBufLen, iov[i].iov_base, iov[i].iov_len);
+			txBufLen += iov[i].iov_len;
+		}
+		return nLen;
+	}
+	struct iovec v[0xfe*2+3];
+	if(iovcnt+1>(int)(sizeof(v)/sizeof(v[0]))){
+		wFlushSCS();
+		return SCS::writeSCSv(iov, iovcnt);
+	}
+	//queued bytes and the caller's segments in one gather write
+	v[0].iov_base = txBuf;
+	v[0].iov_len = txBufLen;
+	memcpy(v+1, iov, iovcnt*sizeof(struct iovec));
+	txLastLen += txBufLen+nLen;
+	txBufLen = 0;
+	if(Capture){
+		Capture->add(SCS_CAP_TX, v, iovcnt+1, monoUs());
+	}
+	if(Echo){
+		EchoLen += v[0].iov_len+nLen;
+	}
+	if(!Fault && Transport){
+		Transport->writev(v, iovcnt+1);
+	}else if(!Fault){
+		txWrite(v, iovcnt+1, v[0].iov_len+nLen);
+	}
+	return nLen;
+}
+
+int SCSerial::writeSCS(unsigned char bDat)
+{
+	if(txBufLen>=(int)sizeof(txBuf)){
+		wFlushSCS();
+	}
+	txBuf[txBufLen++] = bDat;
+	return txBufLen;
+}
+
+void SCSerial::rFlushSCS()
+{
+	if(EchoLen){
+		//the echo of a request without reply may still be on its way
+		echoSkip(monoUs()+wireUs(EchoLen)+TimeOutMarginUs+1000);
+		EchoLen = 0;
+	}
+	if(Transport){
+		Transport->flush();
+		return;
+	}
+	tcflush(fd, TCIFLUSH);
+	rxHead = rxTail = 0;
+	rxRingUs = 0;
+}
+
+void SCSerial::wFlushSCS()
+{
+	if(txBufLen){
+		txLastLen += txBufLen;
+		if(Capture){
+			Capture->add(SCS_CAP_TX, txBuf, txBufLen, monoUs());
+		}
+		if(Echo){
+			EchoLen += txBufLen;
+		}
+		if(!Fault && Transport){
+			Transport->write(txBuf, txBufLen);
+		}else if(!Fault){
+			struct iovec iov;
+			iov.iov_base = txBuf;
+			iov.iov_len = txBufLen;
+			txWrite(&iov, 1, txBufLen);
+		}
+		txBufLen = 0;
+	}
+}
+
+//Errors that mean the adapter is gone: USB unplug gives EIO or ENODEV,
+//a hangup reads as end of file, a transport reports a closed or reset
+//stream as EPIPE or ECONNRESET. Timeouts and EAGAIN are not faults.
+int SCSerial::ioFault(int err)
+{
+	if(err!=EIO && err!=ENODEV && err!=ENXIO && err!=EBADF && err!=EPIPE && err!=ECONNRESET){
+		return 0;
+	}
+	if(!Fault){
+		Faults++;
+		if(Trace){
+			Trace->fault(TraceTag, err);
+		}
+	}
+	Fault = err;
+	return 1;
+}
+
+//The path of the last begin() is opened again, a /dev/serial/by-id link
+//finds the adapter even when it comes back under another ttyUSB number.
+//RS485 driver mode is set again, other tty settings (setLowLatency,
+//setLatencyTimer) are up to the caller. An injected transport is asked
+//to reopen() its link (SCSTcpTransport connects again).
+int SCSerial::reconnect()
+{
+	if(!Fault){
+		return 1;
+	}
+	if(Transport){
+		if(Transport->reopen()!=1){
+			return 0;
+		}
+		Fault = 0;
+		EchoLen = 0;
+		rxDirty = 1;
+		Reconnects++;
+		return 1;
+	}
+	if(!PortPath[0]){
+		return 0;
+	}
+	int Rate = baudRate;
+	int Mode = Dir;
+	u8 saved = Verbose;
+	Verbose = 0;
+	int Ok = begin(Rate, PortPath);
+	Verbose = saved;
+	if(!Ok){
+		closePort();
+		Fault = ENODEV;
+		return 0;
+	}
+	if(Mode==SCSERIAL_DIR_RS485){
+		setDirection(Mode, -1, DirActiveLow, DirTurnUs);
+	}
+	EchoLen = 0;
+	rxDirty = 1;
+	Reconnects++;
+	return 1;
+}
+
+void SCSerial::end()
+{
+	if(Transport){
+		Transport->close();
+		Transport = NULL;
+	}
+	if(DirFd != -1){
+		close(DirFd);
+		DirFd = -1;
+	}
+	Dir = SCSERIAL_DIR_NONE;
+	EchoLen = 0;
+	closePort();
+}
+
+//SyncRead of the block first; if no servo answers it, or the firmware is
+//known to lack it, the same reads go out pipelined in SCSBatch chunks,
+//the payloads are kept in syncReadRxBuff
+int SCSerial::feedBackRx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, SyncReadRx rx[])
+{
+	if(IDN>0xfe){
+		IDN = 0xfe;
+	}
+	for(u8 i=0; i<IDN; i++){
+		rx[i].Valid = 0;
+		rx[i].Stamp = 0;
+	}
+	if(!IDN){
+		return 0;
+	}
+	syncReadBegin(IDN, nLen);
+	int rxNum = 0;
+	if(!NoSyncRead){
+		syncReadPacketTx(ID, IDN, MemAddr, nLen);
+		u8 tabLen = 0;
+		for(u8 i=0; i<IDN; i++){
+			if(ID[i]>=tabLen){
+				tabLen = ID[i]+1;
+			}
+		}
+		SyncReadRx rxTab[0xfe];
+		if(tabLen>0xfe){
+			tabLen = 0xfe;
+		}
+		rxNum = syncReadPacketRxAll(rxTab, tabLen);
+		for(u8 i=0; i<IDN; i++){
+			if(ID[i]<tabLen){
+				rx[i] = rxTab[ID[i]];
+			}
+		}
+		if(rxNum){
+			SyncReadMisses = 0;
+			return rxNum;
+		}
+	}
+	SCSBatch Batch;
+	u8 *Raw = syncReadRxBuff;
+	for(u8 k=0; k<IDN; k+=SCS_BATCH_MAX){
+		Batch.clear();
+		u8 n = IDN-k<SCS_BATCH_MAX ? IDN-k : SCS_BATCH_MAX;
+		for(u8 i=0; i<n; i++){
+			Batch.read(ID[k+i], MemAddr, Raw+(k+i)*nLen, nLen);
+		}
+		batchExec(&Batch);
+		for(u8 i=0; i<n; i++){
+			SCSBatchReq *req = Batch.Req+i;
+			if(req->Valid){
+				rx[k+i].Valid = 1;
+				rx[k+i].Error = req->Error;
+				rx[k+i].Dat = req->nDat;
+				rx[k+i].Stamp = req->Stamp;
+				rxNum++;
+			}
+		}
+	}
+	//one lost SyncRead (noise, a servo still booting) is not a firmware without it
+	if(rxNum && !NoSyncRead && ++SyncReadMisses>=SCSERIAL_SYNC_MISSES){
+		NoSyncRead = 1;
+	}
+	return rxNum;
+}
@@ -1,48 +1,201 @@
-﻿/*
- * SCSerial.h
- * 飞特串行舵机硬件接口层程序
- * 日期: 2022.3.29
- * 作者: 
- */
-
-#ifndef _SCSERIAL_H
-#define _SCSERIAL_H
-
-#include "SCS.h"
-#include <stdio.h>
-#include <termios.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <string.h>
-#include <sys/select.h>
-
-class SCSerial : public SCS
-{
-public:
-	SCSerial();
-	SCSerial(u8 End);
-	SCSerial(u8 End, u8 Level);
-
-protected:
-	int writeSCS(unsigned char *nDat, int nLen);//输出nLen字节
-	int readSCS(unsigned char *nDat, int nLen);//输入nLen字节
-	int writeSCS(unsigned char bDat);//输出1字节
-	void rFlushSCS();//
-	void wFlushSCS();//
-public:
-	unsigned long int IOTimeOut;//输入输出超时
-	int Err;
-public:
-	virtual int getErr(){  return Err;  }
-	virtual int setBaudRate(int baudRate);
-	virtual bool begin(int baudRate, const char* serialPort);
-	virtual void end();
-protected:
-    int fd;//serial port handle
-    struct termios orgopt;//fd ort opt
-	struct termios curopt;//fd cur opt
-	unsigned char txBuf[255];
-	int txBufLen;
-};
-
+﻿/*
+ * SCSerial.h
+ * 飞特串行舵机硬件接口层程序
+ * 日期: 2022.3.29
+ * 作者: 
+ */
+
+#ifndef _SCSERIAL_H
+#define _SCSERIAL_H
+
+#include "SCS.h"
+#include "SCSTransport.h"
+#include "Telemetry.h"
+#include "SCSRegMap.h"
+#include <stdio.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/epoll.h>
+
+#define SCSERIAL_RX_RING 4096//receive ring size, power of 2
+#define SCSERIAL_BAUD_AUTO 0//begin() baud rate: probe the servo rate table
+#define SCSERIAL_BAUD_CODES 8
+#define SCSERIAL_EEPROM_US 10000//settle time after an EEPROM write
+#define SCSERIAL_SYNC_MISSES 3//SyncFeedBack() calls in a row without a SyncRead reply before NoSyncRead is set
+#define SCSERIAL_PATH 128//longest port path kept for reconnect()
+
+#define SCSERIAL_DIR_NONE 0//full duplex, or a transceiver that switches by itself
+#define SCSERIAL_DIR_RTS 1//RTS drives DE/RE, switched around every write
+#define SCSERIAL_DIR_RS485 2//TIOCSRS485, the UART driver drives RTS
+#define SCSERIAL_DIR_GPIO 3//sysfs GPIO line drives DE/RE
+
+class SCSCapture;
+
+class SCSerial : public SCS
+{
+public:
+	SCSerial();
+	SCSerial(u8 End);
+	SCSerial(u8 End, u8 Level);
+	virtual ~SCSerial();
+
+protected:
+	int writeSCS(unsigned char *nDat, int nLen);//输出nLen字节
+	int readSCS(unsigned char *nDat, int nLen);//输入nLen字节
+	int writeSCS(unsigned char bDat);//输出1字节
+	void rFlushSCS();//
+	void wFlushSCS();//
+	int writeSCSv(const struct iovec *iov, int iovcnt);//small frames are queued in txBuf, larger ones go out with writev in place
+public:
+	unsigned long int IOTimeOut;//输入输出超时
+	u8 AdaptiveTimeOut;//1: derive each read timeout from reply length and baud rate instead of IOTimeOut
+	unsigned long int TimeOutMarginUs;//adaptive timeout margin (USB latency, scheduling)
+	unsigned long int ReturnDelayUs;//servo return delay per status packet
+	int Err;
+	u8 DirDrain;//1 (default): release the line after tcdrain(), 0: after the computed frame time
+	u32 EchoSkipped;//echo bytes dropped
+	int Fault;//errno of a lost port (EIO, ENODEV ...), 0 if healthy; while set every transfer fails at once
+	u32 Faults;//times the port was lost
+	u32 Reconnects;//successful reconnect() calls
+	u8 Verbose;//1 (default): begin() reports the line rate on stdout
+	u8 NoSyncRead;//1: firmware without SYNC_READ, SyncFeedBack() uses pipelined reads (set on its own after SCSERIAL_SYNC_MISSES calls in a row only those answer)
+	u8 SyncReadMisses;//consecutive SyncFeedBack() calls answered by the pipelined reads only
+public:
+	virtual int getErr(){  return Err;  }
+	virtual int setBaudRate(int baudRate);
+	int getBaudRate(){  return baudRate;  }
+	virtual int SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[]){  return 0;  }//one SyncRead of the feedback registers, overridden by the series that support it
+	virtual int FeedBack(int ID, Telemetry *Tel){  return -1;  }//FeedBack() into caller storage, no shared state, overridden by every series
+	int detectBaudRate(unsigned long int marginUs = 3000);//broadcast ping at each table rate, returns the rate that answers (port left there) or -1
+	int rebaudAll(int baudRate, u8 BaudAddr, u8 LockAddr, unsigned long int marginUs = 3000);//move the servos of every table rate to baudRate, returns rates moved, -1 if none answers afterwards
+	static int baudCode(int baudRate);//rate to servo baud code, -1 if not in the table
+	static const int baudTable[SCSERIAL_BAUD_CODES];
+	int setLowLatency(u8 Enable);//ASYNC_LOW_LATENCY on the tty driver
+	int setLatencyTimer(int ms);//USB-serial (FTDI) latency timer through sysfs, default 16ms
+	int getLatencyTimer();//latency timer in ms, -1 if the port is not USB-serial
+	int getLowLatency();//1 if ASYNC_LOW_LATENCY is set, -1 if the driver has no serial_struct
+	int setReadMode(u8 vMin, u8 vTime);//termios VMIN/VTIME of the built-in port, kept over rate changes
+	virtual bool begin(int baudRate, const char* serialPort);
+	bool begin(SCSTransport *transport, int baudRate = 1000000);//run over a transport instead of the built-in port, baudRate of the servo bus for adaptive timeouts
+	SCSTransport *getTransport(){  return Transport;  }
+	int setDirection(int Mode, int Gpio = -1, u8 ActiveLow = 0, unsigned long int TurnUs = 0);//half-duplex RS485 direction control of the built-in port, after begin(); TurnUs holds the line after the last stop bit
+	void setEcho(u8 Enable){  Echo = Enable;  EchoLen = 0;  }//drop our own transmitted bytes read back by the transceiver
+	void setCapture(SCSCapture *capture){  Capture = capture;  }//record every frame sent and every byte received, NULL stops
+	static int applySpeed(int fd, struct termios *opt, int baudRate);//set opt and the line rate of a tty, termios2/BOTHER for non-standard rates
+	virtual void end();
+	int reconnect();//reopen the port of the last begin() after a fault at the current rate, 1 on success (also when healthy)
+	const char *getPath(){  return PortPath;  }
+	int rxPoll(int timeOutUs = 0);//pull ready bytes into the receive ring, waits at most timeOutUs, returns bytes buffered
+	int rxAvailable(){  return rxHead-rxTail;  }//bytes buffered in the receive ring
+	int sendRaw(const u8 *nDat, int nLen);//write prebuilt frames now, for layers that frame their own requests
+	int recvRaw(u8 *nDat, int nLen);//received bytes that are already there, never waits
+	int getFd(){  return fd;  }
+	int getEpollFd(){  return epfd;  }//can be added to an outer epoll set to service several buses
+	void setAdaptiveTimeOut(unsigned long int marginUs, unsigned long int returnDelayUs = 0);//enable baud-aware timeouts
+	long rxTimeOutUs(int nLen);//timeout for a reply of nLen bytes
+	template<class Map> static void decodeFeedBack(const u8 *d, u8 Error, Telemetry *t)//Map::FeedBack block at d into t
+	{
+		typedef typename Map::FeedBack FB;
+		t->Position = FB::template get<typename Map::PresentPosition, Map::End>(d);
+		t->Speed = FB::template get<typename Map::PresentSpeed, Map::End>(d);
+		t->Load = FB::template get<typename Map::PresentLoad, Map::End>(d);
+		t->Current = FB::template get<typename Map::PresentCurrent, Map::End>(d);
+		t->Voltage = FB::template get<typename Map::PresentVoltage, Map::End>(d);
+		t->Temperature = FB::template get<typename Map::PresentTemperature, Map::End>(d);
+		t->Moving = FB::template get<typename Map::Moving, Map::End>(d);
+		t->Error = Error;
+	}
+	static u64 monoUs();//CLOCK_MONOTONIC in us
+protected:
+	int feedBackRx(u8 ID[], u8 IDN, u8 MemAddr, u8 nLen, SyncReadRx rx[]);//one SyncRead (or pipelined reads) of IDN servos, rx[i] belongs to ID[i]
+	template<class Map> int feedBack(int ID, Telemetry *Tel)//FeedBack(ID, Tel) of a series, returns the block length or -1
+	{
+		typedef typename Map::FeedBack FB;
+		u8 d[FB::len];
+		SCSReply Reply;
+		u64 Stamp = monoUs();
+		Tel->Valid = Read(ID, FB::addr, d, FB::len, &Reply)==FB::len;
+		Tel->Stamp = Reply.Stamp ? Reply.Stamp : Stamp;
+		if(!Tel->Valid){
+			return -1;
+		}
+		decodeFeedBack<Map>(d, Reply.Error, Tel);
+		return FB::len;
+	}
+	template<class Map> int syncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[])//SyncFeedBack() of a series, decoded with the sign conventions of Map
+	{
+		typedef typename Map::FeedBack FB;
+		SCSLock Guard(this);//rx[].Dat points into the shared reply buffer
+		SyncReadRx rx[0xfe];
+		if(IDN>0xfe){
+			IDN = 0xfe;
+		}
+		u64 Stamp = monoUs();
+		int rxNum = feedBackRx(ID, IDN, FB::addr, FB::len, rx);
+		for(u8 i=0; i<IDN; i++){
+			Telemetry *t = Tel+i;
+			t->Stamp = rx[i].Stamp ? rx[i].Stamp : Stamp;
+			t->Valid = rx[i].Valid;
+			if(!t->Valid){
+				continue;
+			}
+			decodeFeedBack<Map>(rx[i].Dat, rx[i].Error, t);
+		}
+		return rxNum;
+	}
+	int readBytes(unsigned char *nDat, int nLen);//readSCS() without the capture hook
+	int latencyTimerPath(char *path, int size);//sysfs latency_timer of the port
+	void closePort();//restore orgopt, close fd and epfd
+	int ioFault(int err);//enter the fault state if err means the device is gone, returns 1 then
+	int rxFill();//read all ready bytes into the receive ring
+	int rxTake(unsigned char *nDat, int nLen);//consume up to nLen bytes from the receive ring
+	int rxWait(long timeOutUs);//wait for the serial fd to become readable
+	int txWrite(struct iovec *iov, int iovcnt, int nLen);//write to the built-in port with direction control
+	void dirSet(int Tx);
+	int echoSkip(u64 deadline);//drop pending echo bytes, 1 when none is left
+	int setSpeed(int baudRate);//standard Bxxx rate or termios2/BOTHER for any other rate
+	int probe(unsigned long int marginUs);//1 if anything answers a broadcast ping
+	u32 wireUs(int nLen);
+	template<class Map, class Reg> int readReg(int ID, const u8 *Mem)//one field of Map, ID=-1 decodes it from the FeedBack block in Mem
+	{
+		static_assert(Reg::addr>=Map::FeedBack::addr && Reg::addr+Reg::width<=Map::FeedBack::addr+Map::FeedBack::len, "readReg: field outside the FeedBack block");
+		u8 bBuf[Reg::width];
+		const u8 *p = Mem+Reg::addr-Map::FeedBack::addr;
+		if(ID!=-1){
+			Err = 0;
+			if(Read(ID, Reg::addr, bBuf, Reg::width)!=Reg::width){
+				Err = 1;
+				return -1;
+			}
+			p = bBuf;
+		}
+		return SCSField<Reg, Map::End>::decode(p);
+	}
+protected:
+    int fd;//serial port handle
+    struct termios orgopt;//fd ort opt
+	struct termios curopt;//fd cur opt
+	unsigned char txBuf[255];
+	int txBufLen;
+	int txLastLen;//bytes of the last flushed request, still on the wire when the reply wait starts
+	int baudRate;
+	int epfd;//epoll handle, fd is registered once in begin()
+	unsigned char rxRing[SCSERIAL_RX_RING];
+	unsigned int rxHead;
+	unsigned int rxTail;
+	u64 rxRingUs;//arrival of the oldest buffered bytes
+	SCSTransport *Transport;//NULL: built-in serial port, not owned
+	SCSCapture *Capture;//NULL: no capture, not owned
+	int Dir;//SCSERIAL_DIR_*
+	int DirFd;//GPIO value file
+	u8 DirActiveLow;
+	unsigned long int DirTurnUs;
+	u8 Echo;
+	int EchoLen;//bytes sent whose echo has not been read back yet
+	char PortPath[SCSERIAL_PATH];
+};
+
 #endif
\ No newline at end of file
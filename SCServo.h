@@ -1,15 +1,15 @@
-/*
- * SCServo.h
- * 飞特串行舵机接口
- * 日期: 2021.12.8
- * 作者: 
- */
-
-#ifndef _SCSERVO_H
-#define _SCSERVO_H
-
-#include "SMSBL.h" 
-#include "SCSCL.h"
-#include "SMSCL.h"
-#include "SMS_STS.h"
+/*
+ * SCServo.h
+ * 飞特串行舵机接口
+ * 日期: 2021.12.8
+ * 作者: 
+ */
+
+#ifndef _SCSERVO_H
+#define _SCSERVO_H
+
+#include "SMSBL.h" 
+#include "SCSCL.h"
+#include "SMSCL.h"
+#include "SMS_STS.h"
 #endif
\ No newline at end of file
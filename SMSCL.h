@@ -1,109 +1,151 @@
-/*
- * SMSCL.h
- * SMSCLϵджӿ
- * : 2020.6.17
- * : 
- */
-
-#ifndef _SMSCL_H
-#define _SMSCL_H
-
-
-#define	SMSCL_1M 0
-#define	SMSCL_0_5M 1
-#define	SMSCL_250K 2
-#define	SMSCL_128K 3
-#define	SMSCL_115200 4
-#define	SMSCL_76800	5
-#define	SMSCL_57600	6
-#define	SMSCL_38400	7
-
-//ڴ
-//-------EPROM(ֻ)--------
-#define SMSCL_VERSION_L 3
-#define SMSCL_VERSION_H 4
-
-//-------EPROM(д)--------
-#define SMSCL_ID 5
-#define SMSCL_BAUD_RATE 6
-#define SMSCL_RETURN_DELAY_TIME 7
-#define SMSCL_RETURN_LEVEL 8
-#define SMSCL_MIN_ANGLE_LIMIT_L 9
-#define SMSCL_MIN_ANGLE_LIMIT_H 10
-#define SMSCL_MAX_ANGLE_LIMIT_L 11
-#define SMSCL_MAX_ANGLE_LIMIT_H 12
-#define SMSCL_LIMIT_TEMPERATURE 13
-#define SMSCL_MAX_LIMIT_VOLTAGE 14
-#define SMSCL_MIN_LIMIT_VOLTAGE 15
-#define SMSCL_MAX_TORQUE_L 16
-#define SMSCL_MAX_TORQUE_H 17
-#define SMSCL_ALARM_LED 19
-#define SMSCL_ALARM_SHUTDOWN 20
-#define SMSCL_COMPLIANCE_P 21
-#define SMSCL_COMPLIANCE_D 22
-#define SMSCL_COMPLIANCE_I 23
-#define SMSCL_PUNCH_L 24
-#define SMSCL_PUNCH_H 25
-#define SMSCL_CW_DEAD 26
-#define SMSCL_CCW_DEAD 27
-#define SMSCL_OFS_L 33
-#define SMSCL_OFS_H 34
-#define SMSCL_MODE 35
-#define SMSCL_MAX_CURRENT_L 36
-#define SMSCL_MAX_CURRENT_H 37	
-
-//-------SRAM(д)--------
-#define SMSCL_TORQUE_ENABLE 40
-#define SMSCL_ACC 41
-#define SMSCL_GOAL_POSITION_L 42
-#define SMSCL_GOAL_POSITION_H 43
-#define SMSCL_GOAL_TIME_L 44
-#define SMSCL_GOAL_TIME_H 45
-#define SMSCL_GOAL_SPEED_L 46
-#define SMSCL_GOAL_SPEED_H 47
-#define SMSCL_LOCK 48
-
-//-------SRAM(ֻ)--------
-#define SMSCL_PRESENT_POSITION_L 56
-#define SMSCL_PRESENT_POSITION_H 57
-#define SMSCL_PRESENT_SPEED_L 58
-#define SMSCL_PRESENT_SPEED_H 59
-#define SMSCL_PRESENT_LOAD_L 60
-#define SMSCL_PRESENT_LOAD_H 61
-#define SMSCL_PRESENT_VOLTAGE 62
-#define SMSCL_PRESENT_TEMPERATURE 63
-#define SMSCL_REGISTERED_INSTRUCTION 64
-#define SMSCL_MOVING 66
-#define SMSCL_PRESENT_CURRENT_L 69
-#define SMSCL_PRESENT_CURRENT_H 70
-
-#include "SCSerial.h"
-
-class SMSCL : public SCSerial
-{
-public:
-	SMSCL();
-	SMSCL(u8 End);
-	SMSCL(u8 End, u8 Level);
-	virtual int WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0);//ͨдλָ
-	virtual int RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0);//첽дλָ(RegWriteActionЧ)
-	virtual void SyncWritePosEx(u8 ID[], u8 IDN, s16 Position[], u16 Speed[], u8 ACC[]);//ͬдλָ
-	virtual int WheelMode(u8 ID);//ģʽ
-	virtual int WriteSpe(u8 ID, s16 Speed, u8 ACC = 0);//ģʽָ
-	virtual int EnableTorque(u8 ID, u8 Enable);//Ťָ
-	virtual int unLockEprom(u8 ID);//eprom
-	virtual int LockEprom(u8 ID);//eprom
-	virtual int CalibrationOfs(u8 ID);//λУ׼
-	virtual int FeedBack(int ID);//Ϣ
-	virtual int ReadPos(int ID);//λ
-	virtual int ReadSpeed(int ID);//ٶ
-	virtual int ReadLoad(int ID);//ĵѹٷֱ(0~1000)
-	virtual int ReadVoltage(int ID);//ѹ
-	virtual int ReadTemper(int ID);//¶
-	virtual int ReadMove(int ID);////ƶ״̬
-	virtual int ReadCurrent(int ID);//
-private:
-	u8 Mem[SMSCL_PRESENT_CURRENT_H-SMSCL_PRESENT_POSITION_L+1];
-};
-
+/*
+ * SMSCL.h
+ * SMSCLϵджӿ
+ * : 2020.6.17
+ * : 
+ */
+
+#ifndef _SMSCL_H
+#define _SMSCL_H
+
+
+#define	SMSCL_1M 0
+#define	SMSCL_0_5M 1
+#define	SMSCL_250K 2
+#define	SMSCL_128K 3
+#define	SMSCL_115200 4
+#define	SMSCL_76800	5
+#define	SMSCL_57600	6
+#define	SMSCL_38400	7
+
+//ڴ
+//-------EPROM(ֻ)--------
+#define SMSCL_VERSION_L 3
+#define SMSCL_VERSION_H 4
+
+//-------EPROM(д)--------
+#define SMSCL_ID 5
+#define SMSCL_BAUD_RATE 6
+#define SMSCL_RETURN_DELAY_TIME 7
+#define SMSCL_RETURN_LEVEL 8
+#define SMSCL_MIN_ANGLE_LIMIT_L 9
+#define SMSCL_MIN_ANGLE_LIMIT_H 10
+#define SMSCL_MAX_ANGLE_LIMIT_L 11
+#define SMSCL_MAX_ANGLE_LIMIT_H 12
+#define SMSCL_LIMIT_TEMPERATURE 13
+#define SMSCL_MAX_LIMIT_VOLTAGE 14
+#define SMSCL_MIN_LIMIT_VOLTAGE 15
+#define SMSCL_MAX_TORQUE_L 16
+#define SMSCL_MAX_TORQUE_H 17
+#define SMSCL_ALARM_LED 19
+#define SMSCL_ALARM_SHUTDOWN 20
+#define SMSCL_COMPLIANCE_P 21
+#define SMSCL_COMPLIANCE_D 22
+#define SMSCL_COMPLIANCE_I 23
+#define SMSCL_PUNCH_L 24
+#define SMSCL_PUNCH_H 25
+#define SMSCL_CW_DEAD 26
+#define SMSCL_CCW_DEAD 27
+#define SMSCL_OFS_L 33
+#define SMSCL_OFS_H 34
+#define SMSCL_MODE 35
+#define SMSCL_MAX_CURRENT_L 36
+#define SMSCL_MAX_CURRENT_H 37	
+
+//-------SRAM(д)--------
+#define SMSCL_TORQUE_ENABLE 40
+#define SMSCL_ACC 41
+#define SMSCL_GOAL_POSITION_L 42
+#define SMSCL_GOAL_POSITION_H 43
+#define SMSCL_GOAL_TIME_L 44
+#define SMSCL_GOAL_TIME_H 45
+#define SMSCL_GOAL_SPEED_L 46
+#define SMSCL_GOAL_SPEED_H 47
+#define SMSCL_LOCK 48
+
+//-------SRAM(ֻ)--------
+#define SMSCL_PRESENT_POSITION_L 56
+#define SMSCL_PRESENT_POSITION_H 57
+#define SMSCL_PRESENT_SPEED_L 58
+#define SMSCL_PRESENT_SPEED_H 59
+#define SMSCL_PRESENT_LOAD_L 60
+#define SMSCL_PRESENT_LOAD_H 61
+#define SMSCL_PRESENT_VOLTAGE 62
+#define SMSCL_PRESENT_TEMPERATURE 63
+#define SMSCL_REGISTERED_INSTRUCTION 64
+#define SMSCL_MOVING 66
+#define SMSCL_PRESENT_CURRENT_L 69
+#define SMSCL_PRESENT_CURRENT_H 70
+
+#include "SCSerial.h"
+
+//Control table of the series, End is the fixed byte order of the model
+struct SMSCL_Map{
+	enum{ End = 0 };
+	typedef SCSByteOrder<End> Order;
+	typedef SMSCL_Map Map;
+	typedef SCSReg<SMSCL_VERSION_L, 2, 0, SCS_REG_R|SCS_REG_EPROM> Version;
+	typedef SCSReg<SMSCL_ID, 1, 0, SCS_REG_RW|SCS_REG_EPROM> ID;
+	typedef SCSReg<SMSCL_BAUD_RATE, 1, 0, SCS_REG_RW|SCS_REG_EPROM> BaudRate;
+	typedef SCSReg<SMSCL_MIN_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MinAngleLimit;
+	typedef SCSReg<SMSCL_MAX_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MaxAngleLimit;
+	typedef SCSReg<SMSCL_CW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CwDead;
+	typedef SCSReg<SMSCL_CCW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CcwDead;
+	typedef SCSReg<SMSCL_OFS_L, 2, 11, SCS_REG_RW|SCS_REG_EPROM> Ofs;
+	typedef SCSReg<SMSCL_MODE, 1, 0, SCS_REG_RW|SCS_REG_EPROM> Mode;
+	typedef SCSReg<SMSCL_TORQUE_ENABLE, 1> TorqueEnable;
+	typedef SCSReg<SMSCL_ACC, 1> Acc;
+	typedef SCSReg<SMSCL_GOAL_POSITION_L, 2, 15> GoalPosition;
+	typedef SCSReg<SMSCL_GOAL_TIME_L, 2, 10> GoalTime;//PWM in open-loop mode
+	typedef SCSReg<SMSCL_GOAL_SPEED_L, 2, 15> GoalSpeed;
+	typedef SCSReg<SMSCL_LOCK, 1> Lock;
+	typedef SCSReg<SMSCL_PRESENT_POSITION_L, 2, 15, SCS_REG_R> PresentPosition;
+	typedef SCSReg<SMSCL_PRESENT_SPEED_L, 2, 15, SCS_REG_R> PresentSpeed;
+	typedef SCSReg<SMSCL_PRESENT_LOAD_L, 2, 10, SCS_REG_R> PresentLoad;
+	typedef SCSReg<SMSCL_PRESENT_VOLTAGE, 1, 0, SCS_REG_R> PresentVoltage;
+	typedef SCSReg<SMSCL_PRESENT_TEMPERATURE, 1, 0, SCS_REG_R> PresentTemperature;
+	typedef SCSReg<SMSCL_MOVING, 1, 0, SCS_REG_R> Moving;
+	typedef SCSReg<SMSCL_PRESENT_CURRENT_L, 2, 15, SCS_REG_R> PresentCurrent;
+	typedef SCSRegBlock<PresentPosition, PresentCurrent> FeedBack;//block read by FeedBack() into Mem
+};
+
+class SMSCL : public SCSerial
+{
+public:
+	typedef SMSCL_Map Map;//control table, see SCSRegMap.h
+	SMSCL();
+	SMSCL(u8 End);
+	SMSCL(u8 End, u8 Level);
+	virtual int WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0);//ͨдλָ
+	virtual int RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0);//첽дλָ(RegWriteActionЧ)
+	virtual void SyncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[]);//ͬдλָ
+	virtual void SyncWritePosCompact(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[]);//SyncWritePosEx, only the goal positions while ACC and speed stay as last sent
+	virtual int WheelMode(u8 ID);//ģʽ
+	virtual int WriteSpe(u8 ID, s16 Speed, u8 ACC = 0);//ģʽָ
+	virtual int EnableTorque(u8 ID, u8 Enable);//Ťָ
+	virtual int unLockEprom(u8 ID);//eprom
+	virtual int LockEprom(u8 ID);//eprom
+	virtual int RebaudAll(int baudRate);//move all servos, whatever their current rate, to baudRate
+	virtual int CalibrationOfs(u8 ID);//λУ׼
+	virtual int FeedBack(int ID);//Ϣ
+	virtual int FeedBack(int ID, Telemetry *Tel);//feedback into Tel instead of Mem, safe from several threads, returns -1 on timeout
+	virtual int ReadPos(int ID);//λ
+	virtual int ReadSpeed(int ID);//ٶ
+	virtual int ReadLoad(int ID);//ĵѹٷֱ(0~1000)
+	virtual int ReadVoltage(int ID);//ѹ
+	virtual int ReadTemper(int ID);//¶
+	virtual int ReadMove(int ID);////ƶ״̬
+	virtual int ReadCurrent(int ID);//
+	u64 getFeedBackUs(){  return FeedBackUs;  }//arrival of the FeedBack() data, 0 if unknown
+	virtual int SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[]);//feedback of IDN servos from one SyncRead (pipelined reads without firmware support) into Tel[0..IDN-1], returns number of valid entries
+	void resetPosCompact(u8 ID = 0xfe);//forget the ACC and speed last sent to ID (0xfe: all), e.g. after a servo reset
+public:
+	u32 PosCompact;//SyncWritePosCompact() frames sent with the goal position only
+private:
+	void syncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[], int Compact);//SyncWritePosEx() and SyncWritePosCompact()
+	u8 Mem[SMSCL_PRESENT_CURRENT_H-SMSCL_PRESENT_POSITION_L+1];
+	u64 FeedBackUs;//arrival of the status packet FeedBack() decoded into Mem, monotonic us, 0 if unknown
+	u8 PosExSent[SCS_MAX_ID][4];//ACC, speed bytes and a valid flag of the last full SyncWritePosEx block per ID
+};
+
 #endif
\ No newline at end of file
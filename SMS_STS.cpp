@@ -1,339 +1,397 @@
-﻿/*
- * SMS_STS.cpp
- * Feetech SMS/STS Series Serial Servo Application Layer Program
- * Date: 2021.12.8
- * Author: 
- */
-
-#include "SMS_STS.h"
-
-SMS_STS::SMS_STS()
-{
-	End = 0;
-}
-
-SMS_STS::SMS_STS(u8 End):SCSerial(End)
-{
-}
-
-SMS_STS::SMS_STS(u8 End, u8 Level):SCSerial(End, Level)
-{
-}
-
-int SMS_STS::WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC)
-{
-	if(Position<0){
-		Position = -Position;
-		Position |= (1<<15);
-	}
-	u8 bBuf[7];
-	bBuf[0] = ACC;
-	Host2SCS(bBuf+1, bBuf+2, Position);
-	Host2SCS(bBuf+3, bBuf+4, 0);
-	Host2SCS(bBuf+5, bBuf+6, Speed);
-	
-	return genWrite(ID, SMS_STS_ACC, bBuf, 7);
-}
-
-int SMS_STS::RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC)
-{
-	if(Position<0){
-		Position = -Position;
-		Position |= (1<<15);
-	}
-	u8 bBuf[7];
-	bBuf[0] = ACC;
-	Host2SCS(bBuf+1, bBuf+2, Position);
-	Host2SCS(bBuf+3, bBuf+4, 0);
-	Host2SCS(bBuf+5, bBuf+6, Speed);
-	
-	return regWrite(ID, SMS_STS_ACC, bBuf, 7);
-}
-
-void SMS_STS::SyncWritePosEx(u8 ID[], u8 IDN, s16 Position[], u16 Speed[], u8 ACC[])
-{
-    u8 offbuf[IDN][7];
-    for(u8 i = 0; i<IDN; i++){
-		if(Position[i]<0){
-			Position[i] = -Position[i];
-			Position[i] |= (1<<15);
-		}
-        u8 bBuf[7];
-		u16 V;
-		if(Speed){
-			V = Speed[i];
-		}else{
-			V = 0;
-		}
-		if(ACC){
-			bBuf[0] = ACC[i];
-		}else{
-			bBuf[0] = 0;
-		}
-        Host2SCS(bBuf+1, bBuf+2, Position[i]);
-        Host2SCS(bBuf+3, bBuf+4, 0);
-        Host2SCS(bBuf+5, bBuf+6, V);
-        memcpy(offbuf[i], bBuf, 7);
-    }
-    syncWrite(ID, IDN, SMS_STS_ACC, (u8*)offbuf, 7);
-}
-
-int SMS_STS::Mode(u8 ID, u8 mode)
-{
-	// Modes: 0 (servo mode), 1 (closed-loop) or 2 (open-loop)
-    // Mode 3 (stepper mode) is not implemented
-    if(!(mode == 0 || mode == 1 || mode == 2)){
-        Err = 1;
-        return -1;
-    }
-    Err = 0;
-    return writeByte(ID, SMS_STS_MODE, mode);		
-}
-
-int SMS_STS::WriteSpe(u8 ID, s16 Speed, u8 ACC)
-{
-	if(Speed<0){
-		Speed = -Speed;
-		Speed |= (1<<15);
-	}
-	u8 bBuf[2];
-	bBuf[0] = ACC;
-	genWrite(ID, SMS_STS_ACC, bBuf, 1);
-	Host2SCS(bBuf+0, bBuf+1, Speed);
-	
-	return genWrite(ID, SMS_STS_GOAL_SPEED_L, bBuf, 2);
-}
-
-int SMS_STS::RegWriteSpe(u8 ID, s16 Speed, u8 ACC)
-{
-	if(Speed<0){
-		Speed = -Speed;
-		Speed |= (1<<15);
-	}
-	u8 bBuf[2];
-	bBuf[0] = ACC;
-	regWrite(ID, SMS_STS_ACC, bBuf, 1);
-	Host2SCS(bBuf+0, bBuf+1, Speed);
-	
-	return regWrite(ID, SMS_STS_GOAL_SPEED_L, bBuf, 2);
-}
-
-void SMS_STS::SyncWriteSpe(u8 ID[], u8 IDN, s16 Speed[], u8 ACC[])
-{
-    u8 offbuf[IDN][2];
-    for(u8 i = 0; i<IDN; i++){
-		if(Speed[i]<0){
-			Speed[i] = -Speed[i];
-			Speed[i] |= (1<<15);
-		}
-        u8 bBuf[2];
-		if(ACC[i]){
-			bBuf[0] = ACC[i];
-		}else{
-			bBuf[0] = 0;
-		}
-        genWrite(ID[i], SMS_STS_ACC, bBuf, 1);
-        Host2SCS(bBuf+0, bBuf+1, Speed[i]);
-        memcpy(offbuf[i], bBuf, 2);
-    }
-    syncWrite(ID, IDN, SMS_STS_GOAL_SPEED_L, (u8*)offbuf, 2);
-}
-
-int SMS_STS::WritePwm(u8 ID, s16 Pwm)
-{
-    if(Pwm<0){
-        Pwm = -Pwm;
-        Pwm |= (1<<10);
-    }
-    u8 bBuf[2];
-    Host2SCS(bBuf+0, bBuf+1, Pwm);
-    
-    return genWrite(ID, SMS_STS_GOAL_TIME_L, bBuf, 2);
-}
-
-int SMS_STS::RegWritePwm(u8 ID, s16 Pwm)
-{
-    if(Pwm<0){
-        Pwm = -Pwm;
-        Pwm |= (1<<10);
-    }
-    u8 bBuf[2];
-    Host2SCS(bBuf+0, bBuf+1, Pwm);
-    
-    return regWrite(ID, SMS_STS_GOAL_TIME_L, bBuf, 2);
-}
-
-void SMS_STS::SyncWritePwm(u8 ID[], u8 IDN, s16 Pwm[])
-{
-    u8 offbuf[IDN][2];
-    for(u8 i = 0; i<IDN; i++){
-		if(Pwm[i]<0){
-			Pwm[i] = -Pwm[i];
-			Pwm[i] |= (1<<10);
-		}
-        u8 bBuf[2];
-        Host2SCS(bBuf+0, bBuf+1, Pwm[i]);
-        memcpy(offbuf[i], bBuf, 2);
-    }
-    syncWrite(ID, IDN, SMS_STS_GOAL_TIME_L, (u8*)offbuf, 2);
-}
-
-int SMS_STS::EnableTorque(u8 ID, u8 Enable)
-{
-	return writeByte(ID, SMS_STS_TORQUE_ENABLE, Enable);
-}
-
-int SMS_STS::unLockEprom(u8 ID)
-{
-	return writeByte(ID, SMS_STS_LOCK, 0);
-}
-
-int SMS_STS::LockEprom(u8 ID)
-{
-	return writeByte(ID, SMS_STS_LOCK, 1);
-}
-
-int SMS_STS::CalibrationOfs(u8 ID)
-{
-	return writeByte(ID, SMS_STS_TORQUE_ENABLE, 128);
-}
-
-int SMS_STS::FeedBack(int ID)
-{
-	int nLen = Read(ID, SMS_STS_PRESENT_POSITION_L, Mem, sizeof(Mem));
-	if(nLen!=sizeof(Mem)){
-		Err = 1;
-		return -1;
-	}
-	Err = 0;
-	return nLen;
-}
-
-int SMS_STS::ReadPos(int ID)
-{
-	int Pos = -1;
-	if(ID==-1){
-		Pos = Mem[SMS_STS_PRESENT_POSITION_H-SMS_STS_PRESENT_POSITION_L];
-		Pos <<= 8;
-		Pos |= Mem[SMS_STS_PRESENT_POSITION_L-SMS_STS_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Pos = readWord(ID, SMS_STS_PRESENT_POSITION_L);
-		if(Pos==-1){
-			Err = 1;
-		}
-	}
-	if(!Err && (Pos&(1<<15))){
-		Pos = -(Pos&~(1<<15));
-	}
-	
-	return Pos;
-}
-
-int SMS_STS::ReadSpeed(int ID)
-{
-	int Speed = -1;
-	if(ID==-1){
-		Speed = Mem[SMS_STS_PRESENT_SPEED_H-SMS_STS_PRESENT_POSITION_L];
-		Speed <<= 8;
-		Speed |= Mem[SMS_STS_PRESENT_SPEED_L-SMS_STS_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Speed = readWord(ID, SMS_STS_PRESENT_SPEED_L);
-		if(Speed==-1){
-			Err = 1;
-			return -1;
-		}
-	}
-	if(!Err && (Speed&(1<<15))){
-		Speed = -(Speed&~(1<<15));
-	}	
-	return Speed;
-}
-
-int SMS_STS::ReadLoad(int ID)
-{
-	int Load = -1;
-	if(ID==-1){
-		Load = Mem[SMS_STS_PRESENT_LOAD_H-SMS_STS_PRESENT_POSITION_L];
-		Load <<= 8;
-		Load |= Mem[SMS_STS_PRESENT_LOAD_L-SMS_STS_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Load = readWord(ID, SMS_STS_PRESENT_LOAD_L);
-		if(Load==-1){
-			Err = 1;
-		}
-	}
-	if(!Err && (Load&(1<<10))){
-		Load = -(Load&~(1<<10));
-	}
-	return Load;
-}
-
-int SMS_STS::ReadVoltage(int ID)
-{	
-	int Voltage = -1;
-	if(ID==-1){
-		Voltage = Mem[SMS_STS_PRESENT_VOLTAGE-SMS_STS_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Voltage = readByte(ID, SMS_STS_PRESENT_VOLTAGE);
-		if(Voltage==-1){
-			Err = 1;
-		}
-	}
-	return Voltage;
-}
-
-int SMS_STS::ReadTemper(int ID)
-{	
-	int Temper = -1;
-	if(ID==-1){
-		Temper = Mem[SMS_STS_PRESENT_TEMPERATURE-SMS_STS_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Temper = readByte(ID, SMS_STS_PRESENT_TEMPERATURE);
-		if(Temper==-1){
-			Err = 1;
-		}
-	}
-	return Temper;
-}
-
-int SMS_STS::ReadMove(int ID)
-{
-	int Move = -1;
-	if(ID==-1){
-		Move = Mem[SMS_STS_MOVING-SMS_STS_PRESENT_POSITION_L];	
-	}else{
-		Err = 0;
-		Move = readByte(ID, SMS_STS_MOVING);
-		if(Move==-1){
-			Err = 1;
-		}
-	}
-	return Move;
-}
-
-int SMS_STS::ReadCurrent(int ID)
-{
-	int Current = -1;
-	if(ID==-1){
-		Current = Mem[SMS_STS_PRESENT_CURRENT_H-SMS_STS_PRESENT_POSITION_L];
-		Current <<= 8;
-		Current |= Mem[SMS_STS_PRESENT_CURRENT_L-SMS_STS_PRESENT_POSITION_L];
-	}else{
-		Err = 0;
-		Current = readWord(ID, SMS_STS_PRESENT_CURRENT_L);
-		if(Current==-1){
-			Err = 1;
-			return -1;
-		}
-	}
-	if(!Err && (Current&(1<<15))){
-		Current = -(Current&~(1<<15));
-	}	
-	return Current;
-}
-
+﻿/*
+ * SMS_STS.cpp
+ * Feetech SMS/STS Series Serial Servo Application Layer Program
+ * Date: 2021.12.8
+ * Author: 
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "SMS_STS.h"
+
+SMS_STS::SMS_STS()
+{
+	End = 0;
+	FeedBackUs = 0;
+	PosCompact = 0;
+	memset(PosExSent, 0, sizeof(PosExSent));
+}
+
+SMS_STS::SMS_STS(u8 End):SCSerial(End)
+{
+	FeedBackUs = 0;
+	PosCompact = 0;
+	memset(PosExSent, 0, sizeof(PosExSent));
+}
+
+SMS_STS::SMS_STS(u8 End, u8 Level):SCSerial(End, Level)
+{
+	FeedBackUs = 0;
+	PosCompact = 0;
+	memset(PosExSent, 0, sizeof(PosExSent));
+}
+
+int SMS_STS::WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC)
+{
+	resetPosCompact(ID);
+	if(Position<0){
+		Position = -Position;
+		Position |= (1<<15);
+	}
+	u8 bBuf[7];
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+1, Position);
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return genWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+int SMS_STS::RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC)
+{
+	resetPosCompact(ID);
+	if(Position<0){
+		Position = -Position;
+		Position |= (1<<15);
+	}
+	u8 bBuf[7];
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+1, Position);
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return regWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+void SMS_STS::SyncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[])
+{
+	syncWritePosEx(ID, IDN, Position, Speed, ACC, 0);
+}
+
+void SMS_STS::SyncWritePosCompact(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[])
+{
+	syncWritePosEx(ID, IDN, Position, Speed, ACC, 1);
+}
+
+//With Compact, when every servo of the call already got the same ACC
+//and speed from an earlier full block, only the goal positions are sent
+//(2 instead of 7 bytes per servo). ACC or speed written some other way
+//(genWrite, SCSShadow, prepared frames) is not seen here, call
+//resetPosCompact() after such writes.
+void SMS_STS::syncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[], int Compact)
+{
+	typedef SMS_STS_Map M;
+	typedef SCSRegBlock<M::Acc, M::GoalSpeed> Blk;
+	const int SpeedOff = M::GoalSpeed::addr-Blk::addr;
+	if(IDN>SCS_SYNC_WRITE_IDS){
+		return;
+	}
+	u8 *p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=Blk::len){
+		Blk::set<M::Acc, M::End>(p, ACC ? ACC[i] : 0);
+		Blk::set<M::GoalPosition, M::End>(p, Position[i]);
+		Blk::set<M::GoalTime, M::End>(p, 0);
+		Blk::set<M::GoalSpeed, M::End>(p, Speed ? Speed[i] : 0);
+		const u8 *Sent = PosExSent[ID[i]<SCS_MAX_ID ? ID[i] : 0];
+		if(ID[i]>=SCS_MAX_ID || !Sent[3] || Sent[0]!=p[0] || Sent[1]!=p[SpeedOff] || Sent[2]!=p[SpeedOff+1]){
+			Compact = 0;
+		}
+	}
+	if(Compact){
+		for(u8 i = 0; i<IDN; i++){
+			memmove(syncWriteBuf+i*M::GoalPosition::width, syncWriteBuf+i*Blk::len+M::GoalPosition::addr-Blk::addr, M::GoalPosition::width);
+		}
+		PosCompact++;
+		syncWrite(ID, IDN, M::GoalPosition::addr, syncWriteBuf, M::GoalPosition::width);
+		return;
+	}
+	p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=Blk::len){
+		if(ID[i]<SCS_MAX_ID){
+			u8 *Sent = PosExSent[ID[i]];
+			Sent[0] = p[0];
+			Sent[1] = p[SpeedOff];
+			Sent[2] = p[SpeedOff+1];
+			Sent[3] = 1;
+		}
+	}
+	syncWrite(ID, IDN, Blk::addr, syncWriteBuf, Blk::len);
+}
+
+void SMS_STS::resetPosCompact(u8 ID)
+{
+	if(ID>=SCS_MAX_ID){
+		memset(PosExSent, 0, sizeof(PosExSent));
+	}else{
+		PosExSent[ID][3] = 0;
+	}
+}
+
+int SMS_STS::Mode(u8 ID, u8 mode)
+{
+	// Modes: 0 (servo mode), 1 (closed-loop), 2 (open-loop) or 3 (step mode)
+    if(mode>SMS_STS_MODE_STEP){
+        Err = 1;
+        return -1;
+    }
+    Err = 0;
+    return writeByte(ID, SMS_STS_MODE, mode);		
+}
+
+int SMS_STS::SyncMode(const u8 ID[], u8 IDN, u8 mode)
+{
+	if(mode>SMS_STS_MODE_STEP || !IDN){
+		Err = 1;
+		return -1;
+	}
+	Err = 0;
+	u8 Val[0xfe];
+	memset(Val, 0, IDN);
+	syncWrite(ID, IDN, SMS_STS_LOCK, Val, 1);
+	memset(Val, mode, IDN);
+	syncWrite(ID, IDN, SMS_STS_MODE, Val, 1);
+	usleep(SCSERIAL_EEPROM_US);
+	memset(Val, 1, IDN);
+	syncWrite(ID, IDN, SMS_STS_LOCK, Val, 1);
+	return IDN;
+}
+
+int SMS_STS::encodeStep(u8 *p, s32 Step)
+{
+	if(Step>SMS_STS_STEP_MAX || Step<-SMS_STS_STEP_MAX){
+		return 0;
+	}
+	SCSField<SMS_STS_Map::GoalPosition, SMS_STS_Map::End>::encode(p, Step);
+	return 1;
+}
+
+int SMS_STS::WriteStep(u8 ID, s32 Step, u16 Speed, u8 ACC)
+{
+	u8 bBuf[7];
+	if(!encodeStep(bBuf+1, Step)){
+		Err = 1;
+		return -1;
+	}
+	Err = 0;
+	resetPosCompact(ID);
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return genWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+int SMS_STS::RegWriteStep(u8 ID, s32 Step, u16 Speed, u8 ACC)
+{
+	u8 bBuf[7];
+	if(!encodeStep(bBuf+1, Step)){
+		Err = 1;
+		return -1;
+	}
+	Err = 0;
+	resetPosCompact(ID);
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return regWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+int SMS_STS::SyncWriteStep(const u8 ID[], u8 IDN, const s32 Step[], const u16 Speed[], const u8 ACC[])
+{
+	typedef SMS_STS_Map M;
+	typedef SCSRegBlock<M::Acc, M::GoalSpeed> Blk;
+	if(IDN>SCS_SYNC_WRITE_IDS){
+		Err = 1;
+		return -1;
+	}
+	u8 *p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=Blk::len){
+		if(!encodeStep(p+M::GoalPosition::addr-Blk::addr, Step[i])){
+			Err = 1;
+			return -1;
+		}
+		Blk::set<M::Acc, M::End>(p, ACC ? ACC[i] : 0);
+		Blk::set<M::GoalTime, M::End>(p, 0);
+		Blk::set<M::GoalSpeed, M::End>(p, Speed ? Speed[i] : 0);
+	}
+	Err = 0;
+	for(u8 i = 0; i<IDN; i++){
+		resetPosCompact(ID[i]);
+	}
+	syncWrite(ID, IDN, Blk::addr, syncWriteBuf, Blk::len);
+	return IDN;
+}
+
+int SMS_STS::WriteSpe(u8 ID, s16 Speed, u8 ACC)
+{
+	resetPosCompact(ID);
+	if(Speed<0){
+		Speed = -Speed;
+		Speed |= (1<<15);
+	}
+	u8 bBuf[7];
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+1, 0);
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return genWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+int SMS_STS::RegWriteSpe(u8 ID, s16 Speed, u8 ACC)
+{
+	resetPosCompact(ID);
+	if(Speed<0){
+		Speed = -Speed;
+		Speed |= (1<<15);
+	}
+	u8 bBuf[7];
+	bBuf[0] = ACC;
+	SMS_STS_Map::Order::put16(bBuf+1, 0);
+	SMS_STS_Map::Order::put16(bBuf+3, 0);
+	SMS_STS_Map::Order::put16(bBuf+5, Speed);
+	
+	return regWrite(ID, SMS_STS_ACC, bBuf, 7);
+}
+
+void SMS_STS::SyncWriteSpe(const u8 ID[], u8 IDN, const s16 Speed[], const u8 ACC[])
+{
+	for(u8 i = 0; i<IDN; i++){
+		resetPosCompact(ID[i]);
+	}
+	typedef SMS_STS_Map M;
+	typedef SCSRegBlock<M::Acc, M::GoalSpeed> Blk;
+	if(IDN>SCS_SYNC_WRITE_IDS){
+		return;
+	}
+	u8 *p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=Blk::len){
+		Blk::set<M::Acc, M::End>(p, ACC ? ACC[i] : 0);
+		Blk::set<M::GoalPosition, M::End>(p, 0);
+		Blk::set<M::GoalTime, M::End>(p, 0);
+		Blk::set<M::GoalSpeed, M::End>(p, Speed[i]);
+	}
+	syncWrite(ID, IDN, Blk::addr, syncWriteBuf, Blk::len);
+}
+
+int SMS_STS::WritePwm(u8 ID, s16 Pwm)
+{
+    if(Pwm<0){
+        Pwm = -Pwm;
+        Pwm |= (1<<10);
+    }
+    u8 bBuf[2];
+    SMS_STS_Map::Order::put16(bBuf+0, Pwm);
+    
+    return genWrite(ID, SMS_STS_GOAL_TIME_L, bBuf, 2);
+}
+
+int SMS_STS::RegWritePwm(u8 ID, s16 Pwm)
+{
+    if(Pwm<0){
+        Pwm = -Pwm;
+        Pwm |= (1<<10);
+    }
+    u8 bBuf[2];
+    SMS_STS_Map::Order::put16(bBuf+0, Pwm);
+    
+    return regWrite(ID, SMS_STS_GOAL_TIME_L, bBuf, 2);
+}
+
+void SMS_STS::SyncWritePwm(const u8 ID[], u8 IDN, const s16 Pwm[])
+{
+	typedef SMS_STS_Map M;
+	if(IDN>SCS_SYNC_WRITE_IDS){
+		return;
+	}
+	u8 *p = syncWriteBuf;
+	for(u8 i = 0; i<IDN; i++, p+=M::GoalTime::width){
+		SCSField<M::GoalTime, M::End>::encode(p, Pwm[i]);
+	}
+	syncWrite(ID, IDN, M::GoalTime::addr, syncWriteBuf, M::GoalTime::width);
+}
+
+int SMS_STS::EnableTorque(u8 ID, u8 Enable)
+{
+	return writeByte(ID, SMS_STS_TORQUE_ENABLE, Enable);
+}
+
+int SMS_STS::unLockEprom(u8 ID)
+{
+	return writeByte(ID, SMS_STS_LOCK, 0);
+}
+
+int SMS_STS::LockEprom(u8 ID)
+{
+	return writeByte(ID, SMS_STS_LOCK, 1);
+}
+
+int SMS_STS::RebaudAll(int baudRate)
+{
+	return rebaudAll(baudRate, SMS_STS_BAUD_RATE, SMS_STS_LOCK);
+}
+
+int SMS_STS::CalibrationOfs(u8 ID)
+{
+	return writeByte(ID, SMS_STS_TORQUE_ENABLE, 128);
+}
+
+int SMS_STS::FeedBack(int ID)
+{
+	SCSLock Guard(this);//Mem and FeedBackUs change together
+	int nLen = Read(ID, SMS_STS_PRESENT_POSITION_L, Mem, sizeof(Mem));
+	if(nLen!=sizeof(Mem)){
+		Err = 1;
+		return -1;
+	}
+	Err = 0;
+	FeedBackUs = RxStamp;
+	return nLen;
+}
+
+int SMS_STS::ReadPos(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentPosition>(ID, Mem);
+}
+
+int SMS_STS::ReadSpeed(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentSpeed>(ID, Mem);
+}
+
+int SMS_STS::ReadLoad(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentLoad>(ID, Mem);
+}
+
+int SMS_STS::ReadVoltage(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentVoltage>(ID, Mem);
+}
+
+int SMS_STS::ReadTemper(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentTemperature>(ID, Mem);
+}
+
+int SMS_STS::ReadMove(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::Moving>(ID, Mem);
+}
+
+int SMS_STS::ReadCurrent(int ID)
+{
+	return readReg<SMS_STS_Map, SMS_STS_Map::PresentCurrent>(ID, Mem);
+}
+
+
+int SMS_STS::SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[])
+{
+	return syncFeedBack<SMS_STS_Map>(ID, IDN, Tel);
+}
+
+int SMS_STS::FeedBack(int ID, Telemetry *Tel)
+{
+	return feedBack<SMS_STS_Map>(ID, Tel);
+}
@@ -1,97 +1,152 @@
-﻿/*
- * SMS_STS.h
- * Feetech SMS/STS Series Serial Servo Application Layer Program Header
- * Date: 2021.12.8
- * Author: 
- */
-
-#ifndef _SMS_STS_H
-#define _SMS_STS_H
-
-// Baud rate definition
-#define	SMS_STS_1M 0
-#define	SMS_STS_0_5M 1
-#define	SMS_STS_250K 2
-#define	SMS_STS_128K 3
-#define	SMS_STS_115200 4
-#define	SMS_STS_76800 5
-#define	SMS_STS_57600 6
-#define	SMS_STS_38400 7
-
-//Memory table definition
-//-------EPROM (Read only)--------
-#define SMS_STS_MODEL_L 3
-#define SMS_STS_MODEL_H 4
-
-//-------EPROM (Read and Write)--------
-#define SMS_STS_ID 5
-#define SMS_STS_BAUD_RATE 6
-#define SMS_STS_MIN_ANGLE_LIMIT_L 9
-#define SMS_STS_MIN_ANGLE_LIMIT_H 10
-#define SMS_STS_MAX_ANGLE_LIMIT_L 11
-#define SMS_STS_MAX_ANGLE_LIMIT_H 12
-#define SMS_STS_CW_DEAD 26
-#define SMS_STS_CCW_DEAD 27
-#define SMS_STS_OFS_L 31
-#define SMS_STS_OFS_H 32
-#define SMS_STS_MODE 33
-
-//-------SRAM (Read and Write)--------
-#define SMS_STS_TORQUE_ENABLE 40
-#define SMS_STS_ACC 41
-#define SMS_STS_GOAL_POSITION_L 42
-#define SMS_STS_GOAL_POSITION_H 43
-#define SMS_STS_GOAL_TIME_L 44
-#define SMS_STS_GOAL_TIME_H 45
-#define SMS_STS_GOAL_SPEED_L 46
-#define SMS_STS_GOAL_SPEED_H 47
-#define SMS_STS_LOCK 55
-
-//-------SRAM (Read only)--------
-#define SMS_STS_PRESENT_POSITION_L 56
-#define SMS_STS_PRESENT_POSITION_H 57
-#define SMS_STS_PRESENT_SPEED_L 58
-#define SMS_STS_PRESENT_SPEED_H 59
-#define SMS_STS_PRESENT_LOAD_L 60
-#define SMS_STS_PRESENT_LOAD_H 61
-#define SMS_STS_PRESENT_VOLTAGE 62
-#define SMS_STS_PRESENT_TEMPERATURE 63
-#define SMS_STS_MOVING 66
-#define SMS_STS_PRESENT_CURRENT_L 69
-#define SMS_STS_PRESENT_CURRENT_H 70
-
-#include "SCSerial.h"
-
-class SMS_STS : public SCSerial
-{
-public:
-	SMS_STS();
-	SMS_STS(u8 End);
-	SMS_STS(u8 End, u8 Level);
-	virtual int WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0); // Mode 0: Ordinary write single servo position
-	virtual int RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0); // Mode 0: Async write single servo position (RegWriteAction takes effect)
-	virtual void SyncWritePosEx(u8 ID[], u8 IDN, s16 Position[], u16 Speed[], u8 ACC[]); // Mode 0: Sync write multiple servo positions
-	virtual int Mode(u8 ID, u8 mode); // Set mode: 0 (servo), 1 (wheel; closed loop) or 2 (wheel; open loop)
-	virtual int WriteSpe(u8 ID, s16 Speed, u8 ACC = 0); // Mode 1: Ordinary write single servo speed
-    virtual int RegWriteSpe(u8 ID, s16 Speed, u8 ACC = 0); // Mode 1: Async write single servo speed
-    virtual void SyncWriteSpe(u8 ID[], u8 IDN, s16 Speed[], u8 ACC[]); // Mode 1: Sync write multiple servo speeds
-    virtual int WritePwm(u8 ID, s16 Pwm); //Mode 2: Ordinary write single servo PWM
-    virtual int RegWritePwm(u8 ID, s16 Pwm); //Mode 2: Async write single servo PWM
-    virtual void SyncWritePwm(u8 ID[], u8 IDN, s16 Pwm[]); // Mode 2: Sync write multiple servo PWMs
-	virtual int EnableTorque(u8 ID, u8 Enable); // Enable torque
-	virtual int unLockEprom(u8 ID); // EEPROM unlock 
-	virtual int LockEprom(u8 ID);// EEPROM lock
-	virtual int CalibrationOfs(u8 ID); // Median calibration
-	virtual int FeedBack(int ID); // Servo feedback information 
-	virtual int ReadPos(int ID); // Read servo position
-	virtual int ReadSpeed(int ID); // Read servo speed
-	virtual int ReadLoad(int ID); // Read PWM percentage output to the motor ([-1000, 1000] = [100% reverse, 100% forward])
-	virtual int ReadVoltage(int ID); // Read motor voltage 
-	virtual int ReadTemper(int ID); // Read motor temperature
-	virtual int ReadMove(int ID); // Read motion status
-	virtual int ReadCurrent(int ID); // Read motor current
-private:
-	u8 Mem[SMS_STS_PRESENT_CURRENT_H-SMS_STS_PRESENT_POSITION_L+1];
-};
-
+﻿/*
+ * SMS_STS.h
+ * Feetech SMS/STS Series Serial Servo Application Layer Program Header
+ * Date: 2021.12.8
+ * Author: 
+ */
+
+#ifndef _SMS_STS_H
+#define _SMS_STS_H
+
+// Baud rate definition
+#define	SMS_STS_1M 0
+#define	SMS_STS_0_5M 1
+#define	SMS_STS_250K 2
+#define	SMS_STS_128K 3
+#define	SMS_STS_115200 4
+#define	SMS_STS_76800 5
+#define	SMS_STS_57600 6
+#define	SMS_STS_38400 7
+
+// Operating modes (Mode register)
+#define SMS_STS_MODE_SERVO 0
+#define SMS_STS_MODE_WHEEL 1
+#define SMS_STS_MODE_PWM 2
+#define SMS_STS_MODE_STEP 3//multi-turn, goal position is a step relative to the present position
+#define SMS_STS_STEP_MAX 32767//largest step of one goal, sign in bit 15
+
+//Memory table definition
+//-------EPROM (Read only)--------
+#define SMS_STS_MODEL_L 3
+#define SMS_STS_MODEL_H 4
+
+//-------EPROM (Read and Write)--------
+#define SMS_STS_ID 5
+#define SMS_STS_BAUD_RATE 6
+#define SMS_STS_MIN_ANGLE_LIMIT_L 9
+#define SMS_STS_MIN_ANGLE_LIMIT_H 10
+#define SMS_STS_MAX_ANGLE_LIMIT_L 11
+#define SMS_STS_MAX_ANGLE_LIMIT_H 12
+#define SMS_STS_CW_DEAD 26
+#define SMS_STS_CCW_DEAD 27
+#define SMS_STS_OFS_L 31
+#define SMS_STS_OFS_H 32
+#define SMS_STS_MODE 33
+
+//-------SRAM (Read and Write)--------
+#define SMS_STS_TORQUE_ENABLE 40
+#define SMS_STS_ACC 41
+#define SMS_STS_GOAL_POSITION_L 42
+#define SMS_STS_GOAL_POSITION_H 43
+#define SMS_STS_GOAL_TIME_L 44
+#define SMS_STS_GOAL_TIME_H 45
+#define SMS_STS_GOAL_SPEED_L 46
+#define SMS_STS_GOAL_SPEED_H 47
+#define SMS_STS_LOCK 55
+
+//-------SRAM (Read only)--------
+#define SMS_STS_PRESENT_POSITION_L 56
+#define SMS_STS_PRESENT_POSITION_H 57
+#define SMS_STS_PRESENT_SPEED_L 58
+#define SMS_STS_PRESENT_SPEED_H 59
+#define SMS_STS_PRESENT_LOAD_L 60
+#define SMS_STS_PRESENT_LOAD_H 61
+#define SMS_STS_PRESENT_VOLTAGE 62
+#define SMS_STS_PRESENT_TEMPERATURE 63
+#define SMS_STS_MOVING 66
+#define SMS_STS_PRESENT_CURRENT_L 69
+#define SMS_STS_PRESENT_CURRENT_H 70
+
+#include "SCSerial.h"
+#include "Telemetry.h"
+
+//Control table of the series, End is the fixed byte order of the model
+struct SMS_STS_Map{
+	enum{ End = 0 };
+	typedef SCSByteOrder<End> Order;
+	typedef SMS_STS_Map Map;
+	typedef SCSReg<SMS_STS_MODEL_L, 2, 0, SCS_REG_R|SCS_REG_EPROM> Model;
+	typedef SCSReg<SMS_STS_ID, 1, 0, SCS_REG_RW|SCS_REG_EPROM> ID;
+	typedef SCSReg<SMS_STS_BAUD_RATE, 1, 0, SCS_REG_RW|SCS_REG_EPROM> BaudRate;
+	typedef SCSReg<SMS_STS_MIN_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MinAngleLimit;
+	typedef SCSReg<SMS_STS_MAX_ANGLE_LIMIT_L, 2, 0, SCS_REG_RW|SCS_REG_EPROM> MaxAngleLimit;
+	typedef SCSReg<SMS_STS_CW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CwDead;
+	typedef SCSReg<SMS_STS_CCW_DEAD, 1, 0, SCS_REG_RW|SCS_REG_EPROM> CcwDead;
+	typedef SCSReg<SMS_STS_OFS_L, 2, 11, SCS_REG_RW|SCS_REG_EPROM> Ofs;
+	typedef SCSReg<SMS_STS_MODE, 1, 0, SCS_REG_RW|SCS_REG_EPROM> Mode;
+	typedef SCSReg<SMS_STS_TORQUE_ENABLE, 1> TorqueEnable;
+	typedef SCSReg<SMS_STS_ACC, 1> Acc;
+	typedef SCSReg<SMS_STS_GOAL_POSITION_L, 2, 15> GoalPosition;
+	typedef SCSReg<SMS_STS_GOAL_TIME_L, 2, 10> GoalTime;//PWM in open-loop mode
+	typedef SCSReg<SMS_STS_GOAL_SPEED_L, 2, 15> GoalSpeed;
+	typedef SCSReg<SMS_STS_LOCK, 1> Lock;
+	typedef SCSReg<SMS_STS_PRESENT_POSITION_L, 2, 15, SCS_REG_R> PresentPosition;
+	typedef SCSReg<SMS_STS_PRESENT_SPEED_L, 2, 15, SCS_REG_R> PresentSpeed;
+	typedef SCSReg<SMS_STS_PRESENT_LOAD_L, 2, 10, SCS_REG_R> PresentLoad;
+	typedef SCSReg<SMS_STS_PRESENT_VOLTAGE, 1, 0, SCS_REG_R> PresentVoltage;
+	typedef SCSReg<SMS_STS_PRESENT_TEMPERATURE, 1, 0, SCS_REG_R> PresentTemperature;
+	typedef SCSReg<SMS_STS_MOVING, 1, 0, SCS_REG_R> Moving;
+	typedef SCSReg<SMS_STS_PRESENT_CURRENT_L, 2, 15, SCS_REG_R> PresentCurrent;
+	typedef SCSRegBlock<PresentPosition, PresentCurrent> FeedBack;//block read by FeedBack() into Mem
+};
+
+class SMS_STS : public SCSerial
+{
+public:
+	typedef SMS_STS_Map Map;//control table, see SCSRegMap.h
+	SMS_STS();
+	SMS_STS(u8 End);
+	SMS_STS(u8 End, u8 Level);
+	virtual int WritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0); // Mode 0: Ordinary write single servo position
+	virtual int RegWritePosEx(u8 ID, s16 Position, u16 Speed, u8 ACC = 0); // Mode 0: Async write single servo position (RegWriteAction takes effect)
+	virtual void SyncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[]); // Mode 0: Sync write multiple servo positions
+	virtual void SyncWritePosCompact(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[]);//SyncWritePosEx, only the goal positions while ACC and speed stay as last sent
+	virtual int Mode(u8 ID, u8 mode); // Set mode: 0 (servo), 1 (wheel; closed loop), 2 (wheel; open loop) or 3 (step; multi-turn)
+	virtual int SyncMode(const u8 ID[], u8 IDN, u8 mode);//Mode of IDN servos: one unlock, one mode and one lock sync write
+	virtual int WriteStep(u8 ID, s32 Step, u16 Speed, u8 ACC = 0); // Mode 3: Ordinary write single servo step, -1 if |Step|>SMS_STS_STEP_MAX
+	virtual int RegWriteStep(u8 ID, s32 Step, u16 Speed, u8 ACC = 0); // Mode 3: Async write single servo step
+	virtual int SyncWriteStep(const u8 ID[], u8 IDN, const s32 Step[], const u16 Speed[], const u8 ACC[]); // Mode 3: Sync write multiple servo steps, returns IDN, -1 and nothing sent if a step is out of range
+	static int encodeStep(u8 *p, s32 Step);//goal position field of a step, 0 if it does not fit
+	virtual int WriteSpe(u8 ID, s16 Speed, u8 ACC = 0); // Mode 1: Ordinary write single servo speed
+    virtual int RegWriteSpe(u8 ID, s16 Speed, u8 ACC = 0); // Mode 1: Async write single servo speed
+    virtual void SyncWriteSpe(const u8 ID[], u8 IDN, const s16 Speed[], const u8 ACC[]); // Mode 1: Sync write multiple servo speeds (ACC, time and speed in one packet)
+    virtual int WritePwm(u8 ID, s16 Pwm); //Mode 2: Ordinary write single servo PWM
+    virtual int RegWritePwm(u8 ID, s16 Pwm); //Mode 2: Async write single servo PWM
+    virtual void SyncWritePwm(const u8 ID[], u8 IDN, const s16 Pwm[]); // Mode 2: Sync write multiple servo PWMs
+	virtual int EnableTorque(u8 ID, u8 Enable); // Enable torque
+	virtual int unLockEprom(u8 ID); // EEPROM unlock 
+	virtual int LockEprom(u8 ID);// EEPROM lock
+	virtual int RebaudAll(int baudRate);//move all servos, whatever their current rate, to baudRate
+	virtual int CalibrationOfs(u8 ID); // Median calibration
+	virtual int FeedBack(int ID); // Servo feedback information 
+	virtual int FeedBack(int ID, Telemetry *Tel);//feedback into Tel instead of Mem, safe from several threads, returns -1 on timeout
+	virtual int ReadPos(int ID); // Read servo position
+	virtual int ReadSpeed(int ID); // Read servo speed
+	virtual int ReadLoad(int ID); // Read PWM percentage output to the motor ([-1000, 1000] = [100% reverse, 100% forward])
+	virtual int ReadVoltage(int ID); // Read motor voltage 
+	virtual int ReadTemper(int ID); // Read motor temperature
+	virtual int ReadMove(int ID); // Read motion status
+	virtual int ReadCurrent(int ID); // Read motor current
+	u64 getFeedBackUs(){  return FeedBackUs;  }//arrival of the FeedBack() data, 0 if unknown
+	virtual int SyncFeedBack(u8 ID[], u8 IDN, Telemetry Tel[]); // Feedback of IDN servos from one SyncRead into Tel[0..IDN-1], returns number of valid entries
+	void resetPosCompact(u8 ID = 0xfe);//forget the ACC and speed last sent to ID (0xfe: all), e.g. after a servo reset
+public:
+	u32 PosCompact;//SyncWritePosCompact() frames sent with the goal position only
+private:
+	void syncWritePosEx(const u8 ID[], u8 IDN, const s16 Position[], const u16 Speed[], const u8 ACC[], int Compact);//SyncWritePosEx() and SyncWritePosCompact()
+	u8 Mem[SMS_STS_PRESENT_CURRENT_H-SMS_STS_PRESENT_POSITION_L+1];
+	u64 FeedBackUs;//arrival of the status packet FeedBack() decoded into Mem, monotonic us, 0 if unknown
+	u8 PosExSent[SCS_MAX_ID][4];//ACC, speed bytes and a valid flag of the last full SyncWritePosEx block per ID
+};
+
 #endif
\ No newline at end of file
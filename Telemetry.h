@@ -0,0 +1,26 @@
+/*
+ * Telemetry.h
+ * Decoded servo feedback record shared by the application layer programs
+ * Date: 2026.10.14
+ * Author: 
+ */
+
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include "INST.h"
+
+struct Telemetry{
+	s16 Position;//steps
+	s16 Speed;//steps/s
+	s16 Load;//PWM output, [-1000, 1000]
+	u8 Voltage;//0.1V
+	u8 Temperature;//degree Celsius
+	u8 Moving;
+	s16 Current;//6.5mA
+	u8 Error;//servo status byte
+	u8 Valid;//1: decoded from a good status packet in this cycle
+	u64 Stamp;//arrival of the first byte of the status packet, monotonic us (request time if the transport gives no timestamp)
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+Drive several buses from one thread. Every port given on the command
+line gets its own SCSAsync: each round queues a FeedBack of ID1 and a
+goal write on every bus, then one loop polls all of them until the
+callbacks have run.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSAsync.h"
+
+#define BUS_MAX 4
+
+SMS_STS Bus[BUS_MAX];
+SCSAsync *Async[BUS_MAX];
+
+void onWrite(void *arg, SCSAsyncOp *op)
+{
+	if(!op->ok()){
+		printf("bus %ld: write not acknowledged\n", (long)arg);
+	}
+}
+
+void onFeedBack(void *arg, SCSAsyncOp *op)
+{
+	if(!op->ok()){
+		printf("bus %ld: no reply\n", (long)arg);
+		return;
+	}
+	printf("bus %ld: pos %d speed %d\n", (long)arg,
+		SMS_STS_Map::FeedBack::get<SMS_STS_Map::PresentPosition, SMS_STS_Map::End>(op->Dat),
+		SMS_STS_Map::FeedBack::get<SMS_STS_Map::PresentSpeed, SMS_STS_Map::End>(op->Dat));
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+        std::cout<<"argc error!"<<std::endl;
+        return 0;
+	}
+	int BusN = 0;
+	for(int i=1; i<argc && BusN<BUS_MAX; i++){
+		if(!Bus[BusN].begin(1000000, argv[i])){
+			std::cout<<"Failed to init "<<argv[i]<<std::endl;
+			continue;
+		}
+		Bus[BusN].setAdaptiveTimeOut(2000);
+		Async[BusN] = new SCSAsync(Bus+BusN);
+		BusN++;
+	}
+	for(int k=0; k<10; k++){
+		s16 Goal = (k&1) ? 4095 : 0;
+		for(int i=0; i<BusN; i++){
+			Async[i]->WritePosExAsync<SMS_STS_Map>(1, Goal, 2400, 50, onWrite, (void*)(long)i);
+			Async[i]->FeedBackAsync<SMS_STS_Map>(1, onFeedBack, (void*)(long)i);
+		}
+		int Busy = 1;
+		while(Busy){
+			Busy = 0;
+			for(int i=0; i<BusN; i++){
+				Bus[i].rxPoll(0);
+				Async[i]->poll(SCSerial::monoUs());
+				Busy |= Async[i]->pending();
+			}
+		}
+		usleep(200*1000);
+	}
+	for(int i=0; i<BusN; i++){
+		delete Async[i];
+		Bus[i].end();
+	}
+	return 1;
+}
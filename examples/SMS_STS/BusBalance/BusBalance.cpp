@@ -0,0 +1,57 @@
+/*
+Scan every port given on the command line in parallel, locate the servo
+groups of a hexapod (six legs at 200 Hz, a head at 50 Hz) and print the
+predicted load of each bus now and after moving the groups as planned.
+*/
+
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSBusGroup.h"
+#include "SCSDiscovery.h"
+#include "SCSBalance.h"
+
+SMS_STS sm_st[SCS_BAL_BUSES];
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	int n = argc-1<SCS_BAL_BUSES ? argc-1 : SCS_BAL_BUSES;
+	SCSBusGroup Group;
+	SCSBalance Bal;
+	for(int i=0; i<n; i++){
+		printf("serial:%s\n", argv[i+1]);
+		if(!sm_st[i].begin(1000000, argv[i+1])){
+			printf("Failed to init sms/sts motor!\n");
+			return 0;
+		}
+		Group.add(sm_st+i);
+		Bal.addBus(sm_st+i, 0, 1000);//1 ms USB latency per reply
+	}
+	Group.start();
+	SCSDiscovery *Disc[SCS_BAL_BUSES];
+	SCSDiscovery D0(sm_st+0), D1(sm_st+1), D2(sm_st+2), D3(sm_st+3), D4(sm_st+4), D5(sm_st+5), D6(sm_st+6), D7(sm_st+7);
+	SCSDiscovery *All[SCS_BAL_BUSES] = {&D0, &D1, &D2, &D3, &D4, &D5, &D6, &D7};
+	for(int i=0; i<SCS_BAL_BUSES; i++){
+		Disc[i] = i<n ? All[i] : NULL;
+	}
+	int Baud[1] = {1000000};
+	SCSDiscovery::scanGroup(&Group, Disc, Baud, 1, 1);
+	Group.stop();
+	const char *Leg[6] = {"leg1", "leg2", "leg3", "leg4", "leg5", "leg6"};
+	for(int l=0; l<6; l++){
+		u8 ID[3] = {(u8)(l*3+1), (u8)(l*3+2), (u8)(l*3+3)};
+		Bal.addGroup(Leg[l], ID, 3, 200, 15, 7);//FeedBack block in, ACC..speed out
+	}
+	u8 Head[2] = {30, 31};
+	Bal.addGroup("head", Head, 2, 50, 15, 7);
+	Bal.locate(Disc);
+	Bal.plan();
+	Bal.report(stdout);
+	for(int i=0; i<n; i++){
+		sm_st[i].end();
+	}
+	return 1;
+}
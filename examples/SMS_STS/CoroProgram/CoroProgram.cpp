@@ -0,0 +1,68 @@
+/*
+Commission several servos at once with coroutines (C++20). Each servo
+runs the ProgramEprom sequence: unlock the EEPROM, write the angle
+limits, let the write settle, lock and read the limits back. The
+sequences interleave on one bus thread, so the settle delays overlap.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSAsync.h"
+#include "SCSCoro.h"
+
+typedef SMS_STS_Map M;
+
+SMS_STS sm_st;
+SCSAsync Async(&sm_st);
+SCSCoro Co(&Async);
+
+SCSTask program(u8 ID, u16 Min, u16 Max)
+{
+	if(co_await Co.Ping(ID)!=ID){
+		co_return 0;
+	}
+	co_await Co.unLockEprom<M>(ID);
+	co_await Co.write<M, M::MinAngleLimit>(ID, Min);
+	co_await Co.write<M, M::MaxAngleLimit>(ID, Max);
+	co_await Co.delay(SCSERIAL_EEPROM_US);
+	co_await Co.LockEprom<M>(ID);
+	u8 Limit[4];
+	if(!co_await Co.Read(ID, M::MinAngleLimit::addr, Limit, sizeof(Limit))){
+		co_return 0;
+	}
+	printf("ID:%d limits %d..%d\n", ID, Limit[0]|(Limit[1]<<8), Limit[2]|(Limit[3]<<8));
+	co_return 1;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+        std::cout<<"argc error!"<<std::endl;
+        return 0;
+	}
+	std::cout<<"serial:"<<argv[1]<<std::endl;
+    if(!sm_st.begin(1000000, argv[1])){
+        std::cout<<"Failed to init sms/sts motor!"<<std::endl;
+        return 0;
+    }
+	sm_st.setAdaptiveTimeOut(2000);
+	SCSTask Task[4];
+	for(u8 i=0; i<4; i++){
+		Task[i] = program(i+1, 100, 3995);
+	}
+	int Busy = 1;
+	while(Busy){
+		sm_st.rxPoll(100);
+		Co.poll(SCSerial::monoUs());
+		Busy = 0;
+		for(int i=0; i<4; i++){
+			Busy |= !Task[i].done();
+		}
+	}
+	for(int i=0; i<4; i++){
+		printf("ID:%d %s\n", i+1, Task[i].result() ? "ok" : "failed");
+	}
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,61 @@
+/*
+Feedback of ID1..ID6 at 100 Hz, only the changes are appended to a
+binary log (argv[2], default delta.bin) as SCSDelta cycles, each one
+prefixed with its u16 length; cycles without a change are skipped.
+Every 100 cycles the log volume is printed next to what full records
+would have taken.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include "SCServo.h"
+#include "SCSTelemetryStore.h"
+#include "SCSDelta.h"
+
+SMS_STS sm_st;
+SCSTelemetryStore<SMS_STS_Map> Store;
+SCSTelemetryFrame Frame;
+SCSDelta Delta;
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	FILE *Log = fopen(argc>2 ? argv[2] : "delta.bin", "wb");
+	if(!Log){
+		printf("cannot open the log\n");
+		sm_st.end();
+		return 0;
+	}
+	u8 ID[6] = {1, 2, 3, 4, 5, 6};
+	Store.setServos(ID, 6);
+	Delta.setServos(ID, 6);
+	Delta.Deadband[0] = 4;//position steps
+	SCSDeltaRecord Rec[6];
+	u8 Buf[SCS_DELTA_HEAD+6*SCS_DELTA_RECORD_MAX];
+	for(int i=1; i<=3000; i++){
+		Store.update(&sm_st, SCSerial::monoUs());
+		Store.read(&Frame);
+		int n = Delta.update(Frame, Rec);
+		if(n){
+			int Len = Delta.encode(Rec, n, Buf, sizeof(Buf));
+			u8 Head[2] = {(u8)Len, (u8)(Len>>8)};
+			fwrite(Head, 1, 2, Log);
+			fwrite(Buf, 1, Len, Log);
+		}
+		if(i%100==0){
+			printf("cycle:%lu records:%llu bytes:%llu full:%llu\n", Delta.Cycle, (unsigned long long)Delta.Records, (unsigned long long)Delta.BytesOut, (unsigned long long)Delta.BytesFull);
+		}
+		usleep(10000);
+	}
+	fclose(Log);
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,72 @@
+/*
+500 Hz loop: sync write goal positions to ID1/ID2, SyncRead their feedback,
+update the goals in the callback. Prints the period jitter at the end.
+Run as root (or with CAP_SYS_NICE) to get SCHED_FIFO and mlockall.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSLoop.h"
+
+SMS_STS sm_st;
+u8 ID[2] = {1, 2};
+u8 Goal[2*7];//ACC, position, time, speed per servo
+SCSBusSyncWrite Wr = {ID, 2, SMS_STS_ACC, Goal, 7};
+SCSSyncReadBuf<2, 4> Rd(&sm_st);
+SCSLoop Loop;
+
+void setGoal(int i, s16 Position, u16 Speed)
+{
+	u8 *d = Goal+i*7;
+	d[0] = 50;
+	d[1] = Position&0xff;
+	d[2] = Position>>8;
+	d[3] = d[4] = 0;
+	d[5] = Speed&0xff;
+	d[6] = Speed>>8;
+}
+
+int control(void *arg)
+{
+	static int n = 0;
+	for(int i=0; i<2; i++){
+		if(sm_st.syncReadRxPacketSelect(Rd.get(ID[i]))){
+			int Position = sm_st.syncReadRxPacketToWrod(15);
+			if(n%500==0){
+				std::cout<<"ID:"<<(int)ID[i]<<" Position:"<<Position<<std::endl;
+			}
+		}
+	}
+	s16 Position = (n/1000)%2 ? 4095 : 0;//toggle every 2 s
+	setGoal(0, Position, 2400);
+	setGoal(1, Position, 2400);
+	return ++n<5000 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+        std::cout<<"argc error!"<<std::endl;
+        return 0;
+	}
+	std::cout<<"serial:"<<argv[1]<<std::endl;
+    if(!sm_st.begin(1000000, argv[1])){
+        std::cout<<"Failed to init sms/sts motor!"<<std::endl;
+        return 0;
+    }
+	sm_st.setAdaptiveTimeOut(1000);
+	setGoal(0, 0, 2400);
+	setGoal(1, 0, 2400);
+	Rd.begin(ID, 2, SMS_STS_PRESENT_POSITION_L, 4);
+	SCSLoop::lockMemory();
+	Loop.setRealTime(80);
+	Loop.setPeriod(2000);
+	Loop.setCycle(&sm_st, &Wr, &Rd);
+	Loop.setJob(control, NULL);
+	Loop.run();
+	printf("cycles:%lu overruns:%lu jitter p50:%luus p99:%luus max:%luus work p99:%luus\n",
+		Loop.Cycles, Loop.Overruns, Loop.Jitter.percentile(50), Loop.Jitter.percentile(99), Loop.Jitter.Max, Loop.Work.percentile(99));
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,186 @@
+/*
+Round-trip latency of a real bus: Ping, readWord, FeedBack, SyncWritePosEx
+(time to hand the frame to the port) and SyncRead, for each baud rate and
+IOTimeOut given. Prints min/percentiles/max and jitter (standard deviation)
+per operation, and optionally one CSV row per combination, to compare USB
+adapters, latency timers and kernel settings.
+
+usage: LatencyBench port [-i 1,2,3] [-b 1000000,500000] [-t 20,100] [-n 1000]
+                         [-l latencyTimerMs] [-R] [-c out.csv]
+  -i  servo IDs (default 1)
+  -b  host baud rates; the servos must already run at each rate, or give -R
+      to move them with RebaudAll (EEPROM write) and back to the first rate
+  -t  IOTimeOut values in ms (default 100)
+  -n  samples per operation and setting
+  -l  set the USB-serial latency timer first
+  -c  append CSV: op,baud,timeout_ms,ids,samples,lost,min,p50,p90,p99,p999,max,mean,stddev
+The goal written by SyncWritePosEx is the position read at start, so the
+servos do not move.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <algorithm>
+#include "SCServo.h"
+
+#define MAX_SAMPLES 100000
+#define MAX_LIST 16
+
+SMS_STS sm_st;
+static u8 ID[253];
+static u8 IDN;
+static s16 Position[253];
+static u16 Speed[253];
+static u8 ACC[253];
+static Telemetry Tel[253];
+static u32 Sample[MAX_SAMPLES];
+static int Samples = 1000;
+static FILE *Csv;
+
+static int parseList(const char *s, long *v)
+{
+	int n = 0;
+	while(*s && n<MAX_LIST){
+		v[n++] = strtol(s, (char**)&s, 10);
+		if(*s==','){
+			s++;
+		}else if(*s){
+			return 0;
+		}
+	}
+	return n;
+}
+
+static u32 pct(int n, double p)
+{
+	int k = (int)(p/100*(n-1)+0.5);
+	return Sample[k];
+}
+
+//op returns 0 for a lost sample
+static void bench(const char *name, int (*op)(int), int baud, long timeOutMs)
+{
+	int n = 0;
+	int Lost = 0;
+	for(int i=0; i<Samples; i++){
+		u64 t = SCSerial::monoUs();
+		int Ok = op(i);
+		u32 us = (u32)(SCSerial::monoUs()-t);
+		if(Ok){
+			Sample[n++] = us;
+		}else{
+			Lost++;
+		}
+	}
+	if(!n){
+		printf("%-16s all %d samples lost\n", name, Lost);
+		if(Csv){
+			fprintf(Csv, "%s,%d,%ld,%d,0,%d,,,,,,,,\n", name, baud, timeOutMs, IDN, Lost);
+		}
+		return;
+	}
+	double Sum = 0;
+	double Sq = 0;
+	for(int i=0; i<n; i++){
+		Sum += Sample[i];
+		Sq += (double)Sample[i]*Sample[i];
+	}
+	double Mean = Sum/n;
+	double Dev = sqrt(Sq/n-Mean*Mean > 0 ? Sq/n-Mean*Mean : 0);
+	std::sort(Sample, Sample+n);
+	printf("%-16s %6d %6d %7lu %7lu %7lu %7lu %7lu %7lu %8.1f %8.1f\n", name, n, Lost, Sample[0],
+		pct(n, 50), pct(n, 90), pct(n, 99), pct(n, 99.9), Sample[n-1], Mean, Dev);
+	if(Csv){
+		fprintf(Csv, "%s,%d,%ld,%d,%d,%d,%lu,%lu,%lu,%lu,%lu,%lu,%.1f,%.1f\n", name, baud, timeOutMs, IDN, n, Lost,
+			Sample[0], pct(n, 50), pct(n, 90), pct(n, 99), pct(n, 99.9), Sample[n-1], Mean, Dev);
+	}
+}
+
+static int ping(int i){  return sm_st.Ping(ID[i%IDN])!=-1;  }
+static int readWord(int i){  return sm_st.readWord(ID[i%IDN], SMS_STS_PRESENT_POSITION_L)!=-1;  }
+static int feedBack(int i){  return sm_st.FeedBack(ID[i%IDN], Tel)>0;  }
+static int syncWrite(int i){  sm_st.SyncWritePosEx(ID, IDN, Position, Speed, ACC);  return 1;  }
+static int syncRead(int i){  return sm_st.SyncFeedBack(ID, IDN, Tel)==IDN;  }
+
+int main(int argc, char **argv)
+{
+	long Ids[MAX_LIST] = {1};
+	long Bauds[MAX_LIST] = {1000000};
+	long TimeOuts[MAX_LIST] = {100};
+	int IdN = 1, BaudN = 1, TimeOutN = 1;
+	int Latency = -1;
+	int Rebaud = 0;
+	const char *CsvPath = NULL;
+	int c;
+	while((c = getopt(argc, argv, "i:b:t:n:l:Rc:")) != -1){
+		switch(c){
+		case 'i': IdN = parseList(optarg, Ids); break;
+		case 'b': BaudN = parseList(optarg, Bauds); break;
+		case 't': TimeOutN = parseList(optarg, TimeOuts); break;
+		case 'n': Samples = atoi(optarg); break;
+		case 'l': Latency = atoi(optarg); break;
+		case 'R': Rebaud = 1; break;
+		case 'c': CsvPath = optarg; break;
+		default: IdN = 0; break;
+		}
+	}
+	if(optind>=argc || !IdN || !BaudN || !TimeOutN || Samples<1 || Samples>MAX_SAMPLES){
+		printf("usage: %s port [-i ids] [-b bauds] [-t timeoutsMs] [-n samples] [-l latencyMs] [-R] [-c out.csv]\n", argv[0]);
+		return 0;
+	}
+	IDN = IdN;
+	for(int i=0; i<IDN; i++){
+		ID[i] = (u8)Ids[i];
+	}
+	sm_st.Verbose = 0;
+	if(!sm_st.begin(Bauds[0], argv[optind])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	if(Latency>=0 && sm_st.setLatencyTimer(Latency)!=1){
+		printf("latency timer not set\n");
+	}
+	if(CsvPath){
+		Csv = fopen(CsvPath, "a");
+		if(Csv && ftell(Csv)==0){
+			fprintf(Csv, "op,baud,timeout_ms,ids,samples,lost,min,p50,p90,p99,p999,max,mean,stddev\n");
+		}
+	}
+	for(int b=0; b<BaudN; b++){
+		if(b || Rebaud){
+			if(Rebaud && sm_st.RebaudAll(Bauds[b])<0){
+				printf("baud %ld: servos do not answer\n", Bauds[b]);
+				continue;
+			}
+			sm_st.setBaudRate(Bauds[b]);
+		}
+		for(int i=0; i<IDN; i++){
+			int p = sm_st.ReadPos(ID[i]);
+			Position[i] = p<0 ? 0 : p;
+			Speed[i] = 0;
+			ACC[i] = 0;
+		}
+		for(int t=0; t<TimeOutN; t++){
+			sm_st.IOTimeOut = TimeOuts[t];
+			printf("\nbaud:%ld IOTimeOut:%ldms ids:%d samples:%d\n", Bauds[b], TimeOuts[t], IDN, Samples);
+			printf("%-16s %6s %6s %7s %7s %7s %7s %7s %7s %8s %8s\n", "op (us)", "ok", "lost",
+				"min", "p50", "p90", "p99", "p99.9", "max", "mean", "jitter");
+			bench("Ping", ping, Bauds[b], TimeOuts[t]);
+			bench("readWord", readWord, Bauds[b], TimeOuts[t]);
+			bench("FeedBack", feedBack, Bauds[b], TimeOuts[t]);
+			bench("SyncWritePosEx", syncWrite, Bauds[b], TimeOuts[t]);
+			bench("SyncRead", syncRead, Bauds[b], TimeOuts[t]);
+		}
+	}
+	if(Rebaud && BaudN>1){
+		sm_st.RebaudAll(Bauds[0]);
+	}
+	if(Csv){
+		fclose(Csv);
+	}
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,56 @@
+/*
+Read the feedback of ID1..ID4 at 100 Hz with statistics enabled, refresh
+their health in the spare time, and serve the figures for Prometheus at
+http://<host>:9464/metrics for one minute. The exporter thread copies
+the statistics itself, the bus loop is not involved.
+*/
+
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSLoop.h"
+#include "SCSHealth.h"
+#include "SCSMetrics.h"
+
+SMS_STS sm_st;
+SCSHealth Health(&sm_st);
+u8 ID[] = {1, 2, 3, 4};
+Telemetry Tel[4];
+
+int cycle(void *arg)
+{
+	sm_st.SyncFeedBack(ID, sizeof(ID), Tel);
+	Health.step(SCSerial::monoUs());
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	sm_st.enableStats();
+	for(unsigned i=0; i<sizeof(ID); i++){
+		Health.add(ID[i]);
+	}
+	SCSMetrics Metrics;
+	Metrics.addBus(&sm_st, "bus0", &Health);
+	Metrics.setLabels("robot=\"demo\"");
+	if(!Metrics.serve(9464)){
+		printf("Failed to listen on port 9464!\n");
+		return 0;
+	}
+	SCSLoop Loop;
+	Loop.setPeriod(10000);
+	Loop.setJob(cycle, NULL);
+	Loop.run(6000);
+	Metrics.stop();
+	printf("scrapes:%lu\n", Metrics.Scrapes);
+	sm_st.end();
+	return 1;
+}
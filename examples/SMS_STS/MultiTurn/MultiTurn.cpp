@@ -0,0 +1,42 @@
+/*
+Step mode (mode 3): ID1 and ID2 are switched to step mode with one
+batched EEPROM write, then turned 5 turns forward and back with one sync
+write each. A step is relative to the present position, 4096 steps per turn.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include "SCServo.h"
+
+SMS_STS sm_st;
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	u8 ID[2] = {1, 2};
+	s32 Step[2] = {5*4096, -5*4096};
+	u16 Speed[2] = {3400, 3400};
+	u8 ACC[2] = {50, 50};
+	sm_st.SyncMode(ID, 2, SMS_STS_MODE_STEP);
+	for(int i=0; i<4; i++){
+		if(sm_st.SyncWriteStep(ID, 2, Step, Speed, ACC)<0){
+			printf("step out of range\n");
+			break;
+		}
+		printf("step:%ld %ld\n", Step[0], Step[1]);
+		sleep(7);//5 turns at 3400 steps/s
+		Step[0] = -Step[0];
+		Step[1] = -Step[1];
+	}
+	sm_st.SyncMode(ID, 2, SMS_STS_MODE_SERVO);
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,40 @@
+/*
+Tune a servo port for low latency and check it against a control cycle:
+latency timer 1ms, ASYNC_LOW_LATENCY, VMIN/VTIME and optionally the
+SCHED_FIFO priority of the port's IRQ thread, then 500 pings to ID.
+Run as root to change the sysfs and scheduler settings.
+
+usage: PortTune port [ID] [cycleUs] [transactions] [irqPriority]
+exit status 0 when the cycle fits
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "SCServo.h"
+#include "SCSTune.h"
+
+SMS_STS sm_st;
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("usage: %s port [ID] [cycleUs] [transactions] [irqPriority]\n", argv[0]);
+		return 2;
+	}
+	int ID = argc>2 ? atoi(argv[2]) : 1;
+	u32 CycleUs = argc>3 ? atoi(argv[3]) : 5000;
+	int Transactions = argc>4 ? atoi(argv[4]) : 1;
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 2;
+	}
+	SCSTune Tune(&sm_st);
+	Tune.IrqPriority = argc>5 ? atoi(argv[5]) : 0;
+	Tune.Verbose = 0;
+	printf("changed:%d\n", Tune.apply());
+	Tune.measure(ID, 500);
+	int rv = Tune.check(CycleUs, Transactions);
+	Tune.print(stdout);
+	sm_st.end();
+	return rv ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/*
+Feedback of ID1/ID2 at 100 Hz, a 1 kHz control step working on the
+positions predicted for its own time. Every 100 steps the prediction,
+its age and confidence are printed.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include "SCServo.h"
+#include "SCSTelemetryStore.h"
+#include "SCSPredict.h"
+
+SMS_STS sm_st;
+SCSTelemetryStore<SMS_STS_Map> Store;
+SCSTelemetryFrame Frame;
+SCSPredictor Pred;
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	u8 ID[2] = {1, 2};
+	Store.setServos(ID, 2);
+	Pred.setServos(ID, 2);
+	SCSPrediction P[2];
+	for(int i=0; i<5000; i++){
+		if(i%10==0){
+			Store.update(&sm_st, SCSerial::monoUs());
+			Store.read(&Frame);
+			Pred.update(Frame);
+		}
+		Pred.predictAll(SCSerial::monoUs(), P);
+		if(i%100==0){
+			for(int k=0; k<2; k++){
+				printf("ID:%d pos:%.1f speed:%.1f age:%luus confidence:%.2f\n", P[k].ID, P[k].Position, P[k].Speed, P[k].AgeUs, P[k].Confidence);
+			}
+		}
+		usleep(1000);
+	}
+	sm_st.end();
+	return 1;
+}
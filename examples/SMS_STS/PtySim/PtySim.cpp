@@ -0,0 +1,60 @@
+/*
+Virtual servo bus on a pseudo terminal: IDs 1..servos answer like SMS/STS
+servos (SCSCL with end=1) at the given baud rate and return delay, in real
+time. Point any program at the printed path or the symlink, e.g.
+	PtySim 200 1000000 20 /tmp/scs0 &
+	SyncRead /tmp/scs0
+Runs until Ctrl-C and then prints the request count.
+
+usage: PtySim [servos] [baud] [returnDelayUs] [link] [end] [lossPercent]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include "SCSPtySim.h"
+
+static volatile int Done = 0;
+
+static void onSignal(int sig)
+{
+	Done = 1;
+}
+
+int main(int argc, char **argv)
+{
+	int Servos = argc>1 ? atoi(argv[1]) : 12;
+	int Baud = argc>2 ? atoi(argv[2]) : 1000000;
+	int ReturnDelayUs = argc>3 ? atoi(argv[3]) : 20;
+	const char *Link = argc>4 ? argv[4] : NULL;
+	int End = argc>5 ? atoi(argv[5]) : 0;
+	double Loss = argc>6 ? atof(argv[6]) : 0;
+	if(Servos<1 || Servos>253 || SCSSim::baudIndex(Baud)<0){
+		printf("usage: %s [servos 1..253] [baud] [returnDelayUs] [link] [end] [lossPercent]\n", argv[0]);
+		return 0;
+	}
+	static SCSSim sim(Baud);
+	sim.ReturnDelayUs = ReturnDelayUs;
+	sim.LossRate = Loss/100;
+	sim.End = End;
+	for(int i=1; i<=Servos; i++){
+		sim.addServo(i);
+	}
+	static SCSPtySim pty(&sim);
+	if(!pty.open(Link)){
+		perror("pty");
+		return 0;
+	}
+	printf("servos:%d baud:%d return delay:%dus port:%s%s%s\n", Servos, Baud, ReturnDelayUs,
+		pty.path(), Link ? " link:" : "", Link ? Link : "");
+	fflush(stdout);
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+	while(!Done){
+		pty.run(100000);
+	}
+	printf("requests:%lu packets:%lu replies:%lu lost:%lu\n", pty.Requests, sim.RxPackets, sim.TxPackets, sim.Lost);
+	pty.close();
+	return 1;
+}
@@ -0,0 +1,54 @@
+/*
+Two groups on one bus: an arm (ID1, ID2) in position mode cycled every
+10 ms and a wheel pair (ID3, ID4) in wheel mode cycled every 50 ms. Each
+cycle is one write carrying the sync write and the SyncRead request.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include "SCServo.h"
+#include "SCSServoGroup.h"
+
+SMS_STS sm_st;
+u8 ArmID[] = {1, 2};
+u8 WheelID[] = {3, 4};
+ServoGroup<SMS_STS> Arm(&sm_st);
+ServoGroup<SMS_STS> Wheels(&sm_st);
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	Arm.init(ArmID, sizeof(ArmID));
+	Wheels.init(WheelID, sizeof(WheelID), SCS_GROUP_WHEEL);
+	Arm.applyMode();
+	Wheels.applyMode();
+	Arm.read();
+	Arm.hold();//start from where the arm is
+	for(int k=0; k<500; k++){
+		s16 Goal = (k/100)%2 ? 3000 : 1000;
+		Arm.setPosition(0, Goal, 1500, 50);
+		Arm.setPosition(1, 4095-Goal, 1500, 50);
+		Arm.cycle();
+		if(k%5==0){
+			Wheels.setSpeed(0, k<250 ? 1000 : -1000, 50);
+			Wheels.setSpeed(1, k<250 ? -1000 : 1000, 50);
+			Wheels.cycle();
+			printf("arm %d %d wheels %d %d\n", Arm.Tel[0].Position, Arm.Tel[1].Position, Wheels.Tel[0].Speed, Wheels.Tel[1].Speed);
+		}
+		usleep(10000);
+	}
+	Wheels.setSpeed(0, 0);
+	Wheels.setSpeed(1, 0);
+	Wheels.write();
+	printf("arm cycles:%lu lost:%lu wheel cycles:%lu lost:%lu\n", Arm.Cycles, Arm.Lost, Wheels.Cycles, Wheels.Lost);
+	sm_st.end();
+	return 1;
+}
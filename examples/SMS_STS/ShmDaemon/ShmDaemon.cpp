@@ -0,0 +1,74 @@
+/*
+Bus daemon sharing one port between processes. "ShmDaemon /dev/ttyUSB0"
+owns the bus, reads ID1/ID2 every 10 ms and publishes the frames in
+/scs_bus; "ShmDaemon client" (any number of them) prints the newest
+feedback and moves ID1 back and forth through the shared command queue.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "SCServo.h"
+#include "SCSBusOwner.h"
+#include "SCSShmBus.h"
+
+int client()
+{
+	SCSShmBus Shm;
+	if(!Shm.attach("/scs_bus")){
+		std::cout<<"no bus daemon running!"<<std::endl;
+		return 0;
+	}
+	SCSBusFrame Frame;
+	for(int k=0; k<20; k++){
+		s16 Goal = (k&1) ? 4095 : 0;
+		u8 bBuf[2] = {(u8)(Goal&0xff), (u8)(Goal>>8)};//SMS/STS is little endian
+		Shm.command(1, 0, SMS_STS_GOAL_POSITION_L, bBuf, 2);
+		for(int i=0; i<100; i++){
+			u32 n = Shm.latest(&Frame);
+			if(n && !(i%10)){
+				printf("frame:%lu", n);
+				for(u8 j=0; j<Frame.IDN; j++){
+					printf(" ID%d:%d%s", Frame.ID[j], Frame.Tel[j].Position, Frame.Tel[j].Valid ? "" : "(lost)");
+				}
+				printf("\n");
+			}
+			usleep(10000);
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+        std::cout<<"argc error!"<<std::endl;
+        return 0;
+	}
+	if(!strcmp(argv[1], "client")){
+		return client();
+	}
+	std::cout<<"serial:"<<argv[1]<<std::endl;
+	SMS_STS sm_st;
+    if(!sm_st.begin(1000000, argv[1])){
+        std::cout<<"Failed to init sms/sts motor!"<<std::endl;
+        return 0;
+    }
+	SCSShmBus Shm;
+	if(!Shm.create("/scs_bus")){
+		std::cout<<"Failed to create /scs_bus!"<<std::endl;
+		return 0;
+	}
+	SCSBusOwner Owner(&sm_st);
+	u8 ID[2] = {1, 2};
+	Owner.setFeedBack(ID, 2);
+	Owner.setShm(&Shm);
+	Owner.start(10000);
+	sleep(60);
+	Owner.stop();
+	Shm.detach();
+	SCSShmBus::unlink("/scs_bus");
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,89 @@
+/*
+200 Hz bus cycle in slots: the goals of ID1/ID2 (control, 500us reserved),
+their feedback (1 ms reserved), a health refresh every 20 cycles and, in
+the time left, a background job reading the EEPROM block of each servo
+one read per step. The job only takes steps that fit the rest of the
+cycle, so the control writes keep their latency.
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "SCServo.h"
+#include "SCSTdma.h"
+#include "SCSBudget.h"
+#include "SCSHealth.h"
+
+SMS_STS sm_st;
+u8 ID[] = {1, 2};
+Telemetry Tel[2];
+u32 Cycle = 0;
+int Reads = 0;
+
+int control(void *arg)
+{
+	s16 Position[2];
+	u16 Speed[2] = {0, 0};
+	u8 ACC[2] = {0, 0};
+	Position[0] = 2048+(s16)(1000*sin(Cycle*2*M_PI/400));
+	Position[1] = 4096-Position[0];
+	Cycle++;
+	sm_st.SyncWritePosEx(ID, 2, Position, Speed, ACC);
+	return 0;
+}
+
+int feedBack(void *arg)
+{
+	return sm_st.SyncFeedBack(ID, 2, Tel);
+}
+
+int readEprom(void *arg)
+{
+	u8 Eprom[SMS_STS_LOCK];
+	int i = Reads++;
+	if(sm_st.Read(ID[i], 0, Eprom, sizeof(Eprom))==sizeof(Eprom)){
+		printf("ID:%d EPROM id:%d baud:%d\n", ID[i], Eprom[SMS_STS_ID], Eprom[SMS_STS_BAUD_RATE]);
+	}
+	return Reads<(int)sizeof(ID);
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	SCSHealth Health(&sm_st);
+	Health.add(1);
+	Health.add(2);
+	SCSTdma Tdma;
+	SCSBudget Budget;
+	Tdma.setPeriod(5000);
+	Tdma.setSlot(SCS_TDMA_CONTROL, 500);
+	Tdma.setSlot(SCS_TDMA_FEEDBACK, 1000);
+	Budget.addSyncWrite(2, 7);
+	Tdma.addTask(SCS_TDMA_CONTROL, control, NULL, Budget.cycleUs());
+	Budget.clear();
+	Budget.addSyncRead(2, 15);
+	Tdma.addTask(SCS_TDMA_FEEDBACK, feedBack, NULL, Budget.cycleUs());
+	Budget.clear();
+	Budget.addRead(2);
+	Tdma.addTask(SCS_TDMA_HEALTH, SCSHealth::job, &Health, Budget.cycleUs(), 20);
+	Budget.clear();
+	Budget.addRead(SMS_STS_LOCK);
+	Tdma.submit(SCS_TDMA_BACKGROUND, readEprom, NULL, Budget.cycleUs());
+	SCSLoop Loop;
+	Loop.setPeriod(5000);
+	Loop.setJob(SCSTdma::job, &Tdma);
+	Loop.run(1000);
+	for(int c=0; c<SCS_TDMA_CLASSES; c++){
+		printf("slot %d: budget:%luus runs:%lu deferred:%lu overruns:%lu used max:%luus\n", c, Tdma.Slot[c].BudgetUs, Tdma.Slot[c].Runs, Tdma.Slot[c].Deferred, Tdma.Slot[c].Overruns, Tdma.Slot[c].Used.Max);
+	}
+	printf("control bound:%luus jitter p99:%luus overruns:%lu\n", Tdma.controlBoundUs(), Loop.Jitter.percentile(99), Loop.Overruns);
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,49 @@
+/*
+Trace a 200 Hz feedback loop of ID1/ID2 into trace.log from a background
+thread; if the adapter is unplugged the whole ring also goes to
+trace.log.fault. The last events are printed at the end.
+*/
+
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSLoop.h"
+#include "SCSTrace.h"
+
+SMS_STS sm_st;
+SCSTrace Trace;
+u8 ID[] = {1, 2};
+Telemetry Tel[2];
+
+int cycle(void *arg)
+{
+	sm_st.SyncFeedBack(ID, sizeof(ID), Tel);
+	return sm_st.Fault ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	sm_st.setTrace(&Trace);
+	Trace.start("trace.log");
+	SCSLoop Loop;
+	Loop.setPeriod(5000);
+	Loop.setJob(cycle, NULL);
+	Loop.run(2000);
+	Trace.stop();
+	SCSTraceEvent Ev[10];
+	int n = Trace.snapshot(Ev, 10);
+	for(int i=0; i<n; i++){
+		printf("%llu %s ID:%d inst:0x%02x result:%d len:%d latency:%luns\n", (unsigned long long)Ev[i].Ns, SCSTrace::typeName(Ev[i].Type), Ev[i].ID, Ev[i].Inst, Ev[i].Result, Ev[i].Len, Ev[i].LatNs);
+	}
+	printf("written:%lu lost:%lu\n", Trace.Written, Trace.Lost);
+	sm_st.end();
+	return 1;
+}
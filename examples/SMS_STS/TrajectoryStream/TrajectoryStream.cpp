@@ -0,0 +1,60 @@
+/*
+Stream a sine trajectory to ID1/ID2 at 200 Hz. A producer thread queues
+timestamped waypoints every 50 ms ahead of time, the bus loop interpolates
+them (cubic) and sends one sync write per cycle.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "SCServo.h"
+#include "SCSLoop.h"
+#include "SCSTrajectory.h"
+
+SMS_STS sm_st;
+SCSTrajectory Traj(&sm_st);
+SCSLoop Loop;
+volatile int Done = 0;
+
+void *producer(void *arg)
+{
+	u64 t0 = SCSerial::monoUs()+200000;
+	for(int k=0; k<200 && !Done; k++){
+		u64 t = t0+k*50000ULL;
+		s16 Position = 2048+(s16)(1000*sin(2*M_PI*k/40.0));
+		while(Traj.push(1, t, Position)==0 && !Done){
+			usleep(10000);//lookahead queue full
+		}
+		Traj.push(2, t, 4096-Position);
+		usleep(40000);//stay a little ahead of the bus
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+        std::cout<<"argc error!"<<std::endl;
+        return 0;
+	}
+	std::cout<<"serial:"<<argv[1]<<std::endl;
+    if(!sm_st.begin(1000000, argv[1])){
+        std::cout<<"Failed to init sms/sts motor!"<<std::endl;
+        return 0;
+    }
+	Traj.addServo(1);
+	Traj.addServo(2);
+	Traj.Mode = SCS_TRAJ_CUBIC;
+	pthread_t Thread;
+	pthread_create(&Thread, NULL, producer, NULL);
+	Loop.setPeriod(5000);
+	Loop.setJob(SCSTrajectory::job, &Traj);
+	Loop.run(2200);
+	Done = 1;
+	pthread_join(Thread, NULL);
+	printf("ticks:%lu underruns:%lu jitter p99:%luus\n", Traj.Ticks, Traj.Underruns, Loop.Jitter.percentile(99));
+	sm_st.end();
+	return 1;
+}
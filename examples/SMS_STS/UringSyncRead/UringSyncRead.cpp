@@ -0,0 +1,70 @@
+/*
+SyncRead of position and speed of ID1/ID2 on every port given, all ports
+in one io_uring cycle, 1000 cycles. Prints the positions now and then and
+the io_uring_enter calls per cycle at the end.
+
+usage: UringSyncRead port [port ...]
+*/
+
+#include <stdio.h>
+#include "SCServo.h"
+#include "SCSUring.h"
+#include "SCSPrepared.h"
+
+#define PORTS 8
+
+SCSUring Ring;
+SCSUringTransport *Port[PORTS];
+u8 ID[] = {1, 2};
+u8 rxBuff[PORTS][sizeof(ID)*(4+6)];
+SyncReadRx rxTab[PORTS][0xfe];
+SCSSyncReadPacket Read;
+SCSUringSyncRead rd[PORTS];
+
+int main(int argc, char **argv)
+{
+	int n = argc-1;
+	if(n<1 || n>PORTS){
+		printf("usage: %s port [port ...] (up to %d)\n", argv[0], PORTS);
+		return 0;
+	}
+	if(!Ring.init()){
+		printf("io_uring not available, use SCSerial::begin() instead\n");
+		return 0;
+	}
+	Read.prepare(ID, sizeof(ID), SMS_STS_PRESENT_POSITION_L, 4);
+	for(int i=0; i<n; i++){
+		Port[i] = new SCSUringTransport(&Ring);
+		if(!Port[i]->open(argv[i+1], 1000000)){
+			printf("Failed to open %s\n", argv[i+1]);
+			return 0;
+		}
+		rd[i].Port = Port[i];
+		rd[i].Write = NULL;
+		rd[i].Read = &Read;
+		rd[i].rxBuff = rxBuff[i];
+		rd[i].rxTab = rxTab[i];
+		rd[i].tabLen = 0xfe;
+	}
+	for(int k=0; k<1000; k++){
+		int Valid = Ring.syncReadAll(rd, n);
+		if(k%100){
+			continue;
+		}
+		printf("cycle %d valid %d:", k, Valid);
+		for(int i=0; i<n; i++){
+			for(u8 j=0; j<sizeof(ID); j++){
+				SyncReadRx *rx = rxTab[i]+ID[j];
+				if(rx->Valid){
+					printf(" %d/%d=%d", i, ID[j], SCSField<SMS_STS_Map::PresentPosition, SMS_STS_Map::End>::decode(rx->Dat));
+				}
+			}
+		}
+		printf("\n");
+	}
+	printf("io_uring_enter per cycle: %.2f\n", (double)Ring.Enters/Ring.Cycles);
+	for(int i=0; i<n; i++){
+		Port[i]->close();
+	}
+	return 1;
+}
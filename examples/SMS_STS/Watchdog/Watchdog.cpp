@@ -0,0 +1,49 @@
+/*
+Bus owner at 200 Hz reading ID1/ID2 with a watchdog: over 65 degrees,
+over 1000 (6.5 A) current or 50 ms without a reply cuts torque on the
+whole bus with one broadcast and drops the queued goals. Prints the trip
+and the measured reaction time.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include "SCServo.h"
+#include "SCSBusOwner.h"
+#include "SCSWatchdog.h"
+
+SMS_STS sm_st;
+u8 ID[] = {1, 2};
+
+int main(int argc, char **argv)
+{
+	if(argc<2){
+		printf("argc error!\n");
+		return 0;
+	}
+	printf("serial:%s\n", argv[1]);
+	if(!sm_st.begin(1000000, argv[1])){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	SCSBusOwner Owner(&sm_st);
+	SCSWatchdog Watchdog(&sm_st);
+	Watchdog.setServos(ID, sizeof(ID));
+	Watchdog.MaxTemperature = 65;
+	Watchdog.MaxCurrent = 1000;
+	Watchdog.StaleUs = 50000;
+	Owner.setFeedBack(ID, sizeof(ID));
+	Owner.setWatchdog(&Watchdog);
+	Owner.start(5000);
+	for(int k=0; k<100 && !Watchdog.tripped(); k++){
+		Owner.commandWord(1, 0, SMS_STS_GOAL_POSITION_L, (k&1) ? 3000 : 1000);
+		Owner.commandWord(2, 0, SMS_STS_GOAL_POSITION_L, (k&1) ? 1000 : 3000);
+		usleep(100000);
+	}
+	Owner.stop();
+	if(Watchdog.tripped()){
+		printf("trip ID:%d cause:%d value:%d reaction:%luus\n", Watchdog.Last.ID, Watchdog.Last.Cause, Watchdog.Last.Value, (u32)(Watchdog.Last.CutUs-Watchdog.Last.SampleUs));
+	}
+	printf("trips:%lu worst case:%luus dropped:%lu\n", Watchdog.Trips, Watchdog.boundUs(5000), Owner.Dropped);
+	sm_st.end();
+	return 1;
+}
@@ -0,0 +1,117 @@
+/*
+Bus benchmark against simulated SMS/STS servos (no hardware needed).
+Bus time is the modeled wire time: request and reply bytes at the chosen baud
+rate, the servo return delay and the timeout of every lost reply. CPU time is
+the host time spent in the library per cycle.
+
+usage: BusBench [servos] [baud] [returnDelayUs] [lossPercent] [cycles]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "SCServo.h"
+#include "SCSSimBus.h"
+#include "SCSStats.h"
+
+static SCSSim sim;
+static SCSSimBus<SMS_STS> sm_st(&sim);
+
+static u8 ID[253];
+static s16 Position[253];
+static u16 Speed[253];
+static u8 ACC[253];
+static Telemetry Tel[253];
+static int IDN = 12;
+static int Cycles = 1000;
+
+static u64 cpuNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (u64)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+static void bench(const char *name, void (*cycle)(int))
+{
+	static SCSHist busUs;
+	static SCSHist cpu;
+	memset(&busUs, 0, sizeof(busUs));
+	memset(&cpu, 0, sizeof(cpu));
+	u32 Packets = sim.RxPackets+sim.TxPackets;
+	u64 Clock0 = sim.Clock;
+	for(int i=0; i<Cycles; i++){
+		u64 Clock = sim.Clock;
+		u64 Ns = cpuNs();
+		cycle(i);
+		cpu.add((u32)(cpuNs()-Ns));
+		busUs.add((u32)(sim.Clock-Clock));
+	}
+	Packets = sim.RxPackets+sim.TxPackets-Packets;
+	double Sec = (sim.Clock-Clock0)/1000000.0;
+	printf("%-14s %10.0f %8lu %8lu %8lu %8lu %10lu\n", name, Sec>0 ? Packets/Sec : 0.0,
+		busUs.percentile(50), busUs.percentile(90), busUs.percentile(99), busUs.Max, cpu.mean());
+}
+
+static void syncWritePos(int i)
+{
+	for(int k=0; k<IDN; k++){
+		Position[k] = (i*16+k*100)%4096;
+	}
+	sm_st.SyncWritePosEx(ID, IDN, Position, Speed, ACC);
+}
+
+static void syncRead(int i)
+{
+	sm_st.SyncFeedBack(ID, IDN, Tel);
+}
+
+static void feedBack(int i)
+{
+	for(int k=0; k<IDN; k++){
+		sm_st.FeedBack(ID[k]);
+	}
+}
+
+static void pingScan(int i)
+{
+	for(int k=0; k<0xfe; k++){
+		sm_st.Ping(k);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int Baud = 1000000;
+	int ReturnDelayUs = 20;
+	double LossPercent = 0;
+	if(argc>1) IDN = atoi(argv[1]);
+	if(argc>2) Baud = atoi(argv[2]);
+	if(argc>3) ReturnDelayUs = atoi(argv[3]);
+	if(argc>4) LossPercent = atof(argv[4]);
+	if(argc>5) Cycles = atoi(argv[5]);
+	if(IDN<1 || IDN>253 || SCSSim::baudIndex(Baud)<0 || Cycles<1){
+		printf("usage: %s [servos 1..253] [baud] [returnDelayUs] [lossPercent] [cycles]\n", argv[0]);
+		return 0;
+	}
+	sm_st.begin(Baud, NULL);
+	sim.ReturnDelayUs = ReturnDelayUs;
+	sim.LossRate = LossPercent/100;
+	sm_st.setAdaptiveTimeOut(500, ReturnDelayUs);
+	for(int k=0; k<IDN; k++){
+		ID[k] = k+1;
+		Speed[k] = 3000;
+		ACC[k] = 50;
+		sim.addServo(ID[k]);
+	}
+	printf("servos:%d baud:%d return delay:%dus loss:%.1f%% cycles:%d\n", IDN, Baud, ReturnDelayUs, LossPercent, Cycles);
+	printf("%-14s %10s %8s %8s %8s %8s %10s\n", "bench", "packets/s", "p50 us", "p90 us", "p99 us", "max us", "cpu ns");
+	bench("SyncWritePosEx", syncWritePos);
+	bench("SyncRead", syncRead);
+	bench("FeedBack", feedBack);
+	int ScanCycles = Cycles;
+	Cycles = Cycles<10 ? Cycles : 10;
+	bench("Ping scan", pingScan);
+	Cycles = ScanCycles;
+	return 1;
+}
@@ -0,0 +1,275 @@
+/*
+Microbenchmark of the protocol hot paths against an in-memory transport:
+request framing (genWrite, WritePosEx), sync write framing, status packet
+and SyncRead decoding, the SMS/STS field decoders, and eager versus lazy
+(SCSTelemetryView) bulk feedback. Requests go to a
+byte counter, replies are served from canned status packets, so only
+library CPU time is measured. Prints ns/op and bytes/op; run before and
+after a change to put numbers in the pull request.
+
+usage: CodecBench [minTimeMs]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SCServo.h"
+#include "SCSChecksum.h"
+#include "SCSTelemetryView.h"
+
+//SMS_STS over memory: output is counted and dropped, input replays RxBuf
+class MemBus : public SMS_STS
+{
+public:
+	MemBus() : TxBytes(0), RxBytes(0), RxLen(0), RxPos(0){}
+	void reply(const u8 *Dat, int Len)
+	{
+		memcpy(RxBuf, Dat, Len);
+		RxLen = Len;
+		RxPos = 0;
+	}
+	u64 TxBytes;
+	u64 RxBytes;
+protected:
+	int writeSCS(unsigned char *nDat, int nLen){  TxBytes += nLen;  return nLen;  }
+	int writeSCS(unsigned char bDat){  TxBytes++;  return 1;  }
+	int writeSCSv(const struct iovec *iov, int iovcnt)
+	{
+		int n = 0;
+		for(int i=0; i<iovcnt; i++){
+			n += iov[i].iov_len;
+		}
+		TxBytes += n;
+		return n;
+	}
+	//every request consumes the whole canned reply, it starts over each time
+	int readSCS(unsigned char *nDat, int nLen)
+	{
+		int n = 0;
+		while(n<nLen && RxLen){
+			if(RxPos==RxLen){
+				RxPos = 0;
+				if(n){
+					break;
+				}
+			}
+			int k = RxLen-RxPos;
+			if(k>nLen-n){
+				k = nLen-n;
+			}
+			memcpy(nDat+n, RxBuf+RxPos, k);
+			RxPos += k;
+			n += k;
+		}
+		RxBytes += n;
+		return n;
+	}
+	void rFlushSCS(){  RxPos = 0;  }
+	void wFlushSCS(){}
+private:
+	u8 RxBuf[254*(255+6)];
+	int RxLen;
+	int RxPos;
+};
+
+static MemBus bus;
+static u8 ID[253];
+static s16 Position[253];
+static u16 Speed[253];
+static u8 ACC[253];
+static u8 Dat[253*255];
+static SyncReadRx rxTab[254];
+static double MinSec = 0.2;
+static volatile int Sink;
+
+//status packet of ID with nLen payload bytes at p, returns its length
+static int statusPacket(u8 *p, u8 ID, u8 nLen)
+{
+	p[0] = 0xff;
+	p[1] = 0xff;
+	p[2] = ID;
+	p[3] = nLen+2;
+	p[4] = 0;
+	for(u8 i=0; i<nLen; i++){
+		p[5+i] = (u8)(i*37+ID);
+	}
+	p[5+nLen] = ~SCSChecksum::sum(p+2, nLen+3);
+	return nLen+6;
+}
+
+static void canned(u8 IDN, u8 nLen)
+{
+	static u8 Buf[254*(255+6)];
+	int Len = 0;
+	for(u8 i=0; i<IDN; i++){
+		Len += statusPacket(Buf+Len, ID[i], nLen);
+	}
+	bus.reply(Buf, Len);
+}
+
+static double nowSec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec+ts.tv_nsec*1e-9;
+}
+
+//runs op in growing batches until MinSec has passed
+static void bench(const char *name, int IDN, int nLen, void (*op)(int, int))
+{
+	u64 Tx = bus.TxBytes;
+	u64 Rx = bus.RxBytes;
+	u64 Ops = 0;
+	u64 Batch = 16;
+	double t0 = nowSec();
+	double t;
+	while(1){
+		for(u64 i=0; i<Batch; i++){
+			op(IDN, nLen);
+		}
+		Ops += Batch;
+		t = nowSec()-t0;
+		if(t>=MinSec){
+			break;
+		}
+		Batch *= 2;
+	}
+	printf("%-22s %5d %5d %12.1f %10.1f %10.1f\n", name, IDN, nLen, t*1e9/Ops,
+		(double)(bus.TxBytes-Tx)/Ops, (double)(bus.RxBytes-Rx)/Ops);
+}
+
+static void genWrite(int IDN, int nLen)
+{
+	bus.genWrite(1, SMS_STS_GOAL_POSITION_L, Dat, nLen);
+}
+
+static void writePosEx(int IDN, int nLen)
+{
+	bus.WritePosEx(1, 2048, 3000, 50);
+}
+
+static void syncWrite(int IDN, int nLen)
+{
+	bus.syncWrite(ID, IDN, SMS_STS_ACC, Dat, nLen);
+}
+
+static void syncWritePosEx(int IDN, int nLen)
+{
+	bus.SyncWritePosEx(ID, IDN, Position, Speed, ACC);
+}
+
+static void syncWritePosCompact(int IDN, int nLen)
+{
+	bus.SyncWritePosCompact(ID, IDN, Position, Speed, ACC);
+}
+
+static void read(int IDN, int nLen)
+{
+	Sink = bus.Read(1, SMS_STS_PRESENT_POSITION_L, Dat, nLen);
+}
+
+static void syncReadRx(int IDN, int nLen)
+{
+	bus.syncReadPacketTx(ID, IDN, SMS_STS_PRESENT_POSITION_L, nLen);
+	for(int i=0; i<IDN; i++){
+		Sink = bus.syncReadPacketRx(ID[i], Dat);
+	}
+}
+
+static void syncReadRxAll(int IDN, int nLen)
+{
+	bus.syncReadPacketTx(ID, IDN, SMS_STS_PRESENT_POSITION_L, nLen);
+	Sink = bus.syncReadPacketRxAll(rxTab, 254);
+}
+
+static void decode(int IDN, int nLen)
+{
+	Sink = bus.ReadPos(-1)+bus.ReadSpeed(-1)+bus.ReadLoad(-1)+bus.ReadCurrent(-1)
+		+bus.ReadVoltage(-1)+bus.ReadTemper(-1)+bus.ReadMove(-1);
+}
+
+static void feedBack(int IDN, int nLen)
+{
+	Telemetry Tel;
+	Sink = bus.FeedBack(1, &Tel);
+}
+
+static Telemetry Tel[253];
+static SCSLazyFeedBack<SMS_STS_Map> Lazy;
+
+static void syncFeedBack(int IDN, int nLen)
+{
+	Sink = bus.SyncFeedBack(ID, IDN, Tel);
+}
+
+static void lazyMoving(int IDN, int nLen)
+{
+	int Moving = Lazy.update(&bus);
+	for(int i=0; i<IDN; i++){
+		Moving += Lazy.View[i].moving();
+	}
+	Sink = Moving;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc>1){
+		MinSec = atoi(argv[1])/1000.0;
+	}
+	for(int i=0; i<253; i++){
+		ID[i] = i+1;
+		Position[i] = (i*100)%4096-2048;
+		Speed[i] = 3000;
+		ACC[i] = 50;
+	}
+	static const int IDNs[] = {1, 8, 32, 128, 253};
+	static const int Lens[] = {2, 7, 15};
+	printf("%-22s %5s %5s %12s %10s %10s\n", "bench", "IDN", "len", "ns/op", "tx B/op", "rx B/op");
+
+	bus.Level = 0;
+	for(int l=0; l<3; l++){
+		bench("genWrite (no ack)", 1, Lens[l], genWrite);
+	}
+	bench("WritePosEx (no ack)", 1, 7, writePosEx);
+	bus.Level = 1;
+	canned(1, 0);
+	bench("WritePosEx (ack)", 1, 7, writePosEx);
+	for(int n=0; n<5; n++){
+		for(int l=0; l<3; l++){
+			if((Lens[l]+1)*IDNs[n]<=SCS_SYNC_WRITE_BUF){
+				bench("syncWrite", IDNs[n], Lens[l], syncWrite);
+			}
+		}
+	}
+	for(int n=0; n<5; n++){
+		bench("SyncWritePosEx", IDNs[n], 7, syncWritePosEx);
+	}
+	for(int n=0; n<5; n++){
+		bench("SyncWritePosCompact", IDNs[n], 2, syncWritePosCompact);
+	}
+	for(int l=0; l<3; l++){
+		canned(1, Lens[l]);
+		bench("Read", 1, Lens[l], read);
+	}
+	canned(1, 15);
+	bench("FeedBack(ID, Tel)", 1, 15, feedBack);
+	bus.FeedBack(1);
+	bench("decode 7 fields", 1, 15, decode);
+	for(int n=0; n<5; n++){
+		for(int l=0; l<3; l++){
+			bus.syncReadBegin(IDNs[n], Lens[l]);
+			canned(IDNs[n], Lens[l]);
+			bench("syncReadPacketRx", IDNs[n], Lens[l], syncReadRx);
+			bench("syncReadPacketRxAll", IDNs[n], Lens[l], syncReadRxAll);
+		}
+	}
+	bus.syncReadEnd();
+	for(int n=0; n<3; n++){
+		canned(IDNs[n], 15);
+		bench("SyncFeedBack", IDNs[n], 15, syncFeedBack);
+		Lazy.setServos(ID, IDNs[n]);
+		bench("lazy view, moving()", IDNs[n], 15, lazyMoving);
+	}
+	return 1;
+}
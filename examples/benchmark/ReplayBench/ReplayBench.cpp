@@ -0,0 +1,582 @@
+/*
+Regression benchmark replaying a captured session (SCSCapture pcap)
+through the full SMS_STS stack. Every captured request is turned back
+into the library call that sent it (Ping, Read, genWrite, regWrite,
+RegWriteAction, syncWrite, SyncFeedBack or syncRead) and answered with
+the captured replies by SCSReplayTransport, so a run is deterministic
+and needs no hardware. Requests that differ from the capture are counted
+as mismatches. Sessions are standard pcap files (LINKTYPE_USER0) with
+the same layout on every host, so a capture from the robot replays on a
+workstation and opens in Wireshark or tcpdump.
+
+The report (stdout or -o file) is flat JSON, one key per line: CPU time
+per transaction and per cycle (fastest run and median), heap allocations
+per run, and the latency distribution of transactions, of each
+instruction and of cycles (a cycle starts at each SYNC_READ). Every
+statistic is taken per run and the lowest over the runs is reported:
+the replay is deterministic, so the spread between runs is the load of
+the machine, not the library. -c compares two reports, e.g. of the installed and the new
+library build, and lists the metrics that got worse: allocations and
+mismatches on any increase, CPU time and the p50/p90 latencies by more
+than -t percent (default 10). Tails and maxima are reported, not judged.
+
+usage: ReplayBench [-n runs] [-m maxRecords] [-o report.json] capture.pcap
+       ReplayBench -c base.json new.json [-t percent]
+       ReplayBench -s servos cycles capture.pcap   record a session from SCSPtySim
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SCServo.h"
+#include "SCSCapture.h"
+#include "SCSPtySim.h"
+
+#ifndef SCSERVO_VERSION
+#define SCSERVO_VERSION "unknown"
+#endif
+
+#define BENCH_METRICS 64
+
+//heap use of the library while Counting, every other call goes straight to glibc
+extern "C" void *__libc_malloc(size_t n);
+extern "C" void *__libc_calloc(size_t n, size_t s);
+extern "C" void *__libc_realloc(void *p, size_t n);
+extern "C" void __libc_free(void *p);
+
+static volatile int Counting;
+static u64 Allocs;
+static u64 AllocBytes;
+
+extern "C" void *malloc(size_t n)
+{
+	if(Counting){
+		__atomic_add_fetch(&Allocs, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&AllocBytes, n, __ATOMIC_RELAXED);
+	}
+	return __libc_malloc(n);
+}
+
+extern "C" void *calloc(size_t n, size_t s)
+{
+	if(Counting){
+		__atomic_add_fetch(&Allocs, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&AllocBytes, n*s, __ATOMIC_RELAXED);
+	}
+	return __libc_calloc(n, s);
+}
+
+extern "C" void *realloc(void *p, size_t n)
+{
+	if(Counting){
+		__atomic_add_fetch(&Allocs, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&AllocBytes, n, __ATOMIC_RELAXED);
+	}
+	return __libc_realloc(p, n);
+}
+
+extern "C" void free(void *p)
+{
+	__libc_free(p);
+}
+
+static u64 clockNs(clockid_t Clock)
+{
+	struct timespec ts;
+	clock_gettime(Clock, &ts);
+	return (u64)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+//one captured request as the call that replays it
+struct Call{
+	u8 Inst;
+	u8 ID;
+	u8 Addr;
+	u8 Len;//bytes read or written per servo
+	u8 IDN;//sync instructions
+	u8 Cycle;//1: a cycle starts here
+	u8 IDs[254];
+	u8 Dat[SCS_CAP_FRAME];
+	const u8 *Raw;//whole TX record, for frames without a call of their own
+	int RawLen;
+	int PreLen;//sync write frames sent ahead of a SYNC_READ in one write
+};
+
+static SMS_STS sm_st;
+static SCSReplayTransport Replay;
+static Call *Calls;
+static int CallN;
+static int Cycles;
+static u32 *TxnNs;
+static u32 *CycleNs;
+static u32 *InstNs[256];
+static int InstN[256];
+
+static const char *instName(u8 Inst)
+{
+	switch(Inst){
+		case INST_PING: return "ping";
+		case INST_READ: return "read";
+		case INST_WRITE: return "write";
+		case INST_REG_WRITE: return "reg_write";
+		case INST_REG_ACTION: return "action";
+		case INST_SYNC_READ: return "sync_read";
+		case INST_SYNC_WRITE: return "sync_write";
+		default: return "raw";
+	}
+}
+
+//frame at p: returns its length, 0 if it is not a complete frame
+static int frameLen(const u8 *p, int n)
+{
+	if(n<6 || p[0]!=0xff || p[1]!=0xff || p[3]<2 || p[3]+4>n){
+		return 0;
+	}
+	return p[3]+4;
+}
+
+static void parse(Call *c, const u8 *p)
+{
+	const u8 *Par = p+5;
+	int ParN = p[3]-2;
+	c->Inst = p[4];
+	c->ID = p[2];
+	if(c->Inst==INST_READ && ParN==2){
+		c->Addr = Par[0];
+		c->Len = Par[1];
+	}else if((c->Inst==INST_WRITE || c->Inst==INST_REG_WRITE) && ParN>=1){
+		c->Addr = Par[0];
+		c->Len = ParN-1;
+		memcpy(c->Dat, Par+1, c->Len);
+	}else if(c->Inst==INST_SYNC_READ && ParN>=2){
+		c->Addr = Par[0];
+		c->Len = Par[1];
+		c->IDN = ParN-2;
+		memcpy(c->IDs, Par+2, c->IDN);
+	}else if(c->Inst==INST_SYNC_WRITE && ParN>=2 && Par[1] && (ParN-2)%(Par[1]+1)==0){
+		c->Addr = Par[0];
+		c->Len = Par[1];
+		c->IDN = (ParN-2)/(c->Len+1);
+		for(u8 i=0; i<c->IDN; i++){
+			const u8 *s = Par+2+i*(c->Len+1);
+			c->IDs[i] = s[0];
+			memcpy(c->Dat+i*c->Len, s+1, c->Len);
+		}
+	}else if(c->Inst!=INST_PING && c->Inst!=INST_REG_ACTION){
+		c->Inst = 0;
+	}
+}
+
+//the TX records of the capture as calls, returns calls
+static int plan()
+{
+	CallN = 0;
+	Cycles = 0;
+	for(int r=0; r<Replay.RecN; r++){
+		const SCSCapRecord *Rec = Replay.Rec+r;
+		if(Rec->Dir!=SCS_CAP_TX){
+			continue;
+		}
+		Call *c = Calls+CallN++;
+		memset(c, 0, sizeof(Call));
+		c->Raw = Rec->Dat;
+		c->RawLen = Rec->Len;
+		int Pos = 0;
+		int Last = 0;
+		int Frames = 0;
+		int n;
+		while((n = frameLen(Rec->Dat+Pos, Rec->Len-Pos))>0){
+			Last = Pos;
+			Pos += n;
+			Frames++;
+		}
+		if(!Frames || Pos!=Rec->Len){
+			continue;//Inst 0: sent as it is
+		}
+		parse(c, Rec->Dat+Last);
+		if(Frames>1){
+			//sync writes ahead of a SYNC_READ (syncReadPrepared with Pre), anything else goes out raw
+			c->PreLen = Last;
+			if(c->Inst!=INST_SYNC_READ){
+				c->Inst = 0;
+			}
+		}
+		if(c->Inst==INST_SYNC_READ){
+			c->Cycle = 1;
+			Cycles++;
+		}
+	}
+	if(!Cycles && CallN){
+		Calls[0].Cycle = 1;
+		Cycles = 1;
+	}
+	return CallN;
+}
+
+static void exec(Call *c)
+{
+	static u8 Buf[SCS_CAP_FRAME];
+	static u8 rxBuff[254*(255+6)];
+	static SyncReadRx rxTab[0xfe];
+	static Telemetry Tel[254];
+	switch(c->Inst){
+		case INST_PING:
+			sm_st.Ping(c->ID);
+			break;
+		case INST_READ:
+			sm_st.Read(c->ID, c->Addr, Buf, c->Len);
+			break;
+		case INST_WRITE:
+			sm_st.genWrite(c->ID, c->Addr, c->Dat, c->Len);
+			break;
+		case INST_REG_WRITE:
+			sm_st.regWrite(c->ID, c->Addr, c->Dat, c->Len);
+			break;
+		case INST_REG_ACTION:
+			sm_st.RegWriteAction(c->ID);
+			break;
+		case INST_SYNC_WRITE:
+			sm_st.syncWrite(c->IDs, c->IDN, c->Addr, c->Dat, c->Len);
+			break;
+		case INST_SYNC_READ:
+			if(c->PreLen){
+				const u8 *Pkt = c->Raw+c->PreLen;
+				sm_st.syncReadPrepared(Pkt, c->RawLen-c->PreLen, c->IDN, c->Len, rxBuff, rxTab, 0xfe, c->Raw, c->PreLen);
+			}else if(c->Addr==SMS_STS_PRESENT_POSITION_L && c->Len==SMS_STS_Map::FeedBack::len){
+				sm_st.SyncFeedBack(c->IDs, c->IDN, Tel);
+			}else{
+				sm_st.syncRead(c->IDs, c->IDN, c->Addr, c->Len, rxBuff, rxTab, 0xfe);
+			}
+			break;
+		default:
+			sm_st.writePrepared(c->Raw, c->RawLen);
+			break;
+	}
+}
+
+//one replay of the whole capture, latencies into the sample arrays at Run
+static u64 run(int Run)
+{
+	Replay.rewind();
+	u64 Cpu = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+	u64 CycleStart = 0;
+	int Cycle = -1;
+	for(int i=0; i<CallN; i++){
+		Call *c = Calls+i;
+		u64 t0 = clockNs(CLOCK_MONOTONIC);
+		if(c->Cycle){
+			if(Cycle>=0 && TxnNs){
+				CycleNs[Run*Cycles+Cycle] = (u32)(t0-CycleStart);
+			}
+			CycleStart = t0;
+			Cycle++;
+		}
+		exec(c);
+		u64 Ns = clockNs(CLOCK_MONOTONIC)-t0;
+		if(TxnNs){
+			TxnNs[Run*CallN+i] = (u32)Ns;
+			InstNs[c->Inst][InstN[c->Inst]++] = (u32)Ns;
+		}
+	}
+	if(Cycle>=0 && TxnNs){
+		CycleNs[Run*Cycles+Cycle] = (u32)(clockNs(CLOCK_MONOTONIC)-CycleStart);
+	}
+	return clockNs(CLOCK_PROCESS_CPUTIME_ID)-Cpu;
+}
+
+static int cmpU32(const void *a, const void *b)
+{
+	u32 x = *(const u32*)a;
+	u32 y = *(const u32*)b;
+	return x<y ? -1 : x>y;
+}
+
+static int cmpU64(const void *a, const void *b)
+{
+	u64 x = *(const u64*)a;
+	u64 y = *(const u64*)b;
+	return x<y ? -1 : x>y;
+}
+
+//each statistic of the n samples of every run, the lowest over the runs
+static void dist(FILE *f, const char *Name, u32 *v, int n, int Runs)
+{
+	static const int Pct[] = {500, 900, 990, 999};
+	u64 Best[6];
+	for(int k=0; k<6; k++){
+		Best[k] = ~0ULL;
+	}
+	for(int r=0; r<Runs && n; r++){
+		u32 *x = v+(long long)r*n;
+		qsort(x, n, sizeof(u32), cmpU32);
+		u64 Sum = 0;
+		for(int i=0; i<n; i++){
+			Sum += x[i];
+		}
+		u64 Stat[6] = {Sum/n, x[(n-1)*Pct[0]/1000], x[(n-1)*Pct[1]/1000], x[(n-1)*Pct[2]/1000], x[(n-1)*Pct[3]/1000], x[n-1]};
+		for(int k=0; k<6; k++){
+			Best[k] = Stat[k]<Best[k] ? Stat[k] : Best[k];
+		}
+	}
+	fprintf(f, "  \"%s_count\": %d,\n", Name, n);
+	fprintf(f, "  \"%s_mean\": %llu,\n", Name, n ? (unsigned long long)Best[0] : 0ULL);
+	for(int k=0; k<4; k++){
+		fprintf(f, "  \"%s_p%d\": %llu,\n", Name, Pct[k]%10 ? Pct[k] : Pct[k]/10, n ? (unsigned long long)Best[k+1] : 0ULL);
+	}
+	fprintf(f, "  \"%s_max\": %llu,\n", Name, n ? (unsigned long long)Best[5] : 0ULL);
+}
+
+static int bench(const char *Path, int Runs, int MaxRec, const char *Out)
+{
+	SCSCapRecord *Rec = (SCSCapRecord*)malloc(MaxRec*sizeof(SCSCapRecord));
+	Calls = (Call*)malloc(MaxRec*sizeof(Call));
+	if(!Rec || !Calls || !Replay.open(Path, Rec, MaxRec)){
+		printf("cannot load %s\n", Path);
+		return 0;
+	}
+	if(!sm_st.begin(&Replay)){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	plan();
+	if(!CallN){
+		printf("no requests in %s\n", Path);
+		return 0;
+	}
+	TxnNs = NULL;
+	run(0);//warm up: first use allocations, caches
+	u32 Mismatches = Replay.Mismatches;
+	TxnNs = (u32*)malloc((size_t)Runs*CallN*sizeof(u32));
+	CycleNs = (u32*)malloc((size_t)Runs*Cycles*sizeof(u32));
+	u64 *Cpu = (u64*)malloc(Runs*sizeof(u64));
+	for(int i=0; i<CallN; i++){
+		u8 Inst = Calls[i].Inst;
+		if(!InstNs[Inst]){
+			int n = 0;
+			for(int k=0; k<CallN; k++){
+				n += Calls[k].Inst==Inst;
+			}
+			InstNs[Inst] = (u32*)malloc((size_t)Runs*n*sizeof(u32));
+		}
+	}
+	Allocs = AllocBytes = 0;
+	for(int r=0; r<Runs; r++){
+		Counting = 1;
+		Cpu[r] = run(r);
+		Counting = 0;
+	}
+	qsort(Cpu, Runs, sizeof(u64), cmpU64);
+	u64 CpuMin = Cpu[0];
+	u64 CpuMed = Cpu[Runs/2];
+	FILE *f = Out ? fopen(Out, "w") : stdout;
+	if(!f){
+		printf("cannot write %s\n", Out);
+		return 0;
+	}
+	fprintf(f, "{\n");
+	fprintf(f, "  \"format\": \"scservo-replay-bench 1\",\n");
+	fprintf(f, "  \"library\": \"%s\",\n", SCSERVO_VERSION);
+	fprintf(f, "  \"capture\": \"%s\",\n", Path);
+	fprintf(f, "  \"records\": %d,\n", Replay.RecN);
+	fprintf(f, "  \"transactions\": %d,\n", CallN);
+	fprintf(f, "  \"cycles\": %d,\n", Cycles);
+	fprintf(f, "  \"runs\": %d,\n", Runs);
+	fprintf(f, "  \"mismatches\": %lu,\n", Mismatches);
+	fprintf(f, "  \"cpu_ns_per_txn\": %llu,\n", (unsigned long long)(CpuMin/CallN));
+	fprintf(f, "  \"cpu_ns_per_cycle\": %llu,\n", (unsigned long long)(CpuMin/Cycles));
+	fprintf(f, "  \"cpu_ns_per_txn_median\": %llu,\n", (unsigned long long)(CpuMed/CallN));
+	fprintf(f, "  \"allocs_per_run\": %llu,\n", (unsigned long long)(Allocs/Runs));
+	fprintf(f, "  \"alloc_bytes_per_run\": %llu,\n", (unsigned long long)(AllocBytes/Runs));
+	dist(f, "txn_ns", TxnNs, CallN, Runs);
+	dist(f, "cycle_ns", CycleNs, Cycles, Runs);
+	for(int i=0; i<256; i++){
+		if(InstN[i]){
+			char Name[32];
+			snprintf(Name, sizeof(Name), "%s_ns", instName(i));
+			dist(f, Name, InstNs[i], InstN[i]/Runs, Runs);
+		}
+	}
+	fprintf(f, "  \"end\": 0\n}\n");
+	if(Out){
+		fclose(f);
+	}
+	sm_st.end();
+	return 1;
+}
+
+struct Metric{
+	char Key[64];
+	double Val;
+};
+
+//flat report back into Key/Val pairs, string values are skipped
+static int loadReport(const char *Path, Metric *m, int Max)
+{
+	FILE *f = fopen(Path, "r");
+	if(!f){
+		printf("cannot open %s\n", Path);
+		return -1;
+	}
+	char Line[256];
+	int n = 0;
+	while(n<Max && fgets(Line, sizeof(Line), f)){
+		if(sscanf(Line, " \"%63[^\"]\": %lf", m[n].Key, &m[n].Val)==2){
+			n++;
+		}
+	}
+	fclose(f);
+	return n;
+}
+
+//is Key judged, and how: 0 no, 1 beyond Tol percent, 2 on any increase, 3 must be equal
+static int judged(const char *k)
+{
+	static const char *Input[] = {"records", "transactions", "cycles"};
+	for(unsigned i=0; i<sizeof(Input)/sizeof(Input[0]); i++){
+		if(!strcmp(k, Input[i])){
+			return 3;
+		}
+	}
+	if(!strcmp(k, "mismatches") || !strncmp(k, "alloc", 5)){
+		return 2;
+	}
+	int n = strlen(k);
+	if(!strcmp(k, "cpu_ns_per_txn") || !strcmp(k, "cpu_ns_per_cycle") || (n>4 && (!strcmp(k+n-4, "_p50") || !strcmp(k+n-4, "_p90")))){
+		return 1;
+	}
+	return 0;
+}
+
+static int compare(const char *BasePath, const char *NewPath, double Tol)
+{
+	static Metric Base[BENCH_METRICS];
+	static Metric New[BENCH_METRICS];
+	int BaseN = loadReport(BasePath, Base, BENCH_METRICS);
+	int NewN = loadReport(NewPath, New, BENCH_METRICS);
+	if(BaseN<0 || NewN<0){
+		return 0;
+	}
+	int Worse = 0;
+	printf("%-24s %12s %12s %8s\n", "metric", "base", "new", "change");
+	for(int i=0; i<BaseN; i++){
+		const char *k = Base[i].Key;
+		const Metric *m = NULL;
+		for(int j=0; j<NewN && !m; j++){
+			if(!strcmp(New[j].Key, k)){
+				m = New+j;
+			}
+		}
+		if(!m || !strcmp(k, "end") || strstr(k, "_count") || !strcmp(k, "runs")){
+			continue;
+		}
+		double b = Base[i].Val;
+		double v = m->Val;
+		double Pct = b ? 100*(v-b)/b : (v ? 100 : 0);
+		int How = judged(k);
+		int Bad = How==3 ? v!=b : How==2 ? v>b : How==1 ? Pct>Tol : 0;
+		printf("%-24s %12.0f %12.0f %+7.1f%%%s\n", k, b, v, Pct, Bad ? (How==3 ? "  different capture" : "  REGRESSION") : "");
+		Worse += Bad;
+	}
+	printf("%d regressions (tolerance %.1f%%)\n", Worse, Tol);
+	return !Worse;
+}
+
+//a session of Servos simulated servos: sync write positions and SyncFeedBack every cycle, a Read and a Ping now and then
+static int record(int Servos, int N, const char *Path)
+{
+	static SCSSim sim(1000000);
+	for(int i=1; i<=Servos; i++){
+		sim.addServo(i);
+	}
+	static SCSPtySim pty(&sim);
+	static SCSCapture cap;
+	if(!pty.open() || !pty.start()){
+		printf("cannot start the simulator\n");
+		return 0;
+	}
+	if(!sm_st.begin(1000000, pty.path())){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	if(!cap.open(Path)){
+		printf("cannot write %s\n", Path);
+		return 0;
+	}
+	sm_st.setCapture(&cap);
+	cap.start();
+	u8 ID[253];
+	s16 Position[253];
+	u16 Speed[253];
+	u8 ACC[253];
+	Telemetry Tel[253];
+	for(int i=0; i<Servos; i++){
+		ID[i] = i+1;
+		Speed[i] = 2000;
+		ACC[i] = 50;
+	}
+	for(int c=0; c<N; c++){
+		for(int i=0; i<Servos; i++){
+			Position[i] = 2048+(c%200<100 ? c%100 : 100-c%100)*8;
+		}
+		sm_st.SyncWritePosEx(ID, Servos, Position, Speed, ACC);
+		sm_st.SyncFeedBack(ID, Servos, Tel);
+		if(c%50==0){
+			sm_st.ReadTemper(1+c/50%Servos);
+		}
+		if(c%100==0){
+			sm_st.Ping(Servos+1);//an absent servo, a timeout in the session
+		}
+	}
+	sm_st.setCapture(NULL);
+	cap.stop();
+	cap.close();
+	sm_st.end();
+	pty.stop();
+	pty.close();
+	printf("%d cycles of %d servos, %lu records, %lu dropped\n", N, Servos, cap.Records, cap.Dropped);
+	if(cap.WriteErrors){
+		printf("%lu records not written to %s\n", cap.WriteErrors, Path);
+		return 0;
+	}
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	int Runs = 200;
+	int MaxRec = 16384;
+	double Tol = 10;
+	const char *Out = NULL;
+	int a = 1;
+	for(; a+1<argc && argv[a][0]=='-'; a+=2){
+		char o = argv[a][1];
+		if(o=='n'){
+			Runs = atoi(argv[a+1]);
+		}else if(o=='m'){
+			MaxRec = atoi(argv[a+1]);
+		}else if(o=='o'){
+			Out = argv[a+1];
+		}else if(o=='t'){
+			Tol = atof(argv[a+1]);
+		}else if(o=='c' && a+2<argc){
+			for(int k=a+3; k+1<argc; k+=2){
+				if(!strcmp(argv[k], "-t")){
+					Tol = atof(argv[k+1]);
+				}
+			}
+			return compare(argv[a+1], argv[a+2], Tol);
+		}else if(o=='s' && a+3<argc){
+			return record(atoi(argv[a+1]), atoi(argv[a+2]), argv[a+3]);
+		}else{
+			break;
+		}
+	}
+	if(a>=argc || Runs<1 || MaxRec<1){
+		printf("usage: %s [-n runs] [-m maxRecords] [-o report.json] capture.pcap\n", argv[0]);
+		printf("       %s -c base.json new.json [-t percent]\n", argv[0]);
+		printf("       %s -s servos cycles capture.pcap\n", argv[0]);
+		return 0;
+	}
+	return bench(argv[a], Runs, MaxRec, Out);
+}
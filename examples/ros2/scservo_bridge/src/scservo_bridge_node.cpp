@@ -0,0 +1,94 @@
+/*
+ROS 2 bridge: publishes sensor_msgs/JointState on "joint_states" from one
+SyncRead per cycle and takes goals from "joint_commands" (JointState,
+names "servo_<ID>", position rad, optional velocity rad/s). Goals keep
+latest-value semantics and go out in one SyncWritePosEx per cycle. The
+bus runs on the bridge's own SCHED_FIFO loop thread; the ROS executor
+only delivers command messages.
+
+ros2 run scservo_bridge scservo_bridge_node --ros-args -p port:=/dev/ttyUSB0 -p ids:=[1,2,3] -p rate:=500.0
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/joint_state.hpp"
+#include "SCServo.h"
+#include "SCSJointBridge.h"
+
+class ScservoBridge : public rclcpp::Node
+{
+public:
+	ScservoBridge() : Node("scservo_bridge"), Bridge(&Bus)
+	{
+		std::string Port = declare_parameter<std::string>("port", "/dev/ttyUSB0");
+		std::vector<int64_t> Ids = declare_parameter<std::vector<int64_t>>("ids", {1});
+		double Rate = declare_parameter<double>("rate", 500.0);
+		int Priority = declare_parameter<int>("priority", 80);
+		if(!Bus.begin(1000000, Port.c_str())){
+			throw std::runtime_error("Failed to init sms/sts motor on "+Port);
+		}
+		for(int64_t ID : Ids){
+			Bridge.addJoint((u8)ID);
+			Msg.name.push_back("servo_"+std::to_string(ID));
+		}
+		//sized once, the bus thread only overwrites the values
+		Msg.position.resize(Ids.size());
+		Msg.velocity.resize(Ids.size());
+		Msg.effort.resize(Ids.size());
+		Pub = create_publisher<sensor_msgs::msg::JointState>("joint_states", rclcpp::SensorDataQoS());
+		Sub = create_subscription<sensor_msgs::msg::JointState>("joint_commands", 10,
+			[this](const sensor_msgs::msg::JointState &cmd){  onCommand(cmd);  });
+		Bridge.setPublisher(NULL, publish, this);
+		SCSLoop::lockMemory();
+		Bridge.start((u32)(1000000/Rate), Priority);
+	}
+	~ScservoBridge()
+	{
+		Bridge.stop();
+		Bus.end();
+	}
+private:
+	//bus thread: JointState has unbounded sequences and cannot be loaned
+	//from the middleware, so one preallocated message is reused
+	static void publish(void *arg, SCSJointState *m)
+	{
+		ScservoBridge *n = (ScservoBridge*)arg;
+		sensor_msgs::msg::JointState &Msg = n->Msg;
+		Msg.header.stamp = n->now();
+		for(u8 i=0; i<m->N; i++){
+			if(m->Valid[i]){
+				Msg.position[i] = m->Position[i];
+				Msg.velocity[i] = m->Velocity[i];
+				Msg.effort[i] = m->Effort[i];
+			}
+		}
+		n->Pub->publish(Msg);
+	}
+	void onCommand(const sensor_msgs::msg::JointState &cmd)
+	{
+		for(size_t i=0; i<cmd.name.size() && i<cmd.position.size(); i++){
+			if(cmd.name[i].compare(0, 6, "servo_")){
+				continue;
+			}
+			int ID = atoi(cmd.name[i].c_str()+6);
+			double Velocity = i<cmd.velocity.size() ? cmd.velocity[i] : 0;
+			Bridge.command((u8)ID, cmd.position[i], Velocity);
+		}
+	}
+private:
+	SMS_STS Bus;
+	SCSJointBridge Bridge;
+	sensor_msgs::msg::JointState Msg;
+	rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr Pub;
+	rclcpp::Subscription<sensor_msgs::msg::JointState>::SharedPtr Sub;
+};
+
+int main(int argc, char **argv)
+{
+	rclcpp::init(argc, argv);
+	rclcpp::spin(std::make_shared<ScservoBridge>());
+	rclcpp::shutdown();
+	return 0;
+}
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/Calibration.dir/MidpointCalib.cpp.o"
-  "CMakeFiles/Calibration.dir/MidpointCalib.cpp.o.d"
-  "Calibration"
-  "Calibration.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/Calibration.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
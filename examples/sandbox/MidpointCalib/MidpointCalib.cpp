@@ -1,5 +1,6 @@
 #include <iostream>
 #include "SCServo.h"
+#include "SCSCalib.h"
 
 SMS_STS sm_st;
 
@@ -18,13 +19,16 @@ int main(int argc, char **argv)
         return 0;
     }
 
-    for(int i=0; i<sizeof(ID); i++){
-        sm_st.Mode(ID[i], 0); //set to servo mode
-        sm_st.CalibrationOfs(ID[i]); //set starting position as midpoint: 2048 (=Pi radians)
+    //servo mode, then the starting position becomes the midpoint: 2048 (=Pi radians)
+    SCSCalib Calib(&sm_st);
+    Calib.setServos(ID, sizeof(ID));
+    int n = Calib.run();
+    for(int i=0; i<Calib.N; i++){
+        SCSCalibResult *r = Calib.R+i;
+        std::cout<<"ID:"<<(int)r->ID<<" result:"<<(int)r->Result<<" ofs:"<<r->OfsBefore<<"->"<<r->Ofs<<" pos:"<<r->PosBefore<<"->"<<r->Pos<<std::endl;
     }
 
-	std::cout<<"Calibration complete!"<<std::endl;
+	std::cout<<"Calibration complete! "<<n<<" of "<<sizeof(ID)<<" verified, "<<Calib.Packets<<" packets, "<<Calib.Us<<" us"<<std::endl;
 	sm_st.end();
 	return 1;
 }
-
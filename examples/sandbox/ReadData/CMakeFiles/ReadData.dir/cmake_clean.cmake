@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/ReadData.dir/ReadData.cpp.o"
-  "CMakeFiles/ReadData.dir/ReadData.cpp.o.d"
-  "ReadData"
-  "ReadData.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/ReadData.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
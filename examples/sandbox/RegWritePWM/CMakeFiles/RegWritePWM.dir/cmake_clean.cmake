@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/RegWritePWM.dir/RegWritePWM.cpp.o"
-  "CMakeFiles/RegWritePWM.dir/RegWritePWM.cpp.o.d"
-  "RegWritePWM"
-  "RegWritePWM.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/RegWritePWM.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/RegWritePosition.dir/RegWritePosition.cpp.o"
-  "CMakeFiles/RegWritePosition.dir/RegWritePosition.cpp.o.d"
-  "RegWritePosition"
-  "RegWritePosition.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/RegWritePosition.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -5,8 +5,10 @@ The factory speed of the servo motor is 0.0146rpm, and the speed is changed to V
 #include <iostream>
 #include <csignal>
 #include "SCServo.h"
+#include "SCSGroupCommit.h"
 
 SMS_STS sm_st;
+SCSGroupCommit Group(&sm_st);
 
 u8 ID[3] = {11, 12, 13};
 s16 P0 = 2048; // = 1/2 rotation = Pi radians
@@ -47,16 +49,16 @@ int main(int argc, char **argv)
     
 	while(1){
         for(int i=0; i<sizeof(ID); i++){
-    		sm_st.RegWritePosEx(ID[i], P1, V, A);//go to Pos=4095 with Vel=2400 steps/s and Acc=50*100 steps/s^2
+    		Group.stagePosEx<SMS_STS::Map>(ID[i], P1, V, A);//go to Pos=4095 with Vel=2400 steps/s and Acc=50*100 steps/s^2
         }
-        sm_st.RegWriteAction();
+        Group.commit();//one pipelined batch of reg writes, one broadcast action, one SyncRead check
 		std::cout<<"pos = "<<static_cast<int>(P1)<<std::endl;
 		sleep(2);//execution time = 2s, max = [(P1-P0)/V]*1000+[V/(A*100)]*1000
 
         for(int i=0; i<sizeof(ID); i++){
-    		sm_st.RegWritePosEx(ID[i], P0, V, A);//go to Pos=2048 with Vel=2400 steps/s and Acc=50*100 steps/s^2
+    		Group.stagePosEx<SMS_STS::Map>(ID[i], P0, V, A);//go to Pos=2048 with Vel=2400 steps/s and Acc=50*100 steps/s^2
         }
-        sm_st.RegWriteAction();
+        Group.commit();//one pipelined batch of reg writes, one broadcast action, one SyncRead check
 		std::cout<<"pos = "<<static_cast<int>(P0)<<std::endl;
 		sleep(2);//execution time = 2s, max = [(P1-P0)/V]*1000+[V/(A*100)]*1000
 	}
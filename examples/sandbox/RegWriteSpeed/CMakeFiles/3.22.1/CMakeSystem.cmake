@@ -1,15 +0,0 @@
-set(CMAKE_HOST_SYSTEM "Linux-5.15.0-1029-raspi")
-set(CMAKE_HOST_SYSTEM_NAME "Linux")
-set(CMAKE_HOST_SYSTEM_VERSION "5.15.0-1029-raspi")
-set(CMAKE_HOST_SYSTEM_PROCESSOR "aarch64")
-
-
-
-set(CMAKE_SYSTEM "Linux-5.15.0-1029-raspi")
-set(CMAKE_SYSTEM_NAME "Linux")
-set(CMAKE_SYSTEM_VERSION "5.15.0-1029-raspi")
-set(CMAKE_SYSTEM_PROCESSOR "aarch64")
-
-set(CMAKE_CROSSCOMPILING "FALSE")
-
-set(CMAKE_SYSTEM_LOADED 1)
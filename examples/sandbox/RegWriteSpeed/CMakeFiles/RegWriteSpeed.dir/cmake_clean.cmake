@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/RegWriteSpeed.dir/RegWriteSpeed.cpp.o"
-  "CMakeFiles/RegWriteSpeed.dir/RegWriteSpeed.cpp.o.d"
-  "RegWriteSpeed"
-  "RegWriteSpeed.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/RegWriteSpeed.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/SyncWritePWM.dir/SyncWritePWM.cpp.o"
-  "CMakeFiles/SyncWritePWM.dir/SyncWritePWM.cpp.o.d"
-  "SyncWritePWM"
-  "SyncWritePWM.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/SyncWritePWM.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/SyncWritePosition.dir/SyncWritePosition.cpp.o"
-  "CMakeFiles/SyncWritePosition.dir/SyncWritePosition.cpp.o.d"
-  "SyncWritePosition"
-  "SyncWritePosition.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/SyncWritePosition.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
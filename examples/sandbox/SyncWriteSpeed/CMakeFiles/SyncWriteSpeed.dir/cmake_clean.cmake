@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/SyncWriteSpeed.dir/SyncWriteSpeed.cpp.o"
-  "CMakeFiles/SyncWriteSpeed.dir/SyncWriteSpeed.cpp.o.d"
-  "SyncWriteSpeed"
-  "SyncWriteSpeed.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/SyncWriteSpeed.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
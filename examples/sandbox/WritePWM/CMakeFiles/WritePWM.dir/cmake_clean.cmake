@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/WritePWM.dir/WritePWM.cpp.o"
-  "CMakeFiles/WritePWM.dir/WritePWM.cpp.o.d"
-  "WritePWM"
-  "WritePWM.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/WritePWM.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/WritePosition.dir/WritePosition.cpp.o"
-  "CMakeFiles/WritePosition.dir/WritePosition.cpp.o.d"
-  "WritePosition"
-  "WritePosition.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/WritePosition.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
@@ -1,11 +0,0 @@
-file(REMOVE_RECURSE
-  "CMakeFiles/WriteSpeed.dir/WriteSpeed.cpp.o"
-  "CMakeFiles/WriteSpeed.dir/WriteSpeed.cpp.o.d"
-  "WriteSpeed"
-  "WriteSpeed.pdb"
-)
-
-# Per-language clean rules from dependency scanning.
-foreach(lang CXX)
-  include(CMakeFiles/WriteSpeed.dir/cmake_clean_${lang}.cmake OPTIONAL)
-endforeach()
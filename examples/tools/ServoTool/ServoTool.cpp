@@ -0,0 +1,376 @@
+/*
+ServoTool: one command line tool for a bus of SMS/STS servos.
+
+  ServoTool [-p port] [-b baud] [-i ids] [-f file] command [args]
+
+  scan [first last]        SyncRead scan of the model register (-a: every baud rate)
+  ping                     one SyncRead of the model register, lists who answers
+  read addr len            SyncRead of a register range, one hex line per servo
+  write addr byte...       the same bytes to every servo in one sync write (EPROM unlocked around it)
+  monitor hz [cycles]      SyncFeedBack at hz, one line per servo and cycle
+  setid old:new...         new IDs in one provisioning run, read back
+  setbaud rate             new baud rate for every servo, read back, the host follows
+  bench [cycles]           back-to-back SyncFeedBack, rate and latency percentiles
+
+ids: 1,2,5-12, without them the servos found by a SyncRead scan. The file holds "port", "baud"
+and "ids" lines with the same syntax, # starts a comment; arguments
+given later override it. port sim:N runs against N simulated servos.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SCServo.h"
+#include "SCSDiscovery.h"
+#include "SCSProvision.h"
+#include "SCSLoop.h"
+#include "SCSStats.h"
+#include "SCSSim.h"
+#include "SCSSimBus.h"
+
+#define SCS_TOOL_IDS 250//one SyncRead frame carries at most 251 IDs
+
+SMS_STS sm_st;
+SCSSim Sim(1000000);
+SCSSimBus<SMS_STS> SimBus(&Sim);
+SMS_STS *bus = &sm_st;
+
+char Port[128] = "/dev/ttyUSB0";
+int Baud = 1000000;
+u8 ID[0xfe];
+u8 IDN = 0;
+SyncReadRx rxTab[0xfe];
+u8 rxBuff[0xfe*(255+6)];
+
+//"1,2,5-12" into ID[], returns servos added
+int parseIDs(const char *s)
+{
+	int n = 0;
+	while(*s){
+		char *e;
+		long a = strtol(s, &e, 0);
+		if(e==s){
+			s++;
+			continue;
+		}
+		long b = a;
+		s = e;
+		if(*s=='-'){
+			b = strtol(s+1, &e, 0);
+			s = e;
+		}
+		for(long i=a; i<=b && i<0xfe && IDN<SCS_TOOL_IDS; i++){
+			if(i>=0){
+				ID[IDN++] = (u8)i;
+				n++;
+			}
+		}
+	}
+	return n;
+}
+
+int loadConfig(const char *Path)
+{
+	FILE *f = fopen(Path, "r");
+	if(!f){
+		printf("cannot open %s\n", Path);
+		return 0;
+	}
+	char Line[512];
+	while(fgets(Line, sizeof(Line), f)){
+		char *c = strchr(Line, '#');
+		if(c){
+			*c = 0;
+		}
+		char Key[16];
+		char Val[480];
+		if(sscanf(Line, "%15s %479[^\n]", Key, Val)!=2){
+			continue;
+		}
+		if(!strcmp(Key, "port")){
+			sscanf(Val, "%127s", Port);
+		}else if(!strcmp(Key, "baud")){
+			Baud = atoi(Val);
+		}else if(!strcmp(Key, "ids")){
+			parseIDs(Val);
+		}
+	}
+	fclose(f);
+	return 1;
+}
+
+int scan(int argc, char **argv, int All)
+{
+	int First = argc>0 ? atoi(argv[0]) : 0;
+	int Last = argc>1 ? atoi(argv[1]) : 253;
+	SCSDiscovery Disc(bus);
+	if(All){
+		Disc.scanBauds(SCSerial::baudTable, SCSERIAL_BAUD_CODES, 1);
+	}else{
+		Disc.scanSync(First, Last);
+	}
+	for(u8 i=0; i<Disc.IDN; i++){
+		u8 id = Disc.ID[i];
+		printf("ID:%d model:0x%04x baud:%d\n", id, Disc.Model[id], Disc.Baud[id]);
+	}
+	printf("%d servos\n", Disc.IDN);
+	return Disc.IDN;
+}
+
+int readRange(u8 Addr, u8 Len, int Print)
+{
+	u64 t0 = SCSerial::monoUs();
+	int n = bus->syncRead(ID, IDN, Addr, Len, rxBuff, rxTab, 0xfe);
+	u64 Us = SCSerial::monoUs()-t0;
+	for(u8 i=0; i<IDN && Print; i++){
+		const SyncReadRx *r = rxTab+ID[i];
+		if(!r->Valid){
+			printf("ID:%d no reply\n", ID[i]);
+			continue;
+		}
+		printf("ID:%d err:0x%02x", ID[i], r->Error);
+		for(u8 k=0; k<Len; k++){
+			printf(" %02x", r->Dat[k]);
+		}
+		printf("\n");
+	}
+	if(Print){
+		printf("%d of %d answered in %lu us\n", n, IDN, (u32)Us);
+	}
+	return n;
+}
+
+int ping()
+{
+	readRange(SMS_STS_MODEL_L, 2, 0);
+	int n = 0;
+	for(u8 i=0; i<IDN; i++){
+		const SyncReadRx *r = rxTab+ID[i];
+		if(r->Valid){
+			printf("ID:%d model:0x%04x\n", ID[i], SMS_STS_Map::Order::get16(r->Dat));
+			n++;
+		}else{
+			printf("ID:%d no reply\n", ID[i]);
+		}
+	}
+	printf("%d of %d answered\n", n, IDN);
+	return n;
+}
+
+int writeRange(u8 Addr, int argc, char **argv)
+{
+	u8 Len = argc<16 ? argc : 16;
+	u8 Dat[0xfe*16];
+	for(u8 i=0; i<IDN; i++){
+		for(u8 k=0; k<Len; k++){
+			Dat[i*Len+k] = (u8)strtol(argv[k], NULL, 0);
+		}
+	}
+	u8 Lock[0xfe];
+	int Eprom = Addr<SMS_STS_TORQUE_ENABLE;
+	if(Eprom){
+		memset(Lock, 0, IDN);
+		bus->syncWrite(ID, IDN, SMS_STS_LOCK, Lock, 1);
+	}
+	bus->syncWrite(ID, IDN, Addr, Dat, Len);
+	if(Eprom){
+		usleep(SCSERIAL_EEPROM_US);
+		memset(Lock, 1, IDN);
+		bus->syncWrite(ID, IDN, SMS_STS_LOCK, Lock, 1);
+	}
+	printf("%d bytes to %d servos at %d%s\n", Len, IDN, Addr, Eprom ? " (EPROM)" : "");
+	return IDN;
+}
+
+struct Monitor{
+	Telemetry Tel[0xfe];
+	u32 Cycle;
+};
+
+int monitorJob(void *arg)
+{
+	Monitor *m = (Monitor*)arg;
+	bus->SyncFeedBack(ID, IDN, m->Tel);
+	for(u8 i=0; i<IDN; i++){
+		const Telemetry *t = m->Tel+i;
+		if(t->Valid){
+			printf("%lu ID:%d pos:%d speed:%d load:%d volt:%d temp:%d current:%d err:0x%02x\n", m->Cycle, ID[i], t->Position, t->Speed, t->Load, t->Voltage, t->Temperature, t->Current, t->Error);
+		}else{
+			printf("%lu ID:%d no reply\n", m->Cycle, ID[i]);
+		}
+	}
+	fflush(stdout);
+	m->Cycle++;
+	return bus->Fault ? -1 : 0;
+}
+
+int monitor(int Hz, u32 Cycles)
+{
+	static Monitor m;
+	m.Cycle = 0;
+	SCSLoop Loop;
+	Loop.setPeriod(Hz>0 ? 1000000/Hz : 100000);
+	Loop.setJob(monitorJob, &m);
+	return Loop.run(Cycles);
+}
+
+const char *provResult(u8 r)
+{
+	static const char *Name[] = {"absent", "unchanged", "planned", "verified", "mismatch", "conflict"};
+	return r<sizeof(Name)/sizeof(Name[0]) ? Name[r] : "?";
+}
+
+int setIDs(int argc, char **argv)
+{
+	SCSProvision Prov(bus);
+	for(int i=0; i<argc; i++){
+		int Old, New;
+		if(sscanf(argv[i], "%d:%d", &Old, &New)!=2 || Old<0 || Old>253 || New<0 || New>253){
+			printf("bad id pair %s\n", argv[i]);
+			return -1;
+		}
+		SCSServoConfig c;
+		memset(&c, 0, sizeof(c));
+		c.ID = Old;
+		c.Set = SCS_PROV_ID;
+		c.NewID = New;
+		Prov.add(c);
+	}
+	int n = Prov.run();
+	for(int i=0; i<Prov.ServoN; i++){
+		printf("ID:%d -> %d %s\n", Prov.Cfg[i].ID, Prov.Cfg[i].NewID, provResult(Prov.Result[i]));
+	}
+	printf("%d verified, %lu packets\n", n, Prov.Packets);
+	return n;
+}
+
+int setBaud(int Rate)
+{
+	int Code = SCSerial::baudCode(Rate);
+	if(Code<0){
+		printf("no baud code for %d\n", Rate);
+		return -1;
+	}
+	SCSProvision Prov(bus);
+	for(u8 i=0; i<IDN; i++){
+		SCSServoConfig c;
+		memset(&c, 0, sizeof(c));
+		c.ID = ID[i];
+		c.Set = SCS_PROV_BAUD;
+		c.Baud = Code;
+		Prov.add(c);
+	}
+	int n = Prov.run();
+	for(int i=0; i<Prov.ServoN; i++){
+		printf("ID:%d %s\n", Prov.Cfg[i].ID, provResult(Prov.Result[i]));
+	}
+	bus->setBaudRate(Rate);
+	printf("%d of %d verified at %d, %lu packets\n", n, IDN, Rate, Prov.Packets);
+	return n;
+}
+
+int bench(u32 Cycles)
+{
+	static Telemetry Tel[0xfe];
+	bus->enableStats();
+	u64 t0 = SCSerial::monoUs();
+	u64 Valid = 0;
+	for(u32 c=0; c<Cycles; c++){
+		Valid += bus->SyncFeedBack(ID, IDN, Tel);
+	}
+	u64 Us = SCSerial::monoUs()-t0;
+	const SCSStats *s = bus->getStats();
+	const SCSHist *h = s ? &s->Inst[SCSStats::instIndex(INST_SYNC_READ)].Reply : NULL;
+	printf("%lu cycles of %d servos in %lu us: %.1f Hz, %.2f%% replies\n", Cycles, IDN, (u32)Us, Us ? Cycles*1e6/Us : 0, Cycles && IDN ? 100.0*Valid/(Cycles*IDN) : 0);
+	if(h && h->Count){
+		printf("cycle us: mean %lu p50 %lu p99 %lu max %lu\n", h->mean(), h->percentile(50), h->percentile(99), h->Max);
+	}
+	return (int)Valid;
+}
+
+void usage()
+{
+	printf("usage: ServoTool [-p port] [-b baud] [-i ids] [-f file] scan|ping|read|write|monitor|setid|setbaud|bench [args]\n");
+}
+
+int main(int argc, char **argv)
+{
+	int a = 1;
+	int All = 0;
+	for(; a<argc && argv[a][0]=='-'; a++){
+		char o = argv[a][1];
+		if(o=='a'){
+			All = 1;
+			continue;
+		}
+		if(a+1>=argc){
+			usage();
+			return 0;
+		}
+		if(o=='p'){
+			snprintf(Port, sizeof(Port), "%s", argv[++a]);
+		}else if(o=='b'){
+			Baud = atoi(argv[++a]);
+		}else if(o=='i'){
+			IDN = 0;
+			parseIDs(argv[++a]);
+		}else if(o=='f'){
+			if(!loadConfig(argv[++a])){
+				return 0;
+			}
+		}else{
+			usage();
+			return 0;
+		}
+	}
+	if(a>=argc){
+		usage();
+		return 0;
+	}
+	const char *Cmd = argv[a++];
+	int n = argc-a;
+	char **Arg = argv+a;
+	if(!strncmp(Port, "sim:", 4)){
+		int SimN = atoi(Port+4);
+		for(int i=1; i<=SimN && i<0xfe; i++){
+			Sim.addServo(i);
+		}
+		bus = &SimBus;
+	}
+	bus->Verbose = 0;
+	if(!bus->begin(Baud, Port)){
+		printf("Failed to init sms/sts motor!\n");
+		return 0;
+	}
+	if(!IDN && strcmp(Cmd, "scan") && strcmp(Cmd, "setid")){
+		SCSDiscovery Disc(bus);
+		Disc.scanSync();
+		memcpy(ID, Disc.ID, Disc.IDN);
+		IDN = Disc.IDN;
+		if(!IDN){
+			printf("no servos found\n");
+		}
+	}
+	int r = -1;
+	if(!strcmp(Cmd, "scan")){
+		r = scan(n, Arg, All);
+	}else if(!strcmp(Cmd, "ping")){
+		r = ping();
+	}else if(!strcmp(Cmd, "read") && n>=2){
+		r = readRange(atoi(Arg[0]), atoi(Arg[1]), 1);
+	}else if(!strcmp(Cmd, "write") && n>=2){
+		r = writeRange(atoi(Arg[0]), n-1, Arg+1);
+	}else if(!strcmp(Cmd, "monitor") && n>=1){
+		r = monitor(atoi(Arg[0]), n>1 ? atoi(Arg[1]) : 0);
+	}else if(!strcmp(Cmd, "setid") && n>=1){
+		r = setIDs(n, Arg);
+	}else if(!strcmp(Cmd, "setbaud") && n>=1){
+		r = setBaud(atoi(Arg[0]));
+	}else if(!strcmp(Cmd, "bench")){
+		r = bench(n>0 ? atoi(Arg[0]) : 1000);
+	}else{
+		usage();
+	}
+	bus->end();
+	return r<0 ? 0 : 1;
+}